@@ -2,11 +2,40 @@
 #define CC_H
 
 #include "graph.h"
+#include "csr_compact.h"
 #include <stdint.h>
 
 // Default chunk size for parallel algorithms
 #define DEFAULT_CHUNK_SIZE 4096
 
+// Counters recorded for one round of the frontier LP kernels
+typedef struct
+{
+  int64_t active_vertices; // vertices in the frontier at the start of the round
+  int64_t edges_scanned;   // adjacency entries read during the round
+  int dense;               // 1 when the frontier was scanned as a bitmap over all vertices
+} LPRoundStat;
+
+// Growable per-round log; zero-initialize (or lp_round_stats_init) before use
+typedef struct
+{
+  LPRoundStat *rounds;
+  int count;
+  int capacity;
+} LPRoundStats;
+
+void lp_round_stats_init(LPRoundStats *stats);
+void lp_round_stats_free(LPRoundStats *stats);
+
+// Append one round; exits on allocation failure like the kernels
+void lp_round_stats_push(LPRoundStats *stats, int64_t active_vertices, int64_t edges_scanned, int dense);
+
+// Sum of edges_scanned over all recorded rounds
+int64_t lp_round_stats_total_edges(const LPRoundStats *stats);
+
+// Write the log as CSV (Round,Mode,Active Vertices,Edges Scanned). Returns 0 on success
+int lp_round_stats_write_csv(const LPRoundStats *stats, const char *path);
+
 // Sequential connected components algorithm using label propagation
 // Non optimal for sequential execution but simple to parallelize later
 void compute_connected_components(const CSRGraph *restrict G, int32_t *restrict labels);
@@ -19,17 +48,110 @@ void compute_connected_components_bfs(const CSRGraph *restrict G, int32_t *restr
 // Identical to the label propagation version but using OpenMP for loop parallelism
 void compute_connected_components_omp(const CSRGraph *restrict G, int32_t *restrict labels, int chunk_size);
 
+// The same OpenMP LP kernel over the compact layouts of csr_compact.h; labels are identical
+void compute_connected_components_omp_csr32(const CSRGraph32 *restrict G, int32_t *restrict labels,
+                                            int chunk_size);
+void compute_connected_components_omp_varint(const CSRGraphVarint *restrict G, int32_t *restrict labels,
+                                             int chunk_size);
+
+// In-place variants: labels is the kernel's atomic working array (initialized by the call), so
+// nothing is allocated or copied back. Used by cc_context.h to reuse one buffer across calls
+void compute_connected_components_omp_inplace(const CSRGraph *restrict G, _Atomic int32_t *restrict labels,
+                                              int chunk_size);
+void compute_connected_components_omp_csr32_inplace(const CSRGraph32 *restrict G,
+                                                    _Atomic int32_t *restrict labels, int chunk_size);
+void compute_connected_components_omp_varint_inplace(const CSRGraphVarint *restrict G,
+                                                     _Atomic int32_t *restrict labels, int chunk_size);
+
 // Parallel connected components algorithm using OpenCilk
 // Identical to the label propagation version but using Cilk for loop parallelism
 void compute_connected_components_cilk(const CSRGraph *restrict G, int32_t *restrict labels, int chunk_size);
+void compute_connected_components_cilk_inplace(const CSRGraph *restrict G, _Atomic int32_t *restrict labels,
+                                               int chunk_size);
+
+// Recursive divide-and-conquer label propagation using OpenCilk
+// Every round halves the vertex range at its row_ptr cost midpoint down to leaves of about
+// chunk_size average vertices (vertices plus edges, as in the work-stealing scheduler), and rows
+// longer than a leaf are spawned as hub tasks that split their adjacency. The changed flag and
+// the round counters are an OpenCilk reducer instead of a shared atomic.
+// Labels match the LP kernels. Appends one entry per round to stats (may be NULL) and
+// returns the number of rounds executed
+int compute_connected_components_recursive_cilk(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                int chunk_size, LPRoundStats *stats);
+
+// Number of workers the Cilk kernels run on (CILK_NWORKERS or all CPUs)
+int cilk_num_workers(void);
 
 // Parallel connected components algorithm using pthreads
 // More complex implementation using pthreads for parallelism
 void compute_connected_components_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
                                            int num_threads, int chunk_size);
 
+// Pthreads label propagation with an edge-balanced work-stealing scheduler
+// Each thread owns a Chase-Lev deque of tasks cut from its edge-balanced share of the rows;
+// a task holds about chunk_size average vertices worth of edges and hub rows are split
+// over several tasks. Idle threads steal from random victims instead of sharing one counter.
+// Same labels as compute_connected_components_pthreads. Returns the number of stolen tasks
+int64_t compute_connected_components_steal_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                    int num_threads, int chunk_size);
+
+// Pthreads label propagation without per-round barriers
+// Every thread sweeps its edge-balanced share of the rows until the labels stop changing and
+// detects global quiescence from per-thread change counters and clean-sweep epochs.
+// Same labels as compute_connected_components_pthreads. Returns the largest number of
+// sweeps a thread made
+int compute_connected_components_async_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                int num_threads);
+
+// Parallel BFS-based connected components using OpenMP
+// Direction-optimizing BFS (top-down list / bottom-up bitmap) from the highest-degree vertex
+// labels the giant component; a union-find pass over the unreached vertices finishes the rest.
+// Labels match the LP kernels. Returns the number of BFS levels
+int compute_connected_components_bfs_omp(const CSRGraph *restrict G, int32_t *restrict labels,
+                                         int chunk_size);
+
+// Parallel BFS-based connected components using pthreads, same contract as the OpenMP version
+int compute_connected_components_bfs_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                              int num_threads, int chunk_size);
+
+// Frontier (active-set) label propagation using OpenMP
+// Only vertices whose label dropped in the previous round push their label to their neighbors.
+// The frontier switches between a bitmap and a vertex list with its size.
+// Labels match the LP kernels. Appends one entry per round to stats (may be NULL) and
+// returns the number of rounds executed
+int compute_connected_components_frontier_omp(const CSRGraph *restrict G, int32_t *restrict labels,
+                                              int chunk_size, LPRoundStats *stats);
+
+// Frontier label propagation using pthreads, same contract as the OpenMP version
+int compute_connected_components_frontier_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                   int num_threads, int chunk_size, LPRoundStats *stats);
+
+// Sequential connected components algorithm using Afforest-style union-find
+// Links a few sampled neighbors first, then skips the giant component in the final pass
+// Labels match the LP kernels (minimum vertex ID of each component)
+void compute_connected_components_afforest(const CSRGraph *restrict G, int32_t *restrict labels);
+
+// Parallel Afforest using OpenMP with CAS-based linking
+void compute_connected_components_afforest_omp(const CSRGraph *restrict G, int32_t *restrict labels,
+                                               int chunk_size);
+
+// Parallel Afforest using OpenCilk with CAS-based linking
+void compute_connected_components_afforest_cilk(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                int chunk_size);
+
+// Parallel Afforest using pthreads with CAS-based linking
+void compute_connected_components_afforest_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                    int num_threads, int chunk_size);
+
+// Parallel Shiloach-Vishkin (conditional/unconditional hooking + pointer jumping) using pthreads
+// Synchronous rounds on barriers; finishes in O(log n) rounds regardless of the diameter
+// Labels match the LP kernels. Returns the number of rounds executed
+int compute_connected_components_sv_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                             int num_threads, int chunk_size);
+
 // Count the number of unique labels in the labels array
 // Using label propagation, we know that labels are in the range [0, n-1]
+// Runs the parallel pass of component_stats_compute (labels_io.h)
 int32_t count_unique_labels(const int32_t *restrict labels, int32_t n);
 
 #endif
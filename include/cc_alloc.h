@@ -0,0 +1,49 @@
+#ifndef CC_ALLOC_H
+#define CC_ALLOC_H
+
+#include <stddef.h>
+
+// Central allocator for the graph and per-vertex arrays (row_ptr, col_idx, labels, parents,
+// frontiers). Random label reads over a multi-GB array miss the TLB on nearly every access
+// with 4 KB pages, so large arrays can be backed by huge pages instead:
+//   off - posix_memalign with 64-byte alignment (the previous behaviour)
+//   thp - 2 MB aligned heap blocks with madvise(MADV_HUGEPAGE)
+//   2m  - explicit 2 MB hugetlbfs pages (mmap MAP_HUGETLB), thp when none are reserved
+//   1g  - 1 GB hugetlbfs pages for arrays of at least 1 GB, otherwise as 2m
+// Arrays below CC_ALLOC_HUGE_MIN bytes always take the off path. The mode is process-wide
+// and set once by the drivers' --hugepages option, before the graph is loaded.
+
+// Smallest allocation that is considered for huge pages
+#define CC_ALLOC_HUGE_MIN ((size_t)2 << 20)
+
+typedef enum
+{
+  CC_HUGEPAGES_OFF = 0,
+  CC_HUGEPAGES_THP = 1,
+  CC_HUGEPAGES_2M = 2,
+  CC_HUGEPAGES_1G = 3
+} CCHugePages;
+
+// Parse "off", "thp", "2m" or "1g". Returns 0 on success
+int cc_hugepages_parse(const char *name, CCHugePages *out);
+
+const char *cc_hugepages_name(CCHugePages mode);
+
+void cc_alloc_set_hugepages(CCHugePages mode);
+CCHugePages cc_alloc_hugepages(void);
+
+// At least 64-byte aligned, uninitialized. Returns NULL on failure
+void *cc_alloc(size_t bytes);
+
+// Resize a block from cc_alloc (or malloc/posix_memalign), keeping the cc_alloc alignment;
+// hugetlbfs blocks shrink in place, heap blocks move. Returns NULL on failure, leaving p allocated
+void *cc_realloc(void *p, size_t bytes);
+
+// Release a block from cc_alloc, cc_realloc, malloc or posix_memalign. NULL is ignored
+void cc_free(void *p);
+
+// Page sizes that backed the large allocations so far, largest first and joined by '+'
+// ("1g+2m", "thp", "4k"). Written to buf (truncated to size), which is returned
+const char *cc_alloc_pages_used(char *buf, size_t size);
+
+#endif
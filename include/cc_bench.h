@@ -0,0 +1,56 @@
+#ifndef CC_BENCH_H
+#define CC_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+#include "csr_compact.h"
+#include "cc_pthread_pool.h"
+
+// Kernel registry of bin/cc_bench. Every connected components kernel is wrapped behind
+// one signature so the harness can run any subset over a single loaded graph. Adding a
+// kernel means one wrapper and one table entry in src/cc_bench_kernels.c.
+
+// Runtime a kernel parallelizes with, deciding how the harness sets its thread count
+typedef enum
+{
+  CC_BENCH_SEQUENTIAL = 0, // runs once, reported as 1 thread
+  CC_BENCH_OPENMP = 1,     // omp_set_num_threads before every run
+  CC_BENCH_PTHREADS = 2,   // thread count passed to the shared pool
+  CC_BENCH_CILK = 3        // worker count fixed by CILK_NWORKERS at startup (make BENCH_CILK=1)
+} BenchRuntime;
+
+// Inputs of one kernel run
+typedef struct
+{
+  const CSRGraph *G;
+  const CSRGraph32 *G32;    // built once when a selected kernel runs on csr32
+  const CSRGraphVarint *Gv; // built once when a selected kernel runs on varint
+  int num_threads;
+  int chunk_size;
+  CCPthreadPool *pool; // shared pool for CC_BENCH_PTHREADS kernels
+} BenchContext;
+
+typedef struct
+{
+  const char *name;        // CLI name, the same as the drivers' results tag
+  const char *description;
+  BenchRuntime runtime;
+  int uses_chunk;          // 1 when chunk_size changes what the kernel does
+  int compact_labels;      // 1 for 0..k-1 labels, 0 for the minimum vertex ID of each component
+  CSRLayout layout;        // adjacency layout the kernel reads
+  void (*run)(const BenchContext *ctx, int32_t *labels);
+} BenchKernel;
+
+// All kernels built into this binary, in listing order
+const BenchKernel *cc_bench_kernels(size_t *count);
+
+// Kernel called name, or NULL
+const BenchKernel *cc_bench_find_kernel(const char *name);
+
+const char *cc_bench_runtime_name(BenchRuntime runtime);
+
+// Number of Cilk workers, 0 when the binary was built without the Cilk kernels
+int cc_bench_cilk_workers(void);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef CC_CONTEXT_H
+#define CC_CONTEXT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+
+// Reusable connected components context, the entry point of lib/libcc.a and lib/libcc.so.
+// A context owns a graph, an aligned label buffer and a thread pool across calls, so repeated
+// runs on the same graph neither allocate nor page-fault: the LP kernels run directly on the
+// label buffer (the *_inplace variants) instead of on a private atomic copy.
+//
+//   CCContext *ctx = cc_context_create(CC_CONTEXT_OMP, 8, 0);
+//   cc_context_load(ctx, "graph.mtx");
+//   cc_context_run(ctx);
+//   const int32_t *labels = cc_context_labels(ctx); // minimum vertex ID of each component
+//   cc_context_destroy(ctx);
+//
+// A context is not thread-safe; use one per calling thread.
+typedef struct CCContext CCContext;
+
+// Runtime the LP kernel of cc_context_run uses
+typedef enum
+{
+  CC_CONTEXT_OMP = 0,      // compute_connected_components_omp_inplace
+  CC_CONTEXT_PTHREADS = 1, // cc_pthread_pool_run_lp_inplace on the context's pool
+  CC_CONTEXT_CILK = 2      // compute_connected_components_cilk_inplace (make libcc LIB_CILK=1)
+} CCContextBackend;
+
+// Graphs with at most this many stored edges are labeled whole by one thread in
+// cc_context_run_batch; larger ones get all threads, one graph at a time
+#define CC_CONTEXT_BATCH_SMALL_EDGES (1LL << 18)
+
+// Returns NULL on failure (unknown or unavailable backend, thread creation failure).
+// num_threads <= 0 uses all online CPUs; chunk_size follows the LP kernels (1 = static
+// schedule, <= 0 = DEFAULT_CHUNK_SIZE). The Cilk backend runs on CILK_NWORKERS workers
+CCContext *cc_context_create(CCContextBackend backend, int num_threads, int chunk_size);
+
+// Free the graph, the buffers and the pool. NULL is ignored
+void cc_context_destroy(CCContext *ctx);
+
+// Load a graph with load_csr_from_file (symmetrized, self loops dropped) and make it the
+// context's graph, replacing the previous one. Returns 0 on success
+int cc_context_load(CCContext *ctx, const char *path);
+
+// Take ownership of *G (zeroed on return) and make it the context's graph. Returns 0 on success
+int cc_context_set_graph(CCContext *ctx, CSRGraph *G);
+
+// The context's graph, or NULL before the first load/set
+const CSRGraph *cc_context_graph(const CCContext *ctx);
+
+// Label the context's graph. The label buffer only grows, so running again or switching to a
+// graph that is not larger reuses it. Returns 0 on success, -1 when no graph is set
+int cc_context_run(CCContext *ctx);
+
+// Labels of the last cc_context_run (n entries, valid until the next run, set, batch or destroy)
+const int32_t *cc_context_labels(const CCContext *ctx);
+
+// Components in the labels of the last cc_context_run
+int32_t cc_context_count_components(const CCContext *ctx);
+
+// Label count graphs into labels[i] (graphs[i]->n entries each, caller-owned), LP-style
+// minimum-ID labels. Small graphs are spread over the threads and labeled whole by an
+// in-place sequential union-find; graphs above CC_CONTEXT_BATCH_SMALL_EDGES run afterwards
+// on the context's backend. Returns 0 on success
+int cc_context_run_batch(CCContext *ctx, const CSRGraph *const *graphs, int32_t *const *labels, size_t count);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef CC_GPU_H
+#define CC_GPU_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// CUDA connected components with ECL-CC (Jaiganesh and Burtscher, 2018): every vertex starts
+// at its smallest neighbor, then edges are hooked with atomicCAS on the union-find roots
+// (intermediate pointer jumping in every find) and a final pass flattens each vertex onto
+// its root. Vertices are hooked by a thread, a warp or a whole block depending on their
+// degree. Roots are always hooked under smaller roots, so the labels match the LP kernels
+// (minimum vertex ID). Built by make gpu (needs nvcc), separately from the CPU backends.
+
+// Rows above this degree are hooked by a warp, above CC_GPU_BLOCK_DEGREE by a block
+#define CC_GPU_WARP_DEGREE 16
+#define CC_GPU_BLOCK_DEGREE 352
+
+// Upload staging chunk size used by cc_gpu when --chunk-mb is not given
+#define CC_GPU_DEFAULT_CHUNK_BYTES ((size_t)64 << 20)
+
+// Device-resident graph, labels and worklist, reused across runs
+typedef struct CCGpuGraph CCGpuGraph;
+
+// Timings of one upload/run/download cycle
+typedef struct
+{
+  double upload_seconds;   // host -> device copy of row_ptr and col_idx
+  double kernel_seconds;   // init, hooking and flattening kernels (CUDA events)
+  double download_seconds; // device -> host copy of the labels
+  int chunks;              // staging chunks of the last upload
+} GPURunStats;
+
+// Select device and write its name to name (truncated to name_size). Returns 0 on success.
+int cc_gpu_init(int device, char *name, size_t name_size);
+
+// Allocate the device arrays of a graph with n vertices and m edges, plus its labels and
+// worklist, on the current device. Returns NULL on failure.
+CCGpuGraph *cc_gpu_graph_create(int32_t n, int64_t m);
+
+void cc_gpu_graph_destroy(CCGpuGraph *g);
+
+// Copy G (of the size g was created for) to the device through two pinned staging buffers
+// of chunk_bytes: the host copies chunk i + 1 into one buffer while chunk i is transferred
+// from the other, so reading a mapped .csr file or pageable memory overlaps with the DMA and
+// the pinned memory stays bounded. Returns 0 on success.
+int cc_gpu_upload(CCGpuGraph *g, const CSRGraph *G, size_t chunk_bytes, GPURunStats *stats);
+
+// Label the uploaded graph and copy the n labels back. Returns 0 on success.
+int cc_gpu_components(CCGpuGraph *g, int32_t *labels, GPURunStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef CC_INCREMENTAL_H
+#define CC_INCREMENTAL_H
+
+#include <stdint.h>
+
+// Incremental connected components over a concurrent union-find.
+// The engine starts from the labels of a full run (or from singletons) and absorbs batches
+// of new edges in parallel; an update touches only the endpoints of the batch and the tree
+// paths above them, so its cost follows the batch size rather than n or m. Roots are the
+// minimum vertex ID of their component, the label format of the LP kernels.
+// The functions must not be called concurrently on the same engine.
+
+// Batches smaller than this are applied on the calling thread only
+#define CC_INCREMENTAL_PARALLEL_MIN_EDGES 16384
+
+typedef struct CCIncremental CCIncremental;
+
+// One undirected edge of an update batch (0-based vertex IDs)
+typedef struct
+{
+  int32_t u;
+  int32_t v;
+} CCEdge;
+
+// Create an engine over n vertices. labels (may be NULL for all singletons) holds one label
+// in [0, n) per vertex, e.g. the output of any compute_connected_components_* kernel;
+// vertices sharing a label start in the same component. Batches use num_threads threads
+// (<= 0 → all online CPUs). Returns NULL on invalid labels or allocation failure.
+CCIncremental *cc_incremental_create(int32_t n, const int32_t *labels, int num_threads);
+
+void cc_incremental_destroy(CCIncremental *cc);
+
+// Insert count edges. Endpoints >= the current vertex count add new singleton vertices
+// first. Returns the number of components merged by the batch, or -1 on invalid input
+// or allocation failure (the engine is left unchanged).
+int64_t cc_incremental_add_edges(CCIncremental *cc, const CCEdge *edges, int64_t count);
+
+// Component label of v (the minimum vertex ID of its component), or -1 when v is out of range.
+int32_t cc_incremental_query(CCIncremental *cc, int32_t v);
+
+// Number of vertices and components currently tracked.
+int32_t cc_incremental_num_vertices(const CCIncremental *cc);
+int32_t cc_incremental_num_components(const CCIncremental *cc);
+
+// Write the label of every vertex to labels (cc_incremental_num_vertices entries).
+// This is a full O(n) pass meant for snapshots, not for every update.
+void cc_incremental_labels(CCIncremental *cc, int32_t *labels);
+
+#endif
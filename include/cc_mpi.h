@@ -0,0 +1,51 @@
+#ifndef CC_MPI_H
+#define CC_MPI_H
+
+#include <stdint.h>
+#include <mpi.h>
+
+// Distributed connected components with a 1D vertex partition.
+// Every rank owns one contiguous, edge-balanced range of vertices and the CSR rows of
+// those vertices (neighbors keep their global IDs). A rank first runs union-find over
+// its local edges, then the ranks exchange the labels of their boundary vertices in
+// batched, varint-compressed messages and relax their cross edges until an allreduce
+// reports that no label changed. Labels match the LP kernels (minimum vertex ID).
+
+// Rows of one rank's vertex range
+typedef struct
+{
+  int32_t n;        // vertices of the whole graph
+  int64_t m;        // edges of the whole graph
+  int32_t first;    // first owned vertex
+  int32_t last;     // one past the last owned vertex
+  int64_t *row_ptr; // last - first + 1 local offsets into col_idx
+  int32_t *col_idx; // global neighbor IDs
+  int32_t *bounds;  // size + 1 range boundaries of all ranks
+} MPIGraphPart;
+
+// Counters of one distributed run
+typedef struct
+{
+  int rounds;              // label exchange rounds until convergence
+  int64_t updates;         // boundary labels sent by this rank
+  int64_t bytes_sent;      // compressed payload sent by this rank
+  int64_t raw_bytes;       // payload size as (index, label) int32 pairs
+} MPIRunStats;
+
+// Load path and give every rank of comm its edge-balanced share of the rows.
+// Binary .csr files are mapped by every rank and only the local rows are copied; other
+// formats are loaded on rank 0 and sent out. Collective; returns 0 on success on all ranks.
+int cc_mpi_distribute_graph(const char *path, MPIGraphPart *out, MPI_Comm comm);
+
+void cc_mpi_free_graph(MPIGraphPart *part);
+
+// Label the owned vertices (last - first entries of local_labels). Collective; stats may be
+// NULL. Returns 0 on success.
+int cc_mpi_components(const MPIGraphPart *part, int32_t *local_labels, MPIRunStats *stats, MPI_Comm comm);
+
+// Collect all labels on root (labels needs n entries there, may be NULL elsewhere).
+// Collective; returns 0 on success.
+int cc_mpi_gather_labels(const MPIGraphPart *part, const int32_t *local_labels, int32_t *labels, int root,
+                         MPI_Comm comm);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef CC_PTHREAD_POOL_H
+#define CC_PTHREAD_POOL_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cc.h"
+#include "graph.h"
+#include "numa_util.h"
+
+// Persistent worker pool for the pthreads kernels. Workers are created once and reused
+// across runs and sweep configurations, so repeated timings exclude pthread_create/join.
+// Idle workers spin for CC_POOL_SPIN_ITERS polls before parking on a condition variable.
+typedef struct CCPthreadPool CCPthreadPool;
+
+// Polls of the job counter before an idle worker (or the waiting caller) parks
+#define CC_POOL_SPIN_ITERS 20000
+
+// Kernels runnable as a pool job
+typedef enum
+{
+  CC_POOL_LP = 0,       // compute_connected_components_pthreads
+  CC_POOL_AFFOREST = 1, // compute_connected_components_afforest_pthreads
+  CC_POOL_SV = 2,       // compute_connected_components_sv_pthreads
+  CC_POOL_FRONTIER = 3, // compute_connected_components_frontier_pthreads
+  CC_POOL_BFS = 4,      // compute_connected_components_bfs_pthreads
+  CC_POOL_LP_STEAL = 5, // compute_connected_components_steal_pthreads
+  CC_POOL_LP_ASYNC = 6  // compute_connected_components_async_pthreads (chunk_size unused)
+} CCPoolKernel;
+
+// Create a pool able to run jobs on up to max_threads threads (the caller counts as one,
+// so max_threads - 1 workers are started). Returns NULL on failure.
+CCPthreadPool *cc_pthread_pool_create(int max_threads);
+
+// Stop and join the workers and free the pool. NULL is ignored.
+void cc_pthread_pool_destroy(CCPthreadPool *pool);
+
+// Run worker((char *)args + t * arg_size) for t = 0..num_threads-1 and wait for all of them.
+// Thread 0 runs in the caller. The pool grows when num_threads exceeds its size.
+// Returns 0 on success.
+int cc_pthread_pool_run(CCPthreadPool *pool, int num_threads, void *(*worker)(void *), void *args,
+                        size_t arg_size);
+
+// Barrier for a job of num_threads threads, only re-initialized when num_threads differs from
+// the previous job. Call between jobs, never from inside one.
+pthread_barrier_t *cc_pthread_pool_barrier(CCPthreadPool *pool, int num_threads);
+
+// Pin thread t of every later job to numa_cpu_for_thread(topo, t, num_threads), including the
+// caller as thread 0 (it stays pinned after the job). NULL disables pinning for later jobs
+// without unpinning threads. topo must outlive the pool or the next call.
+void cc_pthread_pool_set_affinity(CCPthreadPool *pool, const NumaTopology *topo);
+
+// Run one connected components job on the pool, same contract as the matching
+// compute_connected_components_*_pthreads function. stats is only used by CC_POOL_FRONTIER
+// (may be NULL). Returns the rounds/levels reported by SV, frontier and BFS, the steal count
+// of CC_POOL_LP_STEAL (clamped to INT_MAX), the sweep count of CC_POOL_LP_ASYNC, 0 otherwise.
+int cc_pthread_pool_run_cc(CCPthreadPool *pool, CCPoolKernel kernel, const CSRGraph *restrict G,
+                           int32_t *restrict labels, int num_threads, int chunk_size, LPRoundStats *stats);
+
+// CC_POOL_LP on caller-owned labels: they are the kernel's atomic working array, so nothing is
+// allocated or copied back. The labels are (re)initialized by the workers
+void cc_pthread_pool_run_lp_inplace(CCPthreadPool *pool, const CSRGraph *restrict G,
+                                    _Atomic int32_t *restrict labels, int num_threads, int chunk_size);
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef CSR_COMPACT_H
+#define CSR_COMPACT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "graph.h"
+
+// Smaller adjacency layouts for the bandwidth-bound LP kernels. Both are built from a
+// loaded CSRGraph with sorted, duplicate-free rows (what every loader produces):
+//   csr32  - 32-bit row offsets, col_idx shared with the source graph (m < 2^32)
+//   varint - rows delta-encoded as LEB128 varints: the first neighbor as the zigzag of
+//            (v - u), every further one as (gap - 1), 7 bits per byte
+// Every layout has a row cursor with the same first/next interface, so one kernel source
+// can be instantiated for all of them (src/cc_omp_lp_template.h).
+
+typedef enum
+{
+  CSR_LAYOUT_CSR64 = 0,
+  CSR_LAYOUT_CSR32 = 1,
+  CSR_LAYOUT_VARINT = 2
+} CSRLayout;
+
+typedef struct
+{
+  int32_t n;
+  int64_t m;
+  uint32_t *row_ptr;      // n + 1 offsets
+  const int32_t *col_idx; // borrowed from the source graph
+} CSRGraph32;
+
+typedef struct
+{
+  int32_t n;
+  int64_t m;
+  uint64_t *row_off; // n + 1 byte offsets into data
+  uint8_t *data;
+  size_t data_bytes;
+} CSRGraphVarint;
+
+// Parse "csr64", "csr32" or "varint". Returns 0 on success
+int csr_layout_parse(const char *name, CSRLayout *out);
+
+const char *csr_layout_name(CSRLayout layout);
+
+// Build the 32-bit offsets variant. Returns 0 on success, 1 when m does not fit, -1 on
+// allocation failure. G must outlive out
+int csr32_from_csr(const CSRGraph *G, CSRGraph32 *out);
+
+void csr32_free(CSRGraph32 *g);
+
+// Encode G on num_threads threads (<= 0 → all online CPUs). Returns 0 on success, 1 when
+// a row is not sorted and duplicate-free, -1 on allocation failure
+int csr_varint_from_csr(const CSRGraph *G, int num_threads, CSRGraphVarint *out);
+
+void csr_varint_free(CSRGraphVarint *g);
+
+// Adjacency bytes (offsets plus neighbors) per stored edge
+double csr64_bytes_per_edge(const CSRGraph *G);
+double csr32_bytes_per_edge(const CSRGraph32 *G);
+double csr_varint_bytes_per_edge(const CSRGraphVarint *G);
+
+// Row cursors: *_row_first positions c on the first neighbor of u (0 for an empty row),
+// *_row_next advances it (0 past the end); the current neighbor is c->v
+
+typedef struct
+{
+  const int32_t *p;
+  const int32_t *end;
+  int32_t v;
+} CSRRowCursor;
+
+static inline int csr_cursor_start(CSRRowCursor *c, const int32_t *begin, const int32_t *end)
+{
+  c->p = begin;
+  c->end = end;
+  if (begin == end)
+    return 0;
+  c->v = *begin;
+  return 1;
+}
+
+static inline int csr64_row_first(const CSRGraph *G, int32_t u, CSRRowCursor *c)
+{
+  return csr_cursor_start(c, G->col_idx + G->row_ptr[u], G->col_idx + G->row_ptr[u + 1]);
+}
+
+static inline int csr32_row_first(const CSRGraph32 *G, int32_t u, CSRRowCursor *c)
+{
+  return csr_cursor_start(c, G->col_idx + G->row_ptr[u], G->col_idx + G->row_ptr[u + 1]);
+}
+
+static inline int csr_row_next(CSRRowCursor *c)
+{
+  if (++c->p == c->end)
+    return 0;
+  c->v = *c->p;
+  return 1;
+}
+
+typedef struct
+{
+  const uint8_t *p;
+  const uint8_t *end;
+  int32_t v;
+} VarintRowCursor;
+
+static inline uint32_t varint_decode(const uint8_t **p)
+{
+  const uint8_t *q = *p;
+  uint32_t byte = *q++;
+  uint32_t value = byte & 0x7f;
+  // Most gaps of a well-ordered graph fit in one byte
+  for (int shift = 7; byte & 0x80; shift += 7)
+  {
+    byte = *q++;
+    value |= (byte & 0x7f) << shift;
+  }
+  *p = q;
+  return value;
+}
+
+static inline int csr_varint_row_first(const CSRGraphVarint *G, int32_t u, VarintRowCursor *c)
+{
+  c->p = G->data + G->row_off[u];
+  c->end = G->data + G->row_off[u + 1];
+  if (c->p == c->end)
+    return 0;
+  uint32_t zigzag = varint_decode(&c->p);
+  c->v = u + (int32_t)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+  return 1;
+}
+
+static inline int csr_varint_row_next(VarintRowCursor *c)
+{
+  if (c->p == c->end)
+    return 0;
+  c->v += (int32_t)varint_decode(&c->p) + 1;
+  return 1;
+}
+
+// Neighbors of u, counted by their terminating bytes (instrumentation only)
+static inline int64_t csr_varint_degree(const CSRGraphVarint *G, int32_t u)
+{
+  int64_t degree = 0;
+  for (uint64_t b = G->row_off[u]; b < G->row_off[u + 1]; b++)
+    degree += !(G->data[b] & 0x80);
+  return degree;
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef EDGE_STREAM_H
+#define EDGE_STREAM_H
+
+#include <stdint.h>
+#include "cc_incremental.h"
+
+// Sequential block reader over the edges of a graph file, without building a CSR graph.
+// Matrix Market files (.mtx/.txt) are parsed entry by entry after the mmio header; binary
+// .csr files are mapped without the load-time checksum pass and walked row by row, releasing
+// the pages behind the cursor, so each section is read once and resident memory stays at one
+// block of edges either way. Offsets and columns are range-checked as they are read.
+typedef struct EdgeStream EdgeStream;
+
+// Open path for streaming. Returns NULL (after printing the reason) on failure or for
+// formats that cannot be streamed (.mat).
+EdgeStream *edge_stream_open(const char *path);
+
+void edge_stream_close(EdgeStream *s);
+
+// Number of vertices declared by the file header.
+int32_t edge_stream_num_vertices(const EdgeStream *s);
+
+// Entries declared by the header (.mtx nonzeros, .csr stored edges).
+int64_t edge_stream_num_entries(const EdgeStream *s);
+
+// Fill block with up to capacity edges (0-based, self-loops and out-of-range entries
+// skipped; each edge of a symmetrized .csr is reported once, every stored entry of other
+// .csr files). Returns the number of edges read, 0 at the end of the file, or -1 on a read
+// error or a corrupt .csr entry.
+int64_t edge_stream_next_block(EdgeStream *s, CCEdge *block, int64_t capacity);
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+// Active-set helpers shared by the frontier label propagation and parallel BFS kernels.
+// A vertex joins the next frontier when one of its neighbors lowers its label;
+// each vertex is claimed once per round through its byte in the next bitmap.
+
+// Frontiers larger than n / FRONTIER_DENSE_DIVISOR are scanned as a bitmap over all
+// vertices; smaller ones are kept as an explicit vertex list
+#define FRONTIER_DENSE_DIVISOR 20
+
+// Direction-optimizing BFS switches to bottom-up once the edges leaving the frontier
+// exceed 1/BFS_ALPHA of the unexplored edges, and back to top-down once the frontier
+// is shrinking and holds fewer than n/BFS_BETA vertices (the usual Beamer et al. defaults)
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+// Vertices collected per thread before they are copied into the shared list
+#define FRONTIER_BATCH_SIZE 256
+
+// Thread-local staging buffer for list appends
+typedef struct
+{
+  int32_t items[FRONTIER_BATCH_SIZE];
+  int count;
+} FrontierBatch;
+
+// Copy the staged vertices into list, reserving space with a single fetch_add
+static inline void frontier_batch_flush(FrontierBatch *batch, int32_t *list, _Atomic int64_t *tail)
+{
+  if (batch->count == 0)
+    return;
+  int64_t pos = atomic_fetch_add_explicit(tail, batch->count, memory_order_relaxed);
+  memcpy(list + pos, batch->items, sizeof(int32_t) * (size_t)batch->count);
+  batch->count = 0;
+}
+
+static inline void frontier_batch_push(FrontierBatch *batch, int32_t v, int32_t *list,
+                                       _Atomic int64_t *tail)
+{
+  batch->items[batch->count++] = v;
+  if (batch->count == FRONTIER_BATCH_SIZE)
+    frontier_batch_flush(batch, list, tail);
+}
+
+// Push the label of u to its neighbors. Every neighbor that adopts it is marked in
+// in_next and, when batch is non-NULL, appended to list. Adds the number of newly
+// marked vertices to *activated and returns the number of edges scanned.
+static inline int64_t frontier_push_label(int32_t u, const int64_t *restrict row_ptr,
+                                          const int32_t *restrict col_idx,
+                                          _Atomic int32_t *restrict labels,
+                                          atomic_uchar *restrict in_next, FrontierBatch *batch,
+                                          int32_t *list, _Atomic int64_t *tail, int64_t *activated)
+{
+  const int32_t label = atomic_load_explicit(&labels[u], memory_order_relaxed);
+  for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
+  {
+    int32_t v = col_idx[j];
+    int32_t current = atomic_load_explicit(&labels[v], memory_order_relaxed);
+    int lowered = 0;
+    while (current > label)
+    {
+      if (atomic_compare_exchange_weak_explicit(&labels[v], &current, label,
+                                                memory_order_relaxed, memory_order_relaxed))
+      {
+        lowered = 1;
+        break;
+      }
+    }
+
+    if (lowered && atomic_load_explicit(&in_next[v], memory_order_relaxed) == 0 &&
+        atomic_exchange_explicit(&in_next[v], 1, memory_order_relaxed) == 0)
+    {
+      (*activated)++;
+      if (batch)
+        frontier_batch_push(batch, v, list, tail);
+    }
+  }
+  return row_ptr[u + 1] - row_ptr[u];
+}
+
+#endif
@@ -4,31 +4,111 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// How the row_ptr/col_idx arrays of a CSRGraph are backed.
+typedef enum
+{
+  CSR_STORAGE_HEAP = 0, // allocated with cc_alloc (cc_alloc.h) or malloc
+  CSR_STORAGE_MMAP = 1  // read-only mapping of a binary .csr file
+} CSRStorage;
+
 // Compressed Sparse Row (CSR) representation of a graph.
 typedef struct
 {
-  int32_t n;        // number of vertices
-  int64_t m;        // number of edges
-  int64_t *row_ptr; // row pointers
-  int32_t *col_idx; // column indices
+  int32_t n;           // number of vertices
+  int64_t m;           // number of edges
+  int64_t *row_ptr;    // row pointers
+  int32_t *col_idx;    // column indices
+  CSRStorage storage;  // backing of row_ptr/col_idx, used by free_csr
+  void *mapping;       // base of the file mapping (CSR_STORAGE_MMAP only)
+  size_t mapping_size; // length of the file mapping in bytes
 } CSRGraph;
 
+// Binary CSR file format (.csr), version CSR_BIN_VERSION:
+//   64-byte header (magic, version, n, m, section offsets, build flags, checksum)
+//   row_ptr: (n + 1) int64_t, starting at a 64-byte aligned offset
+//   col_idx: m int32_t, starting at a 64-byte aligned offset
+// The checksum covers both sections. Files use host byte order.
+#define CSR_BIN_VERSION 1
+
 // Load an undirected graph from Matrix Market file into CSR form.
 // symmetrize = 1 → ensure undirected by adding reverse edges.
 // drop_self_loops = 1 → skip edges (i,i).
 // Returns 0 on success.
 int load_csr_from_mtx(const char *path, int symmetrize, int drop_self_loops, CSRGraph *out);
 
+// Same contract as load_csr_from_mtx, but maps the file and parses line-aligned ranges of
+// the body on num_threads threads (<= 0 → all online CPUs) into per-thread edge buffers.
+// load_csr_from_mtx remains the stdio reference loader for validation.
+// Returns 0 on success.
+int load_csr_from_mtx_parallel(const char *path, int symmetrize, int drop_self_loops,
+                               int num_threads, CSRGraph *out);
+
+// Same contract as load_csr_from_mtx_parallel with about a third of its peak memory: the
+// file is parsed twice, once to count the row degrees and once to write every edge
+// straight into its final col_idx slot, so no edge list exists at any point.
+// Peak is the final CSR plus one extra row_ptr array. Returns 0 on success.
+int load_csr_from_mtx_low_memory(const char *path, int symmetrize, int drop_self_loops,
+                                 int num_threads, CSRGraph *out);
+
+// Make load_csr_from_file(_cached) parse .mtx/.txt inputs with load_csr_from_mtx_low_memory.
+void graph_set_low_memory_loading(int enabled);
+
 // Load an undirected graph from MATLAB .mat file into CSR form.
+// A symmetric matrix with sorted columns is its own CSR: its row indices are copied to col_idx
+// without sorting or scattering. Other matrices go through the counting-sort build.
 // Returns 0 on success.
 int load_csr_from_mat(const char *path, CSRGraph *out);
 
-// Load an undirected graph from file (either .mtx/.txt or .mat) into CSR form.
+// Load a graph from a binary .csr file by mapping it directly into out (no copy). The
+// checksum is verified and row_ptr must be non-decreasing with every column in [0, n).
+// Returns 0 on success.
+int load_csr_from_bin(const char *path, CSRGraph *out);
+
+// Same as load_csr_from_bin, but only the header and the first and last row offsets are
+// checked: the checksum and structure passes that read both sections before returning are
+// skipped. Meant for single-pass readers that range-check every offset and column they use
+// (edge_stream does). Returns 0 on success.
+int map_csr_from_bin(const char *path, CSRGraph *out);
+
+// 1 when the .csr file was built with symmetrize set (every edge stored in both rows), 0 when
+// it was not, -1 when its header cannot be read.
+int csr_bin_is_symmetric(const char *path);
+
+// Write g to path in the binary .csr format. symmetrize/drop_self_loops record the
+// options the graph was built with so cached copies are only reused for matching loads.
+// Returns 0 on success.
+int save_csr_to_bin(const CSRGraph *g, const char *path, int symmetrize, int drop_self_loops);
+
+// Split the rows of a CSR graph with offsets row_ptr into parts contiguous ranges holding
+// roughly equal numbers of edges and return the bounds [*start, *end) of part.
+void csr_edge_balanced_rows(const int64_t *row_ptr, int32_t n, int parts, int part,
+                            int32_t *start, int32_t *end);
+
+// Edge k (0 <= k < num_edges) of a synthetic graph: store its endpoints in *u and *v and return 1,
+// or return 0 when slot k holds no edge. It is called twice per edge from any thread, so it
+// must depend on params and k only.
+typedef int (*CSREdgeGenerator)(const void *params, int64_t k, int32_t *u, int32_t *v);
+
+// Build the undirected graph of num_edges generated edges on n vertices: both directions of
+// every edge, without self loops or duplicates. Like the low-memory loader, the edges are
+// generated once to count the row degrees and again to fill col_idx, so no edge list is
+// stored. num_threads <= 0 → all online CPUs. Returns 0 on success.
+int build_csr_from_generator(int32_t n, int64_t num_edges, CSREdgeGenerator generator, const void *params,
+                             int num_threads, CSRGraph *out);
+
+// Load an undirected graph from file (.mtx/.txt, .mat or .csr) into CSR form, or generate one
+// from a gen: specification (graph_gen.h).
 // symmetrize = 1 → ensure undirected by adding reverse edges.
 // drop_self_loops = 1 → skip edges (i,i).
 // Returns 0 on success.
 int load_csr_from_file(const char *path, int symmetrize, int drop_self_loops, CSRGraph *out);
 
+// Same as load_csr_from_file, but keeps a binary cache next to the input
+// (graph.mtx → graph.csr). The cache is reused when it is newer than the input and
+// was built with the same options; otherwise the input is parsed and the cache rewritten.
+// Returns 0 on success.
+int load_csr_from_file_cached(const char *path, int symmetrize, int drop_self_loops, CSRGraph *out);
+
 // Free memory allocated for CSR graph.
 void free_csr(CSRGraph *g);
 
@@ -0,0 +1,67 @@
+#ifndef GRAPH_GEN_H
+#define GRAPH_GEN_H
+
+#include <stdint.h>
+#include "graph.h"
+
+// Synthetic graphs for scaling runs, built in memory by load_csr_from_file from a pseudo-path
+//   gen:<kind>[:key=value]...
+// Kinds and their keys (defaults in brackets):
+//   rmat       - Graph500 Kronecker/R-MAT: scale [16] (n = 2^scale), ef [16] edges per vertex,
+//                a [0.57], b [0.19], c [0.19] quadrant probabilities, permute [1]
+//   er         - Erdos-Renyi G(n, M) with M = ef * n uniform edges: n or scale [2^16], ef [8]
+//   grid2d     - w x h 4-neighbor grid: w [1024], h [w]
+//   grid3d     - x x y x z 6-neighbor grid: x [128], y [x], z [y]
+//   components - count [1024] disjoint pieces of size [32] vertices with ef [2] * size edges
+//                each: a random spanning tree, the rest random pairs inside the piece, so
+//                the graph has exactly count components
+// Every kind takes seed [1] and permute (relabel the vertices with a seeded bijection so IDs
+// carry no locality; on by default for rmat only). Edge k is drawn from a generator seeded by
+// (seed, k), so a specification names the same graph for every thread count and run.
+// Graphs are always symmetric without self loops or duplicate edges.
+
+#define GRAPH_GEN_PREFIX "gen:"
+
+typedef enum
+{
+  GRAPH_GEN_RMAT = 0,
+  GRAPH_GEN_ER = 1,
+  GRAPH_GEN_GRID2D = 2,
+  GRAPH_GEN_GRID3D = 3,
+  GRAPH_GEN_COMPONENTS = 4
+} GraphGenKind;
+
+// Parsed specification plus the values derived from it
+typedef struct
+{
+  GraphGenKind kind;
+  int scale;            // rmat (and er when given)
+  double edge_factor;   // rmat, er, components
+  double a, b, c;       // rmat quadrant probabilities
+  int64_t dims[3];      // grid sizes
+  int64_t pieces;       // components: number of pieces
+  int64_t piece_size;   // components: vertices per piece
+  int64_t piece_slots;  // components: edge slots per piece
+  uint64_t seed;
+  int permute;
+  int32_t n;            // number of vertices
+  int64_t edge_slots;   // generator slots; grids and trees leave some empty
+  uint64_t perm_mul;    // permutation v -> (perm_mul * v + perm_add) mod n
+  uint64_t perm_add;
+} GraphGenSpec;
+
+// 1 when path is a gen: specification
+int graph_gen_is_spec(const char *path);
+
+// Parse a specification (with or without the gen: prefix) into spec.
+// Returns 0 on success, prints the problem to stderr and returns 1 otherwise.
+int graph_gen_parse(const char *text, GraphGenSpec *spec);
+
+// Generate the graph of spec on num_threads threads (<= 0 → all online CPUs).
+// Returns 0 on success.
+int graph_gen_build(const GraphGenSpec *spec, int num_threads, CSRGraph *out);
+
+// Parse and build; the load_csr_from_file entry point for gen: paths. Returns 0 on success.
+int load_csr_from_generator(const char *path, int num_threads, CSRGraph *out);
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef LABELS_IO_H
+#define LABELS_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Label output of the drivers and component statistics over a finished labelling.
+// Both run on thread_util threads, so they are as cheap as the kernels on large graphs.
+
+// Binary label file (.bin), version LABELS_BIN_VERSION:
+//   64-byte header (magic "CCLABELS", version, n, data offset)
+//   n int32_t labels starting at the data offset (64), in host byte order
+// numpy reads it with np.fromfile(path, dtype=np.int32, offset=64).
+#define LABELS_BIN_VERSION 1
+
+typedef enum
+{
+  LABELS_FORMAT_TEXT = 0,  // one decimal label per line
+  LABELS_FORMAT_BINARY = 1 // the .bin layout above
+} LabelsFormat;
+
+// Parse "text" or "binary". Returns 0 on success, -1 for unknown names
+int labels_parse_format(const char *name, LabelsFormat *out);
+
+// File extension without the dot ("txt" or "bin")
+const char *labels_format_extension(LabelsFormat format);
+
+// Write labels in the text format. Every thread formats its range in fixed-size buffers
+// and writes them with pwrite at offsets from a prefix sum of the range lengths.
+// num_threads <= 0 selects all online CPUs. Returns 0 on success
+int labels_write_text(const char *path, const int32_t *labels, int32_t n, int num_threads);
+
+// Write labels in the binary format by mapping the file and copying ranges in parallel.
+// Returns 0 on success
+int labels_write_binary(const char *path, const int32_t *labels, int32_t n, int num_threads);
+
+// Write labels in the given format. Returns 0 on success
+int labels_write(const char *path, LabelsFormat format, const int32_t *labels, int32_t n, int num_threads);
+
+// Read-only mapping of a binary label file
+typedef struct
+{
+  const int32_t *labels;
+  int32_t n;
+  void *mapping;
+  size_t mapping_size;
+} LabelsFile;
+
+// Map a binary label file written by labels_write_binary. Returns 0 on success
+int labels_map_binary(const char *path, LabelsFile *out);
+
+void labels_unmap(LabelsFile *file);
+
+// Component sizes bucketed by powers of two: bucket b holds sizes in [2^b, 2^(b+1))
+#define COMPONENT_STATS_BUCKETS 32
+
+typedef struct
+{
+  int32_t num_components;
+  int32_t largest_component; // dense ID of the largest component (smallest ID on ties)
+  int32_t largest_label;     // label of the largest component in the input
+  int32_t largest_size;      // vertices in the largest component
+  int64_t histogram[COMPONENT_STATS_BUCKETS];
+} ComponentStats;
+
+// Statistics of a labelling with every label in [0, n), such as the LP (minimum vertex
+// ID) or the compact 0..k-1 format. Components get dense IDs 0..k-1 in increasing label
+// order, which for LP labels is the compact BFS format. dense_labels (may be NULL or equal
+// to labels) receives the dense ID of every vertex. num_threads <= 0 selects all online
+// CPUs. Returns 0 on success, -1 for out-of-range labels or allocation failure
+int component_stats_compute(const int32_t *labels, int32_t n, int num_threads, int32_t *dense_labels,
+                            ComponentStats *out);
+
+// Write the non-empty histogram buckets as "Min Size,Max Size,Components" rows. Returns 0 on success
+int component_stats_write_csv(const ComponentStats *stats, const char *path);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef LP_INSTRUMENT_H
+#define LP_INSTRUMENT_H
+
+#include <stdint.h>
+
+// Optional per-round counters for the label propagation kernels (OpenMP, Cilk and the
+// pthreads LP/steal kernels). The kernel hooks below are compiled out unless built with
+// -DCC_INSTRUMENT (make INSTRUMENT=1), so the log stays empty in regular builds.
+// A kernel starts a log, every thread accumulates into its own slot during a round,
+// and one thread closes the round once all of them are done. Only the last run is kept.
+
+// Counters of one thread in one round, padded so threads never share a cache line
+typedef struct
+{
+  _Alignas(64) int64_t changed_vertices; // successful label writes (own vertex or pushed to a neighbor)
+  int64_t edges_scanned;                 // adjacency entries read, including the push pass
+  int64_t cas_failures;                  // failed compare-exchange attempts
+  double busy_seconds;                   // time spent relaxing vertices
+  double idle_seconds;                   // time spent waiting for the other threads
+} LPInstrumentSlot;
+
+// Start a new log for num_threads threads, dropping the previous one
+void lp_instrument_begin(int num_threads);
+
+// Accumulating slot of thread_id for the current round
+LPInstrumentSlot *lp_instrument_slot(int thread_id);
+
+// Record the current round and reset the slots. Called by one thread while no other
+// thread touches its slot. A positive wall_seconds derives idle time as the round's
+// wall time minus the busy time (runtimes without explicit barriers, e.g. Cilk)
+void lp_instrument_end_round(double wall_seconds);
+
+// Monotonic time in seconds
+double lp_instrument_now(void);
+
+// Rounds recorded by the last run (0 when the kernels were built without CC_INSTRUMENT)
+int lp_instrument_rounds(void);
+
+// Write the log as CSV (Round,Thread,Changed Vertices,Edges Scanned,CAS Failures,
+// Busy Seconds,Idle Seconds), one row per thread and round. Returns 0 on success
+int lp_instrument_write_csv(const char *path);
+
+#ifdef CC_INSTRUMENT
+
+#define LP_INSTRUMENT_SLOT(thread_id) lp_instrument_slot(thread_id)
+#define LP_INSTRUMENT_ADD(slot, field, value) \
+  do                                          \
+  {                                           \
+    if (slot)                                 \
+      (slot)->field += (value);               \
+  } while (0)
+#define LP_INSTRUMENT_ONLY(...) __VA_ARGS__
+
+#else
+
+#define LP_INSTRUMENT_SLOT(thread_id) ((LPInstrumentSlot *)0)
+#define LP_INSTRUMENT_ADD(slot, field, value) ((void)(slot))
+#define LP_INSTRUMENT_ONLY(...)
+
+#endif
+
+#endif
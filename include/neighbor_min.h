@@ -0,0 +1,40 @@
+#ifndef NEIGHBOR_MIN_H
+#define NEIGHBOR_MIN_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Minimum-label scan over an adjacency range, shared by the LP kernels.
+// Rows with at least NEIGHBOR_MIN_SIMD_THRESHOLD entries go through a vectorized gather
+// (AVX-512 or AVX2, picked at run time); shorter rows keep the scalar loop, where the
+// dispatch call would cost more than it saves.
+// The vector paths read the labels with plain 32-bit gathers: every lane is an aligned
+// 4-byte load, so each value is one that some thread stored, as with a relaxed atomic load.
+
+#define NEIGHBOR_MIN_SIMD_THRESHOLD 32
+
+// min(init, labels[col_idx[begin..end)]) using the best instruction set of this CPU.
+// Setting CC_SIMD=scalar, avx2 or avx512 in the environment caps the choice.
+int32_t neighbor_min_simd(_Atomic int32_t *labels, const int32_t *col_idx,
+                          int64_t begin, int64_t end, int32_t init);
+
+// Name of the implementation neighbor_min_simd uses ("avx512", "avx2" or "scalar").
+const char *neighbor_min_isa(void);
+
+static inline int32_t neighbor_min(_Atomic int32_t *restrict labels, const int32_t *restrict col_idx,
+                                   int64_t begin, int64_t end, int32_t init)
+{
+  if (end - begin >= NEIGHBOR_MIN_SIMD_THRESHOLD)
+    return neighbor_min_simd(labels, col_idx, begin, end, init);
+
+  int32_t result = init;
+  for (int64_t j = begin; j < end; j++)
+  {
+    int32_t label = atomic_load_explicit(&labels[col_idx[j]], memory_order_relaxed);
+    if (label < result)
+      result = label;
+  }
+  return result;
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef NUMA_UTIL_H
+#define NUMA_UTIL_H
+
+#include <stdint.h>
+#include "graph.h"
+
+// NUMA placement helpers for the --numa driver mode. The topology is read from
+// /sys/devices/system/node (no libnuma dependency) and restricted to the CPUs this
+// process may run on; machines without that information are treated as one node.
+//
+// Thread t of a num_threads-thread run is pinned to numa_cpu_for_thread(): the allowed
+// CPUs are ordered node by node and the threads are spread evenly over that order, so
+// consecutive threads (and the consecutive row ranges they process) share a node.
+typedef struct
+{
+  int num_nodes; // nodes with at least one allowed CPU
+  int num_cpus;  // allowed CPUs
+  int *cpus;     // allowed CPU IDs, grouped by node
+  int *cpu_node; // node of cpus[i]
+} NumaTopology;
+
+// Returns 0 on success; release with numa_topology_free.
+int numa_topology_load(NumaTopology *topo);
+
+void numa_topology_free(NumaTopology *topo);
+
+// CPU for thread_id of a num_threads-thread run (threads beyond num_cpus wrap around).
+int numa_cpu_for_thread(const NumaTopology *topo, int thread_id, int num_threads);
+
+// Node of the CPU numa_cpu_for_thread picks.
+int numa_node_for_thread(const NumaTopology *topo, int thread_id, int num_threads);
+
+// Pin the calling thread to cpu with pthread_setaffinity_np. Returns 0 on success.
+int numa_pin_self(int cpu);
+
+// Pin the calling thread to numa_cpu_for_thread(topo, thread_id, num_threads).
+int numa_pin_thread(const NumaTopology *topo, int thread_id, int num_threads);
+
+// Replace the arrays of G with heap copies whose pages are first touched by pinned threads:
+// part t of csr_edge_balanced_rows(num_threads parts) is copied by thread t, so each row
+// range lives on the node of the thread that processes it. Works for mapped graphs too.
+// Returns 0 on success; on failure G is left untouched.
+int numa_localize_csr(CSRGraph *G, const NumaTopology *topo, int num_threads);
+
+// Per-node read bandwidth: pinned threads stream over their row ranges of G (row_ptr and
+// col_idx) and gbps[node] receives the bytes read on that node divided by the time of its
+// slowest thread, in GB/s. gbps must hold topo->num_nodes entries. Returns 0 on success.
+int numa_measure_bandwidth(const CSRGraph *G, const NumaTopology *topo, int num_threads, double *gbps);
+
+#endif
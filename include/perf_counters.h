@@ -0,0 +1,52 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// Hardware counters around the kernel call of the drivers (--perf-counters), read
+// through perf_event_open. Every thread of the process gets its own counter groups
+// when a measurement starts; threads created during it inherit the counters of their
+// creator. Counts are summed over the threads and scaled when the PMU multiplexed them.
+// Only user-space events are counted, so perf_event_paranoid <= 2 is enough.
+
+// Counters measured per run
+typedef enum
+{
+  PERF_COUNTER_CYCLES = 0,
+  PERF_COUNTER_INSTRUCTIONS,
+  PERF_COUNTER_CACHE_REFERENCES,
+  PERF_COUNTER_CACHE_MISSES,
+  PERF_COUNTER_LLC_LOAD_MISSES,
+  PERF_COUNTER_DTLB_LOAD_MISSES,
+  PERF_COUNTER_COUNT
+} PerfCounterId;
+
+// Readings of one measured section
+typedef struct
+{
+  double values[PERF_COUNTER_COUNT]; // negative when the counter is not available
+  double seconds;                    // wall time between start and stop
+} PerfReading;
+
+typedef struct PerfCounters PerfCounters;
+
+// Probe which counters this machine supports. Returns NULL (with a message) when none is
+PerfCounters *perf_counters_create(void);
+
+void perf_counters_destroy(PerfCounters *pc);
+
+// Open, reset and enable the counter groups of every current thread. Returns 0 on success
+int perf_counters_start(PerfCounters *pc);
+
+// Disable and read the counters opened by perf_counters_start. Returns 0 on success
+int perf_counters_stop(PerfCounters *pc, PerfReading *out);
+
+// Column name of a counter ("Cycles", "LLC Misses", ...)
+const char *perf_counter_name(PerfCounterId id);
+
+// Append one column per counter plus IPC and the LLC-miss bandwidth estimate to the CSV
+// at path, each named "<column_prefix> <counter>" with one row per run. Returns 0 on success
+int perf_counters_write_columns(const char *path, const char *column_prefix, const PerfReading *runs, int count);
+
+// Print the per-run average of every available counter
+void perf_counters_print_summary(const PerfReading *runs, int count);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <stdint.h>
+#include "graph.h"
+
+// Vertex orders applied between loading and computing to improve the locality of the
+// random labels[v] accesses in the kernels.
+typedef enum
+{
+  REORDER_NONE = 0,   // keep the input order
+  REORDER_DEGREE = 1, // degree descending (ties by original ID)
+  REORDER_BFS = 2,    // BFS visit order, one component after the other from its highest-degree vertex
+  REORDER_RCM = 3     // reverse Cuthill-McKee
+} ReorderKind;
+
+// Parse "none", "degree", "bfs" or "rcm". Returns 0 on success, -1 on unknown names.
+int reorder_parse_kind(const char *name, ReorderKind *out);
+
+// Lowercase name of kind, as accepted by reorder_parse_kind.
+const char *reorder_kind_name(ReorderKind kind);
+
+// Compute the permutation of kind: new_id[v] is the new ID of original vertex v.
+// Returns 0 on success.
+int reorder_compute_permutation(const CSRGraph *G, ReorderKind kind, int32_t *new_id);
+
+// Build the relabelled copy of G in out: row new_id[u] holds the (sorted) new IDs of the
+// neighbors of u. Returns 0 on success.
+int reorder_apply(const CSRGraph *G, const int32_t *new_id, CSRGraph *out);
+
+// Replace *G with its reordering of kind and hand the permutation to *new_id_out
+// (free with free()). REORDER_NONE leaves G untouched and sets *new_id_out to NULL.
+// Returns 0 on success; on failure G is left untouched.
+int reorder_graph(CSRGraph *G, ReorderKind kind, int32_t **new_id_out);
+
+// Map labels computed on the reordered graph back to the original vertex order, in place.
+// Every component is relabelled with its minimum original vertex ID (the LP label format),
+// or with compact = 1 numbered 0..k-1 by that minimum (the sequential BFS format), so label
+// files match runs on the original graph. Returns 0 on success.
+int reorder_restore_labels(int32_t *labels, const int32_t *new_id, int32_t n, int compact);
+
+#endif
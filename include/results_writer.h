@@ -12,10 +12,35 @@ typedef enum
     RESULTS_WRITER_INVALID_ARGS = -3
 } results_writer_status;
 
-// Append a column of timing results to a CSV file.
+// Layout of the timing files written by append_times_column
+typedef enum
+{
+    RESULTS_FORMAT_WIDE = 0, // one column per thread count, the whole file rewritten per call
+    RESULTS_FORMAT_LONG = 1  // one "column,run,value" row per value in <base>.long.csv, appended
+} results_format;
+
+// Select the layout for the whole process (drivers' --results-format option).
+// verify/results_to_wide.py turns long files back into the wide layout.
+void results_writer_set_format(results_format format);
+results_format results_writer_get_format(void);
+
+// Parse "wide" or "long". Returns 0 on success, -1 otherwise.
+int results_writer_parse_format(const char *name, results_format *out);
+
+// Long-format path of a results file: results_omp_graph.csv -> results_omp_graph.long.csv
+// (long paths are kept as they are). Returns 0 on success, -1 if it does not fit.
+int results_writer_long_path(char *dest, size_t dest_size, const char *filename);
+
+// Append a column of timing results to a CSV file. In long format the values are appended as
+// rows of <base>.long.csv instead, with one O_APPEND write, so concurrent runs are safe.
 // Returns RESULTS_WRITER_OK on success or an error code on failure.
 results_writer_status append_times_column(const char *filename, const char *column_name, const double *values, size_t count);
 
+// Append a column with 'precision' digits after the decimal point to a wide CSV file, whatever
+// the results format (side files such as perf_<tag>_<matrix>.csv keep their layout).
+results_writer_status append_values_column(const char *filename, const char *column_name, const double *values, size_t count,
+                                           int precision);
+
 // Ensure that the directory at 'path' exists, creating it if necessary.
 // Returns 0 on success, -1 on failure.
 int results_writer_ensure_directory(const char *path);
@@ -25,12 +50,18 @@ int results_writer_ensure_directory(const char *path);
 int results_writer_join_path(char *dest, size_t dest_size, const char *dir, const char *file);
 
 // Extract the matrix stem (filename without directory and extension) from 'matrix_path'.
+// Generator specifications (gen:...) map to a file-name-safe form of the whole specification.
 // Returns 0 on success, -1 on failure.
 int results_writer_matrix_stem(const char *matrix_path, char *dest, size_t dest_size);
 
-// Build a results file path in 'dest' using 'output_dir', 'prefix', and the matrix stem from 'matrix_path'.
-// Returns 0 on success, -1 on failure.
+// Build a results file path <prefix>_<stem>.csv in 'dest' using 'output_dir', 'prefix', and the
+// matrix stem from 'matrix_path'. Returns 0 on success, -1 on failure.
 int results_writer_build_results_path(char *dest, size_t dest_size, const char *output_dir,
                                       const char *prefix, const char *matrix_path);
 
+// Same as results_writer_build_results_path for a timing file: in long format the path ends in
+// .long.csv, the file append_times_column writes to. Returns 0 on success, -1 on failure.
+int results_writer_build_times_path(char *dest, size_t dest_size, const char *output_dir,
+                                    const char *prefix, const char *matrix_path);
+
 #endif
@@ -0,0 +1,22 @@
+#ifndef THREAD_UTIL_H
+#define THREAD_UTIL_H
+
+// Minimal pthreads fork-join helpers for the common (non-kernel) code.
+// graph loading and other shared utilities are linked into every binary, including
+// the OpenCilk one, so they use plain pthreads instead of OpenMP.
+
+// Work function run by each thread: thread_id in [0, num_threads)
+// Functions must not wait on each other; a thread may run several ids in turn
+typedef void (*thread_util_fn)(int thread_id, int num_threads, void *ctx);
+
+// Number of online CPUs (at least 1).
+int thread_util_default_threads(void);
+
+// Run fn on num_threads threads (the calling thread runs thread 0) and wait for all.
+// num_threads <= 0 selects thread_util_default_threads(). Returns 0 on success.
+int thread_util_parallel_run(int num_threads, thread_util_fn fn, void *ctx);
+
+// Split [0, total) into num_parts contiguous ranges and return the bounds of part.
+void thread_util_split_range(long long total, int num_parts, int part, long long *start, long long *end);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef TRIM_H
+#define TRIM_H
+
+#include <stdint.h>
+#include "graph.h"
+
+// Degree-0/degree-1 trimming applied between loading and computing. Isolated vertices and
+// degree-1 chains (trees hanging off the rest of the graph) are peeled away, and the kernels
+// only run on the remaining core graph; trim_expand_labels maps the core labels back to all
+// vertices. Peeling only removes tree vertices, so two core vertices are connected in the
+// core exactly when they are connected in the input.
+typedef struct
+{
+  int32_t *core_id; // core_id[v]: core vertex of original vertex v, -1 when peeled
+  int32_t *root;    // root[v]: core vertex or peeled tree root v hangs off (v itself for those)
+  int32_t n;        // vertices of the input graph
+  int64_t m;        // edges of the input graph
+  int32_t core_n;   // vertices of the core graph
+  int64_t core_m;   // edges of the core graph
+  int32_t isolated; // vertices of degree 0 in the input
+  int32_t peeled;   // vertices removed by degree-1 peeling (not counting isolated ones)
+  int32_t trees;    // components without core vertices (isolated vertices and peeled trees)
+} TrimResult;
+
+// Peel G on num_threads threads (<= 0 → all online CPUs) and build the induced subgraph on
+// the remaining vertices in core (numbered in original order, rows stay sorted). G is not
+// modified. Returns 0 on success; release core with free_csr and out with trim_free.
+int trim_graph(const CSRGraph *G, int num_threads, CSRGraph *core, TrimResult *out);
+
+// Labels for all input vertices from core_labels (one label in [0, core_n) per core vertex,
+// such as the minimum core vertex ID of its component). Every component is labelled with
+// its minimum original vertex ID (the LP label format), or with compact = 1 numbered 0..k-1
+// by that minimum (the sequential BFS format). Returns a malloc'd array of trim->n labels,
+// or NULL on allocation failure.
+int32_t *trim_expand_labels(const TrimResult *trim, const int32_t *core_labels, int compact);
+
+// Free the vertex maps.
+void trim_free(TrimResult *trim);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef TUNED_PROFILE_H
+#define TUNED_PROFILE_H
+
+#include <stddef.h>
+#include "reorder.h"
+
+// Per-graph profile of the best configurations found by cc_pthreads_sweep --autotune, read
+// back by the drivers' --tuned option. The file is <output_dir>/tuned_<matrix>.txt with one
+// whitespace-separated entry per line, comments start with '#':
+//   <key> <threads> <chunk_size> <schedule> <median_seconds>
+// The key is the algorithm, followed by _<order> when reordered and _trim when trimmed
+// (lp, afforest_rcm, lp_degree_trim), so each kernel variant keeps its own entry.
+
+// Best configuration of one kernel variant
+typedef struct
+{
+    int threads;
+    int chunk_size;
+    char schedule[8]; // chunk, steal or async (only the pthreads LP kernel has the last two)
+    double median_seconds;
+} TunedConfig;
+
+// Build the profile key of an algorithm run with the given order and trimming.
+// Returns 0 on success, -1 if it does not fit.
+int tuned_profile_key(char *dest, size_t dest_size, const char *algorithm, ReorderKind reorder, int trimmed);
+
+// Build <output_dir>/tuned_<matrix stem>.txt. Returns 0 on success, -1 on failure.
+int tuned_profile_path(char *dest, size_t dest_size, const char *output_dir, const char *matrix_path);
+
+// Add or replace the entry of key, keeping the other entries. The file is rewritten through a
+// temporary file and renamed, so readers never see a partial profile. Returns 0 on success.
+int tuned_profile_store(const char *path, const char *key, const TunedConfig *config);
+
+// Read the entry of key. Returns 0 when found, 1 when the file or the entry does not exist,
+// -1 on read or parse errors.
+int tuned_profile_load(const char *path, const char *key, TunedConfig *config);
+
+// Driver helper for --tuned: load the entry of (algorithm, reorder, trimmed) from the profile of
+// matrix_path in output_dir, printing a message to stderr when it is missing. Returns 0 on success.
+int tuned_profile_lookup(const char *output_dir, const char *matrix_path, const char *algorithm,
+                         ReorderKind reorder, int trimmed, TunedConfig *config);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Concurrent union-find primitives shared by the Afforest-style kernels.
+// Links always hook the larger root under the smaller one, so every root is the
+// minimum vertex ID of its component, the same label layout the LP kernels produce.
+
+// Number of leading neighbors linked per vertex before sampling the giant component
+#define AFFOREST_NEIGHBOR_ROUNDS 2
+
+// Number of vertices sampled to guess the giant component
+#define AFFOREST_NUM_SAMPLES 1024
+
+// Follow parent pointers from u until a root is reached
+static inline int32_t uf_find(_Atomic int32_t *parent, int32_t u)
+{
+  int32_t p = atomic_load_explicit(&parent[u], memory_order_relaxed);
+  while (p != u)
+  {
+    u = p;
+    p = atomic_load_explicit(&parent[u], memory_order_relaxed);
+  }
+  return p;
+}
+
+// Merge the trees containing u and v using CAS on the larger root
+// Returns 1 when this call hooked a root, 0 when the trees were already merged
+static inline int uf_link(_Atomic int32_t *parent, int32_t u, int32_t v)
+{
+  int32_t p1 = atomic_load_explicit(&parent[u], memory_order_relaxed);
+  int32_t p2 = atomic_load_explicit(&parent[v], memory_order_relaxed);
+
+  while (p1 != p2)
+  {
+    int32_t high = (p1 > p2) ? p1 : p2;
+    int32_t low = (p1 > p2) ? p2 : p1;
+    int32_t p_high = atomic_load_explicit(&parent[high], memory_order_relaxed);
+
+    // Already hooked where we wanted it
+    if (p_high == low)
+      return 0;
+
+    // high is still a root: try to hook it under low
+    if (p_high == high &&
+        atomic_compare_exchange_strong_explicit(&parent[high], &p_high, low,
+                                                memory_order_relaxed, memory_order_relaxed))
+      return 1;
+
+    // Someone else moved high, climb one level and retry
+    p1 = atomic_load_explicit(&parent[atomic_load_explicit(&parent[high], memory_order_relaxed)],
+                              memory_order_relaxed);
+    p2 = atomic_load_explicit(&parent[low], memory_order_relaxed);
+  }
+  return 0;
+}
+
+// Shortcut the parent pointer of u until it points directly at its root
+// Must not run concurrently with uf_link on the same trees
+static inline void uf_compress(_Atomic int32_t *parent, int32_t u)
+{
+  int32_t p = atomic_load_explicit(&parent[u], memory_order_relaxed);
+  int32_t gp = atomic_load_explicit(&parent[p], memory_order_relaxed);
+  while (p != gp)
+  {
+    atomic_store_explicit(&parent[u], gp, memory_order_relaxed);
+    p = gp;
+    gp = atomic_load_explicit(&parent[p], memory_order_relaxed);
+  }
+}
+
+// Sample parent[] at AFFOREST_NUM_SAMPLES pseudo-random vertices and return the most
+// frequent value, i.e. the (likely) root of the largest component.
+// Call after a compress pass so that sampled parents are roots.
+int32_t uf_sample_frequent_root(_Atomic int32_t *parent, int32_t n);
+
+#endif
@@ -1,9 +1,13 @@
 #define _POSIX_C_SOURCE 200112L
 
 #include "cc.h"
+#include "cc_alloc.h"
+#include "labels_io.h"
+#include "union_find.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <inttypes.h>
 
 void compute_connected_components(const CSRGraph *restrict G,
                                   int32_t *restrict labels)
@@ -62,7 +66,7 @@ void compute_connected_components_bfs(const CSRGraph *restrict G, int32_t *restr
     labels[i] = -1;
 
   int32_t *restrict queue;
-  if (posix_memalign((void **)&queue, 64, n * sizeof(int32_t)) != 0)
+  if (!(queue = cc_alloc(n * sizeof(int32_t))))
   {
     fprintf(stderr, "Memory allocation failed\n");
     exit(EXIT_FAILURE);
@@ -94,28 +98,160 @@ void compute_connected_components_bfs(const CSRGraph *restrict G, int32_t *restr
     current_label++;
   }
 
-  free(queue);
+  cc_free(queue);
+}
+
+void lp_round_stats_init(LPRoundStats *stats)
+{
+  stats->rounds = NULL;
+  stats->count = 0;
+  stats->capacity = 0;
+}
+
+void lp_round_stats_free(LPRoundStats *stats)
+{
+  free(stats->rounds);
+  lp_round_stats_init(stats);
+}
+
+void lp_round_stats_push(LPRoundStats *stats, int64_t active_vertices, int64_t edges_scanned, int dense)
+{
+  if (stats->count == stats->capacity)
+  {
+    int new_capacity = stats->capacity ? stats->capacity * 2 : 64;
+    LPRoundStat *tmp = (LPRoundStat *)realloc(stats->rounds, (size_t)new_capacity * sizeof(LPRoundStat));
+    if (!tmp)
+    {
+      fprintf(stderr, "Memory allocation failed (round stats)\n");
+      exit(EXIT_FAILURE);
+    }
+    stats->rounds = tmp;
+    stats->capacity = new_capacity;
+  }
+  stats->rounds[stats->count++] = (LPRoundStat){active_vertices, edges_scanned, dense};
+}
+
+int64_t lp_round_stats_total_edges(const LPRoundStats *stats)
+{
+  int64_t total = 0;
+  for (int r = 0; r < stats->count; r++)
+    total += stats->rounds[r].edges_scanned;
+  return total;
+}
+
+int lp_round_stats_write_csv(const LPRoundStats *stats, const char *path)
+{
+  FILE *f = fopen(path, "w");
+  if (!f)
+    return -1;
+
+  fprintf(f, "Round,Mode,Active Vertices,Edges Scanned\n");
+  for (int r = 0; r < stats->count; r++)
+  {
+    const LPRoundStat *s = &stats->rounds[r];
+    fprintf(f, "%d,%s,%" PRId64 ",%" PRId64 "\n", r + 1, s->dense ? "dense" : "sparse",
+            s->active_vertices, s->edges_scanned);
+  }
+
+  return fclose(f) == 0 ? 0 : -1;
 }
 
 int32_t count_unique_labels(const int32_t *restrict labels, int32_t n)
 {
-  int32_t *restrict unique_flags = (int32_t *)calloc(n, sizeof(int32_t));
-  if (!unique_flags)
+  ComponentStats stats;
+  if (component_stats_compute(labels, n, 0, NULL, &stats) != 0)
+    exit(EXIT_FAILURE);
+  return stats.num_components;
+}
+
+static int cmp_int32(const void *a, const void *b)
+{
+  int32_t lhs = *(const int32_t *)a;
+  int32_t rhs = *(const int32_t *)b;
+  return (lhs > rhs) - (lhs < rhs);
+}
+
+int32_t uf_sample_frequent_root(_Atomic int32_t *parent, int32_t n)
+{
+  if (n <= 0)
+    return 0;
+
+  int32_t samples[AFFOREST_NUM_SAMPLES];
+
+  // Fixed-seed xorshift so the choice is reproducible across runs
+  uint32_t state = 0x9E3779B9u;
+  for (int s = 0; s < AFFOREST_NUM_SAMPLES; s++)
   {
-    fprintf(stderr, "Memory allocation failed\n");
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    int32_t v = (int32_t)(state % (uint32_t)n);
+    samples[s] = atomic_load_explicit(&parent[v], memory_order_relaxed);
+  }
+
+  qsort(samples, AFFOREST_NUM_SAMPLES, sizeof(int32_t), cmp_int32);
+
+  // Longest run in the sorted samples is the most frequent root
+  int32_t best = samples[0];
+  int best_count = 0;
+  int run = 0;
+  for (int s = 0; s < AFFOREST_NUM_SAMPLES; s++)
+  {
+    run = (s > 0 && samples[s] == samples[s - 1]) ? run + 1 : 1;
+    if (run > best_count)
+    {
+      best_count = run;
+      best = samples[s];
+    }
+  }
+
+  return best;
+}
+
+void compute_connected_components_afforest(const CSRGraph *restrict G, int32_t *restrict labels)
+{
+  const int32_t n = G->n;
+  const int64_t *restrict row_ptr = G->row_ptr;
+  const int32_t *restrict col_idx = G->col_idx;
+
+  _Atomic int32_t *parent;
+  if (!(parent = cc_alloc((size_t)n * sizeof(*parent))))
+  {
+    fprintf(stderr, "Memory allocation failed (parent array)\n");
     exit(EXIT_FAILURE);
   }
 
-  int32_t unique_count = 0;
   for (int32_t i = 0; i < n; i++)
+    atomic_init(&parent[i], i);
+
+  // Link the first few neighbors of every vertex
+  for (int r = 0; r < AFFOREST_NEIGHBOR_ROUNDS; r++)
   {
-    if (!unique_flags[labels[i]])
+    for (int32_t u = 0; u < n; u++)
     {
-      unique_flags[labels[i]] = 1;
-      unique_count++;
+      if (row_ptr[u] + r < row_ptr[u + 1])
+        uf_link(parent, u, col_idx[row_ptr[u] + r]);
     }
+    for (int32_t u = 0; u < n; u++)
+      uf_compress(parent, u);
+  }
+
+  // Vertices already in the giant component need no further work
+  int32_t giant = uf_sample_frequent_root(parent, n);
+
+  for (int32_t u = 0; u < n; u++)
+  {
+    if (atomic_load_explicit(&parent[u], memory_order_relaxed) == giant)
+      continue;
+    for (int64_t j = row_ptr[u] + AFFOREST_NEIGHBOR_ROUNDS; j < row_ptr[u + 1]; j++)
+      uf_link(parent, u, col_idx[j]);
+  }
+
+  for (int32_t u = 0; u < n; u++)
+  {
+    uf_compress(parent, u);
+    labels[u] = atomic_load_explicit(&parent[u], memory_order_relaxed);
   }
 
-  free(unique_flags);
-  return unique_count;
+  cc_free(parent);
 }
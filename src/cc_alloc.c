@@ -0,0 +1,271 @@
+#define _GNU_SOURCE
+#include "cc_alloc.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <sys/mman.h>
+
+// Encoded page sizes for MAP_HUGETLB, in case the libc headers predate them
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+#define PAGE_2M ((size_t)2 << 20)
+#define PAGE_1G ((size_t)1 << 30)
+
+// Backing of a large allocation, also the index into alloc_bytes
+enum
+{
+  BACKING_4K = 0,
+  BACKING_THP = 1,
+  BACKING_2M = 2,
+  BACKING_1G = 3,
+  BACKING_COUNT
+};
+
+static const char *const backing_names[BACKING_COUNT] = {"4k", "thp", "2m", "1g"};
+
+static CCHugePages hugepages_mode = CC_HUGEPAGES_OFF;
+
+// Bytes of large allocations per backing, for cc_alloc_pages_used
+static _Atomic size_t alloc_bytes[BACKING_COUNT];
+
+// hugetlbfs blocks have to be unmapped with their size, so they are tracked here; everything
+// else came from the heap and goes back with free()
+typedef struct
+{
+  void *addr;
+  size_t bytes; // mapped length, a multiple of page
+  size_t page;
+} HugeBlock;
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static HugeBlock *registry = NULL;
+static size_t registry_count = 0;
+static size_t registry_capacity = 0;
+
+static atomic_int warned_hugetlb;
+
+int cc_hugepages_parse(const char *name, CCHugePages *out)
+{
+  if (strcmp(name, "off") == 0)
+    *out = CC_HUGEPAGES_OFF;
+  else if (strcmp(name, "thp") == 0)
+    *out = CC_HUGEPAGES_THP;
+  else if (strcmp(name, "2m") == 0)
+    *out = CC_HUGEPAGES_2M;
+  else if (strcmp(name, "1g") == 0)
+    *out = CC_HUGEPAGES_1G;
+  else
+    return -1;
+  return 0;
+}
+
+const char *cc_hugepages_name(CCHugePages mode)
+{
+  switch (mode)
+  {
+  case CC_HUGEPAGES_OFF:
+    return "off";
+  case CC_HUGEPAGES_THP:
+    return "thp";
+  case CC_HUGEPAGES_2M:
+    return "2m";
+  case CC_HUGEPAGES_1G:
+    return "1g";
+  }
+  return "unknown";
+}
+
+void cc_alloc_set_hugepages(CCHugePages mode)
+{
+  hugepages_mode = mode;
+}
+
+CCHugePages cc_alloc_hugepages(void)
+{
+  return hugepages_mode;
+}
+
+static size_t round_up(size_t bytes, size_t page)
+{
+  return (bytes + page - 1) / page * page;
+}
+
+static int registry_find(const void *p)
+{
+  for (size_t i = 0; i < registry_count; i++)
+  {
+    if (registry[i].addr == p)
+      return (int)i;
+  }
+  return -1;
+}
+
+// Map bytes of page-sized hugetlbfs pages and register the block. NULL when none are free
+static void *map_hugetlb(size_t bytes, size_t page)
+{
+#ifdef MAP_HUGETLB
+  size_t length = round_up(bytes, page);
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (page == PAGE_1G ? MAP_HUGE_1GB : MAP_HUGE_2MB);
+  void *p = mmap(NULL, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (p == MAP_FAILED)
+    return NULL;
+
+  pthread_mutex_lock(&registry_lock);
+  if (registry_count == registry_capacity)
+  {
+    size_t capacity = registry_capacity ? registry_capacity * 2 : 16;
+    HugeBlock *tmp = (HugeBlock *)realloc(registry, capacity * sizeof(*tmp));
+    if (!tmp)
+    {
+      pthread_mutex_unlock(&registry_lock);
+      munmap(p, length);
+      return NULL;
+    }
+    registry = tmp;
+    registry_capacity = capacity;
+  }
+  registry[registry_count++] = (HugeBlock){p, length, page};
+  pthread_mutex_unlock(&registry_lock);
+  return p;
+#else
+  (void)bytes;
+  (void)page;
+  return NULL;
+#endif
+}
+
+// 2 MB aligned heap block the kernel may back with transparent huge pages
+static void *alloc_thp(size_t bytes, int *backing)
+{
+  void *p = NULL;
+  if (posix_memalign(&p, PAGE_2M, round_up(bytes, PAGE_2M)) != 0)
+    return NULL;
+#ifdef MADV_HUGEPAGE
+  *backing = (madvise(p, round_up(bytes, PAGE_2M), MADV_HUGEPAGE) == 0) ? BACKING_THP : BACKING_4K;
+#else
+  *backing = BACKING_4K;
+#endif
+  return p;
+}
+
+void *cc_alloc(size_t bytes)
+{
+  if (bytes == 0)
+    bytes = 1;
+  if (hugepages_mode == CC_HUGEPAGES_OFF || bytes < CC_ALLOC_HUGE_MIN)
+  {
+    void *p = NULL;
+    if (posix_memalign(&p, 64, bytes) != 0)
+      return NULL;
+    if (bytes >= CC_ALLOC_HUGE_MIN)
+      atomic_fetch_add(&alloc_bytes[BACKING_4K], bytes);
+    return p;
+  }
+
+  void *p = NULL;
+  int backing = BACKING_4K;
+  if (hugepages_mode == CC_HUGEPAGES_1G && bytes >= PAGE_1G && (p = map_hugetlb(bytes, PAGE_1G)))
+    backing = BACKING_1G;
+  else if (hugepages_mode >= CC_HUGEPAGES_2M && (p = map_hugetlb(bytes, PAGE_2M)))
+    backing = BACKING_2M;
+  else
+  {
+    if (hugepages_mode >= CC_HUGEPAGES_2M && atomic_exchange(&warned_hugetlb, 1) == 0)
+      fprintf(stderr, "Warning: No free hugetlbfs pages (see /proc/sys/vm/nr_hugepages), using madvise\n");
+    p = alloc_thp(bytes, &backing);
+  }
+  if (p)
+    atomic_fetch_add(&alloc_bytes[backing], bytes);
+  return p;
+}
+
+void *cc_realloc(void *p, size_t bytes)
+{
+  if (!p)
+    return cc_alloc(bytes);
+  if (bytes == 0)
+    bytes = 1;
+
+  pthread_mutex_lock(&registry_lock);
+  int index = registry_find(p);
+  if (index < 0)
+  {
+    pthread_mutex_unlock(&registry_lock);
+    // realloc would keep only malloc's 16-byte alignment, so move the data to a fresh block
+    void *moved = cc_alloc(bytes);
+    if (!moved)
+      return NULL;
+    size_t old_bytes = malloc_usable_size(p);
+    memcpy(moved, p, old_bytes < bytes ? old_bytes : bytes);
+    cc_free(p);
+    return moved;
+  }
+
+  HugeBlock block = registry[index];
+  size_t length = round_up(bytes, block.page);
+  if (length <= block.bytes)
+  {
+    // Give the unused tail pages back without moving the data
+    if (length < block.bytes && munmap((char *)p + length, block.bytes - length) == 0)
+      registry[index].bytes = length;
+    pthread_mutex_unlock(&registry_lock);
+    return p;
+  }
+  pthread_mutex_unlock(&registry_lock);
+
+  void *grown = cc_alloc(bytes);
+  if (!grown)
+    return NULL;
+  memcpy(grown, p, block.bytes);
+  cc_free(p);
+  return grown;
+}
+
+void cc_free(void *p)
+{
+  if (!p)
+    return;
+  pthread_mutex_lock(&registry_lock);
+  int index = registry_find(p);
+  if (index >= 0)
+  {
+    HugeBlock block = registry[index];
+    registry[index] = registry[--registry_count];
+    pthread_mutex_unlock(&registry_lock);
+    munmap(block.addr, block.bytes);
+    return;
+  }
+  pthread_mutex_unlock(&registry_lock);
+  free(p);
+}
+
+const char *cc_alloc_pages_used(char *buf, size_t size)
+{
+  size_t used = 0;
+  if (size > 0)
+    buf[0] = '\0';
+  for (int b = BACKING_COUNT - 1; b >= 0; b--)
+  {
+    if (atomic_load(&alloc_bytes[b]) == 0 || used >= size)
+      continue;
+    int written = snprintf(buf + used, size - used, "%s%s", used ? "+" : "", backing_names[b]);
+    if (written > 0)
+      used += (size_t)written;
+  }
+  if (used == 0 && size > 0)
+    snprintf(buf, size, "4k");
+  return buf;
+}
@@ -0,0 +1,177 @@
+#define _GNU_SOURCE
+#include <string.h>
+
+#include "cc.h"
+#include "cc_bench.h"
+#include "cc_pthread_pool.h"
+
+// Wrappers giving every kernel the BenchKernel signature. OpenMP kernels find their
+// thread count already set by the harness; pthreads kernels run on the shared pool.
+
+static void run_seq(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components(ctx->G, labels);
+}
+
+static void run_bfs(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_bfs(ctx->G, labels);
+}
+
+static void run_afforest(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_afforest(ctx->G, labels);
+}
+
+static void run_omp(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_omp(ctx->G, labels, ctx->chunk_size);
+}
+
+static void run_omp_csr32(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_omp_csr32(ctx->G32, labels, ctx->chunk_size);
+}
+
+static void run_omp_varint(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_omp_varint(ctx->Gv, labels, ctx->chunk_size);
+}
+
+static void run_afforest_omp(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_afforest_omp(ctx->G, labels, ctx->chunk_size);
+}
+
+static void run_frontier_omp(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_frontier_omp(ctx->G, labels, ctx->chunk_size, NULL);
+}
+
+static void run_bfs_omp(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_bfs_omp(ctx->G, labels, ctx->chunk_size);
+}
+
+static void run_pool(const BenchContext *ctx, int32_t *labels, CCPoolKernel kernel)
+{
+  cc_pthread_pool_run_cc(ctx->pool, kernel, ctx->G, labels, ctx->num_threads, ctx->chunk_size, NULL);
+}
+
+static void run_pthread(const BenchContext *ctx, int32_t *labels)
+{
+  run_pool(ctx, labels, CC_POOL_LP);
+}
+
+static void run_pthread_steal(const BenchContext *ctx, int32_t *labels)
+{
+  run_pool(ctx, labels, CC_POOL_LP_STEAL);
+}
+
+static void run_pthread_async(const BenchContext *ctx, int32_t *labels)
+{
+  run_pool(ctx, labels, CC_POOL_LP_ASYNC);
+}
+
+static void run_afforest_pthread(const BenchContext *ctx, int32_t *labels)
+{
+  run_pool(ctx, labels, CC_POOL_AFFOREST);
+}
+
+static void run_sv_pthread(const BenchContext *ctx, int32_t *labels)
+{
+  run_pool(ctx, labels, CC_POOL_SV);
+}
+
+static void run_frontier_pthread(const BenchContext *ctx, int32_t *labels)
+{
+  run_pool(ctx, labels, CC_POOL_FRONTIER);
+}
+
+static void run_bfs_pthread(const BenchContext *ctx, int32_t *labels)
+{
+  run_pool(ctx, labels, CC_POOL_BFS);
+}
+
+#ifdef CC_BENCH_WITH_CILK
+static void run_cilk(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_cilk(ctx->G, labels, ctx->chunk_size);
+}
+
+static void run_recursive_cilk(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_recursive_cilk(ctx->G, labels, ctx->chunk_size, NULL);
+}
+
+static void run_afforest_cilk(const BenchContext *ctx, int32_t *labels)
+{
+  compute_connected_components_afforest_cilk(ctx->G, labels, ctx->chunk_size);
+}
+#endif
+
+static const BenchKernel kernels[] = {
+    {"seq", "sequential label propagation", CC_BENCH_SEQUENTIAL, 0, 0, CSR_LAYOUT_CSR64, run_seq},
+    {"bfs", "sequential BFS", CC_BENCH_SEQUENTIAL, 0, 1, CSR_LAYOUT_CSR64, run_bfs},
+    {"afforest", "sequential Afforest union-find", CC_BENCH_SEQUENTIAL, 0, 0, CSR_LAYOUT_CSR64, run_afforest},
+    {"omp", "OpenMP label propagation", CC_BENCH_OPENMP, 1, 0, CSR_LAYOUT_CSR64, run_omp},
+    {"omp_csr32", "OpenMP label propagation, 32-bit offsets", CC_BENCH_OPENMP, 1, 0, CSR_LAYOUT_CSR32, run_omp_csr32},
+    {"omp_varint", "OpenMP label propagation, varint adjacency", CC_BENCH_OPENMP, 1, 0, CSR_LAYOUT_VARINT,
+     run_omp_varint},
+    {"afforest_omp", "OpenMP Afforest", CC_BENCH_OPENMP, 1, 0, CSR_LAYOUT_CSR64, run_afforest_omp},
+    {"frontier_omp", "OpenMP frontier label propagation", CC_BENCH_OPENMP, 1, 0, CSR_LAYOUT_CSR64, run_frontier_omp},
+    {"bfs_omp", "OpenMP direction-optimizing BFS", CC_BENCH_OPENMP, 1, 0, CSR_LAYOUT_CSR64, run_bfs_omp},
+    {"pthread", "pthreads label propagation", CC_BENCH_PTHREADS, 1, 0, CSR_LAYOUT_CSR64, run_pthread},
+    {"pthread_steal", "pthreads LP with work stealing", CC_BENCH_PTHREADS, 1, 0, CSR_LAYOUT_CSR64, run_pthread_steal},
+    {"pthread_async", "pthreads barrier-free LP", CC_BENCH_PTHREADS, 0, 0, CSR_LAYOUT_CSR64, run_pthread_async},
+    {"afforest_pthread", "pthreads Afforest", CC_BENCH_PTHREADS, 1, 0, CSR_LAYOUT_CSR64, run_afforest_pthread},
+    {"sv_pthread", "pthreads Shiloach-Vishkin", CC_BENCH_PTHREADS, 1, 0, CSR_LAYOUT_CSR64, run_sv_pthread},
+    {"frontier_pthread", "pthreads frontier label propagation", CC_BENCH_PTHREADS, 1, 0, CSR_LAYOUT_CSR64,
+     run_frontier_pthread},
+    {"bfs_pthread", "pthreads direction-optimizing BFS", CC_BENCH_PTHREADS, 1, 0, CSR_LAYOUT_CSR64, run_bfs_pthread},
+#ifdef CC_BENCH_WITH_CILK
+    {"cilk", "OpenCilk label propagation", CC_BENCH_CILK, 1, 0, CSR_LAYOUT_CSR64, run_cilk},
+    {"recursive_cilk", "OpenCilk recursive edge-balanced label propagation", CC_BENCH_CILK, 1, 0, CSR_LAYOUT_CSR64,
+     run_recursive_cilk},
+    {"afforest_cilk", "OpenCilk Afforest", CC_BENCH_CILK, 1, 0, CSR_LAYOUT_CSR64, run_afforest_cilk},
+#endif
+};
+
+const BenchKernel *cc_bench_kernels(size_t *count)
+{
+  *count = sizeof(kernels) / sizeof(kernels[0]);
+  return kernels;
+}
+
+const BenchKernel *cc_bench_find_kernel(const char *name)
+{
+  for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++)
+    if (strcmp(kernels[i].name, name) == 0)
+      return &kernels[i];
+  return NULL;
+}
+
+const char *cc_bench_runtime_name(BenchRuntime runtime)
+{
+  switch (runtime)
+  {
+  case CC_BENCH_SEQUENTIAL:
+    return "sequential";
+  case CC_BENCH_OPENMP:
+    return "openmp";
+  case CC_BENCH_PTHREADS:
+    return "pthreads";
+  case CC_BENCH_CILK:
+    return "cilk";
+  }
+  return "unknown";
+}
+
+int cc_bench_cilk_workers(void)
+{
+#ifdef CC_BENCH_WITH_CILK
+  return cilk_num_workers();
+#else
+  return 0;
+#endif
+}
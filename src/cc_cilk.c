@@ -1,15 +1,25 @@
 #define _POSIX_C_SOURCE 200112L
 
 #include "cc.h"
+#include "cc_alloc.h"
+#include "union_find.h"
+#include "neighbor_min.h"
+#include "lp_instrument.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdatomic.h>
 #include <cilk/cilk.h>
+#include <cilk/cilk_api.h>
 
-void compute_connected_components_cilk(const CSRGraph *restrict G,
-                                       int32_t *restrict labels,
-                                       int chunk_size)
+int cilk_num_workers(void)
+{
+  return __cilkrts_get_nworkers();
+}
+
+void compute_connected_components_cilk_inplace(const CSRGraph *restrict G,
+                                               _Atomic int32_t *restrict atomic_labels,
+                                               int chunk_size)
 {
   const int32_t n = G->n;
   const int64_t *restrict row_ptr = G->row_ptr;
@@ -17,43 +27,33 @@ void compute_connected_components_cilk(const CSRGraph *restrict G,
   const int effective_chunk = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
 
   //Initialize labels
-  for (int32_t i = 0; i < n; i++)
-    labels[i] = i;
-
-  _Atomic int32_t *atomic_labels;
-  if (posix_memalign((void **)&atomic_labels, 64, (size_t)n * sizeof(*atomic_labels)) != 0)
-  {
-    fprintf(stderr, "Memory allocation failed (atomic labels)\n");
-    exit(EXIT_FAILURE);
-  }
-
   cilk_for(int32_t i = 0; i < n; i++)
-    atomic_store_explicit(&atomic_labels[i], labels[i], memory_order_relaxed);
+    atomic_store_explicit(&atomic_labels[i], i, memory_order_relaxed);
 
+  // No barriers to time: a worker's idle time is the round's wall time minus its busy time
+  LP_INSTRUMENT_ONLY(lp_instrument_begin(__cilkrts_get_nworkers());)
   while (1)
   {
     _Atomic int any_changed = 0;
+    LP_INSTRUMENT_ONLY(double round_start = lp_instrument_now();)
 
     // Main label propagation loop
     cilk_for(int32_t base = 0; base < n; base += effective_chunk)
     {
       int local_changed = 0;
       int32_t end = (base + effective_chunk < n) ? base + effective_chunk : n;
+      // A chunk never spawns, so it runs start to finish on one worker
+      LPInstrumentSlot *stats = LP_INSTRUMENT_SLOT(__cilkrts_get_worker_number());
+      LP_INSTRUMENT_ONLY(double chunk_start = lp_instrument_now();)
 
       // Process vertices in the chunk
       for (int32_t u = base; u < end; u++)
       {
         int32_t old_label = atomic_load_explicit(&atomic_labels[u], memory_order_relaxed);
-        int32_t new_label = old_label;
-        
-        // Check neighbors for smaller labels
-        for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
-        {
-          int32_t v = col_idx[j];
-          int32_t neighbor_label = atomic_load_explicit(&atomic_labels[v], memory_order_relaxed);
-          if (neighbor_label < new_label)
-            new_label = neighbor_label;
-        }
+
+        // Check neighbors for smaller labels (vectorized for long rows)
+        int32_t new_label = neighbor_min(atomic_labels, col_idx, row_ptr[u], row_ptr[u + 1], old_label);
+        LP_INSTRUMENT_ADD(stats, edges_scanned, row_ptr[u + 1] - row_ptr[u]);
         
         // Update label if a smaller one was found
         if (new_label < old_label)
@@ -63,7 +63,9 @@ void compute_connected_components_cilk(const CSRGraph *restrict G,
                  !atomic_compare_exchange_weak_explicit(&atomic_labels[u],&current, new_label,
                                                         memory_order_relaxed,memory_order_relaxed))
           {
+            LP_INSTRUMENT_ADD(stats, cas_failures, 1);
           }
+          LP_INSTRUMENT_ADD(stats, changed_vertices, current > new_label);
 
           local_changed = 1;
           
@@ -76,21 +78,270 @@ void compute_connected_components_cilk(const CSRGraph *restrict G,
                    !atomic_compare_exchange_weak_explicit(&atomic_labels[v],&neighbor, new_label,
                                                           memory_order_relaxed,memory_order_relaxed))
             {
+              LP_INSTRUMENT_ADD(stats, cas_failures, 1);
             }
+            LP_INSTRUMENT_ADD(stats, changed_vertices, neighbor > new_label);
           }
+          LP_INSTRUMENT_ADD(stats, edges_scanned, row_ptr[u + 1] - row_ptr[u]);
         }
       }
 
       if (local_changed)
         atomic_store_explicit(&any_changed, 1, memory_order_relaxed);
+      LP_INSTRUMENT_ONLY(stats->busy_seconds += lp_instrument_now() - chunk_start;)
     }
+    LP_INSTRUMENT_ONLY(lp_instrument_end_round(lp_instrument_now() - round_start);)
 
     if (atomic_load_explicit(&any_changed, memory_order_acquire) == 0)
       break;
   }
+}
+
+void compute_connected_components_cilk(const CSRGraph *restrict G,
+                                       int32_t *restrict labels,
+                                       int chunk_size)
+{
+  const int32_t n = G->n;
+  _Atomic int32_t *atomic_labels;
+  if (!(atomic_labels = cc_alloc((size_t)n * sizeof(*atomic_labels))))
+  {
+    fprintf(stderr, "Memory allocation failed (atomic labels)\n");
+    exit(EXIT_FAILURE);
+  }
+
+  compute_connected_components_cilk_inplace(G, atomic_labels, chunk_size);
 
   cilk_for(int32_t i = 0; i < n; i++)
     labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
 
-  free(atomic_labels);
+  cc_free(atomic_labels);
+}
+
+// Smallest leaf of the recursive kernel, in cost units (vertices plus edges)
+#define RECURSIVE_MIN_GRAIN 64
+
+// Per-round counters of the recursive kernel, kept in a reducer so leaves never share a line
+typedef struct
+{
+  int64_t lowered;       // successful label decreases; the round converged when this stays 0
+  int64_t edges_scanned; // adjacency entries read
+} RoundCounters;
+
+static void round_counters_identity(void *view)
+{
+  memset(view, 0, sizeof(RoundCounters));
+}
+
+static void round_counters_reduce(void *left, void *right)
+{
+  RoundCounters *l = (RoundCounters *)left;
+  const RoundCounters *r = (const RoundCounters *)right;
+  l->lowered += r->lowered;
+  l->edges_scanned += r->edges_scanned;
+}
+
+#define ROUND_COUNTERS_REDUCER cilk_reducer(round_counters_identity, round_counters_reduce)
+
+// Lower labels[v] to label. Returns 1 when this call lowered it
+static inline int lower_label(_Atomic int32_t *labels, int32_t v, int32_t label)
+{
+  int32_t current = atomic_load_explicit(&labels[v], memory_order_relaxed);
+  while (current > label &&
+         !atomic_compare_exchange_weak_explicit(&labels[v], &current, label, memory_order_relaxed,
+                                                memory_order_relaxed))
+    ;
+  return current > label;
+}
+
+// Minimum label over col_idx[begin, end) and init, split into grain-sized halves
+static int32_t hub_min(_Atomic int32_t *labels, const int32_t *col_idx, int64_t begin, int64_t end,
+                       int64_t grain, int32_t init)
+{
+  if (end - begin <= grain)
+    return neighbor_min(labels, col_idx, begin, end, init);
+  int64_t mid = begin + (end - begin) / 2;
+  int32_t left = cilk_spawn hub_min(labels, col_idx, begin, mid, grain, init);
+  int32_t right = hub_min(labels, col_idx, mid, end, grain, init);
+  cilk_sync;
+  return left < right ? left : right;
+}
+
+// One LP step of a row longer than grain: the minimum and the push each run as parallel tasks
+static void relax_hub(_Atomic int32_t *labels, const int32_t *col_idx, int32_t u, int64_t begin, int64_t end,
+                      int64_t grain, RoundCounters ROUND_COUNTERS_REDUCER *counters)
+{
+  int32_t old_label = atomic_load_explicit(&labels[u], memory_order_relaxed);
+  int32_t new_label = hub_min(labels, col_idx, begin, end, grain, old_label);
+  counters->edges_scanned += end - begin;
+  if (new_label >= old_label)
+    return;
+
+  counters->lowered += lower_label(labels, u, new_label);
+  cilk_for(int64_t piece = begin; piece < end; piece += grain)
+  {
+    int64_t piece_end = (piece + grain < end) ? piece + grain : end;
+    int64_t lowered = 0;
+    for (int64_t j = piece; j < piece_end; j++)
+      lowered += lower_label(labels, col_idx[j], new_label);
+    counters->lowered += lowered;
+    counters->edges_scanned += piece_end - piece;
+  }
+}
+
+// One LP step of every row in [lo, hi). The range is halved at its cost midpoint (found in
+// row_ptr) until it is at most grain; rows heavier than grain are spawned as hub tasks
+static void relax_range(const CSRGraph *restrict G, _Atomic int32_t *restrict labels, int32_t lo, int32_t hi,
+                        int64_t grain, RoundCounters ROUND_COUNTERS_REDUCER *counters)
+{
+  const int64_t *restrict row_ptr = G->row_ptr;
+  const int32_t *restrict col_idx = G->col_idx;
+
+  if (hi - lo > 1 && (int64_t)(hi - lo) + row_ptr[hi] - row_ptr[lo] > grain)
+  {
+    // Smallest mid whose prefix holds half of the range's cost, kept strictly inside (lo, hi)
+    const int64_t half = ((int64_t)lo + row_ptr[lo] + (int64_t)hi + row_ptr[hi]) / 2;
+    int32_t left = lo + 1;
+    int32_t right = hi - 1;
+    while (left < right)
+    {
+      int32_t probe = left + (right - left) / 2;
+      if ((int64_t)probe + row_ptr[probe] < half)
+        left = probe + 1;
+      else
+        right = probe;
+    }
+    cilk_spawn relax_range(G, labels, lo, left, grain, counters);
+    relax_range(G, labels, left, hi, grain, counters);
+    cilk_sync;
+    return;
+  }
+
+  int64_t lowered = 0;
+  int64_t scanned = 0;
+  for (int32_t u = lo; u < hi; u++)
+  {
+    const int64_t begin = row_ptr[u];
+    const int64_t end = row_ptr[u + 1];
+    if (end - begin > grain)
+    {
+      cilk_spawn relax_hub(labels, col_idx, u, begin, end, grain, counters);
+      continue;
+    }
+
+    int32_t old_label = atomic_load_explicit(&labels[u], memory_order_relaxed);
+    int32_t new_label = neighbor_min(labels, col_idx, begin, end, old_label);
+    scanned += end - begin;
+    if (new_label < old_label)
+    {
+      lowered += lower_label(labels, u, new_label);
+      // Propagate the new label to neighbors to help convergence
+      for (int64_t j = begin; j < end; j++)
+        lowered += lower_label(labels, col_idx[j], new_label);
+      scanned += end - begin;
+    }
+  }
+  cilk_sync;
+  counters->lowered += lowered;
+  counters->edges_scanned += scanned;
+}
+
+int compute_connected_components_recursive_cilk(const CSRGraph *restrict G,
+                                                int32_t *restrict labels,
+                                                int chunk_size,
+                                                LPRoundStats *stats)
+{
+  const int32_t n = G->n;
+  const int effective_chunk = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
+  // Same task size as the pthreads work-stealing scheduler: chunk_size average vertices of cost
+  int64_t grain = (int64_t)effective_chunk * (n > 0 ? G->m / n + 1 : 1);
+  if (grain < RECURSIVE_MIN_GRAIN)
+    grain = RECURSIVE_MIN_GRAIN;
+
+  _Atomic int32_t *atomic_labels;
+  if (!(atomic_labels = cc_alloc((size_t)n * sizeof(*atomic_labels))))
+  {
+    fprintf(stderr, "Memory allocation failed (atomic labels)\n");
+    exit(EXIT_FAILURE);
+  }
+
+  cilk_for(int32_t i = 0; i < n; i++)
+    atomic_store_explicit(&atomic_labels[i], i, memory_order_relaxed);
+
+  int rounds = 0;
+  while (n > 0)
+  {
+    RoundCounters ROUND_COUNTERS_REDUCER counters = {0, 0};
+    relax_range(G, atomic_labels, 0, n, grain, &counters);
+    rounds++;
+    if (stats)
+      lp_round_stats_push(stats, n, counters.edges_scanned, 1);
+    if (counters.lowered == 0)
+      break;
+  }
+
+  cilk_for(int32_t i = 0; i < n; i++)
+    labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
+
+  cc_free(atomic_labels);
+  return rounds;
+}
+
+void compute_connected_components_afforest_cilk(const CSRGraph *restrict G,
+                                                int32_t *restrict labels,
+                                                int chunk_size)
+{
+  const int32_t n = G->n;
+  const int64_t *restrict row_ptr = G->row_ptr;
+  const int32_t *restrict col_idx = G->col_idx;
+  const int effective_chunk = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
+
+  _Atomic int32_t *parent;
+  if (!(parent = cc_alloc((size_t)n * sizeof(*parent))))
+  {
+    fprintf(stderr, "Memory allocation failed (parent array)\n");
+    exit(EXIT_FAILURE);
+  }
+
+  cilk_for(int32_t i = 0; i < n; i++)
+    atomic_store_explicit(&parent[i], i, memory_order_relaxed);
+
+  // Link the first few neighbors of every vertex, compressing after each round
+  for (int r = 0; r < AFFOREST_NEIGHBOR_ROUNDS; r++)
+  {
+    cilk_for(int32_t base = 0; base < n; base += effective_chunk)
+    {
+      int32_t end = (base + effective_chunk < n) ? base + effective_chunk : n;
+      for (int32_t u = base; u < end; u++)
+      {
+        if (row_ptr[u] + r < row_ptr[u + 1])
+          uf_link(parent, u, col_idx[row_ptr[u] + r]);
+      }
+    }
+
+    cilk_for(int32_t u = 0; u < n; u++)
+      uf_compress(parent, u);
+  }
+
+  // Vertices already in the giant component need no further work
+  const int32_t giant = uf_sample_frequent_root(parent, n);
+
+  cilk_for(int32_t base = 0; base < n; base += effective_chunk)
+  {
+    int32_t end = (base + effective_chunk < n) ? base + effective_chunk : n;
+    for (int32_t u = base; u < end; u++)
+    {
+      if (atomic_load_explicit(&parent[u], memory_order_relaxed) == giant)
+        continue;
+      for (int64_t j = row_ptr[u] + AFFOREST_NEIGHBOR_ROUNDS; j < row_ptr[u + 1]; j++)
+        uf_link(parent, u, col_idx[j]);
+    }
+  }
+
+  cilk_for(int32_t u = 0; u < n; u++)
+    uf_compress(parent, u);
+
+  cilk_for(int32_t i = 0; i < n; i++)
+    labels[i] = atomic_load_explicit(&parent[i], memory_order_relaxed);
+
+  cc_free(parent);
 }
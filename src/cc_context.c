@@ -0,0 +1,270 @@
+#define _POSIX_C_SOURCE 200112L
+#include "cc_context.h"
+#include "cc_alloc.h"
+
+#include <omp.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cc.h"
+#include "cc_pthread_pool.h"
+#include "thread_util.h"
+
+// The label buffer is handed out as int32_t once the kernel has finished with it
+_Static_assert(sizeof(_Atomic int32_t) == sizeof(int32_t), "atomic labels must match int32_t");
+
+struct CCContext
+{
+  CCContextBackend backend;
+  int num_threads;
+  int chunk_size;
+  CCPthreadPool *pool;
+  CSRGraph G;
+  int has_graph;
+  _Atomic int32_t *labels; // 64-byte aligned, capacity entries
+  int32_t capacity;
+  int32_t labeled;         // vertices labeled by the last cc_context_run, 0 before
+};
+
+CCContext *cc_context_create(CCContextBackend backend, int num_threads, int chunk_size)
+{
+#ifndef CC_LIB_WITH_CILK
+  if (backend == CC_CONTEXT_CILK)
+  {
+    fprintf(stderr, "cc_context: built without the Cilk backend (make libcc LIB_CILK=1)\n");
+    return NULL;
+  }
+#endif
+  if (backend != CC_CONTEXT_OMP && backend != CC_CONTEXT_PTHREADS && backend != CC_CONTEXT_CILK)
+  {
+    fprintf(stderr, "cc_context: unknown backend %d\n", (int)backend);
+    return NULL;
+  }
+
+  CCContext *ctx = (CCContext *)calloc(1, sizeof(*ctx));
+  if (!ctx)
+    return NULL;
+  ctx->backend = backend;
+  ctx->num_threads = num_threads > 0 ? num_threads : thread_util_default_threads();
+#ifdef CC_LIB_WITH_CILK
+  if (backend == CC_CONTEXT_CILK)
+    ctx->num_threads = cilk_num_workers();
+#endif
+  ctx->chunk_size = chunk_size;
+
+  // Every backend batches on the pool; its idle workers park, so it costs nothing between calls
+  ctx->pool = cc_pthread_pool_create(ctx->num_threads);
+  if (!ctx->pool)
+  {
+    fprintf(stderr, "cc_context: failed to start %d threads\n", ctx->num_threads);
+    free(ctx);
+    return NULL;
+  }
+  return ctx;
+}
+
+void cc_context_destroy(CCContext *ctx)
+{
+  if (!ctx)
+    return;
+  cc_pthread_pool_destroy(ctx->pool);
+  if (ctx->has_graph)
+    free_csr(&ctx->G);
+  cc_free(ctx->labels);
+  free(ctx);
+}
+
+int cc_context_set_graph(CCContext *ctx, CSRGraph *G)
+{
+  if (ctx->has_graph)
+    free_csr(&ctx->G);
+  ctx->G = *G;
+  ctx->has_graph = 1;
+  ctx->labeled = 0;
+  memset(G, 0, sizeof(*G));
+  return 0;
+}
+
+int cc_context_load(CCContext *ctx, const char *path)
+{
+  CSRGraph G;
+  if (load_csr_from_file(path, 1, 1, &G) != 0)
+  {
+    fprintf(stderr, "cc_context: failed to load graph from %s\n", path);
+    return -1;
+  }
+  return cc_context_set_graph(ctx, &G);
+}
+
+const CSRGraph *cc_context_graph(const CCContext *ctx)
+{
+  return ctx->has_graph ? &ctx->G : NULL;
+}
+
+// Grow the label buffer to n entries. The old contents are not kept; the kernels rewrite them
+static int reserve_labels(CCContext *ctx, int32_t n)
+{
+  if (n <= ctx->capacity && ctx->labels)
+    return 0;
+  cc_free(ctx->labels);
+  ctx->labels = NULL;
+  ctx->capacity = 0;
+  if (!(ctx->labels = cc_alloc((size_t)(n > 0 ? n : 1) * sizeof(*ctx->labels))))
+  {
+    fprintf(stderr, "cc_context: memory allocation failed (labels)\n");
+    return -1;
+  }
+  ctx->capacity = n;
+  return 0;
+}
+
+// One LP run of the context's backend over G into ctx->labels
+static void run_backend(CCContext *ctx, const CSRGraph *G)
+{
+  switch (ctx->backend)
+  {
+  case CC_CONTEXT_PTHREADS:
+    cc_pthread_pool_run_lp_inplace(ctx->pool, G, ctx->labels, ctx->num_threads, ctx->chunk_size);
+    break;
+#ifdef CC_LIB_WITH_CILK
+  case CC_CONTEXT_CILK:
+    compute_connected_components_cilk_inplace(G, ctx->labels, ctx->chunk_size);
+    break;
+#endif
+  default:
+    omp_set_num_threads(ctx->num_threads);
+    compute_connected_components_omp_inplace(G, ctx->labels, ctx->chunk_size);
+    break;
+  }
+}
+
+int cc_context_run(CCContext *ctx)
+{
+  if (!ctx->has_graph)
+  {
+    fprintf(stderr, "cc_context: no graph set\n");
+    return -1;
+  }
+  if (reserve_labels(ctx, ctx->G.n) != 0)
+    return -1;
+  run_backend(ctx, &ctx->G);
+  ctx->labeled = ctx->G.n;
+  return 0;
+}
+
+const int32_t *cc_context_labels(const CCContext *ctx)
+{
+  return (const int32_t *)ctx->labels;
+}
+
+int32_t cc_context_count_components(const CCContext *ctx)
+{
+  return ctx->labeled > 0 ? count_unique_labels(cc_context_labels(ctx), ctx->labeled) : 0;
+}
+
+// Sequential union-find with labels itself as the parent array. Roots are hooked under the
+// smaller root and path halving only moves pointers down, so labels[u] <= u throughout and
+// one ascending pass leaves every vertex pointing at the minimum ID of its component
+static void label_small_graph(const CSRGraph *G, int32_t *labels)
+{
+  const int32_t n = G->n;
+  for (int32_t u = 0; u < n; u++)
+    labels[u] = u;
+
+  for (int32_t u = 0; u < n; u++)
+  {
+    for (int64_t j = G->row_ptr[u]; j < G->row_ptr[u + 1]; j++)
+    {
+      int32_t v = G->col_idx[j];
+      // Rows are symmetric, so every edge is seen once from its larger endpoint
+      if (v >= u)
+        continue;
+      int32_t ru = u;
+      while (labels[ru] != ru)
+      {
+        labels[ru] = labels[labels[ru]];
+        ru = labels[ru];
+      }
+      int32_t rv = v;
+      while (labels[rv] != rv)
+      {
+        labels[rv] = labels[labels[rv]];
+        rv = labels[rv];
+      }
+      if (ru < rv)
+        labels[rv] = ru;
+      else if (rv < ru)
+        labels[ru] = rv;
+    }
+  }
+
+  for (int32_t u = 0; u < n; u++)
+    labels[u] = labels[labels[u]];
+}
+
+// Shared state of one batch; threads claim graphs from next
+typedef struct
+{
+  const CSRGraph *const *graphs;
+  int32_t *const *labels;
+  size_t count;
+  atomic_size_t next;
+} BatchState;
+
+typedef struct
+{
+  BatchState *state;
+} BatchArgs;
+
+static void *batch_worker(void *arg)
+{
+  BatchState *state = ((BatchArgs *)arg)->state;
+  while (1)
+  {
+    size_t i = atomic_fetch_add_explicit(&state->next, 1, memory_order_relaxed);
+    if (i >= state->count)
+      break;
+    if (state->graphs[i]->m <= CC_CONTEXT_BATCH_SMALL_EDGES)
+      label_small_graph(state->graphs[i], state->labels[i]);
+  }
+  return NULL;
+}
+
+int cc_context_run_batch(CCContext *ctx, const CSRGraph *const *graphs, int32_t *const *labels, size_t count)
+{
+  if (count == 0)
+    return 0;
+
+  BatchArgs *args = (BatchArgs *)malloc((size_t)ctx->num_threads * sizeof(*args));
+  if (!args)
+  {
+    fprintf(stderr, "cc_context: memory allocation failed (batch)\n");
+    return -1;
+  }
+  BatchState state = {.graphs = graphs, .labels = labels, .count = count};
+  atomic_init(&state.next, 0);
+  for (int t = 0; t < ctx->num_threads; t++)
+    args[t].state = &state;
+
+  int threads = (size_t)ctx->num_threads < count ? ctx->num_threads : (int)count;
+  int rc = cc_pthread_pool_run(ctx->pool, threads, batch_worker, args, sizeof(*args));
+  free(args);
+  if (rc != 0)
+    return -1;
+
+  // Large graphs get the whole team and the reusable buffer, one after the other
+  for (size_t i = 0; i < count; i++)
+  {
+    if (graphs[i]->m <= CC_CONTEXT_BATCH_SMALL_EDGES)
+      continue;
+    // The buffer no longer holds the labels of the context's own graph
+    ctx->labeled = 0;
+    if (reserve_labels(ctx, graphs[i]->n) != 0)
+      return -1;
+    run_backend(ctx, graphs[i]);
+    memcpy(labels[i], (const int32_t *)ctx->labels, (size_t)graphs[i]->n * sizeof(int32_t));
+  }
+  return 0;
+}
@@ -0,0 +1,381 @@
+#include "cc_gpu.h"
+
+#include <cuda_runtime.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define GPU_THREADS_PER_BLOCK 256
+#define GPU_WARP_SIZE 32
+
+// Print the failing call and return -1 from the enclosing function
+#define GPU_CHECK(call, what)                                                          \
+  do                                                                                   \
+  {                                                                                    \
+    cudaError_t gpu_err = (call);                                                      \
+    if (gpu_err != cudaSuccess)                                                        \
+    {                                                                                  \
+      fprintf(stderr, "cc_gpu: %s failed: %s\n", (what), cudaGetErrorString(gpu_err)); \
+      return -1;                                                                       \
+    }                                                                                  \
+  } while (0)
+
+struct CCGpuGraph
+{
+  int32_t n;
+  int64_t m;
+  int64_t *row_ptr;  // device
+  int32_t *col_idx;  // device
+  int32_t *parent;   // device union-find parents, the labels after flattening
+  int32_t *worklist; // device: warp vertices from the front, block vertices from the back
+  int32_t *counters; // device: [0] warp vertices pushed, [1] first block vertex
+  void *staging[2];  // pinned upload buffers
+  size_t staging_bytes;
+  cudaStream_t streams[2];
+  cudaEvent_t drained[2]; // the last transfer out of staging[i] has finished
+  cudaEvent_t start, stop;
+  int blocks; // grid size of the grid-stride kernels
+};
+
+static double wall_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Root of v, pointing every vertex on the path at its grandparent on the way
+static __device__ int32_t representative(int32_t v, int32_t *parent)
+{
+  int32_t curr = parent[v];
+  if (curr != v)
+  {
+    int32_t next, prev = v;
+    while (curr > (next = parent[curr]))
+    {
+      parent[prev] = next;
+      prev = curr;
+      curr = next;
+    }
+  }
+  return curr;
+}
+
+// Merge the trees of *vstat and ostat, hooking the larger root under the smaller one. A
+// failed CAS means the root was hooked meanwhile, so the hook is retried from its new parent
+static __device__ void hook(int32_t *vstat, int32_t ostat, int32_t *parent)
+{
+  int32_t v = *vstat;
+  while (v != ostat)
+  {
+    if (v < ostat)
+    {
+      int32_t ret = atomicCAS(&parent[ostat], ostat, v);
+      if (ret == ostat)
+        break;
+      ostat = ret;
+    }
+    else
+    {
+      int32_t ret = atomicCAS(&parent[v], v, ostat);
+      if (ret == v)
+        break;
+      v = ret;
+    }
+  }
+  *vstat = v;
+}
+
+// Start every vertex at its smallest neighbor when that is smaller than itself (rows are sorted)
+static __global__ void init_kernel(int32_t n, const int64_t *row_ptr, const int32_t *col_idx, int32_t *parent,
+                                   int32_t *counters)
+{
+  const int32_t stride = gridDim.x * blockDim.x;
+  int32_t v = blockIdx.x * blockDim.x + threadIdx.x;
+  if (v == 0)
+  {
+    counters[0] = 0;
+    counters[1] = n;
+  }
+  for (; v < n; v += stride)
+  {
+    const int64_t beg = row_ptr[v];
+    parent[v] = (beg < row_ptr[v + 1] && col_idx[beg] < v) ? col_idx[beg] : v;
+  }
+}
+
+// Thread per vertex for low-degree rows; larger rows go to the worklist for the warp and block kernels.
+// Every edge is hooked once, from its larger endpoint
+static __global__ void hook_thread_kernel(int32_t n, const int64_t *row_ptr, const int32_t *col_idx,
+                                          int32_t *parent, int32_t *worklist, int32_t *counters)
+{
+  const int32_t stride = gridDim.x * blockDim.x;
+  for (int32_t v = blockIdx.x * blockDim.x + threadIdx.x; v < n; v += stride)
+  {
+    const int64_t beg = row_ptr[v];
+    const int64_t end = row_ptr[v + 1];
+    const int64_t degree = end - beg;
+    if (degree > CC_GPU_BLOCK_DEGREE)
+    {
+      worklist[atomicSub(&counters[1], 1) - 1] = v;
+      continue;
+    }
+    if (degree > CC_GPU_WARP_DEGREE)
+    {
+      worklist[atomicAdd(&counters[0], 1)] = v;
+      continue;
+    }
+
+    int32_t vstat = representative(v, parent);
+    for (int64_t j = beg; j < end; j++)
+    {
+      const int32_t u = col_idx[j];
+      if (u >= v)
+        break;
+      hook(&vstat, representative(u, parent), parent);
+    }
+  }
+}
+
+// Warp per medium-degree vertex, lanes striding over the row
+static __global__ void hook_warp_kernel(const int64_t *row_ptr, const int32_t *col_idx, int32_t *parent,
+                                        const int32_t *worklist, const int32_t *counters)
+{
+  const int32_t lane = threadIdx.x % GPU_WARP_SIZE;
+  const int32_t warps = gridDim.x * blockDim.x / GPU_WARP_SIZE;
+  const int32_t count = counters[0];
+  for (int32_t w = (blockIdx.x * blockDim.x + threadIdx.x) / GPU_WARP_SIZE; w < count; w += warps)
+  {
+    const int32_t v = worklist[w];
+    int32_t vstat = representative(v, parent);
+    for (int64_t j = row_ptr[v] + lane; j < row_ptr[v + 1]; j += GPU_WARP_SIZE)
+    {
+      const int32_t u = col_idx[j];
+      if (u < v)
+        hook(&vstat, representative(u, parent), parent);
+    }
+  }
+}
+
+// Block per high-degree vertex
+static __global__ void hook_block_kernel(int32_t n, const int64_t *row_ptr, const int32_t *col_idx,
+                                         int32_t *parent, const int32_t *worklist, const int32_t *counters)
+{
+  for (int32_t i = counters[1] + blockIdx.x; i < n; i += gridDim.x)
+  {
+    const int32_t v = worklist[i];
+    int32_t vstat = representative(v, parent);
+    for (int64_t j = row_ptr[v] + threadIdx.x; j < row_ptr[v + 1]; j += blockDim.x)
+    {
+      const int32_t u = col_idx[j];
+      if (u < v)
+        hook(&vstat, representative(u, parent), parent);
+    }
+  }
+}
+
+// Point every vertex straight at its root
+static __global__ void flatten_kernel(int32_t n, int32_t *parent)
+{
+  const int32_t stride = gridDim.x * blockDim.x;
+  for (int32_t v = blockIdx.x * blockDim.x + threadIdx.x; v < n; v += stride)
+  {
+    int32_t root = parent[v];
+    const int32_t old = root;
+    while (root > parent[root])
+      root = parent[root];
+    if (root != old)
+      parent[v] = root;
+  }
+}
+
+int cc_gpu_init(int device, char *name, size_t name_size)
+{
+  int count = 0;
+  GPU_CHECK(cudaGetDeviceCount(&count), "cudaGetDeviceCount");
+  if (device < 0 || device >= count)
+  {
+    fprintf(stderr, "cc_gpu: device %d not available (%d device%s)\n", device, count, count == 1 ? "" : "s");
+    return -1;
+  }
+  GPU_CHECK(cudaSetDevice(device), "cudaSetDevice");
+  cudaDeviceProp prop;
+  GPU_CHECK(cudaGetDeviceProperties(&prop, device), "cudaGetDeviceProperties");
+  if (name && name_size > 0)
+    snprintf(name, name_size, "%s", prop.name);
+  return 0;
+}
+
+CCGpuGraph *cc_gpu_graph_create(int32_t n, int64_t m)
+{
+  CCGpuGraph *g = (CCGpuGraph *)calloc(1, sizeof(*g));
+  if (!g)
+  {
+    fprintf(stderr, "cc_gpu: memory allocation failed\n");
+    return NULL;
+  }
+  g->n = n;
+  g->m = m;
+
+  int device = 0, sms = 1;
+  cudaError_t err = cudaGetDevice(&device);
+  if (err == cudaSuccess)
+    err = cudaDeviceGetAttribute(&sms, cudaDevAttrMultiProcessorCount, device);
+  // Enough resident blocks to fill every SM, the kernels stride over the rest
+  g->blocks = sms * (2048 / GPU_THREADS_PER_BLOCK);
+
+  const size_t vertices = (size_t)(n > 0 ? n : 1);
+  if (err == cudaSuccess)
+    err = cudaMalloc((void **)&g->row_ptr, (vertices + 1) * sizeof(int64_t));
+  if (err == cudaSuccess)
+    err = cudaMalloc((void **)&g->col_idx, (size_t)(m > 0 ? m : 1) * sizeof(int32_t));
+  if (err == cudaSuccess)
+    err = cudaMalloc((void **)&g->parent, vertices * sizeof(int32_t));
+  if (err == cudaSuccess)
+    err = cudaMalloc((void **)&g->worklist, vertices * sizeof(int32_t));
+  if (err == cudaSuccess)
+    err = cudaMalloc((void **)&g->counters, 2 * sizeof(int32_t));
+  for (int i = 0; i < 2 && err == cudaSuccess; i++)
+  {
+    err = cudaStreamCreateWithFlags(&g->streams[i], cudaStreamNonBlocking);
+    if (err == cudaSuccess)
+      err = cudaEventCreateWithFlags(&g->drained[i], cudaEventDisableTiming);
+  }
+  if (err == cudaSuccess)
+    err = cudaEventCreate(&g->start);
+  if (err == cudaSuccess)
+    err = cudaEventCreate(&g->stop);
+  if (err != cudaSuccess)
+  {
+    fprintf(stderr, "cc_gpu: device allocation failed (n=%d, m=%lld): %s\n", n, (long long)m,
+            cudaGetErrorString(err));
+    cc_gpu_graph_destroy(g);
+    return NULL;
+  }
+  return g;
+}
+
+void cc_gpu_graph_destroy(CCGpuGraph *g)
+{
+  if (!g)
+    return;
+  cudaFree(g->row_ptr);
+  cudaFree(g->col_idx);
+  cudaFree(g->parent);
+  cudaFree(g->worklist);
+  cudaFree(g->counters);
+  for (int i = 0; i < 2; i++)
+  {
+    if (g->staging[i])
+      cudaFreeHost(g->staging[i]);
+    if (g->streams[i])
+      cudaStreamDestroy(g->streams[i]);
+    if (g->drained[i])
+      cudaEventDestroy(g->drained[i]);
+  }
+  if (g->start)
+    cudaEventDestroy(g->start);
+  if (g->stop)
+    cudaEventDestroy(g->stop);
+  free(g);
+}
+
+// (Re)allocate the two pinned staging buffers with chunk_bytes each
+static int reserve_staging(CCGpuGraph *g, size_t chunk_bytes)
+{
+  if (g->staging_bytes == chunk_bytes && g->staging[0])
+    return 0;
+  for (int i = 0; i < 2; i++)
+  {
+    if (g->staging[i])
+      cudaFreeHost(g->staging[i]);
+    g->staging[i] = NULL;
+  }
+  g->staging_bytes = 0;
+  for (int i = 0; i < 2; i++)
+    GPU_CHECK(cudaMallocHost(&g->staging[i], chunk_bytes), "cudaMallocHost (staging)");
+  g->staging_bytes = chunk_bytes;
+  return 0;
+}
+
+// Stream bytes from src to the device through the staging buffers, alternating between them.
+// *slot carries the next buffer over from the previous array so the pipeline never drains
+static int upload_array(CCGpuGraph *g, void *dst, const void *src, size_t bytes, int *slot, int *chunks)
+{
+  for (size_t offset = 0; offset < bytes; offset += g->staging_bytes)
+  {
+    const size_t len = (bytes - offset < g->staging_bytes) ? bytes - offset : g->staging_bytes;
+    const int s = *slot;
+    *slot ^= 1;
+    // The buffer is free once its previous chunk has reached the device
+    GPU_CHECK(cudaEventSynchronize(g->drained[s]), "cudaEventSynchronize");
+    memcpy(g->staging[s], (const char *)src + offset, len);
+    GPU_CHECK(cudaMemcpyAsync((char *)dst + offset, g->staging[s], len, cudaMemcpyHostToDevice, g->streams[s]),
+              "cudaMemcpyAsync (upload)");
+    GPU_CHECK(cudaEventRecord(g->drained[s], g->streams[s]), "cudaEventRecord");
+    (*chunks)++;
+  }
+  return 0;
+}
+
+int cc_gpu_upload(CCGpuGraph *g, const CSRGraph *G, size_t chunk_bytes, GPURunStats *stats)
+{
+  if (G->n != g->n || G->m != g->m)
+  {
+    fprintf(stderr, "cc_gpu: graph size does not match the device buffers\n");
+    return -1;
+  }
+  if (chunk_bytes == 0)
+    chunk_bytes = CC_GPU_DEFAULT_CHUNK_BYTES;
+  if (reserve_staging(g, chunk_bytes) != 0)
+    return -1;
+
+  const double start = wall_seconds();
+  int slot = 0, chunks = 0;
+  if (upload_array(g, g->row_ptr, G->row_ptr, ((size_t)G->n + 1) * sizeof(int64_t), &slot, &chunks) != 0 ||
+      upload_array(g, g->col_idx, G->col_idx, (size_t)G->m * sizeof(int32_t), &slot, &chunks) != 0)
+    return -1;
+  for (int i = 0; i < 2; i++)
+    GPU_CHECK(cudaStreamSynchronize(g->streams[i]), "cudaStreamSynchronize (upload)");
+
+  if (stats)
+  {
+    stats->upload_seconds = wall_seconds() - start;
+    stats->chunks = chunks;
+  }
+  return 0;
+}
+
+int cc_gpu_components(CCGpuGraph *g, int32_t *labels, GPURunStats *stats)
+{
+  const int32_t n = g->n;
+  float kernel_ms = 0.0f;
+  if (n > 0)
+  {
+    GPU_CHECK(cudaEventRecord(g->start, 0), "cudaEventRecord");
+    init_kernel<<<g->blocks, GPU_THREADS_PER_BLOCK>>>(n, g->row_ptr, g->col_idx, g->parent, g->counters);
+    hook_thread_kernel<<<g->blocks, GPU_THREADS_PER_BLOCK>>>(n, g->row_ptr, g->col_idx, g->parent, g->worklist,
+                                                             g->counters);
+    hook_warp_kernel<<<g->blocks, GPU_THREADS_PER_BLOCK>>>(g->row_ptr, g->col_idx, g->parent, g->worklist,
+                                                           g->counters);
+    hook_block_kernel<<<g->blocks, GPU_THREADS_PER_BLOCK>>>(n, g->row_ptr, g->col_idx, g->parent, g->worklist,
+                                                            g->counters);
+    flatten_kernel<<<g->blocks, GPU_THREADS_PER_BLOCK>>>(n, g->parent);
+    GPU_CHECK(cudaGetLastError(), "kernel launch");
+    GPU_CHECK(cudaEventRecord(g->stop, 0), "cudaEventRecord");
+    GPU_CHECK(cudaEventSynchronize(g->stop), "kernels");
+    GPU_CHECK(cudaEventElapsedTime(&kernel_ms, g->start, g->stop), "cudaEventElapsedTime");
+  }
+
+  const double start = wall_seconds();
+  if (n > 0)
+    GPU_CHECK(cudaMemcpy(labels, g->parent, (size_t)n * sizeof(int32_t), cudaMemcpyDeviceToHost),
+              "cudaMemcpy (labels)");
+  if (stats)
+  {
+    stats->kernel_seconds = (double)kernel_ms * 1e-3;
+    stats->download_seconds = wall_seconds() - start;
+  }
+  return 0;
+}
@@ -0,0 +1,277 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "cc_incremental.h"
+#include "cc_alloc.h"
+#include "thread_util.h"
+#include "union_find.h"
+
+struct CCIncremental
+{
+  _Atomic int32_t *parent; // union-find forest, parent[v] <= v
+  int32_t n;               // vertices in use
+  int32_t capacity;        // allocated entries of parent
+  int32_t components;      // roots among the first n vertices
+  int num_threads;         // threads used for large batches
+};
+
+typedef struct
+{
+  _Atomic int32_t *parent;
+  const int32_t *labels;
+  _Atomic int32_t *first; // first[l]: smallest vertex carrying label l
+  int32_t n;
+  int64_t *roots;         // per-thread root counts
+} SeedCtx;
+
+static void seed_first(int thread_id, int num_threads, void *arg)
+{
+  SeedCtx *ctx = (SeedCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+  {
+    _Atomic int32_t *slot = &ctx->first[ctx->labels[v]];
+    int32_t current = atomic_load_explicit(slot, memory_order_relaxed);
+    while (v < current &&
+           !atomic_compare_exchange_weak_explicit(slot, &current, v, memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+  }
+}
+
+// Hook every vertex directly under the smallest vertex of its label
+static void seed_parent(int thread_id, int num_threads, void *arg)
+{
+  SeedCtx *ctx = (SeedCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  int64_t roots = 0;
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+  {
+    int32_t p = atomic_load_explicit(&ctx->first[ctx->labels[v]], memory_order_relaxed);
+    atomic_init(&ctx->parent[v], p);
+    roots += (p == v);
+  }
+  ctx->roots[thread_id] = roots;
+}
+
+static void seed_init(int thread_id, int num_threads, void *arg)
+{
+  SeedCtx *ctx = (SeedCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+  {
+    if (ctx->labels)
+      atomic_init(&ctx->first[v], INT32_MAX);
+    else
+      atomic_init(&ctx->parent[v], v);
+  }
+}
+
+CCIncremental *cc_incremental_create(int32_t n, const int32_t *labels, int num_threads)
+{
+  if (n < 0)
+    return NULL;
+  if (labels)
+  {
+    for (int32_t v = 0; v < n; v++)
+    {
+      if (labels[v] < 0 || labels[v] >= n)
+      {
+        fprintf(stderr, "Invalid seed label %d for vertex %d (n=%d)\n", labels[v], v, n);
+        return NULL;
+      }
+    }
+  }
+
+  CCIncremental *cc = calloc(1, sizeof(CCIncremental));
+  if (!cc)
+    return NULL;
+  cc->num_threads = (num_threads > 0) ? num_threads : thread_util_default_threads();
+  cc->n = n;
+  cc->capacity = (n > 0) ? n : 1;
+  cc->parent = cc_alloc(sizeof(*cc->parent) * (size_t)cc->capacity);
+  SeedCtx ctx = {.parent = cc->parent, .labels = labels, .n = n};
+  ctx.roots = calloc((size_t)cc->num_threads, sizeof(int64_t));
+  ctx.first = labels ? cc_alloc(sizeof(*ctx.first) * (size_t)cc->capacity) : NULL;
+  if (!cc->parent || !ctx.roots || (labels && !ctx.first))
+  {
+    fprintf(stderr, "Memory allocation failed (incremental CC)\n");
+    free(ctx.roots);
+    cc_free(ctx.first);
+    cc_incremental_destroy(cc);
+    return NULL;
+  }
+
+  thread_util_parallel_run(cc->num_threads, seed_init, &ctx);
+  if (labels)
+  {
+    thread_util_parallel_run(cc->num_threads, seed_first, &ctx);
+    thread_util_parallel_run(cc->num_threads, seed_parent, &ctx);
+    for (int t = 0; t < cc->num_threads; t++)
+      cc->components += (int32_t)ctx.roots[t];
+  }
+  else
+  {
+    cc->components = n;
+  }
+
+  free(ctx.roots);
+  cc_free(ctx.first);
+  return cc;
+}
+
+void cc_incremental_destroy(CCIncremental *cc)
+{
+  if (!cc)
+    return;
+  cc_free(cc->parent);
+  free(cc);
+}
+
+// Make room for vertices [cc->n, n) as singletons; amortized over the batches that add them
+static int grow_vertices(CCIncremental *cc, int32_t n)
+{
+  if (n <= cc->n)
+    return 0;
+  if (n > cc->capacity)
+  {
+    int64_t capacity = 2 * (int64_t)cc->capacity;
+    if (capacity < n)
+      capacity = n;
+    if (capacity > INT32_MAX)
+      capacity = INT32_MAX;
+    _Atomic int32_t *parent = cc_realloc(cc->parent, sizeof(*parent) * (size_t)capacity);
+    if (!parent)
+    {
+      fprintf(stderr, "Memory allocation failed (incremental CC, %d vertices)\n", n);
+      return 1;
+    }
+    cc->parent = parent;
+    cc->capacity = (int32_t)capacity;
+  }
+  for (int32_t v = cc->n; v < n; v++)
+    atomic_init(&cc->parent[v], v);
+  cc->components += n - cc->n;
+  cc->n = n;
+  return 0;
+}
+
+typedef struct
+{
+  _Atomic int32_t *parent;
+  const CCEdge *edges;
+  int64_t count;
+  int64_t *hooks; // per-thread successful links
+} BatchCtx;
+
+static void batch_link(int thread_id, int num_threads, void *arg)
+{
+  BatchCtx *ctx = (BatchCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->count, num_threads, thread_id, &start, &end);
+  int64_t hooks = 0;
+  for (long long i = start; i < end; i++)
+    hooks += uf_link(ctx->parent, ctx->edges[i].u, ctx->edges[i].v);
+  ctx->hooks[thread_id] = hooks;
+}
+
+// Flatten the paths above the batch endpoints so later finds stay short
+static void batch_compress(int thread_id, int num_threads, void *arg)
+{
+  BatchCtx *ctx = (BatchCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->count, num_threads, thread_id, &start, &end);
+  for (long long i = start; i < end; i++)
+  {
+    uf_compress(ctx->parent, ctx->edges[i].u);
+    uf_compress(ctx->parent, ctx->edges[i].v);
+  }
+}
+
+int64_t cc_incremental_add_edges(CCIncremental *cc, const CCEdge *edges, int64_t count)
+{
+  if (count <= 0)
+    return (count == 0) ? 0 : -1;
+
+  int32_t max_vertex = -1;
+  for (int64_t i = 0; i < count; i++)
+  {
+    if (edges[i].u < 0 || edges[i].v < 0 || edges[i].u == INT32_MAX || edges[i].v == INT32_MAX)
+    {
+      fprintf(stderr, "Invalid edge (%d, %d) in update batch\n", edges[i].u, edges[i].v);
+      return -1;
+    }
+    if (edges[i].u > max_vertex)
+      max_vertex = edges[i].u;
+    if (edges[i].v > max_vertex)
+      max_vertex = edges[i].v;
+  }
+  if (grow_vertices(cc, max_vertex + 1) != 0)
+    return -1;
+
+  int num_threads = (count >= CC_INCREMENTAL_PARALLEL_MIN_EDGES) ? cc->num_threads : 1;
+  int64_t local_hooks = 0;
+  BatchCtx ctx = {.parent = cc->parent, .edges = edges, .count = count};
+  ctx.hooks = (num_threads > 1) ? calloc((size_t)num_threads, sizeof(int64_t)) : &local_hooks;
+  if (!ctx.hooks)
+  {
+    fprintf(stderr, "Memory allocation failed (incremental CC batch)\n");
+    return -1;
+  }
+
+  thread_util_parallel_run(num_threads, batch_link, &ctx);
+  thread_util_parallel_run(num_threads, batch_compress, &ctx);
+
+  int64_t merged = 0;
+  for (int t = 0; t < num_threads; t++)
+    merged += ctx.hooks[t];
+  if (num_threads > 1)
+    free(ctx.hooks);
+  cc->components -= (int32_t)merged;
+  return merged;
+}
+
+int32_t cc_incremental_query(CCIncremental *cc, int32_t v)
+{
+  if (v < 0 || v >= cc->n)
+    return -1;
+  uf_compress(cc->parent, v);
+  return atomic_load_explicit(&cc->parent[v], memory_order_relaxed);
+}
+
+int32_t cc_incremental_num_vertices(const CCIncremental *cc)
+{
+  return cc->n;
+}
+
+int32_t cc_incremental_num_components(const CCIncremental *cc)
+{
+  return cc->components;
+}
+
+typedef struct
+{
+  _Atomic int32_t *parent;
+  int32_t *labels;
+  int32_t n;
+} SnapshotCtx;
+
+static void snapshot_labels(int thread_id, int num_threads, void *arg)
+{
+  SnapshotCtx *ctx = (SnapshotCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+    ctx->labels[v] = uf_find(ctx->parent, v);
+}
+
+void cc_incremental_labels(CCIncremental *cc, int32_t *labels)
+{
+  SnapshotCtx ctx = {.parent = cc->parent, .labels = labels, .n = cc->n};
+  thread_util_parallel_run(cc->num_threads, snapshot_labels, &ctx);
+}
@@ -0,0 +1,539 @@
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#include "cc_mpi.h"
+#include "cc_alloc.h"
+#include "graph.h"
+#include "union_find.h"
+
+// Largest element count handed to a single MPI point-to-point call
+#define MPI_CHUNK_ELEMS (1 << 28)
+
+// Worst-case bytes of one varint-encoded (index delta, label) pair
+#define MPI_MAX_UPDATE_BYTES 10
+
+#define TAG_ROW_PTR 1
+#define TAG_COL_IDX 2
+
+static int send_array(const void *buf, int64_t count, MPI_Datatype type, size_t elem_size, int dest, int tag,
+                      MPI_Comm comm)
+{
+  const char *p = (const char *)buf;
+  for (int64_t done = 0; done < count;)
+  {
+    int chunk = (int)((count - done < MPI_CHUNK_ELEMS) ? count - done : MPI_CHUNK_ELEMS);
+    if (MPI_Send(p + (size_t)done * elem_size, chunk, type, dest, tag, comm) != MPI_SUCCESS)
+      return 1;
+    done += chunk;
+  }
+  return 0;
+}
+
+static int recv_array(void *buf, int64_t count, MPI_Datatype type, size_t elem_size, int src, int tag,
+                      MPI_Comm comm)
+{
+  char *p = (char *)buf;
+  for (int64_t done = 0; done < count;)
+  {
+    int chunk = (int)((count - done < MPI_CHUNK_ELEMS) ? count - done : MPI_CHUNK_ELEMS);
+    if (MPI_Recv(p + (size_t)done * elem_size, chunk, type, src, tag, comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+      return 1;
+    done += chunk;
+  }
+  return 0;
+}
+
+// Allocate the local rows of part for [first, last) with local_m edges
+static int alloc_part(MPIGraphPart *part, int64_t local_m)
+{
+  int32_t rows = part->last - part->first;
+  part->row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)rows + 1));
+  part->col_idx = cc_alloc(sizeof(int32_t) * (size_t)(local_m > 0 ? local_m : 1));
+  return (part->row_ptr && part->col_idx) ? 0 : 1;
+}
+
+// Copy the rows [first, last) of G into part, rebasing the offsets to zero
+static int copy_rows(const CSRGraph *G, MPIGraphPart *part)
+{
+  int64_t base = G->row_ptr[part->first];
+  int64_t local_m = G->row_ptr[part->last] - base;
+  if (alloc_part(part, local_m) != 0)
+    return 1;
+  for (int32_t u = part->first; u <= part->last; u++)
+    part->row_ptr[u - part->first] = G->row_ptr[u] - base;
+  memcpy(part->col_idx, G->col_idx + base, sizeof(int32_t) * (size_t)local_m);
+  return 0;
+}
+
+static int is_binary_csr(const char *path)
+{
+  const char *ext = strrchr(path, '.');
+  return ext && strcasecmp(ext, ".csr") == 0;
+}
+
+int cc_mpi_distribute_graph(const char *path, MPIGraphPart *out, MPI_Comm comm)
+{
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+  memset(out, 0, sizeof(*out));
+  out->bounds = malloc(sizeof(int32_t) * ((size_t)size + 1));
+  int status = out->bounds ? 0 : 1;
+
+  CSRGraph G;
+  memset(&G, 0, sizeof(G));
+  const int every_rank_maps = is_binary_csr(path);
+  if (status == 0 && (every_rank_maps || rank == 0))
+  {
+    // Mapped .csr files only page in the rows each rank reads
+    status = every_rank_maps ? load_csr_from_bin(path, &G) : load_csr_from_file(path, 1, 1, &G);
+    if (status != 0)
+      fprintf(stderr, "Rank %d: failed to load graph from %s\n", rank, path);
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm);
+  if (status != 0)
+  {
+    free_csr(&G);
+    cc_mpi_free_graph(out);
+    return 1;
+  }
+
+  int64_t header[2] = {G.n, G.m};
+  if (!every_rank_maps)
+    MPI_Bcast(header, 2, MPI_INT64_T, 0, comm);
+  out->n = (int32_t)header[0];
+  out->m = header[1];
+
+  if (every_rank_maps || rank == 0)
+  {
+    for (int p = 0; p < size; p++)
+    {
+      int32_t start, end;
+      csr_edge_balanced_rows(G.row_ptr, G.n, size, p, &start, &end);
+      out->bounds[p] = start;
+      out->bounds[p + 1] = end;
+    }
+  }
+  if (!every_rank_maps)
+    MPI_Bcast(out->bounds, size + 1, MPI_INT32_T, 0, comm);
+  out->first = out->bounds[rank];
+  out->last = out->bounds[rank + 1];
+
+  if (every_rank_maps)
+  {
+    status = copy_rows(&G, out);
+  }
+  else if (rank == 0)
+  {
+    for (int p = 1; p < size; p++)
+    {
+      int32_t start = out->bounds[p], end = out->bounds[p + 1];
+      int64_t base = G.row_ptr[start];
+      if (send_array(G.row_ptr + start, (int64_t)end - start + 1, MPI_INT64_T, sizeof(int64_t), p, TAG_ROW_PTR,
+                     comm) != 0 ||
+          send_array(G.col_idx + base, G.row_ptr[end] - base, MPI_INT32_T, sizeof(int32_t), p, TAG_COL_IDX,
+                     comm) != 0)
+        status = 1;
+    }
+    if (status == 0)
+      status = copy_rows(&G, out);
+  }
+  else
+  {
+    int32_t rows = out->last - out->first;
+    int64_t *row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)rows + 1));
+    status = row_ptr ? recv_array(row_ptr, rows + 1, MPI_INT64_T, sizeof(int64_t), 0, TAG_ROW_PTR, comm) : 1;
+    if (status == 0)
+    {
+      int64_t base = row_ptr[0];
+      int64_t local_m = row_ptr[rows] - base;
+      status = alloc_part(out, local_m);
+      if (status == 0)
+      {
+        for (int32_t i = 0; i <= rows; i++)
+          out->row_ptr[i] = row_ptr[i] - base;
+        status = recv_array(out->col_idx, local_m, MPI_INT32_T, sizeof(int32_t), 0, TAG_COL_IDX, comm);
+      }
+    }
+    cc_free(row_ptr);
+  }
+  free_csr(&G);
+
+  MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm);
+  if (status != 0)
+  {
+    if (rank == 0)
+      fprintf(stderr, "Failed to distribute graph rows\n");
+    cc_mpi_free_graph(out);
+    return 2;
+  }
+  return 0;
+}
+
+void cc_mpi_free_graph(MPIGraphPart *part)
+{
+  cc_free(part->row_ptr);
+  cc_free(part->col_idx);
+  free(part->bounds);
+  part->row_ptr = NULL;
+  part->col_idx = NULL;
+  part->bounds = NULL;
+}
+
+static inline size_t varint_put(unsigned char *p, uint32_t value)
+{
+  size_t len = 0;
+  while (value >= 0x80)
+  {
+    p[len++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  p[len++] = (unsigned char)value;
+  return len;
+}
+
+static inline size_t varint_get(const unsigned char *p, uint32_t *value)
+{
+  uint32_t result = 0;
+  size_t len = 0;
+  int shift = 0;
+  unsigned char byte;
+  do
+  {
+    byte = p[len++];
+    result |= (uint32_t)(byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  *value = result;
+  return len;
+}
+
+static int cmp_int32(const void *a, const void *b)
+{
+  int32_t x = *(const int32_t *)a;
+  int32_t y = *(const int32_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Index of id in the sorted array ids[0, count)
+static int64_t find_sorted(const int32_t *ids, int64_t count, int32_t id)
+{
+  int64_t lo = 0, hi = count;
+  while (lo < hi)
+  {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (ids[mid] < id)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// Exchange state built once per run
+typedef struct
+{
+  int size;
+  int32_t *ghost_ids;      // sorted remote neighbors, grouped by owner as a side effect
+  int32_t *ghost_label;    // current label of every ghost
+  int64_t num_ghosts;
+  int *ghost_offset;       // size + 1: ghosts owned by rank p start at ghost_offset[p]
+  int64_t *cross_ptr;      // local rows + 1: cross edges of every local vertex
+  int32_t *cross_ghost;    // ghost index of every cross edge
+  int32_t *send_list;      // local vertices requested by each rank, in the rank's ghost order
+  int32_t *sent_label;     // label last sent for every send list entry (-1 = never)
+  int *send_offset;        // size + 1
+  unsigned char *send_buf;
+  unsigned char *recv_buf;
+  size_t recv_capacity;
+  int *send_counts, *send_displs, *recv_counts, *recv_displs;
+} Exchange;
+
+static void free_exchange(Exchange *ex)
+{
+  cc_free(ex->ghost_ids);
+  cc_free(ex->ghost_label);
+  free(ex->ghost_offset);
+  cc_free(ex->cross_ptr);
+  cc_free(ex->cross_ghost);
+  free(ex->send_list);
+  free(ex->sent_label);
+  free(ex->send_offset);
+  free(ex->send_buf);
+  free(ex->recv_buf);
+  free(ex->send_counts);
+  free(ex->send_displs);
+  free(ex->recv_counts);
+  free(ex->recv_displs);
+}
+
+// Find the ghosts, index the cross edges and tell every owner which of its vertices we read
+static int build_exchange(const MPIGraphPart *part, Exchange *ex, MPI_Comm comm)
+{
+  const int32_t rows = part->last - part->first;
+  const int64_t local_m = part->row_ptr[rows];
+  const int size = ex->size;
+
+  ex->cross_ptr = cc_alloc(sizeof(int64_t) * ((size_t)rows + 1));
+  ex->ghost_offset = calloc((size_t)size + 1, sizeof(int));
+  ex->send_offset = calloc((size_t)size + 1, sizeof(int));
+  ex->send_counts = malloc(sizeof(int) * (size_t)size);
+  ex->send_displs = malloc(sizeof(int) * (size_t)size);
+  ex->recv_counts = malloc(sizeof(int) * (size_t)size);
+  ex->recv_displs = malloc(sizeof(int) * (size_t)size);
+  if (!ex->cross_ptr || !ex->ghost_offset || !ex->send_offset || !ex->send_counts || !ex->send_displs ||
+      !ex->recv_counts || !ex->recv_displs)
+    return 1;
+
+  int64_t cross = 0;
+  ex->cross_ptr[0] = 0;
+  for (int32_t u = 0; u < rows; u++)
+  {
+    for (int64_t j = part->row_ptr[u]; j < part->row_ptr[u + 1]; j++)
+    {
+      int32_t w = part->col_idx[j];
+      cross += (w < part->first || w >= part->last);
+    }
+    ex->cross_ptr[u + 1] = cross;
+  }
+
+  ex->ghost_ids = cc_alloc(sizeof(int32_t) * (size_t)(cross > 0 ? cross : 1));
+  ex->cross_ghost = cc_alloc(sizeof(int32_t) * (size_t)(cross > 0 ? cross : 1));
+  if (!ex->ghost_ids || !ex->cross_ghost)
+    return 1;
+  int64_t k = 0;
+  for (int64_t j = 0; j < local_m; j++)
+  {
+    int32_t w = part->col_idx[j];
+    if (w < part->first || w >= part->last)
+      ex->ghost_ids[k++] = w;
+  }
+  qsort(ex->ghost_ids, (size_t)cross, sizeof(int32_t), cmp_int32);
+  int64_t unique = 0;
+  for (int64_t i = 0; i < cross; i++)
+  {
+    if (unique == 0 || ex->ghost_ids[unique - 1] != ex->ghost_ids[i])
+      ex->ghost_ids[unique++] = ex->ghost_ids[i];
+  }
+  ex->num_ghosts = unique;
+  if (unique > INT_MAX)
+    return 1;
+
+  // Cross edges by ghost index; a ghost starts with its own ID as label
+  k = 0;
+  for (int64_t j = 0; j < local_m; j++)
+  {
+    int32_t w = part->col_idx[j];
+    if (w < part->first || w >= part->last)
+      ex->cross_ghost[k++] = (int32_t)find_sorted(ex->ghost_ids, unique, w);
+  }
+  ex->ghost_label = cc_alloc(sizeof(int32_t) * (size_t)(unique > 0 ? unique : 1));
+  if (!ex->ghost_label)
+    return 1;
+  memcpy(ex->ghost_label, ex->ghost_ids, sizeof(int32_t) * (size_t)unique);
+
+  // Owners hold contiguous ranges, so the sorted ghosts are grouped by owner
+  for (int p = 0; p < size; p++)
+    ex->ghost_offset[p + 1] = (int)find_sorted(ex->ghost_ids, unique, part->bounds[p + 1]);
+  for (int p = 0; p < size; p++)
+  {
+    ex->send_counts[p] = ex->ghost_offset[p + 1] - ex->ghost_offset[p];
+    ex->send_displs[p] = ex->ghost_offset[p];
+  }
+  MPI_Alltoall(ex->send_counts, 1, MPI_INT, ex->recv_counts, 1, MPI_INT, comm);
+  int64_t requested = 0;
+  for (int p = 0; p < size; p++)
+  {
+    ex->recv_displs[p] = (int)requested;
+    requested += ex->recv_counts[p];
+    ex->send_offset[p + 1] = (int)requested;
+  }
+  if (requested > INT_MAX / MPI_MAX_UPDATE_BYTES)
+    return 1;
+
+  ex->send_list = malloc(sizeof(int32_t) * (size_t)(requested > 0 ? requested : 1));
+  ex->sent_label = malloc(sizeof(int32_t) * (size_t)(requested > 0 ? requested : 1));
+  ex->send_buf = malloc((size_t)MPI_MAX_UPDATE_BYTES * (size_t)(requested > 0 ? requested : 1));
+  if (!ex->send_list || !ex->sent_label || !ex->send_buf)
+    return 1;
+  MPI_Alltoallv(ex->ghost_ids, ex->send_counts, ex->send_displs, MPI_INT32_T, ex->send_list, ex->recv_counts,
+                ex->recv_displs, MPI_INT32_T, comm);
+  for (int64_t i = 0; i < requested; i++)
+  {
+    ex->send_list[i] -= part->first;
+    ex->sent_label[i] = -1;
+  }
+  return 0;
+}
+
+int cc_mpi_components(const MPIGraphPart *part, int32_t *local_labels, MPIRunStats *stats, MPI_Comm comm)
+{
+  const int32_t rows = part->last - part->first;
+  Exchange ex;
+  memset(&ex, 0, sizeof(ex));
+  MPI_Comm_size(comm, &ex.size);
+  _Atomic int32_t *parent = cc_alloc(sizeof(*parent) * (size_t)(rows > 0 ? rows : 1));
+  int32_t *component = cc_alloc(sizeof(int32_t) * (size_t)(rows > 0 ? rows : 1));
+
+  int status = (parent && component) ? 0 : 1;
+  MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm);
+  if (status == 0)
+    status = build_exchange(part, &ex, comm);
+  MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, comm);
+  if (status != 0)
+  {
+    fprintf(stderr, "Memory allocation failed (MPI CC)\n");
+    cc_free(parent);
+    cc_free(component);
+    free_exchange(&ex);
+    return 1;
+  }
+
+  // Local union-find over the edges with both endpoints owned here
+  for (int32_t u = 0; u < rows; u++)
+    atomic_init(&parent[u], u);
+  for (int32_t u = 0; u < rows; u++)
+  {
+    for (int64_t j = part->row_ptr[u]; j < part->row_ptr[u + 1]; j++)
+    {
+      int32_t w = part->col_idx[j];
+      if (w >= part->first && w < part->last)
+        uf_link(parent, u, w - part->first);
+    }
+  }
+  for (int32_t u = 0; u < rows; u++)
+  {
+    uf_compress(parent, u);
+    component[u] = part->first + u; // only the entries of roots are used
+  }
+
+  MPIRunStats local = {0};
+  for (;;)
+  {
+    // Pull the ghost labels into the local components
+    for (int32_t u = 0; u < rows; u++)
+    {
+      int32_t r = atomic_load_explicit(&parent[u], memory_order_relaxed);
+      for (int64_t j = ex.cross_ptr[u]; j < ex.cross_ptr[u + 1]; j++)
+      {
+        int32_t label = ex.ghost_label[ex.cross_ghost[j]];
+        if (label < component[r])
+          component[r] = label;
+      }
+    }
+
+    // One message per rank: varint (index delta, label) for every changed boundary vertex
+    int64_t sent = 0;
+    size_t bytes = 0;
+    for (int p = 0; p < ex.size; p++)
+    {
+      ex.send_displs[p] = (int)bytes;
+      int32_t previous = -1;
+      for (int i = ex.send_offset[p]; i < ex.send_offset[p + 1]; i++)
+      {
+        int32_t label = component[atomic_load_explicit(&parent[ex.send_list[i]], memory_order_relaxed)];
+        if (label == ex.sent_label[i])
+          continue;
+        int32_t index = i - ex.send_offset[p];
+        bytes += varint_put(ex.send_buf + bytes, (uint32_t)(index - previous));
+        bytes += varint_put(ex.send_buf + bytes, (uint32_t)label);
+        previous = index;
+        ex.sent_label[i] = label;
+        sent++;
+      }
+      ex.send_counts[p] = (int)bytes - ex.send_displs[p];
+    }
+    local.updates += sent;
+    local.bytes_sent += (int64_t)bytes;
+    local.raw_bytes += sent * 2 * (int64_t)sizeof(int32_t);
+
+    // Nothing sent anywhere means no ghost can change: the labels are final
+    int64_t any_sent = sent;
+    MPI_Allreduce(MPI_IN_PLACE, &any_sent, 1, MPI_INT64_T, MPI_MAX, comm);
+    if (any_sent == 0)
+      break;
+    local.rounds++;
+
+    MPI_Alltoall(ex.send_counts, 1, MPI_INT, ex.recv_counts, 1, MPI_INT, comm);
+    size_t recv_bytes = 0;
+    for (int p = 0; p < ex.size; p++)
+    {
+      ex.recv_displs[p] = (int)recv_bytes;
+      recv_bytes += (size_t)ex.recv_counts[p];
+    }
+    if (recv_bytes > ex.recv_capacity)
+    {
+      unsigned char *buf = realloc(ex.recv_buf, recv_bytes);
+      if (!buf)
+      {
+        fprintf(stderr, "Memory allocation failed (MPI CC receive buffer)\n");
+        MPI_Abort(comm, EXIT_FAILURE);
+      }
+      ex.recv_buf = buf;
+      ex.recv_capacity = recv_bytes;
+    }
+    MPI_Alltoallv(ex.send_buf, ex.send_counts, ex.send_displs, MPI_BYTE, ex.recv_buf, ex.recv_counts,
+                  ex.recv_displs, MPI_BYTE, comm);
+
+    for (int p = 0; p < ex.size; p++)
+    {
+      const unsigned char *pos = ex.recv_buf + ex.recv_displs[p];
+      const unsigned char *end = pos + ex.recv_counts[p];
+      int64_t index = -1;
+      while (pos < end)
+      {
+        uint32_t delta, label;
+        pos += varint_get(pos, &delta);
+        pos += varint_get(pos, &label);
+        index += delta;
+        int32_t *ghost = &ex.ghost_label[ex.ghost_offset[p] + index];
+        if ((int32_t)label < *ghost)
+          *ghost = (int32_t)label;
+      }
+    }
+  }
+
+  for (int32_t u = 0; u < rows; u++)
+    local_labels[u] = component[atomic_load_explicit(&parent[u], memory_order_relaxed)];
+  if (stats)
+    *stats = local;
+
+  cc_free(parent);
+  cc_free(component);
+  free_exchange(&ex);
+  return 0;
+}
+
+int cc_mpi_gather_labels(const MPIGraphPart *part, const int32_t *local_labels, int32_t *labels, int root,
+                         MPI_Comm comm)
+{
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+  int *counts = NULL, *displs = NULL;
+  if (rank == root)
+  {
+    counts = malloc(sizeof(int) * (size_t)size);
+    displs = malloc(sizeof(int) * (size_t)size);
+    if (!counts || !displs)
+    {
+      fprintf(stderr, "Memory allocation failed (MPI label gather)\n");
+      MPI_Abort(comm, EXIT_FAILURE);
+    }
+    for (int p = 0; p < size; p++)
+    {
+      counts[p] = part->bounds[p + 1] - part->bounds[p];
+      displs[p] = part->bounds[p];
+    }
+  }
+  int rc = MPI_Gatherv(local_labels, part->last - part->first, MPI_INT32_T, labels, counts, displs, MPI_INT32_T,
+                       root, comm);
+  free(counts);
+  free(displs);
+  return rc == MPI_SUCCESS ? 0 : 1;
+}
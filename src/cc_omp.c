@@ -1,15 +1,70 @@
 #define _POSIX_C_SOURCE 200112L
 
 #include "cc.h"
+#include "cc_alloc.h"
+#include "union_find.h"
+#include "frontier.h"
+#include "neighbor_min.h"
+#include "lp_instrument.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <omp.h>
 #include <stdatomic.h>
 
-void compute_connected_components_omp(const CSRGraph *restrict G,
-                                      int32_t *restrict labels,
-                                      int chunk_size)
+// Scalar minimum over a varint row; the decode chain leaves nothing to vectorize
+static inline int32_t varint_row_min(const CSRGraphVarint *restrict G, _Atomic int32_t *restrict labels,
+                                     int32_t u, int32_t init)
+{
+  int32_t result = init;
+  VarintRowCursor c;
+  for (int more = csr_varint_row_first(G, u, &c); more; more = csr_varint_row_next(&c))
+  {
+    int32_t label = atomic_load_explicit(&labels[c.v], memory_order_relaxed);
+    if (label < result)
+      result = label;
+  }
+  return result;
+}
+
+// One LP kernel per adjacency layout, all from cc_omp_lp_template.h
+
+#define LP_KERNEL_NAME compute_connected_components_omp
+#define LP_INPLACE_NAME compute_connected_components_omp_inplace
+#define LP_GRAPH_T CSRGraph
+#define LP_CURSOR_T CSRRowCursor
+#define LP_ROW_FIRST(G, u, c) csr64_row_first(G, u, c)
+#define LP_ROW_NEXT(c) csr_row_next(c)
+#define LP_ROW_MIN(G, labels, u, init) \
+  neighbor_min(labels, (G)->col_idx, (G)->row_ptr[u], (G)->row_ptr[(u) + 1], init)
+#define LP_ROW_DEGREE(G, u) ((G)->row_ptr[(u) + 1] - (G)->row_ptr[u])
+#include "cc_omp_lp_template.h"
+
+#define LP_KERNEL_NAME compute_connected_components_omp_csr32
+#define LP_INPLACE_NAME compute_connected_components_omp_csr32_inplace
+#define LP_GRAPH_T CSRGraph32
+#define LP_CURSOR_T CSRRowCursor
+#define LP_ROW_FIRST(G, u, c) csr32_row_first(G, u, c)
+#define LP_ROW_NEXT(c) csr_row_next(c)
+#define LP_ROW_MIN(G, labels, u, init) \
+  neighbor_min(labels, (G)->col_idx, (G)->row_ptr[u], (G)->row_ptr[(u) + 1], init)
+#define LP_ROW_DEGREE(G, u) ((int64_t)(G)->row_ptr[(u) + 1] - (G)->row_ptr[u])
+#include "cc_omp_lp_template.h"
+
+#define LP_KERNEL_NAME compute_connected_components_omp_varint
+#define LP_INPLACE_NAME compute_connected_components_omp_varint_inplace
+#define LP_GRAPH_T CSRGraphVarint
+#define LP_CURSOR_T VarintRowCursor
+#define LP_ROW_FIRST(G, u, c) csr_varint_row_first(G, u, c)
+#define LP_ROW_NEXT(c) csr_varint_row_next(c)
+#define LP_ROW_MIN(G, labels, u, init) varint_row_min(G, labels, u, init)
+#define LP_ROW_DEGREE(G, u) csr_varint_degree(G, u)
+#include "cc_omp_lp_template.h"
+
+int compute_connected_components_frontier_omp(const CSRGraph *restrict G,
+                                              int32_t *restrict labels,
+                                              int chunk_size,
+                                              LPRoundStats *stats)
 {
   const int32_t n = G->n;
   const int64_t *restrict row_ptr = G->row_ptr;
@@ -17,79 +72,414 @@ void compute_connected_components_omp(const CSRGraph *restrict G,
   const int chunking_enabled = (chunk_size != 1);
   const int effective_chunk = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
 
-#pragma omp parallel for schedule(static)
-  for (int32_t i = 0; i < n; i++)
-    labels[i] = i;
-
   _Atomic int32_t *atomic_labels;
-  if (posix_memalign((void **)&atomic_labels, 64, (size_t)n * sizeof(*atomic_labels)) != 0)
+  atomic_uchar *in_frontier;
+  atomic_uchar *in_next;
+  int32_t *frontier;
+  int32_t *next_frontier;
+  if (!(atomic_labels = cc_alloc((size_t)n * sizeof(*atomic_labels))) ||
+      !(in_frontier = cc_alloc((size_t)n * sizeof(*in_frontier))) ||
+      !(in_next = cc_alloc((size_t)n * sizeof(*in_next))) ||
+      !(frontier = cc_alloc((size_t)n * sizeof(*frontier))) ||
+      !(next_frontier = cc_alloc((size_t)n * sizeof(*next_frontier))))
   {
-    fprintf(stderr, "Memory allocation failed (atomic labels)\n");
+    fprintf(stderr, "Memory allocation failed (frontier)\n");
     exit(EXIT_FAILURE);
   }
 
+  // Every vertex starts active
 #pragma omp parallel for schedule(static)
   for (int32_t i = 0; i < n; i++)
-    atomic_store_explicit(&atomic_labels[i], labels[i], memory_order_relaxed);
+  {
+    atomic_store_explicit(&atomic_labels[i], i, memory_order_relaxed);
+    atomic_store_explicit(&in_frontier[i], 1, memory_order_relaxed);
+    atomic_store_explicit(&in_next[i], 0, memory_order_relaxed);
+  }
 
-  // Set OpenMP scheduling during runtime according to chunking preference
   omp_set_schedule(chunking_enabled ? omp_sched_dynamic : omp_sched_static,
                    chunking_enabled ? effective_chunk : 0);
 
-  while (1)
+  int64_t frontier_size = n;
+  int dense = 1;
+  int rounds = 0;
+  while (frontier_size > 0)
   {
-    int changed = 0;
+    // Sparse rounds append to the next list as they go; dense rounds only set the bitmap
+    const int build_list = !dense;
+    _Atomic int64_t next_tail = 0;
+    int64_t edges_scanned = 0;
+    int64_t activated = 0;
+
+#pragma omp parallel reduction(+ : edges_scanned, activated)
+    {
+      FrontierBatch batch;
+      batch.count = 0;
+      FrontierBatch *out = build_list ? &batch : NULL;
+
+      if (dense)
+      {
+#pragma omp for schedule(runtime)
+        for (int32_t u = 0; u < n; u++)
+        {
+          if (!atomic_load_explicit(&in_frontier[u], memory_order_relaxed))
+            continue;
+          atomic_store_explicit(&in_frontier[u], 0, memory_order_relaxed);
+          edges_scanned += frontier_push_label(u, row_ptr, col_idx, atomic_labels, in_next, out,
+                                               next_frontier, &next_tail, &activated);
+        }
+      }
+      else
+      {
+#pragma omp for schedule(runtime)
+        for (int64_t i = 0; i < frontier_size; i++)
+        {
+          int32_t u = frontier[i];
+          atomic_store_explicit(&in_frontier[u], 0, memory_order_relaxed);
+          edges_scanned += frontier_push_label(u, row_ptr, col_idx, atomic_labels, in_next, out,
+                                               next_frontier, &next_tail, &activated);
+        }
+      }
+
+      if (out)
+        frontier_batch_flush(out, next_frontier, &next_tail);
+    }
+
+    if (stats)
+      lp_round_stats_push(stats, frontier_size, edges_scanned, dense);
+    rounds++;
+
+    // The next frontier becomes the current one; the old bitmap was cleared while scanning
+    atomic_uchar *tmp_flags = in_frontier;
+    in_frontier = in_next;
+    in_next = tmp_flags;
+    int32_t *tmp_list = frontier;
+    frontier = next_frontier;
+    next_frontier = tmp_list;
+
+    frontier_size = activated;
+    dense = frontier_size > n / FRONTIER_DENSE_DIVISOR;
+
+    // Leaving dense mode: build the list from the bitmap once
+    if (!dense && !build_list && frontier_size > 0)
+    {
+      _Atomic int64_t pack_tail = 0;
+#pragma omp parallel
+      {
+        FrontierBatch batch;
+        batch.count = 0;
+#pragma omp for schedule(static)
+        for (int32_t u = 0; u < n; u++)
+        {
+          if (atomic_load_explicit(&in_frontier[u], memory_order_relaxed))
+            frontier_batch_push(&batch, u, frontier, &pack_tail);
+        }
+        frontier_batch_flush(&batch, frontier, &pack_tail);
+      }
+    }
+  }
+
+#pragma omp parallel for schedule(static)
+  for (int32_t i = 0; i < n; i++)
+    labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
 
-// Dynamic scheduling unless the caller requested no chunking (meaning chunk_size == 1)
-// Main propagation loop
-#pragma omp parallel for schedule(runtime) reduction(|| : changed)
+  cc_free(atomic_labels);
+  cc_free(in_frontier);
+  cc_free(in_next);
+  cc_free(frontier);
+  cc_free(next_frontier);
+  return rounds;
+}
+
+// Highest-degree vertex (lowest ID on ties), the seed of the giant-component BFS
+static int32_t max_degree_vertex(const int64_t *restrict row_ptr, int32_t n)
+{
+  int32_t best = 0;
+  int64_t best_degree = -1;
+#pragma omp parallel
+  {
+    int32_t local = 0;
+    int64_t local_degree = -1;
+#pragma omp for schedule(static) nowait
     for (int32_t u = 0; u < n; u++)
     {
-      int32_t old_label = atomic_load_explicit(&atomic_labels[u], memory_order_relaxed);
-      int32_t new_label = old_label;
+      int64_t degree = row_ptr[u + 1] - row_ptr[u];
+      if (degree > local_degree)
+      {
+        local_degree = degree;
+        local = u;
+      }
+    }
+#pragma omp critical
+    {
+      if (local_degree > best_degree || (local_degree == best_degree && local < best))
+      {
+        best_degree = local_degree;
+        best = local;
+      }
+    }
+  }
+  return best;
+}
+
+int compute_connected_components_bfs_omp(const CSRGraph *restrict G,
+                                         int32_t *restrict labels,
+                                         int chunk_size)
+{
+  const int32_t n = G->n;
+  const int64_t *restrict row_ptr = G->row_ptr;
+  const int32_t *restrict col_idx = G->col_idx;
+  const int chunking_enabled = (chunk_size != 1);
+  const int effective_chunk = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
+  if (n == 0)
+    return 0;
+
+  atomic_uchar *visited;
+  atomic_uchar *in_frontier;
+  atomic_uchar *in_next;
+  int32_t *frontier;
+  int32_t *next_frontier;
+  _Atomic int32_t *parent;
+  if (!(visited = cc_alloc((size_t)n * sizeof(*visited))) ||
+      !(in_frontier = cc_alloc((size_t)n * sizeof(*in_frontier))) ||
+      !(in_next = cc_alloc((size_t)n * sizeof(*in_next))) ||
+      !(frontier = cc_alloc((size_t)n * sizeof(*frontier))) ||
+      !(next_frontier = cc_alloc((size_t)n * sizeof(*next_frontier))) ||
+      !(parent = cc_alloc((size_t)n * sizeof(*parent))))
+  {
+    fprintf(stderr, "Memory allocation failed (BFS)\n");
+    exit(EXIT_FAILURE);
+  }
+
+#pragma omp parallel for schedule(static)
+  for (int32_t i = 0; i < n; i++)
+  {
+    atomic_store_explicit(&visited[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&in_frontier[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&in_next[i], 0, memory_order_relaxed);
+  }
+
+  omp_set_schedule(chunking_enabled ? omp_sched_dynamic : omp_sched_static,
+                   chunking_enabled ? effective_chunk : 0);
 
-      // Check neighbors for smaller labels
-      for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
+  // Direction-optimizing BFS from the highest-degree vertex
+  const int32_t seed = max_degree_vertex(row_ptr, n);
+  atomic_store_explicit(&visited[seed], 1, memory_order_relaxed);
+  frontier[0] = seed;
+  int64_t frontier_size = 1;
+  int64_t prev_size = 0;
+  int64_t frontier_edges = row_ptr[seed + 1] - row_ptr[seed];
+  int64_t unexplored_edges = G->m - frontier_edges;
+  int bottom_up = 0;
+  int levels = 0;
+
+  while (frontier_size > 0)
+  {
+    if (!bottom_up && frontier_edges > unexplored_edges / BFS_ALPHA)
+    {
+      // Switch to bottom-up: the frontier becomes a bitmap
+#pragma omp parallel for schedule(static)
+      for (int64_t i = 0; i < frontier_size; i++)
+        atomic_store_explicit(&in_frontier[frontier[i]], 1, memory_order_relaxed);
+      bottom_up = 1;
+    }
+    else if (bottom_up && frontier_size < prev_size && frontier_size < n / BFS_BETA)
+    {
+      // Switch back to top-down: pack the bitmap into a list
+      _Atomic int64_t pack_tail = 0;
+#pragma omp parallel
       {
-        int32_t v = col_idx[j];
-        int32_t neighbor_label = atomic_load_explicit(&atomic_labels[v], memory_order_relaxed);
-        if (neighbor_label < new_label)
-          new_label = neighbor_label;
+        FrontierBatch batch;
+        batch.count = 0;
+#pragma omp for schedule(static)
+        for (int32_t u = 0; u < n; u++)
+        {
+          if (atomic_load_explicit(&in_frontier[u], memory_order_relaxed))
+          {
+            atomic_store_explicit(&in_frontier[u], 0, memory_order_relaxed);
+            frontier_batch_push(&batch, u, frontier, &pack_tail);
+          }
+        }
+        frontier_batch_flush(&batch, frontier, &pack_tail);
       }
+      bottom_up = 0;
+    }
 
-      // Update label if a smaller one was found
-      if (new_label < old_label)
+    int64_t next_size = 0;
+    int64_t next_edges = 0;
+    if (bottom_up)
+    {
+      // Every unvisited vertex looks for a parent in the frontier
+#pragma omp parallel for schedule(runtime) reduction(+ : next_size, next_edges)
+      for (int32_t v = 0; v < n; v++)
       {
-        int32_t current = old_label;
-        while (current > new_label &&
-               !atomic_compare_exchange_weak_explicit(&atomic_labels[u], &current,
-                                                      new_label, memory_order_relaxed, memory_order_relaxed))
+        if (atomic_load_explicit(&visited[v], memory_order_relaxed))
+          continue;
+        for (int64_t j = row_ptr[v]; j < row_ptr[v + 1]; j++)
         {
+          if (atomic_load_explicit(&in_frontier[col_idx[j]], memory_order_relaxed))
+          {
+            atomic_store_explicit(&visited[v], 1, memory_order_relaxed);
+            atomic_store_explicit(&in_next[v], 1, memory_order_relaxed);
+            next_size++;
+            next_edges += row_ptr[v + 1] - row_ptr[v];
+            break;
+          }
         }
+      }
 
-        changed = 1;
-        
-        // Propagate the new label to neighbors to help convergence
-        for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
+      atomic_uchar *tmp_flags = in_frontier;
+      in_frontier = in_next;
+      in_next = tmp_flags;
+#pragma omp parallel for schedule(static)
+      for (int32_t i = 0; i < n; i++)
+        atomic_store_explicit(&in_next[i], 0, memory_order_relaxed);
+    }
+    else
+    {
+      // Frontier vertices claim their unvisited neighbors
+      _Atomic int64_t next_tail = 0;
+#pragma omp parallel reduction(+ : next_size, next_edges)
+      {
+        FrontierBatch batch;
+        batch.count = 0;
+#pragma omp for schedule(runtime)
+        for (int64_t i = 0; i < frontier_size; i++)
         {
-          int32_t v = col_idx[j];
-          int32_t neighbor = atomic_load_explicit(&atomic_labels[v], memory_order_relaxed);
-          while (neighbor > new_label &&
-                 !atomic_compare_exchange_weak_explicit(&atomic_labels[v], &neighbor,
-                                                        new_label, memory_order_relaxed, memory_order_relaxed))
+          int32_t u = frontier[i];
+          for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
           {
+            int32_t v = col_idx[j];
+            if (!atomic_load_explicit(&visited[v], memory_order_relaxed) &&
+                atomic_exchange_explicit(&visited[v], 1, memory_order_relaxed) == 0)
+            {
+              frontier_batch_push(&batch, v, next_frontier, &next_tail);
+              next_size++;
+              next_edges += row_ptr[v + 1] - row_ptr[v];
+            }
           }
         }
+        frontier_batch_flush(&batch, next_frontier, &next_tail);
       }
+
+      int32_t *tmp_list = frontier;
+      frontier = next_frontier;
+      next_frontier = tmp_list;
     }
 
-    if (!changed)
-      break;
+    prev_size = frontier_size;
+    frontier_size = next_size;
+    frontier_edges = next_edges;
+    unexplored_edges -= next_edges;
+    levels++;
+  }
+
+  // The BFS component is labelled with its minimum vertex ID
+  int32_t giant_label = n;
+#pragma omp parallel for schedule(static) reduction(min : giant_label)
+  for (int32_t v = 0; v < n; v++)
+  {
+    if (atomic_load_explicit(&visited[v], memory_order_relaxed) && v < giant_label)
+      giant_label = v;
+  }
+
+  // Union-find over the vertices the BFS did not reach; their edges stay among themselves
+#pragma omp parallel for schedule(static)
+  for (int32_t v = 0; v < n; v++)
+    atomic_store_explicit(&parent[v], v, memory_order_relaxed);
+
+#pragma omp parallel for schedule(runtime)
+  for (int32_t v = 0; v < n; v++)
+  {
+    if (atomic_load_explicit(&visited[v], memory_order_relaxed))
+      continue;
+    for (int64_t j = row_ptr[v]; j < row_ptr[v + 1]; j++)
+    {
+      if (col_idx[j] < v)
+        uf_link(parent, v, col_idx[j]);
+    }
+  }
+
+#pragma omp parallel for schedule(static)
+  for (int32_t v = 0; v < n; v++)
+  {
+    if (atomic_load_explicit(&visited[v], memory_order_relaxed))
+    {
+      labels[v] = giant_label;
+    }
+    else
+    {
+      uf_compress(parent, v);
+      labels[v] = atomic_load_explicit(&parent[v], memory_order_relaxed);
+    }
+  }
+
+  cc_free(visited);
+  cc_free(in_frontier);
+  cc_free(in_next);
+  cc_free(frontier);
+  cc_free(next_frontier);
+  cc_free(parent);
+  return levels;
+}
+
+void compute_connected_components_afforest_omp(const CSRGraph *restrict G,
+                                               int32_t *restrict labels,
+                                               int chunk_size)
+{
+  const int32_t n = G->n;
+  const int64_t *restrict row_ptr = G->row_ptr;
+  const int32_t *restrict col_idx = G->col_idx;
+  const int chunking_enabled = (chunk_size != 1);
+  const int effective_chunk = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
+
+  _Atomic int32_t *parent;
+  if (!(parent = cc_alloc((size_t)n * sizeof(*parent))))
+  {
+    fprintf(stderr, "Memory allocation failed (parent array)\n");
+    exit(EXIT_FAILURE);
   }
 
 #pragma omp parallel for schedule(static)
   for (int32_t i = 0; i < n; i++)
-    labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
+    atomic_store_explicit(&parent[i], i, memory_order_relaxed);
+
+  omp_set_schedule(chunking_enabled ? omp_sched_dynamic : omp_sched_static,
+                   chunking_enabled ? effective_chunk : 0);
+
+  // Link the first few neighbors of every vertex, compressing after each round
+  for (int r = 0; r < AFFOREST_NEIGHBOR_ROUNDS; r++)
+  {
+#pragma omp parallel for schedule(runtime)
+    for (int32_t u = 0; u < n; u++)
+    {
+      if (row_ptr[u] + r < row_ptr[u + 1])
+        uf_link(parent, u, col_idx[row_ptr[u] + r]);
+    }
+
+#pragma omp parallel for schedule(static)
+    for (int32_t u = 0; u < n; u++)
+      uf_compress(parent, u);
+  }
+
+  // Vertices already in the giant component need no further work
+  const int32_t giant = uf_sample_frequent_root(parent, n);
+
+#pragma omp parallel for schedule(runtime)
+  for (int32_t u = 0; u < n; u++)
+  {
+    if (atomic_load_explicit(&parent[u], memory_order_relaxed) == giant)
+      continue;
+    for (int64_t j = row_ptr[u] + AFFOREST_NEIGHBOR_ROUNDS; j < row_ptr[u + 1]; j++)
+      uf_link(parent, u, col_idx[j]);
+  }
+
+#pragma omp parallel for schedule(static)
+  for (int32_t u = 0; u < n; u++)
+    uf_compress(parent, u);
+
+#pragma omp parallel for schedule(static)
+  for (int32_t i = 0; i < n; i++)
+    labels[i] = atomic_load_explicit(&parent[i], memory_order_relaxed);
 
-  free(atomic_labels);
+  cc_free(parent);
 }
@@ -0,0 +1,125 @@
+// OpenMP label propagation kernel body, instantiated once per adjacency layout by
+// src/cc_omp.c. No include guard on purpose: every inclusion defines one kernel.
+//
+// Parameters (all #undef'd at the end):
+//   LP_KERNEL_NAME               function name (int32_t labels, allocates its own atomic copy)
+//   LP_INPLACE_NAME              function name of the variant working on caller-owned atomic labels
+//   LP_GRAPH_T                   graph type (CSRGraph, CSRGraph32, CSRGraphVarint)
+//   LP_CURSOR_T                  row cursor type of csr_compact.h
+//   LP_ROW_FIRST(G, u, c)        start cursor c on row u, 0 for an empty row
+//   LP_ROW_NEXT(c)               advance c, 0 past the end of the row
+//   LP_ROW_MIN(G, labels, u, m)  min(m, labels of the neighbors of u)
+//   LP_ROW_DEGREE(G, u)          neighbors of u (only evaluated in instrumented builds)
+
+void LP_INPLACE_NAME(const LP_GRAPH_T *restrict G,
+                     _Atomic int32_t *restrict atomic_labels,
+                     int chunk_size)
+{
+  const int32_t n = G->n;
+  const int chunking_enabled = (chunk_size != 1);
+  const int effective_chunk = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
+
+#pragma omp parallel for schedule(static)
+  for (int32_t i = 0; i < n; i++)
+    atomic_store_explicit(&atomic_labels[i], i, memory_order_relaxed);
+
+  // Set OpenMP scheduling during runtime according to chunking preference
+  omp_set_schedule(chunking_enabled ? omp_sched_dynamic : omp_sched_static,
+                   chunking_enabled ? effective_chunk : 0);
+
+  LP_INSTRUMENT_ONLY(lp_instrument_begin(omp_get_max_threads());)
+  while (1)
+  {
+    int changed = 0;
+
+// Dynamic scheduling unless the caller requested no chunking (meaning chunk_size == 1)
+// Main propagation loop
+#pragma omp parallel reduction(|| : changed)
+    {
+      LPInstrumentSlot *stats = LP_INSTRUMENT_SLOT(omp_get_thread_num());
+      LP_INSTRUMENT_ONLY(double round_start = lp_instrument_now();)
+
+#pragma omp for schedule(runtime) nowait
+      for (int32_t u = 0; u < n; u++)
+      {
+        int32_t old_label = atomic_load_explicit(&atomic_labels[u], memory_order_relaxed);
+
+        // Check neighbors for smaller labels
+        int32_t new_label = LP_ROW_MIN(G, atomic_labels, u, old_label);
+        LP_INSTRUMENT_ADD(stats, edges_scanned, LP_ROW_DEGREE(G, u));
+
+        // Update label if a smaller one was found
+        if (new_label < old_label)
+        {
+          int32_t current = old_label;
+          while (current > new_label &&
+                 !atomic_compare_exchange_weak_explicit(&atomic_labels[u], &current,
+                                                        new_label, memory_order_relaxed, memory_order_relaxed))
+          {
+            LP_INSTRUMENT_ADD(stats, cas_failures, 1);
+          }
+          LP_INSTRUMENT_ADD(stats, changed_vertices, current > new_label);
+
+          changed = 1;
+
+          // Propagate the new label to neighbors to help convergence
+          LP_CURSOR_T c;
+          for (int more = LP_ROW_FIRST(G, u, &c); more; more = LP_ROW_NEXT(&c))
+          {
+            int32_t v = c.v;
+            int32_t neighbor = atomic_load_explicit(&atomic_labels[v], memory_order_relaxed);
+            while (neighbor > new_label &&
+                   !atomic_compare_exchange_weak_explicit(&atomic_labels[v], &neighbor,
+                                                          new_label, memory_order_relaxed, memory_order_relaxed))
+            {
+              LP_INSTRUMENT_ADD(stats, cas_failures, 1);
+            }
+            LP_INSTRUMENT_ADD(stats, changed_vertices, neighbor > new_label);
+          }
+          LP_INSTRUMENT_ADD(stats, edges_scanned, LP_ROW_DEGREE(G, u));
+        }
+      }
+
+      // The implicit barrier at the end of the region, made explicit so its wait can be timed
+      LP_INSTRUMENT_ONLY(double work_end = lp_instrument_now();
+                         _Pragma("omp barrier")
+                         stats->busy_seconds += work_end - round_start;
+                         stats->idle_seconds += lp_instrument_now() - work_end;)
+    }
+    LP_INSTRUMENT_ONLY(lp_instrument_end_round(0.0);)
+
+    if (!changed)
+      break;
+  }
+
+}
+
+void LP_KERNEL_NAME(const LP_GRAPH_T *restrict G,
+                    int32_t *restrict labels,
+                    int chunk_size)
+{
+  const int32_t n = G->n;
+  _Atomic int32_t *atomic_labels;
+  if (!(atomic_labels = cc_alloc((size_t)n * sizeof(*atomic_labels))))
+  {
+    fprintf(stderr, "Memory allocation failed (atomic labels)\n");
+    exit(EXIT_FAILURE);
+  }
+
+  LP_INPLACE_NAME(G, atomic_labels, chunk_size);
+
+#pragma omp parallel for schedule(static)
+  for (int32_t i = 0; i < n; i++)
+    labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
+
+  cc_free(atomic_labels);
+}
+
+#undef LP_KERNEL_NAME
+#undef LP_INPLACE_NAME
+#undef LP_GRAPH_T
+#undef LP_CURSOR_T
+#undef LP_ROW_FIRST
+#undef LP_ROW_NEXT
+#undef LP_ROW_MIN
+#undef LP_ROW_DEGREE
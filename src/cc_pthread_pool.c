@@ -0,0 +1,244 @@
+#define _GNU_SOURCE
+#define _XOPEN_SOURCE 700
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "cc_pthread_pool.h"
+#include "numa_util.h"
+
+struct CCPthreadPool
+{
+  pthread_t *threads;          // workers 1..num_workers (thread 0 is the caller)
+  int num_workers;             // workers started so far
+  pthread_mutex_t lock;        // protects parking on wake/done
+  pthread_cond_t wake;         // signalled when a new job is published
+  pthread_cond_t done;         // signalled when the last participant finishes
+  atomic_uint generation;      // bumped once per published job
+  atomic_int remaining;        // workers that have not finished the current job yet
+  atomic_int stop;             // set by cc_pthread_pool_destroy
+  void *(*worker)(void *);     // current job
+  char *args;                  // base of the per-thread argument array
+  size_t arg_size;             // stride of the argument array
+  int job_threads;             // threads taking part in the current job
+  pthread_barrier_t barrier;   // shared barrier handed out to jobs
+  int barrier_threads;         // count the barrier was initialized with (0 = none)
+  const NumaTopology *topo;    // pin job threads when non-NULL
+  int caller_cpu;              // CPU the caller was last pinned to (-1 = not pinned)
+};
+
+// Per-worker start argument
+typedef struct
+{
+  CCPthreadPool *pool;
+  int index;           // thread ID within every job
+  unsigned generation; // last job published before the worker started
+} PoolWorkerArgs;
+
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+// Spin on the job counter, then park until it moves past seen
+static unsigned wait_for_job(CCPthreadPool *pool, unsigned seen)
+{
+  unsigned gen;
+  for (int spin = 0; spin < CC_POOL_SPIN_ITERS; spin++)
+  {
+    gen = atomic_load_explicit(&pool->generation, memory_order_acquire);
+    if (gen != seen)
+      return gen;
+    cpu_relax();
+  }
+
+  pthread_mutex_lock(&pool->lock);
+  while ((gen = atomic_load_explicit(&pool->generation, memory_order_acquire)) == seen)
+    pthread_cond_wait(&pool->wake, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+  return gen;
+}
+
+// Pin the running thread to its CPU for the current job when affinity is enabled
+static void pin_for_job(const CCPthreadPool *pool, int index, int *pinned_cpu)
+{
+  if (!pool->topo)
+    return;
+  int cpu = numa_cpu_for_thread(pool->topo, index, pool->job_threads);
+  if (cpu != *pinned_cpu && numa_pin_self(cpu) == 0)
+    *pinned_cpu = cpu;
+}
+
+static void *pool_worker(void *arg)
+{
+  PoolWorkerArgs *self = (PoolWorkerArgs *)arg;
+  CCPthreadPool *pool = self->pool;
+  const int index = self->index;
+  unsigned seen = self->generation;
+  free(self);
+
+  int pinned_cpu = -1;
+  for (;;)
+  {
+    seen = wait_for_job(pool, seen);
+    if (atomic_load_explicit(&pool->stop, memory_order_acquire))
+      break;
+    // Workers outside the job only acknowledge it, so no worker can still be reading
+    // the job fields when the caller publishes the next one
+    if (index < pool->job_threads)
+    {
+      pin_for_job(pool, index, &pinned_cpu);
+      pool->worker(pool->args + (size_t)index * pool->arg_size);
+    }
+
+    if (atomic_fetch_sub_explicit(&pool->remaining, 1, memory_order_acq_rel) == 1)
+    {
+      pthread_mutex_lock(&pool->lock);
+      pthread_cond_signal(&pool->done);
+      pthread_mutex_unlock(&pool->lock);
+    }
+  }
+  return NULL;
+}
+
+// Start workers until the pool can run jobs of num_threads threads
+static int grow_pool(CCPthreadPool *pool, int num_threads)
+{
+  const int needed = num_threads - 1;
+  if (needed <= pool->num_workers)
+    return 0;
+
+  pthread_t *threads = realloc(pool->threads, (size_t)needed * sizeof(pthread_t));
+  if (!threads)
+    return 1;
+  pool->threads = threads;
+
+  while (pool->num_workers < needed)
+  {
+    PoolWorkerArgs *self = malloc(sizeof(PoolWorkerArgs));
+    if (!self)
+      return 1;
+    self->pool = pool;
+    self->index = pool->num_workers + 1;
+    self->generation = atomic_load_explicit(&pool->generation, memory_order_relaxed);
+    if (pthread_create(&pool->threads[pool->num_workers], NULL, pool_worker, self) != 0)
+    {
+      free(self);
+      return 1;
+    }
+    pool->num_workers++;
+  }
+  return 0;
+}
+
+CCPthreadPool *cc_pthread_pool_create(int max_threads)
+{
+  CCPthreadPool *pool = calloc(1, sizeof(CCPthreadPool));
+  if (!pool)
+    return NULL;
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  atomic_init(&pool->generation, 0);
+  atomic_init(&pool->remaining, 0);
+  atomic_init(&pool->stop, 0);
+  pool->caller_cpu = -1;
+
+  if (grow_pool(pool, max_threads) != 0)
+  {
+    fprintf(stderr, "Failed to start %d pool threads\n", max_threads - 1);
+    cc_pthread_pool_destroy(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void cc_pthread_pool_destroy(CCPthreadPool *pool)
+{
+  if (!pool)
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  atomic_store_explicit(&pool->stop, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&pool->generation, 1, memory_order_release);
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (int w = 0; w < pool->num_workers; w++)
+    pthread_join(pool->threads[w], NULL);
+
+  if (pool->barrier_threads > 0)
+    pthread_barrier_destroy(&pool->barrier);
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->threads);
+  free(pool);
+}
+
+int cc_pthread_pool_run(CCPthreadPool *pool, int num_threads, void *(*worker)(void *), void *args,
+                        size_t arg_size)
+{
+  if (num_threads < 1)
+    return 1;
+  if (grow_pool(pool, num_threads) != 0)
+  {
+    fprintf(stderr, "Failed to grow pool to %d threads\n", num_threads);
+    return 1;
+  }
+
+  pool->job_threads = num_threads;
+  const int notify = (num_threads > 1) ? pool->num_workers : 0;
+  if (notify > 0)
+  {
+    // The job fields are published by the release increment of generation
+    pool->worker = worker;
+    pool->args = (char *)args;
+    pool->arg_size = arg_size;
+    atomic_store_explicit(&pool->remaining, notify, memory_order_relaxed);
+
+    pthread_mutex_lock(&pool->lock);
+    atomic_fetch_add_explicit(&pool->generation, 1, memory_order_release);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+  }
+
+  pin_for_job(pool, 0, &pool->caller_cpu);
+  worker(args);
+
+  if (notify > 0)
+  {
+    int spin = 0;
+    while (atomic_load_explicit(&pool->remaining, memory_order_acquire) > 0 && spin++ < CC_POOL_SPIN_ITERS)
+      cpu_relax();
+
+    pthread_mutex_lock(&pool->lock);
+    while (atomic_load_explicit(&pool->remaining, memory_order_acquire) > 0)
+      pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+  }
+  return 0;
+}
+
+pthread_barrier_t *cc_pthread_pool_barrier(CCPthreadPool *pool, int num_threads)
+{
+  if (pool->barrier_threads != num_threads)
+  {
+    if (pool->barrier_threads > 0)
+      pthread_barrier_destroy(&pool->barrier);
+    pthread_barrier_init(&pool->barrier, NULL, num_threads);
+    pool->barrier_threads = num_threads;
+  }
+  return &pool->barrier;
+}
+
+void cc_pthread_pool_set_affinity(CCPthreadPool *pool, const NumaTopology *topo)
+{
+  pool->topo = topo;
+}
@@ -2,13 +2,21 @@
 #define _XOPEN_SOURCE 700
 #define _POSIX_C_SOURCE 200112L
 
+#include <limits.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include "graph.h"
+#include "cc_alloc.h"
 #include "cc.h"
+#include "union_find.h"
+#include "frontier.h"
+#include "neighbor_min.h"
+#include "lp_instrument.h"
+#include "cc_pthread_pool.h"
 
 // Thread arguments structure for pthreads
 typedef struct
@@ -27,23 +35,265 @@ typedef struct
   int32_t block_end;          // End index of the block for this thread
 } ThreadArgs;
 
-// Returns 1 when vertex u (or its neighbors) adopts a lower label
-// Uses inline to avoid function call overhead in the inner loop
-static inline int relax_vertex_label(int32_t u, const int64_t *restrict row_ptr,
-                                     const int32_t *restrict col_idx, atomic_int *restrict labels)
+// Vertex range assignment shared by the multi-phase kernels
+typedef struct
 {
-  int32_t old_label = atomic_load_explicit(&labels[u], memory_order_relaxed);
-  int32_t new_label = old_label;
+  int chunking_enabled; // Flag to enable/disable chunking
+  int chunk_size;       // Chunk size for dynamic work distribution
+  int32_t n;            // Number of vertices
+  int32_t block_start;  // Start index of the static block for this thread
+  int32_t block_end;    // End index of the static block for this thread
+} WorkSplit;
+
+// Idle polls of the asynchronous LP worker between sched_yield calls
+#define ASYNC_YIELD_SPINS 64
+
+// Per-thread termination state of the asynchronous LP worker, one cache line per thread
+typedef struct
+{
+  _Alignas(64) _Atomic int64_t changes; // vertices this thread relabelled so far (monotonic)
+  _Atomic int64_t clean_epoch;          // change total around the last clean sweep, -1 while sweeping
+} AsyncSlot;
+
+// Thread arguments for the asynchronous LP worker
+typedef struct
+{
+  const CSRGraph *G;          // Graph
+  atomic_int *labels;         // Atomic labels array
+  AsyncSlot *slots;           // One termination slot per thread
+  atomic_int *done;           // Set once global quiescence is detected
+  int *sweeps;                // Sweeps over its rows, per thread
+  int thread_id;              // Thread ID
+  int num_threads;            // Total number of threads
+  pthread_barrier_t *barrier; // Only used once, after the label initialization
+} AsyncArgs;
+
+// Thread arguments for the Afforest union-find worker
+typedef struct
+{
+  const CSRGraph *G;          // Graph
+  int32_t *labels;            // Output labels (each thread writes its static block)
+  _Atomic int32_t *parent;    // Union-find parent array
+  atomic_int *cursors;        // One dynamic work index per linking phase
+  int32_t *giant;             // Sampled giant-component root, written by thread 0
+  int thread_id;              // Thread ID
+  pthread_barrier_t *barrier; // Barrier for synchronization
+  WorkSplit split;            // Work distribution settings
+} AfforestArgs;
+
+// Thread arguments for the Shiloach-Vishkin worker
+typedef struct
+{
+  const CSRGraph *G;          // Graph
+  int32_t *labels;            // Output labels (each thread writes its static block)
+  _Atomic int32_t *parent;    // Parent pointers read during a hooking step
+  _Atomic int32_t *next;      // Parent pointers written during a hooking step
+  atomic_uchar *star;         // star[v] = 1 when v belongs to a rooted star
+  atomic_int *cursors;        // Dynamic work indices for the two hooking steps
+  atomic_int *changed;        // Round status: 1 = changed, 0 = unchanged, -1 = done
+  int *rounds;                // Number of rounds executed, written by thread 0
+  int thread_id;              // Thread ID
+  pthread_barrier_t *barrier; // Barrier for synchronization
+  WorkSplit split;            // Work distribution settings
+} SVArgs;
+
+// Smallest task of the work-stealing scheduler, in cost units (vertices plus edges)
+#define STEAL_MIN_GRAIN 64
+
+// Edge-balanced unit of work for the work-stealing LP scheduler: vertices [first, last),
+// restricted to the adjacency entries in [edge_begin, edge_end). Hub rows are split over
+// several single-vertex tasks.
+typedef struct
+{
+  int32_t first;
+  int32_t last;
+  int64_t edge_begin;
+  int64_t edge_end;
+} StealTask;
+
+// Chase-Lev deque over a fixed task array. The tasks are built once per run and the
+// deque is refilled at every round start, so no pushes happen while threads steal.
+typedef struct
+{
+  _Alignas(64) _Atomic int64_t top;    // next task thieves take
+  _Alignas(64) _Atomic int64_t bottom; // one past the next task the owner pops
+  StealTask *tasks;                    // tasks of the owner's edge-balanced vertex range
+  int64_t count;
+} StealDeque;
+
+// Thread arguments for the work-stealing LP worker
+typedef struct
+{
+  const CSRGraph *G;          // Graph
+  atomic_int *labels;         // Atomic labels array
+  atomic_int *changed;        // Round status: 1 = changed, 0 = unchanged, -1 = done
+  StealDeque *deques;         // One deque per thread
+  int64_t grain;              // Task size in edges (plus one unit per vertex)
+  int64_t *steals;            // Tasks taken from other deques, per thread
+  int thread_id;              // Thread ID
+  int num_threads;            // Total number of threads
+  pthread_barrier_t *barrier; // Barrier for synchronization
+} StealArgs;
+
+// Round state shared by the frontier LP workers, updated by thread 0 between barriers
+typedef struct
+{
+  atomic_uchar *in_frontier;  // in_frontier[v] = 1 when v is in the current frontier
+  atomic_uchar *in_next;      // in_next[v] = 1 when v already joined the next frontier
+  int32_t *frontier;          // current frontier as a vertex list (sparse rounds)
+  int32_t *next_frontier;     // next frontier list, filled during sparse rounds
+  _Atomic int64_t next_tail;  // length of next_frontier
+  _Atomic int64_t pack_tail;  // length of frontier while packing it from the bitmap
+  int64_t frontier_size;      // vertices in the current frontier
+  int dense;                  // 1 when the current frontier is scanned as a bitmap
+  int pack;                   // 1 when the frontier list must be packed from the bitmap
+  int rounds;                 // Number of rounds executed
+  LPRoundStats *stats;        // Optional per-round log
+  int64_t *edges;             // Per-thread edges scanned in the current round
+  int64_t *activated;         // Per-thread vertices added to the next frontier
+} FrontierState;
+
+// Thread arguments for the frontier LP worker
+typedef struct
+{
+  const CSRGraph *G;          // Graph
+  _Atomic int32_t *labels;    // Atomic labels array
+  FrontierState *state;       // Shared round state
+  atomic_int *cursors;        // Dynamic work indices for the scan and pack phases
+  int thread_id;              // Thread ID
+  int num_threads;            // Total number of threads
+  int chunk_size;             // Chunk size for work distribution
+  pthread_barrier_t *barrier; // Barrier for synchronization
+} FrontierArgs;
+
+// Level state shared by the BFS workers, updated by thread 0 between barriers
+typedef struct
+{
+  atomic_uchar *visited;      // visited[v] = 1 once the BFS reached v
+  atomic_uchar *in_frontier;  // current frontier bitmap (bottom-up levels)
+  atomic_uchar *in_next;      // next frontier bitmap (bottom-up levels)
+  int32_t *frontier;          // current frontier list (top-down levels)
+  int32_t *next_frontier;     // next frontier list (top-down levels)
+  _Atomic int32_t *parent;    // Union-find parents for the vertices the BFS did not reach
+  _Atomic int64_t next_tail;  // length of next_frontier
+  _Atomic int64_t pack_tail;  // length of frontier while packing it from the bitmap
+  int64_t frontier_size;      // vertices in the current frontier
+  int64_t unexplored_edges;   // edges of the vertices not reached yet
+  int bottom_up;              // 1 when the current level runs bottom-up
+  int convert;                // BFS_* conversion to run before the current level
+  int clear_next;             // 1 when in_next still holds the previous bitmap
+  int levels;                 // Number of BFS levels executed
+  int64_t *found;             // Per-thread vertices reached in the current level
+  int64_t *found_edges;       // Per-thread edges of those vertices
+} BFSState;
+
+// Thread arguments for the BFS worker
+typedef struct
+{
+  const CSRGraph *G;          // Graph
+  int32_t *labels;            // Output labels (each thread writes its static block)
+  BFSState *state;            // Shared level state
+  atomic_int *cursors;        // Dynamic work indices for the BFS levels and the union-find pass
+  int thread_id;              // Thread ID
+  int num_threads;            // Total number of threads
+  int chunk_size;             // Chunk size for work distribution
+  pthread_barrier_t *barrier; // Barrier for synchronization
+  WorkSplit split;            // Work distribution settings over all vertices
+} BFSArgs;
+
+// Fill in the chunking settings and the static block owned by thread_id
+static void init_work_split(WorkSplit *split, int32_t n, int thread_id, int num_threads, int chunk_size)
+{
+  const int32_t static_block = (int32_t)(((int64_t)n + num_threads - 1) / num_threads);
+  int64_t start = (int64_t)thread_id * static_block;
+  int64_t end = start + static_block;
+  if (start > n)
+    start = n;
+  if (end > n)
+    end = n;
+
+  split->chunking_enabled = (chunk_size != 1);
+  split->chunk_size = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
+  split->n = n;
+  split->block_start = (int32_t)start;
+  split->block_end = (int32_t)end;
+}
+
+// Run worker on num_threads threads: on the pool when one is given, otherwise on
+// threads created for this call only
+static void run_workers(CCPthreadPool *pool, int num_threads, void *(*worker)(void *), void *args,
+                        size_t arg_size)
+{
+  if (pool)
+  {
+    if (cc_pthread_pool_run(pool, num_threads, worker, args, arg_size) != 0)
+      exit(EXIT_FAILURE);
+    return;
+  }
+
+  pthread_t *threads = malloc(num_threads * sizeof(pthread_t));
+  if (!threads)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+  for (int t = 0; t < num_threads; t++)
+    pthread_create(&threads[t], NULL, worker, (char *)args + (size_t)t * arg_size);
+  for (int t = 0; t < num_threads; t++)
+    pthread_join(threads[t], NULL);
+  free(threads);
+}
+
+// Pooled jobs share the pool's barrier; standalone calls initialize local
+static pthread_barrier_t *acquire_barrier(CCPthreadPool *pool, pthread_barrier_t *local, int num_threads)
+{
+  if (pool)
+    return cc_pthread_pool_barrier(pool, num_threads);
+  pthread_barrier_init(local, NULL, num_threads);
+  return local;
+}
+
+static void release_barrier(CCPthreadPool *pool, pthread_barrier_t *local)
+{
+  if (!pool)
+    pthread_barrier_destroy(local);
+}
 
-  // Check neighbors for smaller labels
-  for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
+// Claim the next vertex range of a phase; returns 0 once the phase has no work left
+// Dynamic mode pulls chunk_size ranges from cursor, static mode yields the thread's block once
+static inline int claim_range(const WorkSplit *split, atomic_int *cursor, int *taken,
+                              int32_t *start, int32_t *end)
+{
+  if (split->chunking_enabled)
   {
-    int32_t v = col_idx[j];
-    int32_t neighbor_label = atomic_load_explicit(&labels[v], memory_order_relaxed);
-    if (neighbor_label < new_label)
-      new_label = neighbor_label;
+    int first = atomic_fetch_add_explicit(cursor, split->chunk_size, memory_order_relaxed);
+    if (first >= split->n)
+      return 0;
+    *start = first;
+    *end = (first + split->chunk_size < split->n) ? first + split->chunk_size : split->n;
+    return 1;
   }
 
+  if (*taken)
+    return 0;
+  *taken = 1;
+  *start = split->block_start;
+  *end = split->block_end;
+  return 1;
+}
+
+// Returns 1 when vertex u (or its neighbors in col_idx[begin..end)) adopts a lower label
+// Uses inline to avoid function call overhead in the inner loop
+static inline int relax_vertex_range(int32_t u, int64_t begin, int64_t end,
+                                     const int32_t *restrict col_idx, atomic_int *restrict labels,
+                                     LPInstrumentSlot *stats)
+{
+  int32_t old_label = atomic_load_explicit(&labels[u], memory_order_relaxed);
+
+  // Check neighbors for smaller labels (vectorized for long rows)
+  int32_t new_label = neighbor_min(labels, col_idx, begin, end, old_label);
+  LP_INSTRUMENT_ADD(stats, edges_scanned, end - begin);
+
   // Update label if a smaller one was found
   if (new_label < old_label)
   {
@@ -52,10 +302,12 @@ static inline int relax_vertex_label(int32_t u, const int64_t *restrict row_ptr,
            !atomic_compare_exchange_weak_explicit(&labels[u], &current, new_label,
                                                   memory_order_relaxed, memory_order_relaxed))
     {
+      LP_INSTRUMENT_ADD(stats, cas_failures, 1);
     }
+    LP_INSTRUMENT_ADD(stats, changed_vertices, current > new_label);
 
     // Propagate the new label to neighbors to help convergence
-    for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
+    for (int64_t j = begin; j < end; j++)
     {
       int32_t v = col_idx[j];
       int32_t neighbor = atomic_load_explicit(&labels[v], memory_order_relaxed);
@@ -63,8 +315,11 @@ static inline int relax_vertex_label(int32_t u, const int64_t *restrict row_ptr,
              !atomic_compare_exchange_weak_explicit(&labels[v], &neighbor, new_label,
                                                     memory_order_relaxed, memory_order_relaxed))
       {
+        LP_INSTRUMENT_ADD(stats, cas_failures, 1);
       }
+      LP_INSTRUMENT_ADD(stats, changed_vertices, neighbor > new_label);
     }
+    LP_INSTRUMENT_ADD(stats, edges_scanned, end - begin);
 
     return 1;
   }
@@ -72,6 +327,14 @@ static inline int relax_vertex_label(int32_t u, const int64_t *restrict row_ptr,
   return 0;
 }
 
+// Returns 1 when vertex u (or its neighbors) adopts a lower label
+static inline int relax_vertex_label(int32_t u, const int64_t *restrict row_ptr,
+                                     const int32_t *restrict col_idx, atomic_int *restrict labels,
+                                     LPInstrumentSlot *stats)
+{
+  return relax_vertex_range(u, row_ptr[u], row_ptr[u + 1], col_idx, labels, stats);
+}
+
 // Worker thread: Semi asynchronous label propagation
 static void *lp_worker_full_async(void *arg)
 {
@@ -84,6 +347,14 @@ static void *lp_worker_full_async(void *arg)
   const int chunking_enabled = args->chunking_enabled;
   const int32_t block_start = args->block_start;
   const int32_t block_end = args->block_end;
+  LPInstrumentSlot *stats = LP_INSTRUMENT_SLOT(args->thread_id);
+
+  // First touch of this thread's edge-balanced share of the labels, the same rows
+  // numa_localize_csr places on its node
+  int32_t init_start, init_end;
+  csr_edge_balanced_rows(row_ptr, n, args->num_threads, args->thread_id, &init_start, &init_end);
+  for (int32_t u = init_start; u < init_end; u++)
+    atomic_init(&args->labels[u], u);
 
   while (1)
   {
@@ -93,6 +364,7 @@ static void *lp_worker_full_async(void *arg)
     if (chunking_enabled && args->thread_id == 0)
       atomic_store_explicit(args->next_vertex, 0, memory_order_relaxed);
     pthread_barrier_wait(args->barrier);
+    LP_INSTRUMENT_ONLY(double round_start = lp_instrument_now();)
 
     // Check if chunking is enabled and choose between dynamic or static work distribution
     if (chunking_enabled)
@@ -108,14 +380,14 @@ static void *lp_worker_full_async(void *arg)
           end = n;
 
         for (int32_t u = start; u < end; u++)
-          local_changed |= relax_vertex_label(u, row_ptr, col_idx, args->labels);
+          local_changed |= relax_vertex_label(u, row_ptr, col_idx, args->labels, stats);
       }
     }
     else
     {
       // Static block assigned to this thread
       for (int32_t u = block_start; u < block_end; u++)
-        local_changed |= relax_vertex_label(u, row_ptr, col_idx, args->labels);
+        local_changed |= relax_vertex_label(u, row_ptr, col_idx, args->labels, stats);
     }
 
     // Mark if this thread changed anything
@@ -123,7 +395,10 @@ static void *lp_worker_full_async(void *arg)
       atomic_store_explicit(args->changed, 1, memory_order_relaxed);
 
     // Synchronize all threads
+    LP_INSTRUMENT_ONLY(double work_end = lp_instrument_now();)
     pthread_barrier_wait(args->barrier);
+    LP_INSTRUMENT_ONLY(stats->busy_seconds += work_end - round_start;
+                       stats->idle_seconds += lp_instrument_now() - work_end;)
 
     // One thread checks for convergence
     if (args->thread_id == 0)
@@ -139,6 +414,7 @@ static void *lp_worker_full_async(void *arg)
     }
 
     pthread_barrier_wait(args->barrier);
+    LP_INSTRUMENT_ONLY(if (args->thread_id == 0) lp_instrument_end_round(0.0);)
 
     // Stop condition: changed == -1 means no thread changed anything
     if (atomic_load_explicit(args->changed, memory_order_acquire) == -1)
@@ -148,8 +424,9 @@ static void *lp_worker_full_async(void *arg)
   return NULL;
 }
 
-void compute_connected_components_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
-                                           int num_threads, int chunk_size)
+// LP on caller-owned atomic labels; the workers initialize them
+static void run_lp_inplace(CCPthreadPool *pool, const CSRGraph *restrict G, atomic_int *restrict atomic_labels,
+                           int num_threads, int chunk_size)
 {
   const int32_t n = G->n;
   const int chunking_enabled = (chunk_size != 1);
@@ -158,16 +435,6 @@ void compute_connected_components_pthreads(const CSRGraph *restrict G, int32_t *
                                    ? (int32_t)(((int64_t)n + num_threads - 1) / num_threads)
                                    : 0;
 
-  atomic_int *atomic_labels;
-  if (posix_memalign((void **)&atomic_labels, 64, (size_t)n * sizeof(atomic_int)) != 0)
-  {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(EXIT_FAILURE);
-  }
-
-  for (int32_t i = 0; i < n; i++)
-    atomic_init(&atomic_labels[i], i);
-
   atomic_int changed;
   atomic_init(&changed, 1);
 
@@ -175,13 +442,12 @@ void compute_connected_components_pthreads(const CSRGraph *restrict G, int32_t *
   atomic_int next_vertex;
   atomic_init(&next_vertex, 0);
 
-  pthread_barrier_t barrier;
-  pthread_barrier_init(&barrier, NULL, num_threads);
+  pthread_barrier_t local_barrier;
+  pthread_barrier_t *barrier = acquire_barrier(pool, &local_barrier, num_threads);
 
-  pthread_t *threads = malloc(num_threads * sizeof(pthread_t));
   ThreadArgs *args = malloc(num_threads * sizeof(ThreadArgs));
 
-  // Create worker threads
+  // Per-thread arguments
   for (int t = 0; t < num_threads; t++)
   {
     args[t].G = G;
@@ -191,7 +457,7 @@ void compute_connected_components_pthreads(const CSRGraph *restrict G, int32_t *
     args[t].n = n;
     args[t].thread_id = t;
     args[t].num_threads = num_threads;
-    args[t].barrier = &barrier;
+    args[t].barrier = barrier;
     args[t].chunk_size = chunking_enabled ? effective_chunk : 0;
     args[t].chunking_enabled = chunking_enabled;
     if (!chunking_enabled)
@@ -210,19 +476,1369 @@ void compute_connected_components_pthreads(const CSRGraph *restrict G, int32_t *
       args[t].block_start = 0;
       args[t].block_end = 0;
     }
-    pthread_create(&threads[t], NULL, lp_worker_full_async, &args[t]);
   }
 
-  // Wait for all threads to finish
-  for (int t = 0; t < num_threads; t++)
-    pthread_join(threads[t], NULL);
+  LP_INSTRUMENT_ONLY(lp_instrument_begin(num_threads);)
+  run_workers(pool, num_threads, lp_worker_full_async, args, sizeof(*args));
+
+  release_barrier(pool, &local_barrier);
+  free(args);
+}
+
+static void run_lp(CCPthreadPool *pool, const CSRGraph *restrict G, int32_t *restrict labels,
+                   int num_threads, int chunk_size)
+{
+  const int32_t n = G->n;
+  atomic_int *atomic_labels;
+  if (!(atomic_labels = cc_alloc((size_t)n * sizeof(atomic_int))))
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  run_lp_inplace(pool, G, atomic_labels, num_threads, chunk_size);
 
   // Copy results
   for (int32_t i = 0; i < n; i++)
     labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
 
-  pthread_barrier_destroy(&barrier);
-  free(atomic_labels);
-  free(threads);
+  cc_free(atomic_labels);
+}
+
+// Cut the rows [start, end) into tasks of about grain cost units, one unit per vertex plus
+// one per edge; rows heavier than grain are split into edge ranges of their own.
+// With tasks == NULL only counts. Returns the number of tasks.
+static int64_t build_steal_tasks(const int64_t *restrict row_ptr, int32_t start, int32_t end,
+                                 int64_t grain, StealTask *tasks)
+{
+  int64_t count = 0;
+  int32_t first = start;
+  int64_t cost = 0;
+  for (int32_t u = start; u < end; u++)
+  {
+    int64_t degree = row_ptr[u + 1] - row_ptr[u];
+    if (degree + 1 > grain)
+    {
+      if (first < u)
+      {
+        if (tasks)
+          tasks[count] = (StealTask){first, u, row_ptr[first], row_ptr[u]};
+        count++;
+      }
+      for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j += grain)
+      {
+        if (tasks)
+        {
+          int64_t piece_end = (j + grain < row_ptr[u + 1]) ? j + grain : row_ptr[u + 1];
+          tasks[count] = (StealTask){u, u + 1, j, piece_end};
+        }
+        count++;
+      }
+      first = u + 1;
+      cost = 0;
+      continue;
+    }
+
+    if (cost + degree + 1 > grain && first < u)
+    {
+      if (tasks)
+        tasks[count] = (StealTask){first, u, row_ptr[first], row_ptr[u]};
+      count++;
+      first = u;
+      cost = 0;
+    }
+    cost += degree + 1;
+  }
+  if (first < end)
+  {
+    if (tasks)
+      tasks[count] = (StealTask){first, end, row_ptr[first], row_ptr[end]};
+    count++;
+  }
+  return count;
+}
+
+// Owner side: take the task at the bottom of the deque
+static inline int steal_deque_pop(StealDeque *deque, StealTask *task)
+{
+  int64_t b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+  if (t > b)
+  {
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    return 0;
+  }
+
+  *task = deque->tasks[b];
+  if (t == b)
+  {
+    // Last task: race the thieves for it
+    int won = atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                      memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    return won;
+  }
+  return 1;
+}
+
+// Thief side: take the task at the top of the deque. Returns 0 when it looks empty,
+// -1 when another thread won the race for the task
+static inline int steal_deque_steal(StealDeque *deque, StealTask *task)
+{
+  int64_t t = atomic_load_explicit(&deque->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+  if (t >= b)
+    return 0;
+
+  *task = deque->tasks[t];
+  if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                               memory_order_seq_cst, memory_order_relaxed))
+    return -1;
+  return 1;
+}
+
+// Steal from the other deques, starting at a random victim; returns 0 once all are empty
+static int steal_task(StealDeque *deques, int thread_id, int num_threads, uint32_t *rng, StealTask *task)
+{
+  for (;;)
+  {
+    *rng ^= *rng << 13;
+    *rng ^= *rng >> 17;
+    *rng ^= *rng << 5;
+    int first = (int)(*rng % (uint32_t)num_threads);
+    int contended = 0;
+    for (int k = 0; k < num_threads; k++)
+    {
+      int victim = (first + k) % num_threads;
+      if (victim == thread_id)
+        continue;
+      int status = steal_deque_steal(&deques[victim], task);
+      if (status == 1)
+        return 1;
+      if (status < 0)
+        contended = 1;
+    }
+    // Tasks are never added during a round, so only lost races are worth a retry
+    if (!contended)
+      return 0;
+  }
+}
+
+// Worker thread: label propagation over edge-balanced tasks with work stealing
+static void *lp_worker_steal(void *arg)
+{
+  StealArgs *args = (StealArgs *)arg;
+  const int64_t *restrict row_ptr = args->G->row_ptr;
+  const int32_t *restrict col_idx = args->G->col_idx;
+  StealDeque *self = &args->deques[args->thread_id];
+  uint32_t rng = 2654435761u * (uint32_t)(args->thread_id + 1);
+  int64_t steals = 0;
+  LPInstrumentSlot *stats = LP_INSTRUMENT_SLOT(args->thread_id);
+
+  // Tasks of this thread's edge-balanced share of the rows
+  int32_t start, end;
+  csr_edge_balanced_rows(row_ptr, args->G->n, args->num_threads, args->thread_id, &start, &end);
+  self->count = build_steal_tasks(row_ptr, start, end, args->grain, NULL);
+  self->tasks = malloc((size_t)(self->count > 0 ? self->count : 1) * sizeof(StealTask));
+  if (!self->tasks)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+  build_steal_tasks(row_ptr, start, end, args->grain, self->tasks);
+
+  // First touch of the labels of the same rows
+  for (int32_t u = start; u < end; u++)
+    atomic_init(&args->labels[u], u);
+
+  while (1)
+  {
+    int local_changed = 0;
+
+    // Refill the own deque; nobody steals before the barrier
+    atomic_store_explicit(&self->top, 0, memory_order_relaxed);
+    atomic_store_explicit(&self->bottom, self->count, memory_order_relaxed);
+    pthread_barrier_wait(args->barrier);
+    LP_INSTRUMENT_ONLY(double round_start = lp_instrument_now();)
+
+    StealTask task;
+    for (;;)
+    {
+      if (!steal_deque_pop(self, &task))
+      {
+        if (!steal_task(args->deques, args->thread_id, args->num_threads, &rng, &task))
+          break;
+        steals++;
+      }
+
+      for (int32_t u = task.first; u < task.last; u++)
+      {
+        int64_t begin = row_ptr[u] > task.edge_begin ? row_ptr[u] : task.edge_begin;
+        int64_t stop = row_ptr[u + 1] < task.edge_end ? row_ptr[u + 1] : task.edge_end;
+        local_changed |= relax_vertex_range(u, begin, stop, col_idx, args->labels, stats);
+      }
+    }
+
+    if (local_changed)
+      atomic_store_explicit(args->changed, 1, memory_order_relaxed);
+    LP_INSTRUMENT_ONLY(double work_end = lp_instrument_now();)
+    pthread_barrier_wait(args->barrier);
+    LP_INSTRUMENT_ONLY(stats->busy_seconds += work_end - round_start;
+                       stats->idle_seconds += lp_instrument_now() - work_end;)
+
+    // One thread checks for convergence
+    if (args->thread_id == 0)
+    {
+      if (atomic_load_explicit(args->changed, memory_order_acquire) == 0)
+        atomic_store_explicit(args->changed, -1, memory_order_release);
+      else
+        atomic_store_explicit(args->changed, 0, memory_order_relaxed);
+    }
+    pthread_barrier_wait(args->barrier);
+    LP_INSTRUMENT_ONLY(if (args->thread_id == 0) lp_instrument_end_round(0.0);)
+
+    if (atomic_load_explicit(args->changed, memory_order_acquire) == -1)
+      break;
+  }
+
+  args->steals[args->thread_id] = steals;
+  free(self->tasks);
+  self->tasks = NULL;
+  return NULL;
+}
+
+static int64_t run_lp_steal(CCPthreadPool *pool, const CSRGraph *restrict G, int32_t *restrict labels,
+                            int num_threads, int chunk_size)
+{
+  const int32_t n = G->n;
+  const int effective_chunk = (chunk_size > 0) ? chunk_size : DEFAULT_CHUNK_SIZE;
+
+  // chunk_size keeps its meaning: a task holds about chunk_size average vertices worth of edges
+  int64_t grain = (int64_t)effective_chunk * (n > 0 ? G->m / n + 1 : 1);
+  if (grain < STEAL_MIN_GRAIN)
+    grain = STEAL_MIN_GRAIN;
+
+  atomic_int *atomic_labels;
+  StealDeque *deques;
+  if (!(atomic_labels = cc_alloc((size_t)n * sizeof(atomic_int))) ||
+      posix_memalign((void **)&deques, 64, (size_t)num_threads * sizeof(StealDeque)) != 0)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    atomic_init(&deques[t].top, 0);
+    atomic_init(&deques[t].bottom, 0);
+    deques[t].tasks = NULL;
+    deques[t].count = 0;
+  }
+
+  atomic_int changed;
+  atomic_init(&changed, 0);
+
+  pthread_barrier_t local_barrier;
+  pthread_barrier_t *barrier = acquire_barrier(pool, &local_barrier, num_threads);
+
+  StealArgs *args = malloc(num_threads * sizeof(StealArgs));
+  int64_t *steals = malloc(num_threads * sizeof(int64_t));
+  if (!args || !steals)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    args[t].G = G;
+    args[t].labels = atomic_labels;
+    args[t].changed = &changed;
+    args[t].deques = deques;
+    args[t].grain = grain;
+    args[t].steals = steals;
+    args[t].thread_id = t;
+    args[t].num_threads = num_threads;
+    args[t].barrier = barrier;
+  }
+
+  LP_INSTRUMENT_ONLY(lp_instrument_begin(num_threads);)
+  run_workers(pool, num_threads, lp_worker_steal, args, sizeof(*args));
+
+  for (int32_t i = 0; i < n; i++)
+    labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
+
+  int64_t total_steals = 0;
+  for (int t = 0; t < num_threads; t++)
+    total_steals += steals[t];
+
+  release_barrier(pool, &local_barrier);
+  cc_free(atomic_labels);
+  free(deques);
+  free(steals);
   free(args);
+  return total_steals;
+}
+
+// Sum of the per-thread change counters
+static inline int64_t async_total_changes(AsyncSlot *slots, int num_threads)
+{
+  int64_t total = 0;
+  for (int t = 0; t < num_threads; t++)
+    total += atomic_load(&slots[t].changes);
+  return total;
+}
+
+// Worker thread: barrier-free label propagation with counter-based termination.
+// Each thread keeps sweeping its edge-balanced rows while labels keep changing. A sweep is
+// clean when it changed nothing and the change total was the same before and after it;
+// the thread then publishes that total as its clean epoch and idles until the total moves.
+// Once every clean epoch equals the current total, no thread is sweeping and no change is
+// pending, so the labels are a fixpoint.
+static void *lp_worker_async(void *arg)
+{
+  AsyncArgs *args = (AsyncArgs *)arg;
+  const int64_t *restrict row_ptr = args->G->row_ptr;
+  const int32_t *restrict col_idx = args->G->col_idx;
+  AsyncSlot *slots = args->slots;
+  AsyncSlot *self = &slots[args->thread_id];
+  const int num_threads = args->num_threads;
+
+  int32_t start, end;
+  csr_edge_balanced_rows(row_ptr, args->G->n, num_threads, args->thread_id, &start, &end);
+  for (int32_t u = start; u < end; u++)
+    atomic_init(&args->labels[u], u);
+  pthread_barrier_wait(args->barrier);
+
+  int64_t own_changes = 0;
+  int64_t verified = -1; // change total this thread's rows were last verified at
+  int sweeps = 0;
+  int idle_spins = 0;
+  while (1)
+  {
+    int64_t before = async_total_changes(slots, num_threads);
+    if (before == verified)
+    {
+      if (atomic_load_explicit(args->done, memory_order_acquire))
+        break;
+      // Nothing new since the last clean sweep: back off instead of rescanning
+      if (++idle_spins % ASYNC_YIELD_SPINS == 0)
+        sched_yield();
+      continue;
+    }
+    idle_spins = 0;
+
+    atomic_store(&self->clean_epoch, -1);
+    int64_t local_changes = 0;
+    for (int32_t u = start; u < end; u++)
+      local_changes += relax_vertex_label(u, row_ptr, col_idx, args->labels, NULL);
+    sweeps++;
+
+    if (local_changes > 0)
+    {
+      own_changes += local_changes;
+      atomic_store(&self->changes, own_changes);
+      continue;
+    }
+    if (async_total_changes(slots, num_threads) != before)
+      continue;
+
+    // Clean sweep at total `before`; the last thread to get there ends the run
+    verified = before;
+    atomic_store(&self->clean_epoch, before);
+    int quiescent = 1;
+    for (int t = 0; t < num_threads && quiescent; t++)
+      quiescent = (atomic_load(&slots[t].clean_epoch) == before);
+    if (quiescent && async_total_changes(slots, num_threads) == before)
+      atomic_store_explicit(args->done, 1, memory_order_release);
+  }
+
+  args->sweeps[args->thread_id] = sweeps;
+  return NULL;
+}
+
+static int run_lp_async(CCPthreadPool *pool, const CSRGraph *restrict G, int32_t *restrict labels,
+                        int num_threads)
+{
+  const int32_t n = G->n;
+
+  atomic_int *atomic_labels;
+  AsyncSlot *slots;
+  if (!(atomic_labels = cc_alloc((size_t)n * sizeof(atomic_int))) ||
+      posix_memalign((void **)&slots, 64, (size_t)num_threads * sizeof(AsyncSlot)) != 0)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    atomic_init(&slots[t].changes, 0);
+    atomic_init(&slots[t].clean_epoch, -1);
+  }
+
+  atomic_int done;
+  atomic_init(&done, 0);
+
+  pthread_barrier_t local_barrier;
+  pthread_barrier_t *barrier = acquire_barrier(pool, &local_barrier, num_threads);
+
+  AsyncArgs *args = malloc(num_threads * sizeof(AsyncArgs));
+  int *sweeps = malloc(num_threads * sizeof(int));
+  if (!args || !sweeps)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    args[t].G = G;
+    args[t].labels = atomic_labels;
+    args[t].slots = slots;
+    args[t].done = &done;
+    args[t].sweeps = sweeps;
+    args[t].thread_id = t;
+    args[t].num_threads = num_threads;
+    args[t].barrier = barrier;
+  }
+
+  run_workers(pool, num_threads, lp_worker_async, args, sizeof(*args));
+
+  for (int32_t i = 0; i < n; i++)
+    labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
+
+  int max_sweeps = 0;
+  for (int t = 0; t < num_threads; t++)
+  {
+    if (sweeps[t] > max_sweeps)
+      max_sweeps = sweeps[t];
+  }
+
+  release_barrier(pool, &local_barrier);
+  cc_free(atomic_labels);
+  free(slots);
+  free(sweeps);
+  free(args);
+  return max_sweeps;
+}
+
+// Worker thread: Afforest phases separated by barriers
+static void *afforest_worker(void *arg)
+{
+  AfforestArgs *args = (AfforestArgs *)arg;
+  const int64_t *restrict row_ptr = args->G->row_ptr;
+  const int32_t *restrict col_idx = args->G->col_idx;
+  _Atomic int32_t *parent = args->parent;
+  const int32_t block_start = args->split.block_start;
+  const int32_t block_end = args->split.block_end;
+  int32_t start, end;
+
+  for (int32_t u = block_start; u < block_end; u++)
+    atomic_store_explicit(&parent[u], u, memory_order_relaxed);
+  pthread_barrier_wait(args->barrier);
+
+  // Link the first few neighbors of every vertex, compressing after each round
+  for (int r = 0; r < AFFOREST_NEIGHBOR_ROUNDS; r++)
+  {
+    int taken = 0;
+    while (claim_range(&args->split, &args->cursors[r], &taken, &start, &end))
+    {
+      for (int32_t u = start; u < end; u++)
+      {
+        if (row_ptr[u] + r < row_ptr[u + 1])
+          uf_link(parent, u, col_idx[row_ptr[u] + r]);
+      }
+    }
+    pthread_barrier_wait(args->barrier);
+
+    for (int32_t u = block_start; u < block_end; u++)
+      uf_compress(parent, u);
+    pthread_barrier_wait(args->barrier);
+  }
+
+  // One thread samples the giant component for everyone
+  if (args->thread_id == 0)
+    *args->giant = uf_sample_frequent_root(parent, args->split.n);
+  pthread_barrier_wait(args->barrier);
+
+  const int32_t giant = *args->giant;
+  int taken = 0;
+  while (claim_range(&args->split, &args->cursors[AFFOREST_NEIGHBOR_ROUNDS], &taken, &start, &end))
+  {
+    for (int32_t u = start; u < end; u++)
+    {
+      // Vertices already in the giant component need no further work
+      if (atomic_load_explicit(&parent[u], memory_order_relaxed) == giant)
+        continue;
+      for (int64_t j = row_ptr[u] + AFFOREST_NEIGHBOR_ROUNDS; j < row_ptr[u + 1]; j++)
+        uf_link(parent, u, col_idx[j]);
+    }
+  }
+  pthread_barrier_wait(args->barrier);
+
+  // Final compress doubles as the copy into the output labels
+  for (int32_t u = block_start; u < block_end; u++)
+  {
+    uf_compress(parent, u);
+    args->labels[u] = atomic_load_explicit(&parent[u], memory_order_relaxed);
+  }
+
+  return NULL;
+}
+
+static void run_afforest(CCPthreadPool *pool, const CSRGraph *restrict G, int32_t *restrict labels,
+                         int num_threads, int chunk_size)
+{
+  const int32_t n = G->n;
+
+  _Atomic int32_t *parent;
+  if (!(parent = cc_alloc((size_t)n * sizeof(*parent))))
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  atomic_int cursors[AFFOREST_NEIGHBOR_ROUNDS + 1];
+  for (int r = 0; r <= AFFOREST_NEIGHBOR_ROUNDS; r++)
+    atomic_init(&cursors[r], 0);
+
+  int32_t giant = 0;
+
+  pthread_barrier_t local_barrier;
+  pthread_barrier_t *barrier = acquire_barrier(pool, &local_barrier, num_threads);
+
+  AfforestArgs *args = malloc(num_threads * sizeof(AfforestArgs));
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    args[t].G = G;
+    args[t].labels = labels;
+    args[t].parent = parent;
+    args[t].cursors = cursors;
+    args[t].giant = &giant;
+    args[t].thread_id = t;
+    args[t].barrier = barrier;
+    init_work_split(&args[t].split, n, t, num_threads, chunk_size);
+  }
+
+  run_workers(pool, num_threads, afforest_worker, args, sizeof(*args));
+
+  release_barrier(pool, &local_barrier);
+  cc_free(parent);
+  free(args);
+}
+
+// Recompute star[] for the current parent array (three barrier-separated passes)
+static void sv_mark_stars(SVArgs *args, _Atomic int32_t *parent, _Atomic int32_t *next)
+{
+  const int32_t block_start = args->split.block_start;
+  const int32_t block_end = args->split.block_end;
+  atomic_uchar *star = args->star;
+
+  // Start the hooking step from a copy of the current parents
+  for (int32_t v = block_start; v < block_end; v++)
+  {
+    atomic_store_explicit(&next[v], atomic_load_explicit(&parent[v], memory_order_relaxed),
+                          memory_order_relaxed);
+    atomic_store_explicit(&star[v], 1, memory_order_relaxed);
+  }
+  pthread_barrier_wait(args->barrier);
+
+  // A vertex with a grandparent other than its parent disqualifies itself and that grandparent
+  for (int32_t v = block_start; v < block_end; v++)
+  {
+    int32_t p = atomic_load_explicit(&parent[v], memory_order_relaxed);
+    int32_t gp = atomic_load_explicit(&parent[p], memory_order_relaxed);
+    if (p != gp)
+    {
+      atomic_store_explicit(&star[v], 0, memory_order_relaxed);
+      atomic_store_explicit(&star[gp], 0, memory_order_relaxed);
+    }
+  }
+  pthread_barrier_wait(args->barrier);
+
+  // Children inherit the status of their root
+  for (int32_t v = block_start; v < block_end; v++)
+  {
+    int32_t p = atomic_load_explicit(&parent[v], memory_order_relaxed);
+    if (atomic_load_explicit(&star[v], memory_order_relaxed) &&
+        !atomic_load_explicit(&star[p], memory_order_relaxed))
+      atomic_store_explicit(&star[v], 0, memory_order_relaxed);
+  }
+  pthread_barrier_wait(args->barrier);
+}
+
+// Hook star roots onto neighboring trees. Reads parent[], writes next[] so the step
+// behaves like a synchronous PRAM step. Conditional hooking only moves a root to a
+// smaller parent; unconditional hooking lets stagnant stars join any adjacent tree.
+static int sv_hook(SVArgs *args, _Atomic int32_t *parent, _Atomic int32_t *next,
+                   atomic_int *cursor, int conditional)
+{
+  const int64_t *restrict row_ptr = args->G->row_ptr;
+  const int32_t *restrict col_idx = args->G->col_idx;
+  atomic_uchar *star = args->star;
+  int local_changed = 0;
+  int taken = 0;
+  int32_t start, end;
+
+  while (claim_range(&args->split, cursor, &taken, &start, &end))
+  {
+    for (int32_t u = start; u < end; u++)
+    {
+      if (!atomic_load_explicit(&star[u], memory_order_relaxed))
+        continue;
+
+      int32_t pu = atomic_load_explicit(&parent[u], memory_order_relaxed);
+      for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
+      {
+        int32_t pv = atomic_load_explicit(&parent[col_idx[j]], memory_order_relaxed);
+        if (conditional)
+        {
+          // Keep the smallest candidate so the outcome is deterministic
+          int32_t current = atomic_load_explicit(&next[pu], memory_order_relaxed);
+          while (pv < current &&
+                 !atomic_compare_exchange_weak_explicit(&next[pu], &current, pv,
+                                                        memory_order_relaxed, memory_order_relaxed))
+          {
+          }
+          if (pv < pu)
+            local_changed = 1;
+        }
+        else if (pv != pu)
+        {
+          atomic_store_explicit(&next[pu], pv, memory_order_relaxed);
+          local_changed = 1;
+          break;
+        }
+      }
+    }
+  }
+
+  pthread_barrier_wait(args->barrier);
+  return local_changed;
+}
+
+// Worker thread: synchronous Shiloach-Vishkin rounds separated by barriers
+static void *sv_worker(void *arg)
+{
+  SVArgs *args = (SVArgs *)arg;
+  const int32_t n = args->split.n;
+  const int32_t block_start = args->split.block_start;
+  const int32_t block_end = args->split.block_end;
+  _Atomic int32_t *parent = args->parent;
+  _Atomic int32_t *next = args->next;
+
+  for (int32_t v = block_start; v < block_end; v++)
+    atomic_store_explicit(&parent[v], v, memory_order_relaxed);
+  pthread_barrier_wait(args->barrier);
+
+  int round = 0;
+  while (1)
+  {
+    int local_changed = 0;
+    _Atomic int32_t *tmp;
+
+    // Conditional hooking
+    sv_mark_stars(args, parent, next);
+    local_changed |= sv_hook(args, parent, next, &args->cursors[0], 1);
+    tmp = parent;
+    parent = next;
+    next = tmp;
+
+    // Unconditional hooking of stars that did not move
+    sv_mark_stars(args, parent, next);
+    local_changed |= sv_hook(args, parent, next, &args->cursors[1], 0);
+    tmp = parent;
+    parent = next;
+    next = tmp;
+
+    // Pointer jumping
+    for (int32_t v = block_start; v < block_end; v++)
+    {
+      int32_t p = atomic_load_explicit(&parent[v], memory_order_relaxed);
+      int32_t gp = atomic_load_explicit(&parent[p], memory_order_relaxed);
+      if (p != gp)
+      {
+        atomic_store_explicit(&parent[v], gp, memory_order_relaxed);
+        local_changed = 1;
+      }
+    }
+
+    if (local_changed)
+      atomic_store_explicit(args->changed, 1, memory_order_relaxed);
+    round++;
+    pthread_barrier_wait(args->barrier);
+
+    // One thread checks for convergence and rearms the work queues
+    if (args->thread_id == 0)
+    {
+      atomic_store_explicit(&args->cursors[0], 0, memory_order_relaxed);
+      atomic_store_explicit(&args->cursors[1], 0, memory_order_relaxed);
+      if (atomic_load_explicit(args->changed, memory_order_acquire) == 0)
+        atomic_store_explicit(args->changed, -1, memory_order_release);
+      else
+        atomic_store_explicit(args->changed, 0, memory_order_relaxed);
+    }
+    pthread_barrier_wait(args->barrier);
+
+    if (atomic_load_explicit(args->changed, memory_order_acquire) == -1)
+      break;
+  }
+
+  if (args->thread_id == 0)
+    *args->rounds = round;
+
+  // Every tree is now a star; roots are arbitrary, so relabel with the component minimum
+  for (int32_t v = block_start; v < block_end; v++)
+    atomic_store_explicit(&next[v], n, memory_order_relaxed);
+  pthread_barrier_wait(args->barrier);
+
+  for (int32_t v = block_start; v < block_end; v++)
+  {
+    int32_t root = atomic_load_explicit(&parent[v], memory_order_relaxed);
+    int32_t current = atomic_load_explicit(&next[root], memory_order_relaxed);
+    while (v < current &&
+           !atomic_compare_exchange_weak_explicit(&next[root], &current, v,
+                                                  memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+  }
+  pthread_barrier_wait(args->barrier);
+
+  for (int32_t v = block_start; v < block_end; v++)
+    args->labels[v] = atomic_load_explicit(&next[atomic_load_explicit(&parent[v], memory_order_relaxed)],
+                                           memory_order_relaxed);
+
+  return NULL;
+}
+
+static int run_sv(CCPthreadPool *pool, const CSRGraph *restrict G, int32_t *restrict labels,
+                  int num_threads, int chunk_size)
+{
+  const int32_t n = G->n;
+
+  _Atomic int32_t *parent;
+  _Atomic int32_t *next;
+  atomic_uchar *star;
+  if (!(parent = cc_alloc((size_t)n * sizeof(*parent))) ||
+      !(next = cc_alloc((size_t)n * sizeof(*next))) ||
+      !(star = cc_alloc((size_t)n * sizeof(*star))))
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  atomic_int cursors[2];
+  atomic_init(&cursors[0], 0);
+  atomic_init(&cursors[1], 0);
+
+  atomic_int changed;
+  atomic_init(&changed, 0);
+
+  int rounds = 0;
+
+  pthread_barrier_t local_barrier;
+  pthread_barrier_t *barrier = acquire_barrier(pool, &local_barrier, num_threads);
+
+  SVArgs *args = malloc(num_threads * sizeof(SVArgs));
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    args[t].G = G;
+    args[t].labels = labels;
+    args[t].parent = parent;
+    args[t].next = next;
+    args[t].star = star;
+    args[t].cursors = cursors;
+    args[t].changed = &changed;
+    args[t].rounds = &rounds;
+    args[t].thread_id = t;
+    args[t].barrier = barrier;
+    init_work_split(&args[t].split, n, t, num_threads, chunk_size);
+  }
+
+  run_workers(pool, num_threads, sv_worker, args, sizeof(*args));
+
+  release_barrier(pool, &local_barrier);
+  cc_free(parent);
+  cc_free(next);
+  cc_free(star);
+  free(args);
+  return rounds;
+}
+
+// Worker thread: frontier label propagation, one scan phase per round plus an
+// optional pack phase when the frontier shrinks below the dense threshold
+static void *frontier_worker(void *arg)
+{
+  FrontierArgs *args = (FrontierArgs *)arg;
+  FrontierState *state = args->state;
+  const int64_t *restrict row_ptr = args->G->row_ptr;
+  const int32_t *restrict col_idx = args->G->col_idx;
+  const int32_t n = args->G->n;
+  const int tid = args->thread_id;
+
+  WorkSplit vertex_split;
+  init_work_split(&vertex_split, n, tid, args->num_threads, args->chunk_size);
+
+  while (1)
+  {
+    const int dense = state->dense;
+    const int build_list = !dense;
+    int64_t edges_scanned = 0;
+    int64_t activated = 0;
+    FrontierBatch batch;
+    batch.count = 0;
+    FrontierBatch *out = build_list ? &batch : NULL;
+
+    // Scan phase: bitmap over all vertices or the explicit list
+    WorkSplit split = vertex_split;
+    if (!dense)
+      init_work_split(&split, (int32_t)state->frontier_size, tid, args->num_threads, args->chunk_size);
+
+    int taken = 0;
+    int32_t start, end;
+    while (claim_range(&split, &args->cursors[0], &taken, &start, &end))
+    {
+      for (int32_t i = start; i < end; i++)
+      {
+        int32_t u = i;
+        if (dense)
+        {
+          if (!atomic_load_explicit(&state->in_frontier[u], memory_order_relaxed))
+            continue;
+        }
+        else
+        {
+          u = state->frontier[i];
+        }
+        atomic_store_explicit(&state->in_frontier[u], 0, memory_order_relaxed);
+        edges_scanned += frontier_push_label(u, row_ptr, col_idx, args->labels, state->in_next, out,
+                                             state->next_frontier, &state->next_tail, &activated);
+      }
+    }
+    if (out)
+      frontier_batch_flush(out, state->next_frontier, &state->next_tail);
+
+    state->edges[tid] = edges_scanned;
+    state->activated[tid] = activated;
+    pthread_barrier_wait(args->barrier);
+
+    // One thread closes the round, swaps the frontiers and rearms the work queues
+    if (tid == 0)
+    {
+      int64_t round_edges = 0;
+      int64_t next_size = 0;
+      for (int t = 0; t < args->num_threads; t++)
+      {
+        round_edges += state->edges[t];
+        next_size += state->activated[t];
+      }
+      if (state->stats)
+        lp_round_stats_push(state->stats, state->frontier_size, round_edges, dense);
+      state->rounds++;
+
+      atomic_uchar *tmp_flags = state->in_frontier;
+      state->in_frontier = state->in_next;
+      state->in_next = tmp_flags;
+      int32_t *tmp_list = state->frontier;
+      state->frontier = state->next_frontier;
+      state->next_frontier = tmp_list;
+
+      state->frontier_size = next_size;
+      state->dense = next_size > n / FRONTIER_DENSE_DIVISOR;
+      state->pack = !state->dense && !build_list && next_size > 0;
+      atomic_store_explicit(&state->next_tail, 0, memory_order_relaxed);
+      atomic_store_explicit(&state->pack_tail, 0, memory_order_relaxed);
+      atomic_store_explicit(&args->cursors[0], 0, memory_order_relaxed);
+      atomic_store_explicit(&args->cursors[1], 0, memory_order_relaxed);
+    }
+    pthread_barrier_wait(args->barrier);
+
+    if (state->frontier_size == 0)
+      break;
+
+    // Leaving dense mode: build the list from the bitmap once
+    if (state->pack)
+    {
+      taken = 0;
+      while (claim_range(&vertex_split, &args->cursors[1], &taken, &start, &end))
+      {
+        for (int32_t u = start; u < end; u++)
+        {
+          if (atomic_load_explicit(&state->in_frontier[u], memory_order_relaxed))
+            frontier_batch_push(&batch, u, state->frontier, &state->pack_tail);
+        }
+      }
+      frontier_batch_flush(&batch, state->frontier, &state->pack_tail);
+      pthread_barrier_wait(args->barrier);
+    }
+  }
+
+  return NULL;
+}
+
+static int run_frontier(CCPthreadPool *pool, const CSRGraph *restrict G, int32_t *restrict labels,
+                        int num_threads, int chunk_size, LPRoundStats *stats)
+{
+  const int32_t n = G->n;
+
+  _Atomic int32_t *atomic_labels;
+  FrontierState state;
+  if (!(atomic_labels = cc_alloc((size_t)n * sizeof(*atomic_labels))) ||
+      !(state.in_frontier = cc_alloc((size_t)n * sizeof(*state.in_frontier))) ||
+      !(state.in_next = cc_alloc((size_t)n * sizeof(*state.in_next))) ||
+      !(state.frontier = cc_alloc((size_t)n * sizeof(*state.frontier))) ||
+      !(state.next_frontier = cc_alloc((size_t)n * sizeof(*state.next_frontier))))
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Every vertex starts active
+  for (int32_t i = 0; i < n; i++)
+  {
+    atomic_init(&atomic_labels[i], i);
+    atomic_init(&state.in_frontier[i], 1);
+    atomic_init(&state.in_next[i], 0);
+  }
+
+  atomic_init(&state.next_tail, 0);
+  atomic_init(&state.pack_tail, 0);
+  state.frontier_size = n;
+  state.dense = 1;
+  state.pack = 0;
+  state.rounds = 0;
+  state.stats = stats;
+  state.edges = malloc(num_threads * sizeof(int64_t));
+  state.activated = malloc(num_threads * sizeof(int64_t));
+
+  atomic_int cursors[2];
+  atomic_init(&cursors[0], 0);
+  atomic_init(&cursors[1], 0);
+
+  pthread_barrier_t local_barrier;
+  pthread_barrier_t *barrier = acquire_barrier(pool, &local_barrier, num_threads);
+
+  FrontierArgs *args = malloc(num_threads * sizeof(FrontierArgs));
+  if (!state.edges || !state.activated || !args)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    args[t].G = G;
+    args[t].labels = atomic_labels;
+    args[t].state = &state;
+    args[t].cursors = cursors;
+    args[t].thread_id = t;
+    args[t].num_threads = num_threads;
+    args[t].chunk_size = chunk_size;
+    args[t].barrier = barrier;
+  }
+
+  run_workers(pool, num_threads, frontier_worker, args, sizeof(*args));
+
+  for (int32_t i = 0; i < n; i++)
+    labels[i] = atomic_load_explicit(&atomic_labels[i], memory_order_relaxed);
+
+  release_barrier(pool, &local_barrier);
+  cc_free(atomic_labels);
+  cc_free(state.in_frontier);
+  cc_free(state.in_next);
+  cc_free(state.frontier);
+  cc_free(state.next_frontier);
+  free(state.edges);
+  free(state.activated);
+  free(args);
+  return state.rounds;
+}
+
+// Frontier conversions run before a BFS level
+enum
+{
+  BFS_KEEP = 0,      // keep the current representation
+  BFS_TO_BITMAP = 1, // top-down list → bottom-up bitmap
+  BFS_TO_LIST = 2    // bottom-up bitmap → top-down list
+};
+
+// Worker thread: direction-optimizing BFS levels, then union-find over the unreached vertices
+static void *bfs_worker(void *arg)
+{
+  BFSArgs *args = (BFSArgs *)arg;
+  BFSState *state = args->state;
+  const int64_t *restrict row_ptr = args->G->row_ptr;
+  const int32_t *restrict col_idx = args->G->col_idx;
+  const int32_t n = args->G->n;
+  const int tid = args->thread_id;
+  const WorkSplit *vertex_split = &args->split;
+  const int32_t block_start = vertex_split->block_start;
+  const int32_t block_end = vertex_split->block_end;
+  atomic_uchar *visited = state->visited;
+
+  while (1)
+  {
+    // Prepare the frontier for this level
+    if (state->clear_next || state->convert == BFS_TO_LIST)
+    {
+      FrontierBatch batch;
+      batch.count = 0;
+      for (int32_t u = block_start; u < block_end; u++)
+      {
+        if (state->clear_next)
+          atomic_store_explicit(&state->in_next[u], 0, memory_order_relaxed);
+        if (state->convert == BFS_TO_LIST && atomic_load_explicit(&state->in_frontier[u], memory_order_relaxed))
+        {
+          atomic_store_explicit(&state->in_frontier[u], 0, memory_order_relaxed);
+          frontier_batch_push(&batch, u, state->frontier, &state->pack_tail);
+        }
+      }
+      frontier_batch_flush(&batch, state->frontier, &state->pack_tail);
+    }
+    if (state->convert == BFS_TO_BITMAP)
+    {
+      WorkSplit list_split;
+      init_work_split(&list_split, (int32_t)state->frontier_size, tid, args->num_threads, 1);
+      for (int32_t i = list_split.block_start; i < list_split.block_end; i++)
+        atomic_store_explicit(&state->in_frontier[state->frontier[i]], 1, memory_order_relaxed);
+    }
+    if (state->clear_next || state->convert != BFS_KEEP)
+      pthread_barrier_wait(args->barrier);
+
+    const int bottom_up = state->bottom_up;
+    int64_t found = 0;
+    int64_t found_edges = 0;
+    int taken = 0;
+    int32_t start, end;
+
+    if (bottom_up)
+    {
+      // Every unvisited vertex looks for a parent in the frontier
+      while (claim_range(vertex_split, &args->cursors[0], &taken, &start, &end))
+      {
+        for (int32_t v = start; v < end; v++)
+        {
+          if (atomic_load_explicit(&visited[v], memory_order_relaxed))
+            continue;
+          for (int64_t j = row_ptr[v]; j < row_ptr[v + 1]; j++)
+          {
+            if (atomic_load_explicit(&state->in_frontier[col_idx[j]], memory_order_relaxed))
+            {
+              atomic_store_explicit(&visited[v], 1, memory_order_relaxed);
+              atomic_store_explicit(&state->in_next[v], 1, memory_order_relaxed);
+              found++;
+              found_edges += row_ptr[v + 1] - row_ptr[v];
+              break;
+            }
+          }
+        }
+      }
+    }
+    else
+    {
+      // Frontier vertices claim their unvisited neighbors
+      FrontierBatch batch;
+      batch.count = 0;
+      WorkSplit split;
+      init_work_split(&split, (int32_t)state->frontier_size, tid, args->num_threads, args->chunk_size);
+      while (claim_range(&split, &args->cursors[0], &taken, &start, &end))
+      {
+        for (int32_t i = start; i < end; i++)
+        {
+          int32_t u = state->frontier[i];
+          for (int64_t j = row_ptr[u]; j < row_ptr[u + 1]; j++)
+          {
+            int32_t v = col_idx[j];
+            if (!atomic_load_explicit(&visited[v], memory_order_relaxed) &&
+                atomic_exchange_explicit(&visited[v], 1, memory_order_relaxed) == 0)
+            {
+              frontier_batch_push(&batch, v, state->next_frontier, &state->next_tail);
+              found++;
+              found_edges += row_ptr[v + 1] - row_ptr[v];
+            }
+          }
+        }
+      }
+      frontier_batch_flush(&batch, state->next_frontier, &state->next_tail);
+    }
+
+    state->found[tid] = found;
+    state->found_edges[tid] = found_edges;
+    pthread_barrier_wait(args->barrier);
+
+    // One thread closes the level and picks the direction of the next one
+    if (tid == 0)
+    {
+      int64_t next_size = 0;
+      int64_t next_edges = 0;
+      for (int t = 0; t < args->num_threads; t++)
+      {
+        next_size += state->found[t];
+        next_edges += state->found_edges[t];
+      }
+
+      if (bottom_up)
+      {
+        atomic_uchar *tmp_flags = state->in_frontier;
+        state->in_frontier = state->in_next;
+        state->in_next = tmp_flags;
+      }
+      else
+      {
+        int32_t *tmp_list = state->frontier;
+        state->frontier = state->next_frontier;
+        state->next_frontier = tmp_list;
+      }
+
+      const int64_t prev_size = state->frontier_size;
+      state->frontier_size = next_size;
+      state->unexplored_edges -= next_edges;
+      state->levels++;
+
+      state->clear_next = bottom_up;
+      state->convert = BFS_KEEP;
+      if (!bottom_up && next_edges > state->unexplored_edges / BFS_ALPHA)
+        state->convert = BFS_TO_BITMAP;
+      else if (bottom_up && next_size < prev_size && next_size < n / BFS_BETA)
+        state->convert = BFS_TO_LIST;
+      if (state->convert != BFS_KEEP)
+        state->bottom_up = !bottom_up;
+
+      atomic_store_explicit(&state->next_tail, 0, memory_order_relaxed);
+      atomic_store_explicit(&state->pack_tail, 0, memory_order_relaxed);
+      atomic_store_explicit(&args->cursors[0], 0, memory_order_relaxed);
+    }
+    pthread_barrier_wait(args->barrier);
+
+    if (state->frontier_size == 0)
+      break;
+  }
+
+  // The BFS component is labelled with its minimum vertex ID
+  int32_t local_min = n;
+  for (int32_t v = block_start; v < block_end; v++)
+  {
+    if (atomic_load_explicit(&visited[v], memory_order_relaxed))
+    {
+      local_min = v;
+      break;
+    }
+  }
+  state->found[tid] = local_min;
+  for (int32_t v = block_start; v < block_end; v++)
+    atomic_store_explicit(&state->parent[v], v, memory_order_relaxed);
+  pthread_barrier_wait(args->barrier);
+
+  int32_t giant_label = n;
+  for (int t = 0; t < args->num_threads; t++)
+  {
+    if (state->found[t] < giant_label)
+      giant_label = (int32_t)state->found[t];
+  }
+
+  // Union-find over the vertices the BFS did not reach; their edges stay among themselves
+  int taken = 0;
+  int32_t start, end;
+  while (claim_range(vertex_split, &args->cursors[1], &taken, &start, &end))
+  {
+    for (int32_t v = start; v < end; v++)
+    {
+      if (atomic_load_explicit(&visited[v], memory_order_relaxed))
+        continue;
+      for (int64_t j = row_ptr[v]; j < row_ptr[v + 1]; j++)
+      {
+        if (col_idx[j] < v)
+          uf_link(state->parent, v, col_idx[j]);
+      }
+    }
+  }
+  pthread_barrier_wait(args->barrier);
+
+  for (int32_t v = block_start; v < block_end; v++)
+  {
+    if (atomic_load_explicit(&visited[v], memory_order_relaxed))
+    {
+      args->labels[v] = giant_label;
+    }
+    else
+    {
+      uf_compress(state->parent, v);
+      args->labels[v] = atomic_load_explicit(&state->parent[v], memory_order_relaxed);
+    }
+  }
+
+  return NULL;
+}
+
+static int run_bfs(CCPthreadPool *pool, const CSRGraph *restrict G, int32_t *restrict labels,
+                   int num_threads, int chunk_size)
+{
+  const int32_t n = G->n;
+  if (n == 0)
+    return 0;
+
+  BFSState state;
+  if (!(state.visited = cc_alloc((size_t)n * sizeof(*state.visited))) ||
+      !(state.in_frontier = cc_alloc((size_t)n * sizeof(*state.in_frontier))) ||
+      !(state.in_next = cc_alloc((size_t)n * sizeof(*state.in_next))) ||
+      !(state.frontier = cc_alloc((size_t)n * sizeof(*state.frontier))) ||
+      !(state.next_frontier = cc_alloc((size_t)n * sizeof(*state.next_frontier))) ||
+      !(state.parent = cc_alloc((size_t)n * sizeof(*state.parent))))
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // Seed the BFS at the highest-degree vertex
+  int32_t seed = 0;
+  for (int32_t u = 1; u < n; u++)
+  {
+    if (G->row_ptr[u + 1] - G->row_ptr[u] > G->row_ptr[seed + 1] - G->row_ptr[seed])
+      seed = u;
+  }
+
+  for (int32_t i = 0; i < n; i++)
+  {
+    atomic_init(&state.visited[i], 0);
+    atomic_init(&state.in_frontier[i], 0);
+    atomic_init(&state.in_next[i], 0);
+  }
+  atomic_store_explicit(&state.visited[seed], 1, memory_order_relaxed);
+  state.frontier[0] = seed;
+
+  const int64_t seed_edges = G->row_ptr[seed + 1] - G->row_ptr[seed];
+  atomic_init(&state.next_tail, 0);
+  atomic_init(&state.pack_tail, 0);
+  state.frontier_size = 1;
+  state.unexplored_edges = G->m - seed_edges;
+  state.bottom_up = 0;
+  state.convert = (seed_edges > state.unexplored_edges / BFS_ALPHA) ? BFS_TO_BITMAP : BFS_KEEP;
+  if (state.convert == BFS_TO_BITMAP)
+    state.bottom_up = 1;
+  state.clear_next = 0;
+  state.levels = 0;
+  state.found = malloc(num_threads * sizeof(int64_t));
+  state.found_edges = malloc(num_threads * sizeof(int64_t));
+
+  atomic_int cursors[2];
+  atomic_init(&cursors[0], 0);
+  atomic_init(&cursors[1], 0);
+
+  pthread_barrier_t local_barrier;
+  pthread_barrier_t *barrier = acquire_barrier(pool, &local_barrier, num_threads);
+
+  BFSArgs *args = malloc(num_threads * sizeof(BFSArgs));
+  if (!state.found || !state.found_edges || !args)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+
+  for (int t = 0; t < num_threads; t++)
+  {
+    args[t].G = G;
+    args[t].labels = labels;
+    args[t].state = &state;
+    args[t].cursors = cursors;
+    args[t].thread_id = t;
+    args[t].num_threads = num_threads;
+    args[t].chunk_size = chunk_size;
+    args[t].barrier = barrier;
+    init_work_split(&args[t].split, n, t, num_threads, chunk_size);
+  }
+
+  run_workers(pool, num_threads, bfs_worker, args, sizeof(*args));
+
+  release_barrier(pool, &local_barrier);
+  cc_free(state.visited);
+  cc_free(state.in_frontier);
+  cc_free(state.in_next);
+  cc_free(state.frontier);
+  cc_free(state.next_frontier);
+  cc_free(state.parent);
+  free(state.found);
+  free(state.found_edges);
+  free(args);
+  return state.levels;
+}
+
+void compute_connected_components_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                           int num_threads, int chunk_size)
+{
+  run_lp(NULL, G, labels, num_threads, chunk_size);
+}
+
+void compute_connected_components_afforest_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                    int num_threads, int chunk_size)
+{
+  run_afforest(NULL, G, labels, num_threads, chunk_size);
+}
+
+int64_t compute_connected_components_steal_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                    int num_threads, int chunk_size)
+{
+  return run_lp_steal(NULL, G, labels, num_threads, chunk_size);
+}
+
+int compute_connected_components_async_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                int num_threads)
+{
+  return run_lp_async(NULL, G, labels, num_threads);
+}
+
+int compute_connected_components_sv_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                             int num_threads, int chunk_size)
+{
+  return run_sv(NULL, G, labels, num_threads, chunk_size);
+}
+
+int compute_connected_components_frontier_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                                   int num_threads, int chunk_size, LPRoundStats *stats)
+{
+  return run_frontier(NULL, G, labels, num_threads, chunk_size, stats);
+}
+
+int compute_connected_components_bfs_pthreads(const CSRGraph *restrict G, int32_t *restrict labels,
+                                              int num_threads, int chunk_size)
+{
+  return run_bfs(NULL, G, labels, num_threads, chunk_size);
+}
+
+void cc_pthread_pool_run_lp_inplace(CCPthreadPool *pool, const CSRGraph *restrict G,
+                                    _Atomic int32_t *restrict labels, int num_threads, int chunk_size)
+{
+  run_lp_inplace(pool, G, labels, num_threads, chunk_size);
+}
+
+int cc_pthread_pool_run_cc(CCPthreadPool *pool, CCPoolKernel kernel, const CSRGraph *restrict G,
+                           int32_t *restrict labels, int num_threads, int chunk_size, LPRoundStats *stats)
+{
+  switch (kernel)
+  {
+  case CC_POOL_LP_STEAL:
+  {
+    int64_t steals = run_lp_steal(pool, G, labels, num_threads, chunk_size);
+    return steals > INT_MAX ? INT_MAX : (int)steals;
+  }
+  case CC_POOL_LP_ASYNC:
+    return run_lp_async(pool, G, labels, num_threads);
+  case CC_POOL_AFFOREST:
+    run_afforest(pool, G, labels, num_threads, chunk_size);
+    return 0;
+  case CC_POOL_SV:
+    return run_sv(pool, G, labels, num_threads, chunk_size);
+  case CC_POOL_FRONTIER:
+    return run_frontier(pool, G, labels, num_threads, chunk_size, stats);
+  case CC_POOL_BFS:
+    return run_bfs(pool, G, labels, num_threads, chunk_size);
+  default:
+    run_lp(pool, G, labels, num_threads, chunk_size);
+    return 0;
+  }
 }
@@ -0,0 +1,233 @@
+#define _POSIX_C_SOURCE 200112L
+#include "csr_compact.h"
+#include "cc_alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "thread_util.h"
+
+int csr_layout_parse(const char *name, CSRLayout *out)
+{
+  if (strcmp(name, "csr64") == 0)
+    *out = CSR_LAYOUT_CSR64;
+  else if (strcmp(name, "csr32") == 0)
+    *out = CSR_LAYOUT_CSR32;
+  else if (strcmp(name, "varint") == 0)
+    *out = CSR_LAYOUT_VARINT;
+  else
+    return -1;
+  return 0;
+}
+
+const char *csr_layout_name(CSRLayout layout)
+{
+  switch (layout)
+  {
+  case CSR_LAYOUT_CSR64:
+    return "csr64";
+  case CSR_LAYOUT_CSR32:
+    return "csr32";
+  case CSR_LAYOUT_VARINT:
+    return "varint";
+  }
+  return "unknown";
+}
+
+int csr32_from_csr(const CSRGraph *G, CSRGraph32 *out)
+{
+  memset(out, 0, sizeof(*out));
+  if (G->m > (int64_t)UINT32_MAX)
+    return 1;
+
+  if (!(out->row_ptr = cc_alloc(sizeof(uint32_t) * ((size_t)G->n + 1))))
+    return -1;
+  for (int32_t u = 0; u <= G->n; u++)
+    out->row_ptr[u] = (uint32_t)G->row_ptr[u];
+  out->n = G->n;
+  out->m = G->m;
+  out->col_idx = G->col_idx;
+  return 0;
+}
+
+void csr32_free(CSRGraph32 *g)
+{
+  cc_free(g->row_ptr);
+  memset(g, 0, sizeof(*g));
+}
+
+static inline int varint_length(uint32_t value)
+{
+  int bytes = 1;
+  while (value >= 0x80)
+  {
+    value >>= 7;
+    bytes++;
+  }
+  return bytes;
+}
+
+static inline uint8_t *varint_encode(uint8_t *p, uint32_t value)
+{
+  while (value >= 0x80)
+  {
+    *p++ = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  *p++ = (uint8_t)value;
+  return p;
+}
+
+static inline uint32_t zigzag32(int64_t delta)
+{
+  return (uint32_t)((delta << 1) ^ (delta >> 63));
+}
+
+// Shared state of the parallel encoder
+typedef struct
+{
+  const CSRGraph *G;
+  CSRGraphVarint *out;
+  int64_t *block_bytes; // per thread: encoded bytes, then the first byte offset of its rows
+  int *unsorted;        // per thread: found a row that is not strictly increasing
+} VarintBuildCtx;
+
+// Pass 1: encoded length of every row into row_off[u]
+static void varint_size_rows(int thread_id, int num_threads, void *arg)
+{
+  VarintBuildCtx *ctx = (VarintBuildCtx *)arg;
+  const CSRGraph *G = ctx->G;
+  int32_t start, end;
+  csr_edge_balanced_rows(G->row_ptr, G->n, num_threads, thread_id, &start, &end);
+
+  int64_t total = 0;
+  for (int32_t u = start; u < end; u++)
+  {
+    int64_t begin = G->row_ptr[u];
+    int64_t stop = G->row_ptr[u + 1];
+    uint64_t bytes = 0;
+    if (begin < stop)
+      bytes += (uint64_t)varint_length(zigzag32((int64_t)G->col_idx[begin] - u));
+    for (int64_t j = begin + 1; j < stop; j++)
+    {
+      if (G->col_idx[j] <= G->col_idx[j - 1])
+      {
+        ctx->unsorted[thread_id] = 1;
+        return;
+      }
+      bytes += (uint64_t)varint_length((uint32_t)(G->col_idx[j] - G->col_idx[j - 1] - 1));
+    }
+    ctx->out->row_off[u] = bytes;
+    total += (int64_t)bytes;
+  }
+  ctx->block_bytes[thread_id] = total;
+}
+
+// Pass 2: turn the lengths into offsets from the thread's start and encode the rows.
+// Each thread only rewrites the offsets of its own rows
+static void varint_encode_rows(int thread_id, int num_threads, void *arg)
+{
+  VarintBuildCtx *ctx = (VarintBuildCtx *)arg;
+  const CSRGraph *G = ctx->G;
+  CSRGraphVarint *out = ctx->out;
+  int32_t start, end;
+  csr_edge_balanced_rows(G->row_ptr, G->n, num_threads, thread_id, &start, &end);
+
+  uint64_t offset = (uint64_t)ctx->block_bytes[thread_id];
+  for (int32_t u = start; u < end; u++)
+  {
+    uint64_t bytes = out->row_off[u];
+    out->row_off[u] = offset;
+    uint8_t *p = out->data + offset;
+    int64_t begin = G->row_ptr[u];
+    int64_t stop = G->row_ptr[u + 1];
+    if (begin < stop)
+      p = varint_encode(p, zigzag32((int64_t)G->col_idx[begin] - u));
+    for (int64_t j = begin + 1; j < stop; j++)
+      p = varint_encode(p, (uint32_t)(G->col_idx[j] - G->col_idx[j - 1] - 1));
+    offset += bytes;
+  }
+}
+
+int csr_varint_from_csr(const CSRGraph *G, int num_threads, CSRGraphVarint *out)
+{
+  memset(out, 0, sizeof(*out));
+  if (num_threads <= 0)
+    num_threads = thread_util_default_threads();
+
+  VarintBuildCtx ctx = {.G = G, .out = out};
+  ctx.block_bytes = (int64_t *)malloc(sizeof(int64_t) * (size_t)num_threads);
+  ctx.unsorted = (int *)calloc((size_t)num_threads, sizeof(int));
+  if (!ctx.block_bytes || !ctx.unsorted ||
+      !(out->row_off = cc_alloc(sizeof(uint64_t) * ((size_t)G->n + 1))))
+  {
+    out->row_off = NULL;
+    free(ctx.block_bytes);
+    free(ctx.unsorted);
+    return -1;
+  }
+
+  // Both passes split the rows by edges, so every thread encodes the rows it sized
+  int rc = 0;
+  thread_util_parallel_run(num_threads, varint_size_rows, &ctx);
+  for (int t = 0; t < num_threads; t++)
+  {
+    if (ctx.unsorted[t])
+      rc = 1;
+  }
+
+  int64_t total = 0;
+  for (int t = 0; t < num_threads && rc == 0; t++)
+  {
+    int64_t bytes = ctx.block_bytes[t];
+    ctx.block_bytes[t] = total;
+    total += bytes;
+  }
+
+  if (rc == 0)
+  {
+    out->data_bytes = (size_t)total;
+    out->data = (uint8_t *)cc_alloc(out->data_bytes);
+    if (!out->data)
+      rc = -1;
+  }
+  if (rc == 0)
+  {
+    thread_util_parallel_run(num_threads, varint_encode_rows, &ctx);
+    out->row_off[G->n] = (uint64_t)total;
+    out->n = G->n;
+    out->m = G->m;
+  }
+
+  free(ctx.block_bytes);
+  free(ctx.unsorted);
+  if (rc != 0)
+    csr_varint_free(out);
+  return rc;
+}
+
+void csr_varint_free(CSRGraphVarint *g)
+{
+  cc_free(g->row_off);
+  cc_free(g->data);
+  memset(g, 0, sizeof(*g));
+}
+
+double csr64_bytes_per_edge(const CSRGraph *G)
+{
+  double bytes = (double)((size_t)G->n + 1) * sizeof(int64_t) + (double)G->m * sizeof(int32_t);
+  return G->m > 0 ? bytes / (double)G->m : 0.0;
+}
+
+double csr32_bytes_per_edge(const CSRGraph32 *G)
+{
+  double bytes = (double)((size_t)G->n + 1) * sizeof(uint32_t) + (double)G->m * sizeof(int32_t);
+  return G->m > 0 ? bytes / (double)G->m : 0.0;
+}
+
+double csr_varint_bytes_per_edge(const CSRGraphVarint *G)
+{
+  double bytes = (double)((size_t)G->n + 1) * sizeof(uint64_t) + (double)G->data_bytes;
+  return G->m > 0 ? bytes / (double)G->m : 0.0;
+}
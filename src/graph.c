@@ -7,10 +7,16 @@
 #include <strings.h>
 #include <inttypes.h>
 #include <errno.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <matio.h>
 
 #include "graph.h"
+#include "cc_alloc.h"
+#include "graph_gen.h"
 #include "mmio.h"
+#include "thread_util.h"
 
 // simple (u,v) edge
 typedef struct
@@ -18,45 +24,45 @@ typedef struct
   int32_t u, v;
 } Edge;
 
-// comparison function between edges for qsort
-static int cmp_edge(const void *a, const void *b)
+// Per-thread edge buffer filled by the loaders
+typedef struct
 {
-  const Edge *ea = (const Edge *)a;
-  const Edge *eb = (const Edge *)b;
-  if (ea->u != eb->u)
-    return (ea->u < eb->u) ? -1 : 1;
-  if (ea->v != eb->v)
-    return (ea->v < eb->v) ? -1 : 1;
-  return 0;
-}
+  Edge *edges;
+  int64_t count;
+  int64_t capacity;
+  int failed; // allocation failure while parsing
+} EdgeBuffer;
 
-// deduplicate sorted edges in-place, updating m
-static void dedup_edges(Edge *E, int64_t *m, int drop_self_loops)
+static int build_csr_from_edge_buffers(EdgeBuffer *buffers, int num_buffers, int32_t n,
+                                       int drop_self_loops, int num_threads, CSRGraph *out);
+
+// Set by graph_set_low_memory_loading
+static int low_memory_loading = 0;
+
+void graph_set_low_memory_loading(int enabled)
 {
-  int64_t write = 0;
-  for (int64_t r = 0; r < *m; ++r)
-  {
-    if (drop_self_loops && E[r].u == E[r].v)
-      continue;
-    if (write == 0 ||
-        E[r].u != E[write - 1].u ||
-        E[r].v != E[write - 1].v)
-    {
-      E[write++] = E[r];
-    }
-  }
-  *m = write;
+  low_memory_loading = enabled;
 }
 
 int load_csr_from_file(const char *path, int symmetrize, int drop_self_loops, CSRGraph *out)
 {
+  // Generator options may contain '.', so the prefix is checked before the extension
+  if (graph_gen_is_spec(path))
+    return load_csr_from_generator(path, 0, out);
+
   const char *ext = strrchr(path, '.');
   if (!ext)
     ext = "";
 
   if (strcasecmp(ext, ".mtx") == 0 || strcasecmp(ext, ".txt") == 0)
   {
-    return load_csr_from_mtx(path, symmetrize, drop_self_loops, out);
+    if (low_memory_loading)
+      return load_csr_from_mtx_low_memory(path, symmetrize, drop_self_loops, 0, out);
+    return load_csr_from_mtx_parallel(path, symmetrize, drop_self_loops, 0, out);
+  }
+  else if (strcasecmp(ext, ".csr") == 0)
+  {
+    return load_csr_from_bin(path, out);
   }
   else if (strcasecmp(ext, ".mat") == 0)
   {
@@ -140,69 +146,960 @@ int load_csr_from_mtx(const char *path, int symmetrize, int drop_self_loops, CSR
   }
   fclose(f);
 
-  qsort(E, m, sizeof(Edge), cmp_edge);
-  dedup_edges(E, &m, drop_self_loops);
+  EdgeBuffer buffer = {.edges = E, .count = m, .capacity = cap, .failed = 0};
+  return build_csr_from_edge_buffers(&buffer, 1, n, drop_self_loops, 0, out);
+}
+
+// Shared state of the parallel CSR build
+typedef struct
+{
+  EdgeBuffer *buffers;      // edge source (edge-list loaders)
+  int num_buffers;
+  const mat_sparse_t *csc;  // edge source (.mat loader), column c holds entries (ir[j], c)
+  int32_t csc_cols;
+  CSREdgeGenerator generator; // edge source (synthetic graphs), both directions of each edge
+  const void *generator_params;
+  int64_t generator_edges;
+  int32_t n;
+  int drop_self_loops;
+  _Atomic int64_t *cursor;  // per-row counts, then per-row scatter positions
+  int64_t *row_ptr;         // row offsets of the scattered (unsorted) rows
+  int32_t *col_idx;         // scattered neighbors
+  int64_t *final_row_ptr;   // row offsets after removing duplicates
+  int32_t *final_col_idx;   // compacted neighbors
+  int64_t *block_sums;      // per-thread totals for the prefix scan
+  int64_t *scan_target;     // array scanned in place by csr_scan_*
+} CSRBuildCtx;
+
+void csr_edge_balanced_rows(const int64_t *row_ptr, int32_t n, int parts, int part,
+                            int32_t *start, int32_t *end)
+{
+  const int64_t m = row_ptr[n];
+  int32_t bounds[2];
+  for (int k = 0; k < 2; k++)
+  {
+    int p = part + k;
+    if (p <= 0)
+    {
+      bounds[k] = 0;
+      continue;
+    }
+    if (p >= parts)
+    {
+      bounds[k] = n;
+      continue;
+    }
+    // First row starting at or after the p-th share of the edges
+    int64_t target = m / parts * p + m % parts * p / parts;
+    int32_t lo = 0, hi = n;
+    while (lo < hi)
+    {
+      int32_t mid = lo + (hi - lo) / 2;
+      if (row_ptr[mid] < target)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    bounds[k] = lo;
+  }
+  *start = bounds[0];
+  *end = bounds[1];
+}
+
+static void csr_count_edges(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  for (int b = 0; b < ctx->num_buffers; b++)
+  {
+    const Edge *E = ctx->buffers[b].edges;
+    long long start, end;
+    thread_util_split_range(ctx->buffers[b].count, num_threads, thread_id, &start, &end);
+    for (long long r = start; r < end; ++r)
+    {
+      if (ctx->drop_self_loops && E[r].u == E[r].v)
+        continue;
+      atomic_fetch_add_explicit(&ctx->cursor[E[r].u], 1, memory_order_relaxed);
+    }
+  }
+}
+
+static void csr_scatter_edges(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  for (int b = 0; b < ctx->num_buffers; b++)
+  {
+    const Edge *E = ctx->buffers[b].edges;
+    long long start, end;
+    thread_util_split_range(ctx->buffers[b].count, num_threads, thread_id, &start, &end);
+    for (long long r = start; r < end; ++r)
+    {
+      if (ctx->drop_self_loops && E[r].u == E[r].v)
+        continue;
+      int64_t pos = atomic_fetch_add_explicit(&ctx->cursor[E[r].u], 1, memory_order_relaxed);
+      ctx->col_idx[pos] = E[r].v;
+    }
+  }
+}
+
+static void csr_count_csc(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  const mat_sparse_t *csc = ctx->csc;
+  long long start, end;
+  thread_util_split_range(ctx->csc_cols, num_threads, thread_id, &start, &end);
+  for (long long c = start; c < end; ++c)
+  {
+    for (int64_t j = csc->jc[c]; j < (int64_t)csc->jc[c + 1]; ++j)
+    {
+      int r = csc->ir[j];
+      if (r >= 0 && r < ctx->n)
+        atomic_fetch_add_explicit(&ctx->cursor[r], 1, memory_order_relaxed);
+    }
+  }
+}
+
+static void csr_scatter_csc(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  const mat_sparse_t *csc = ctx->csc;
+  long long start, end;
+  thread_util_split_range(ctx->csc_cols, num_threads, thread_id, &start, &end);
+  for (long long c = start; c < end; ++c)
+  {
+    for (int64_t j = csc->jc[c]; j < (int64_t)csc->jc[c + 1]; ++j)
+    {
+      int r = csc->ir[j];
+      if (r < 0 || r >= ctx->n)
+        continue;
+      int64_t pos = atomic_fetch_add_explicit(&ctx->cursor[r], 1, memory_order_relaxed);
+      ctx->col_idx[pos] = (int32_t)c;
+    }
+  }
+}
+
+static void csr_count_generated(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->generator_edges, num_threads, thread_id, &start, &end);
+  for (long long k = start; k < end; ++k)
+  {
+    int32_t u, v;
+    if (!ctx->generator(ctx->generator_params, k, &u, &v) || u == v)
+      continue;
+    atomic_fetch_add_explicit(&ctx->cursor[u], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ctx->cursor[v], 1, memory_order_relaxed);
+  }
+}
+
+// Generates every edge a second time; the generator is a pure function of k
+static void csr_scatter_generated(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->generator_edges, num_threads, thread_id, &start, &end);
+  for (long long k = start; k < end; ++k)
+  {
+    int32_t u, v;
+    if (!ctx->generator(ctx->generator_params, k, &u, &v) || u == v)
+      continue;
+    int64_t pos = atomic_fetch_add_explicit(&ctx->cursor[u], 1, memory_order_relaxed);
+    ctx->col_idx[pos] = v;
+    pos = atomic_fetch_add_explicit(&ctx->cursor[v], 1, memory_order_relaxed);
+    ctx->col_idx[pos] = u;
+  }
+}
+
+// Copy the per-row counts into row_ptr[u + 1]
+static void csr_copy_counts(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  for (long long u = start; u < end; ++u)
+    ctx->row_ptr[u + 1] = atomic_load_explicit(&ctx->cursor[u], memory_order_relaxed);
+}
+
+// Blocked exclusive scan over scan_target[1..n]: first pass sums each block
+static void csr_scan_sums(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  int64_t sum = 0;
+  for (long long u = start; u < end; ++u)
+    sum += ctx->scan_target[u + 1];
+  ctx->block_sums[thread_id] = sum;
+}
+
+// Second pass: turn counts into offsets starting at the block's prefix
+static void csr_scan_offsets(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  int64_t offset = ctx->block_sums[thread_id];
+  for (long long u = start; u < end; ++u)
+  {
+    offset += ctx->scan_target[u + 1];
+    ctx->scan_target[u + 1] = offset;
+  }
+}
+
+static void csr_prefix_scan(CSRBuildCtx *ctx, int64_t *target, int num_threads)
+{
+  ctx->scan_target = target;
+  target[0] = 0;
+  thread_util_parallel_run(num_threads, csr_scan_sums, ctx);
+  int64_t running = 0;
+  for (int t = 0; t < num_threads; t++)
+  {
+    int64_t block = ctx->block_sums[t];
+    ctx->block_sums[t] = running;
+    running += block;
+  }
+  thread_util_parallel_run(num_threads, csr_scan_offsets, ctx);
+}
+
+// Point each row's scatter cursor at its first slot
+static void csr_init_cursor(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  for (long long u = start; u < end; ++u)
+    atomic_store_explicit(&ctx->cursor[u], ctx->row_ptr[u], memory_order_relaxed);
+}
+
+static inline void swap_int32(int32_t *a, int32_t *b)
+{
+  int32_t t = *a;
+  *a = *b;
+  *b = t;
+}
 
-  int64_t *restrict row_ptr;
-  if (posix_memalign((void **)&row_ptr, 64, sizeof(int64_t) * (n + 1)) != 0)
+// Sort a short neighbor list; most rows are below the quicksort cutoff
+static void sort_neighbors(int32_t *a, int64_t len)
+{
+  while (len > 32)
   {
-    free(E);
-    return 6;
+    // Median of three pivot, then Hoare partition
+    int64_t mid = len / 2;
+    if (a[mid] < a[0])
+      swap_int32(&a[mid], &a[0]);
+    if (a[len - 1] < a[0])
+      swap_int32(&a[len - 1], &a[0]);
+    if (a[len - 1] < a[mid])
+      swap_int32(&a[len - 1], &a[mid]);
+    int32_t pivot = a[mid];
+
+    int64_t i = -1, j = len;
+    for (;;)
+    {
+      do
+        i++;
+      while (a[i] < pivot);
+      do
+        j--;
+      while (a[j] > pivot);
+      if (i >= j)
+        break;
+      swap_int32(&a[i], &a[j]);
+    }
+
+    // Recurse into the smaller half, loop on the larger one
+    int64_t left = j + 1;
+    if (left < len - left)
+    {
+      sort_neighbors(a, left);
+      a += left;
+      len -= left;
+    }
+    else
+    {
+      sort_neighbors(a + left, len - left);
+      len = left;
+    }
   }
 
-  for (int64_t r = 0; r < m; ++r)
-    row_ptr[E[r].u + 1]++;
-  for (int32_t i = 0; i < n; ++i)
-    row_ptr[i + 1] += row_ptr[i];
+  for (int64_t i = 1; i < len; ++i)
+  {
+    int32_t v = a[i];
+    int64_t j = i - 1;
+    while (j >= 0 && a[j] > v)
+    {
+      a[j + 1] = a[j];
+      j--;
+    }
+    a[j + 1] = v;
+  }
+}
 
-  int32_t *restrict col_idx;
-  if (posix_memalign((void **)&col_idx, 64, sizeof(int32_t) * m) != 0)
+// Sort and deduplicate every row in place; the new degree goes to final_row_ptr[u + 1]
+static void csr_sort_rows(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  int32_t start, end;
+  csr_edge_balanced_rows(ctx->row_ptr, ctx->n, num_threads, thread_id, &start, &end);
+  for (int32_t u = start; u < end; ++u)
   {
-    free(row_ptr);
-    free(E);
-    return 7;
+    int32_t *row = ctx->col_idx + ctx->row_ptr[u];
+    int64_t len = ctx->row_ptr[u + 1] - ctx->row_ptr[u];
+    sort_neighbors(row, len);
+
+    int64_t write = 0;
+    for (int64_t r = 0; r < len; ++r)
+    {
+      if (write == 0 || row[r] != row[write - 1])
+        row[write++] = row[r];
+    }
+    ctx->final_row_ptr[u + 1] = write;
+  }
+}
+
+// Copy the deduplicated prefix of every row into the compacted array
+static void csr_compact_rows(int thread_id, int num_threads, void *arg)
+{
+  CSRBuildCtx *ctx = (CSRBuildCtx *)arg;
+  int32_t start, end;
+  csr_edge_balanced_rows(ctx->final_row_ptr, ctx->n, num_threads, thread_id, &start, &end);
+  for (int32_t u = start; u < end; ++u)
+  {
+    int64_t len = ctx->final_row_ptr[u + 1] - ctx->final_row_ptr[u];
+    memcpy(ctx->final_col_idx + ctx->final_row_ptr[u], ctx->col_idx + ctx->row_ptr[u],
+           sizeof(int32_t) * (size_t)len);
+  }
+}
+
+static void free_edge_buffers(EdgeBuffer *buffers, int num_buffers)
+{
+  for (int b = 0; b < num_buffers; b++)
+  {
+    free(buffers[b].edges);
+    buffers[b].edges = NULL;
   }
+}
 
-  int64_t *head = (int64_t *)malloc(sizeof(int64_t) * n);
-  if (!head)
+// Counting-sort build shared by all loaders: count per row, scan, scatter with atomic
+// cursors, then sort and deduplicate each (short) row independently. ctx must name one
+// edge source; edge buffers are released as soon as they have been scattered.
+static int build_csr(CSRBuildCtx *ctx, int num_threads, CSRGraph *out)
+{
+  if (num_threads <= 0)
+    num_threads = thread_util_default_threads();
+  const int32_t n = ctx->n;
+  const int from_buffers = (ctx->csc == NULL && ctx->generator == NULL);
+  thread_util_fn count_fn = from_buffers ? csr_count_edges : (ctx->csc ? csr_count_csc : csr_count_generated);
+  thread_util_fn scatter_fn =
+      from_buffers ? csr_scatter_edges : (ctx->csc ? csr_scatter_csc : csr_scatter_generated);
+  int rc = 0;
+
+  ctx->cursor = (_Atomic int64_t *)calloc((size_t)n + 1, sizeof(*ctx->cursor));
+  ctx->block_sums = (int64_t *)malloc(sizeof(int64_t) * (size_t)num_threads);
+  if (!ctx->cursor || !ctx->block_sums)
   {
-    free(col_idx);
-    free(row_ptr);
-    free(E);
-    return 8;
+    rc = 8;
+    goto done;
   }
-  memcpy(head, row_ptr, sizeof(int64_t) * n);
 
-  for (int64_t r = 0; r < m; ++r)
+  if (!(ctx->row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)n + 1))))
   {
-    int32_t u = E[r].u;
-    col_idx[head[u]++] = E[r].v;
+    rc = 6;
+    goto done;
   }
 
-  free(head);
-  free(E);
+  thread_util_parallel_run(num_threads, count_fn, ctx);
+  thread_util_parallel_run(num_threads, csr_copy_counts, ctx);
+  csr_prefix_scan(ctx, ctx->row_ptr, num_threads);
+  const int64_t m = ctx->row_ptr[n];
+
+  if (!(ctx->col_idx = cc_alloc(sizeof(int32_t) * (size_t)(m > 0 ? m : 1))))
+  {
+    rc = 7;
+    goto done;
+  }
+
+  thread_util_parallel_run(num_threads, csr_init_cursor, ctx);
+  thread_util_parallel_run(num_threads, scatter_fn, ctx);
+  if (from_buffers)
+    free_edge_buffers(ctx->buffers, ctx->num_buffers);
+  free(ctx->cursor);
+  ctx->cursor = NULL;
+
+  if (!(ctx->final_row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)n + 1))))
+  {
+    rc = 6;
+    goto done;
+  }
+  thread_util_parallel_run(num_threads, csr_sort_rows, ctx);
+  csr_prefix_scan(ctx, ctx->final_row_ptr, num_threads);
+  const int64_t final_m = ctx->final_row_ptr[n];
+
+  if (final_m == m)
+  {
+    // No duplicates: rows are already in place
+    ctx->final_col_idx = ctx->col_idx;
+    ctx->col_idx = NULL;
+  }
+  else
+  {
+    if (!(ctx->final_col_idx = cc_alloc(sizeof(int32_t) * (size_t)(final_m > 0 ? final_m : 1))))
+    {
+      rc = 7;
+      goto done;
+    }
+    thread_util_parallel_run(num_threads, csr_compact_rows, ctx);
+  }
 
   out->n = n;
-  out->m = m;
-  out->row_ptr = row_ptr;
-  out->col_idx = col_idx;
+  out->m = final_m;
+  out->row_ptr = ctx->final_row_ptr;
+  out->col_idx = ctx->final_col_idx;
+  ctx->final_row_ptr = NULL;
+  ctx->final_col_idx = NULL;
+
+done:
+  if (from_buffers)
+    free_edge_buffers(ctx->buffers, ctx->num_buffers);
+  free(ctx->cursor);
+  free(ctx->block_sums);
+  cc_free(ctx->row_ptr);
+  cc_free(ctx->col_idx);
+  cc_free(ctx->final_row_ptr);
+  cc_free(ctx->final_col_idx);
+  return rc;
+}
+
+static int build_csr_from_edge_buffers(EdgeBuffer *buffers, int num_buffers, int32_t n,
+                                       int drop_self_loops, int num_threads, CSRGraph *out)
+{
+  CSRBuildCtx ctx = {
+      .buffers = buffers,
+      .num_buffers = num_buffers,
+      .n = n,
+      .drop_self_loops = drop_self_loops};
+  return build_csr(&ctx, num_threads, out);
+}
+
+int build_csr_from_generator(int32_t n, int64_t num_edges, CSREdgeGenerator generator, const void *params,
+                             int num_threads, CSRGraph *out)
+{
+  memset(out, 0, sizeof(*out));
+  CSRBuildCtx ctx = {
+      .n = n,
+      .drop_self_loops = 1,
+      .generator = generator,
+      .generator_params = params,
+      .generator_edges = num_edges};
+  return build_csr(&ctx, num_threads, out);
+}
+
+// What a parse pass does with every edge
+typedef enum
+{
+  MTX_PASS_BUFFER = 0, // append to the thread's edge buffer
+  MTX_PASS_COUNT = 1,  // count the edge in its row (low-memory loader)
+  MTX_PASS_FILL = 2    // store the edge at its row cursor (low-memory loader)
+} MtxPass;
+
+// Shared state of one parallel parse
+typedef struct
+{
+  const char *body;     // first byte after the size line
+  size_t body_size;     // bytes until end of file
+  int32_t n;            // number of vertices
+  int mirror;           // add (j,i) for every (i,j) with i != j
+  EdgeBuffer *buffers;  // one buffer per thread
+  MtxPass pass;
+  int drop_self_loops;  // count/fill passes skip (i,i) themselves
+  _Atomic int64_t *row_cursor; // count/fill passes: per-row counts, then scatter positions
+  int32_t *col_idx;     // fill pass destination
+  _Atomic int64_t entries; // data lines parsed, checked against the header's nz
+} MtxParseCtx;
+
+static int edge_buffer_push(EdgeBuffer *buf, int32_t u, int32_t v)
+{
+  if (buf->count == buf->capacity)
+  {
+    int64_t new_capacity = buf->capacity ? buf->capacity * 2 : 1024;
+    Edge *tmp = (Edge *)realloc(buf->edges, sizeof(Edge) * new_capacity);
+    if (!tmp)
+    {
+      buf->failed = 1;
+      return -1;
+    }
+    buf->edges = tmp;
+    buf->capacity = new_capacity;
+  }
+  buf->edges[buf->count++] = (Edge){u, v};
   return 0;
 }
 
+// Parse an unsigned decimal at p; digits are accumulated without per-char bounds
+// checks beyond the range end. Returns the position after the number.
+static inline const char *parse_index(const char *p, const char *end, int64_t *out, int *ok)
+{
+  uint64_t value = 0;
+  const char *start = p;
+  while (p < end)
+  {
+    unsigned digit = (unsigned)(unsigned char)*p - '0';
+    if (digit > 9)
+      break;
+    value = value * 10 + digit;
+    p++;
+  }
+  *ok = (p != start) && (p - start) <= 18;
+  *out = (int64_t)value;
+  return p;
+}
+
+// Advance p past the end of the current line
+static inline const char *next_line(const char *p, const char *end)
+{
+  const char *nl = memchr(p, '\n', (size_t)(end - p));
+  return nl ? nl + 1 : end;
+}
+
+// Count or store (u, v) for the low-memory loader
+static inline void mtx_place_edge(MtxParseCtx *ctx, int32_t u, int32_t v)
+{
+  if (ctx->pass == MTX_PASS_COUNT)
+  {
+    atomic_fetch_add_explicit(&ctx->row_cursor[u + 1], 1, memory_order_relaxed);
+    return;
+  }
+  int64_t pos = atomic_fetch_add_explicit(&ctx->row_cursor[u], 1, memory_order_relaxed);
+  ctx->col_idx[pos] = v;
+}
+
+static void parse_mtx_range(int thread_id, int num_threads, void *arg)
+{
+  MtxParseCtx *ctx = (MtxParseCtx *)arg;
+  EdgeBuffer *buf = ctx->buffers ? &ctx->buffers[thread_id] : NULL;
+  const char *body_end = ctx->body + ctx->body_size;
+
+  long long start_off, end_off;
+  thread_util_split_range((long long)ctx->body_size, num_threads, thread_id, &start_off, &end_off);
+
+  // Each range owns the lines that start inside it
+  const char *p = ctx->body + start_off;
+  const char *end = ctx->body + end_off;
+  if (thread_id > 0 && p[-1] != '\n')
+    p = next_line(p, body_end);
+
+  if (ctx->pass == MTX_PASS_BUFFER)
+  {
+    // Rough initial guess: a short "i j" line is at least 4 bytes
+    int64_t guess = ((end_off - start_off) / 8 + 16) * (ctx->mirror ? 2 : 1);
+    buf->edges = (Edge *)malloc(sizeof(Edge) * guess);
+    buf->capacity = buf->edges ? guess : 0;
+  }
+
+  int64_t entries = 0;
+  while (p < end)
+  {
+    while (p < body_end && (*p == ' ' || *p == '\t'))
+      p++;
+    if (p >= body_end || *p == '%' || *p == '\n' || *p == '\r')
+    {
+      p = next_line(p, body_end);
+      continue;
+    }
+
+    int64_t i, j;
+    int ok_i, ok_j;
+    p = parse_index(p, body_end, &i, &ok_i);
+    while (p < body_end && (*p == ' ' || *p == '\t'))
+      p++;
+    p = parse_index(p, body_end, &j, &ok_j);
+    p = next_line(p, body_end); // ignore values and anything else on the line
+
+    // Malformed lines are not entries, so they show up as a count mismatch
+    if (!ok_i || !ok_j)
+      continue;
+    entries++;
+    i--;
+    j--; // convert to 0-based
+    if (i < 0 || j < 0 || i >= ctx->n || j >= ctx->n)
+      continue;
+    if (ctx->pass != MTX_PASS_BUFFER)
+    {
+      if (i == j && ctx->drop_self_loops)
+        continue;
+      mtx_place_edge(ctx, (int32_t)i, (int32_t)j);
+      if (ctx->mirror && i != j)
+        mtx_place_edge(ctx, (int32_t)j, (int32_t)i);
+      continue;
+    }
+    if (edge_buffer_push(buf, (int32_t)i, (int32_t)j) != 0)
+      return;
+    if (ctx->mirror && i != j && edge_buffer_push(buf, (int32_t)j, (int32_t)i) != 0)
+      return;
+  }
+  atomic_fetch_add_explicit(&ctx->entries, entries, memory_order_relaxed);
+}
+
+// Fail a parse whose entry count differs from the header (truncated file or extra lines)
+static int check_mtx_entries(const MtxParseCtx *ctx, int64_t nz, const char *path)
+{
+  int64_t entries = atomic_load(&ctx->entries);
+  if (entries == nz)
+    return 0;
+  fprintf(stderr, "%s declares %" PRId64 " entries but holds %" PRId64 "; the file is truncated or malformed.\n",
+          path, nz, entries);
+  return 1;
+}
+
+// Read the Matrix Market header of path (dimension and declared entry count) and map the
+// whole file. *map is NULL when the file has no body. Returns 0 or the loader error code.
+static int map_mtx_file(const char *path, int32_t *n, int64_t *num_entries, int *symmetric_in_file, void **map,
+                        size_t *file_size, long *body_offset)
+{
+  // Header through mmio, body through the mapping
+  FILE *f = fopen(path, "r");
+  if (!f)
+  {
+    perror("fopen");
+    return 1;
+  }
+
+  MM_typecode matcode;
+  if (mm_read_banner(f, &matcode) != 0)
+  {
+    fprintf(stderr, "Could not process Matrix Market banner.\n");
+    fclose(f);
+    return 2;
+  }
+
+  if (!mm_is_matrix(matcode) || !mm_is_coordinate(matcode))
+  {
+    fprintf(stderr, "Only sparse coordinate matrices are supported.\n");
+    fclose(f);
+    return 3;
+  }
+
+  int M, N, nz;
+  if (mm_read_mtx_crd_size(f, &M, &N, &nz) != 0)
+  {
+    fprintf(stderr, "Failed reading size line.\n");
+    fclose(f);
+    return 4;
+  }
+
+  *body_offset = ftell(f);
+  struct stat st;
+  if (*body_offset < 0 || fstat(fileno(f), &st) != 0)
+  {
+    perror("ftell/fstat");
+    fclose(f);
+    return 1;
+  }
+
+  *n = (int32_t)((M > N) ? M : N);
+  *num_entries = nz;
+  *symmetric_in_file = mm_is_symmetric(matcode) || mm_is_hermitian(matcode) || mm_is_skew(matcode);
+
+  *file_size = (size_t)st.st_size;
+  *map = NULL;
+  if (*file_size > (size_t)*body_offset)
+  {
+    *map = mmap(NULL, *file_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+    if (*map == MAP_FAILED)
+    {
+      *map = NULL;
+      perror("mmap");
+      fclose(f);
+      return 1;
+    }
+    posix_madvise(*map, *file_size, POSIX_MADV_SEQUENTIAL);
+  }
+  fclose(f);
+  return 0;
+}
+
+int load_csr_from_mtx_parallel(const char *path, int symmetrize, int drop_self_loops,
+                               int num_threads, CSRGraph *out)
+{
+  memset(out, 0, sizeof(*out));
+  if (num_threads <= 0)
+    num_threads = thread_util_default_threads();
+
+  int32_t n;
+  int64_t nz;
+  int symmetric_in_file;
+  void *map;
+  size_t file_size;
+  long body_offset;
+  int rc = map_mtx_file(path, &n, &nz, &symmetric_in_file, &map, &file_size, &body_offset);
+  if (rc != 0)
+    return rc;
+
+  EdgeBuffer *buffers = (EdgeBuffer *)calloc((size_t)num_threads, sizeof(EdgeBuffer));
+  if (!buffers)
+  {
+    if (map)
+      munmap(map, file_size);
+    return 5;
+  }
+
+  MtxParseCtx ctx = {
+      .body = map ? (const char *)map + body_offset : NULL,
+      .body_size = map ? file_size - (size_t)body_offset : 0,
+      .n = n,
+      .mirror = symmetric_in_file || symmetrize,
+      .buffers = buffers,
+      .pass = MTX_PASS_BUFFER};
+
+  if (ctx.body_size > 0)
+    thread_util_parallel_run(num_threads, parse_mtx_range, &ctx);
+  if (map)
+    munmap(map, file_size);
+
+  int failed = 0;
+  for (int t = 0; t < num_threads; t++)
+    failed |= buffers[t].failed;
+
+  if (failed)
+  {
+    for (int t = 0; t < num_threads; t++)
+      free(buffers[t].edges);
+    free(buffers);
+    fprintf(stderr, "Memory allocation failed while parsing %s\n", path);
+    return 5;
+  }
+  if (check_mtx_entries(&ctx, nz, path) != 0)
+  {
+    for (int t = 0; t < num_threads; t++)
+      free(buffers[t].edges);
+    free(buffers);
+    return 4;
+  }
+
+  rc = build_csr_from_edge_buffers(buffers, num_threads, n, drop_self_loops, num_threads, out);
+  free(buffers);
+  return rc;
+}
+
+int load_csr_from_mtx_low_memory(const char *path, int symmetrize, int drop_self_loops,
+                                 int num_threads, CSRGraph *out)
+{
+  memset(out, 0, sizeof(*out));
+  if (num_threads <= 0)
+    num_threads = thread_util_default_threads();
+
+  int32_t n;
+  int64_t nz;
+  int symmetric_in_file;
+  void *map;
+  size_t file_size;
+  long body_offset;
+  int rc = map_mtx_file(path, &n, &nz, &symmetric_in_file, &map, &file_size, &body_offset);
+  if (rc != 0)
+    return rc;
+
+  CSRBuildCtx build = {.n = n};
+  build.block_sums = (int64_t *)malloc(sizeof(int64_t) * (size_t)num_threads);
+  if (!build.block_sums ||
+      !(build.row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)n + 1))))
+  {
+    build.row_ptr = NULL;
+    rc = 6;
+    goto done;
+  }
+  memset(build.row_ptr, 0, sizeof(int64_t) * ((size_t)n + 1));
+
+  MtxParseCtx ctx = {
+      .body = map ? (const char *)map + body_offset : NULL,
+      .body_size = map ? file_size - (size_t)body_offset : 0,
+      .n = n,
+      .mirror = symmetric_in_file || symmetrize,
+      .pass = MTX_PASS_COUNT,
+      .drop_self_loops = drop_self_loops,
+      .row_cursor = (_Atomic int64_t *)build.row_ptr};
+
+  // Pass 1 counts every row into row_ptr[u + 1]; the scan turns counts into offsets
+  if (ctx.body_size > 0)
+    thread_util_parallel_run(num_threads, parse_mtx_range, &ctx);
+  if (check_mtx_entries(&ctx, nz, path) != 0)
+  {
+    rc = 4;
+    goto done;
+  }
+  csr_prefix_scan(&build, build.row_ptr, num_threads);
+  const int64_t m = build.row_ptr[n];
+
+  if (!(build.col_idx = cc_alloc(sizeof(int32_t) * (size_t)(m > 0 ? m : 1))))
+  {
+    rc = 7;
+    goto done;
+  }
+
+  // Pass 2 parses again and stores every edge at its row cursor, straight into col_idx
+  ctx.pass = MTX_PASS_FILL;
+  ctx.col_idx = build.col_idx;
+  if (ctx.body_size > 0)
+    thread_util_parallel_run(num_threads, parse_mtx_range, &ctx);
+  if (map)
+    munmap(map, file_size);
+  map = NULL;
+
+  // Each cursor stopped at the end of its row, which is where the next row starts
+  memmove(build.row_ptr + 1, build.row_ptr, sizeof(int64_t) * (size_t)n);
+  build.row_ptr[0] = 0;
+
+  if (!(build.final_row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)n + 1))))
+  {
+    rc = 6;
+    goto done;
+  }
+  thread_util_parallel_run(num_threads, csr_sort_rows, &build);
+  csr_prefix_scan(&build, build.final_row_ptr, num_threads);
+  const int64_t final_m = build.final_row_ptr[n];
+
+  if (final_m != m)
+  {
+    // Rows only move towards the front, so duplicates are squeezed out in place
+    for (int32_t u = 0; u < n; ++u)
+    {
+      int64_t len = build.final_row_ptr[u + 1] - build.final_row_ptr[u];
+      if (build.final_row_ptr[u] != build.row_ptr[u])
+        memmove(build.col_idx + build.final_row_ptr[u], build.col_idx + build.row_ptr[u],
+                sizeof(int32_t) * (size_t)len);
+    }
+    int32_t *shrunk = (int32_t *)cc_realloc(build.col_idx, sizeof(int32_t) * (size_t)(final_m > 0 ? final_m : 1));
+    if (shrunk)
+      build.col_idx = shrunk;
+  }
+
+  out->n = n;
+  out->m = final_m;
+  out->row_ptr = build.final_row_ptr;
+  out->col_idx = build.col_idx;
+  build.final_row_ptr = NULL;
+  build.col_idx = NULL;
+
+done:
+  if (map)
+    munmap(map, file_size);
+  free(build.block_sums);
+  cc_free(build.row_ptr);
+  cc_free(build.col_idx);
+  cc_free(build.final_row_ptr);
+  return rc;
+}
+
 void free_csr(CSRGraph *g)
 {
   if (!g)
     return;
-  if (g->row_ptr)
-    free(g->row_ptr);
-  if (g->col_idx)
-    free(g->col_idx);
+  if (g->storage == CSR_STORAGE_MMAP)
+  {
+    if (g->mapping)
+      munmap(g->mapping, g->mapping_size);
+  }
+  else
+  {
+    // cc_free also releases arrays that came from malloc, such as an adopted .mat ir
+    cc_free(g->row_ptr);
+    cc_free(g->col_idx);
+  }
+  g->storage = CSR_STORAGE_HEAP;
+  g->mapping = NULL;
+  g->mapping_size = 0;
   g->row_ptr = NULL;
   g->col_idx = NULL;
   g->n = 0;
   g->m = 0;
 }
 
+// Shared state of the CSC symmetry check
+typedef struct
+{
+  const int32_t *ir;      // row indices of the CSC, per column
+  const int64_t *col_ptr; // column offsets of the CSC
+  int32_t n;
+  atomic_int asymmetric;  // set by the first thread that finds a missing mirror entry
+} CSCCheckCtx;
+
+// Check that every column is strictly increasing and every (r, c) has its mirror (c, r)
+static void csc_check_symmetric(int thread_id, int num_threads, void *arg)
+{
+  CSCCheckCtx *ctx = (CSCCheckCtx *)arg;
+  int32_t start, end;
+  csr_edge_balanced_rows(ctx->col_ptr, ctx->n, num_threads, thread_id, &start, &end);
+  for (int32_t c = start; c < end; ++c)
+  {
+    if (atomic_load_explicit(&ctx->asymmetric, memory_order_relaxed))
+      return;
+    for (int64_t j = ctx->col_ptr[c]; j < ctx->col_ptr[c + 1]; ++j)
+    {
+      int32_t r = ctx->ir[j];
+      if (r < 0 || r >= ctx->n || (j > ctx->col_ptr[c] && r <= ctx->ir[j - 1]))
+      {
+        atomic_store_explicit(&ctx->asymmetric, 1, memory_order_relaxed);
+        return;
+      }
+
+      // Binary search for c in column r
+      int64_t lo = ctx->col_ptr[r], hi = ctx->col_ptr[r + 1];
+      while (lo < hi)
+      {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (ctx->ir[mid] < c)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+      if (lo == ctx->col_ptr[r + 1] || ctx->ir[lo] != c)
+      {
+        atomic_store_explicit(&ctx->asymmetric, 1, memory_order_relaxed);
+        return;
+      }
+    }
+  }
+}
+
+// Use the row indices of a symmetric n x n CSC matrix as col_idx, copied straight into a
+// cc_alloc block without the counting-sort build. Returns 0 when out holds the graph, 1 when
+// the matrix is not symmetric and -1 on allocation failure.
+static int csr_from_symmetric_csc(const mat_sparse_t *sparse, int32_t n, CSRGraph *out)
+{
+  // col_idx is copied as is, so the index type must already be 32-bit
+  if (sizeof(*sparse->ir) != sizeof(int32_t) || sparse->njc < n + 1)
+    return 1;
+
+  int64_t *row_ptr = NULL;
+  if (!(row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)n + 1))))
+    return -1;
+  for (int32_t c = 0; c <= n; ++c)
+    row_ptr[c] = (int64_t)sparse->jc[c];
+
+  CSCCheckCtx ctx = {.ir = (const int32_t *)sparse->ir, .col_ptr = row_ptr, .n = n};
+  atomic_init(&ctx.asymmetric, 0);
+  thread_util_parallel_run(0, csc_check_symmetric, &ctx);
+  if (atomic_load(&ctx.asymmetric))
+  {
+    cc_free(row_ptr);
+    return 1;
+  }
+
+  // matio owns sparse->ir and releases it in Mat_VarFree, so the graph gets its own copy
+  int32_t *col_idx = cc_alloc(sizeof(int32_t) * (size_t)(row_ptr[n] > 0 ? row_ptr[n] : 1));
+  if (!col_idx)
+  {
+    cc_free(row_ptr);
+    return -1;
+  }
+  memcpy(col_idx, sparse->ir, sizeof(int32_t) * (size_t)row_ptr[n]);
+
+  out->n = n;
+  out->m = row_ptr[n];
+  out->row_ptr = row_ptr;
+  out->col_idx = col_idx;
+  return 0;
+}
+
 int load_csr_from_mat(const char *path, CSRGraph *out)
 {
   memset(out, 0, sizeof(*out));
@@ -241,56 +1138,30 @@ int load_csr_from_mat(const char *path, CSRGraph *out)
   int32_t n = (int32_t)var->dims[0];
   int32_t mcols = (int32_t)var->dims[1];
 
-  int64_t nz = sparse->jc[mcols];
-
-  // Build CSR from column-compressed format in MATLAB (CSC)
-  int64_t *row_ptr = (int64_t *)calloc((size_t)n + 1, sizeof(int64_t));
-  int32_t *col_idx = (int32_t *)malloc(sizeof(int32_t) * nz);
-  if (!row_ptr || !col_idx)
+  // A symmetric CSC matrix already is the CSR of the graph: copy its arrays
+  int reused = (n == mcols) ? csr_from_symmetric_csc(sparse, n, out) : 1;
+  if (reused <= 0)
   {
-    fprintf(stderr, "Memory allocation failed\n");
     Mat_VarFree(var);
     Mat_Close(matfp);
-    free(row_ptr);
-    free(col_idx);
-    return 3;
+    if (reused < 0)
+      fprintf(stderr, "Memory allocation failed\n");
+    return reused == 0 ? 0 : 3;
   }
 
-  // Count entries per row
-  for (int c = 0; c < mcols; ++c)
-  {
-    for (int64_t j = sparse->jc[c]; j < sparse->jc[c + 1]; ++j)
-    {
-      int r = sparse->ir[j];
-      if (r >= 0 && r < n)
-        row_ptr[r + 1]++;
-    }
-  }
-  for (int i = 0; i < n; ++i)
-    row_ptr[i + 1] += row_ptr[i];
-
-  // Fill col_idx
-  int64_t *head = (int64_t *)malloc(sizeof(int64_t) * n);
-  memcpy(head, row_ptr, sizeof(int64_t) * n);
-
-  for (int c = 0; c < mcols; ++c)
-  {
-    for (int64_t j = sparse->jc[c]; j < sparse->jc[c + 1]; ++j)
-    {
-      int r = sparse->ir[j];
-      if (r < 0 || r >= n)
-        continue;
-      col_idx[head[r]++] = c;
-    }
-  }
+  // Build CSR from column-compressed format in MATLAB (CSC): row r of the CSR gets
+  // column c for every stored (r, c); entries are scattered in parallel and each row
+  // is sorted afterwards
+  CSRBuildCtx ctx = {
+      .csc = sparse,
+      .csc_cols = mcols,
+      .n = n,
+      .drop_self_loops = 0};
+  int rc = build_csr(&ctx, 0, out);
+  if (rc != 0)
+    fprintf(stderr, "Memory allocation failed\n");
 
-  free(head);
   Mat_VarFree(var);
   Mat_Close(matfp);
-
-  out->n = n;
-  out->m = row_ptr[n];
-  out->row_ptr = row_ptr;
-  out->col_idx = col_idx;
-  return 0;
+  return rc == 0 ? 0 : 3;
 }
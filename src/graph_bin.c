@@ -0,0 +1,388 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "graph.h"
+#include "graph_gen.h"
+#include "thread_util.h"
+
+#define CSR_BIN_MAGIC "CCCSRBIN"
+#define CSR_BIN_ALIGN 64
+
+// Build flags recorded in the header
+#define CSR_BIN_FLAG_SYMMETRIZE 0x1u
+#define CSR_BIN_FLAG_DROP_SELF_LOOPS 0x2u
+
+// On-disk header, padded to one cache line
+typedef struct
+{
+  char magic[8];           // CSR_BIN_MAGIC without terminator
+  uint32_t version;        // CSR_BIN_VERSION
+  uint32_t flags;          // CSR_BIN_FLAG_* used when building the graph
+  int64_t n;               // number of vertices
+  int64_t m;               // number of edges
+  uint64_t row_ptr_offset; // byte offset of row_ptr (64-byte aligned)
+  uint64_t col_idx_offset; // byte offset of col_idx (64-byte aligned)
+  uint64_t checksum;       // checksum of both sections
+  uint64_t reserved;       // zero
+} CSRBinHeader;
+
+_Static_assert(sizeof(CSRBinHeader) == CSR_BIN_ALIGN, "CSR header must fill one cache line");
+
+static uint64_t align_up(uint64_t value)
+{
+  return (value + CSR_BIN_ALIGN - 1) & ~(uint64_t)(CSR_BIN_ALIGN - 1);
+}
+
+// FNV-1a style mix over 64-bit words, with the byte tail folded into a final word
+static uint64_t checksum_update(uint64_t h, const void *data, size_t bytes)
+{
+  const unsigned char *p = (const unsigned char *)data;
+  size_t words = bytes / sizeof(uint64_t);
+  for (size_t i = 0; i < words; i++)
+  {
+    uint64_t w;
+    memcpy(&w, p + i * sizeof(uint64_t), sizeof(w));
+    h = (h ^ w) * 0x100000001b3ULL;
+  }
+
+  size_t tail = bytes % sizeof(uint64_t);
+  if (tail)
+  {
+    uint64_t w = 0;
+    memcpy(&w, p + words * sizeof(uint64_t), tail);
+    h = (h ^ w) * 0x100000001b3ULL;
+  }
+  return h;
+}
+
+static uint64_t csr_checksum(const int64_t *row_ptr, int64_t n, const int32_t *col_idx, int64_t m)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  h = checksum_update(h, row_ptr, (size_t)(n + 1) * sizeof(int64_t));
+  h = checksum_update(h, col_idx, (size_t)m * sizeof(int32_t));
+  return h;
+}
+
+static uint32_t build_flags(int symmetrize, int drop_self_loops)
+{
+  return (symmetrize ? CSR_BIN_FLAG_SYMMETRIZE : 0u) |
+         (drop_self_loops ? CSR_BIN_FLAG_DROP_SELF_LOOPS : 0u);
+}
+
+static int write_fully(int fd, const void *data, size_t bytes)
+{
+  const char *p = (const char *)data;
+  while (bytes > 0)
+  {
+    ssize_t written = write(fd, p, bytes);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    p += written;
+    bytes -= (size_t)written;
+  }
+  return 0;
+}
+
+static int write_padding(int fd, uint64_t from, uint64_t to)
+{
+  static const char zeros[CSR_BIN_ALIGN] = {0};
+  return (to > from) ? write_fully(fd, zeros, (size_t)(to - from)) : 0;
+}
+
+int save_csr_to_bin(const CSRGraph *g, const char *path, int symmetrize, int drop_self_loops)
+{
+  if (!g || !path || !g->row_ptr || (g->m > 0 && !g->col_idx))
+    return 1;
+
+  CSRBinHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CSR_BIN_MAGIC, sizeof(header.magic));
+  header.version = CSR_BIN_VERSION;
+  header.flags = build_flags(symmetrize, drop_self_loops);
+  header.n = g->n;
+  header.m = g->m;
+  header.row_ptr_offset = align_up(sizeof(CSRBinHeader));
+  header.col_idx_offset = align_up(header.row_ptr_offset + (uint64_t)(g->n + 1) * sizeof(int64_t));
+  header.checksum = csr_checksum(g->row_ptr, g->n, g->col_idx, g->m);
+
+  // Write to a temporary file and rename so concurrent readers never see a partial cache
+  char tmp_path[PATH_MAX];
+  int written = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%ld", path, (long)getpid());
+  if (written < 0 || (size_t)written >= sizeof(tmp_path))
+    return 2;
+
+  int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    fprintf(stderr, "Failed to create %s: %s\n", tmp_path, strerror(errno));
+    return 3;
+  }
+
+  uint64_t row_bytes = (uint64_t)(g->n + 1) * sizeof(int64_t);
+  uint64_t col_bytes = (uint64_t)g->m * sizeof(int32_t);
+  int rc = 0;
+  if (write_fully(fd, &header, sizeof(header)) != 0 ||
+      write_padding(fd, sizeof(header), header.row_ptr_offset) != 0 ||
+      write_fully(fd, g->row_ptr, (size_t)row_bytes) != 0 ||
+      write_padding(fd, header.row_ptr_offset + row_bytes, header.col_idx_offset) != 0 ||
+      write_fully(fd, g->col_idx, (size_t)col_bytes) != 0)
+  {
+    fprintf(stderr, "Failed to write %s: %s\n", tmp_path, strerror(errno));
+    rc = 4;
+  }
+
+  if (close(fd) != 0 && rc == 0)
+    rc = 4;
+
+  if (rc == 0 && rename(tmp_path, path) != 0)
+  {
+    fprintf(stderr, "Failed to rename %s to %s: %s\n", tmp_path, path, strerror(errno));
+    rc = 5;
+  }
+
+  if (rc != 0)
+    unlink(tmp_path);
+  return rc;
+}
+
+// Map path and validate its header; on success *header points into the mapping
+static int map_csr_file(const char *path, void **base, size_t *size, const CSRBinHeader **header)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+    return 1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CSRBinHeader))
+  {
+    fprintf(stderr, "%s is too small to be a CSR file.\n", path);
+    close(fd);
+    return 2;
+  }
+
+  void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    fprintf(stderr, "Failed to map %s: %s\n", path, strerror(errno));
+    return 3;
+  }
+
+  const CSRBinHeader *h = (const CSRBinHeader *)map;
+  const uint64_t file_size = (uint64_t)st.st_size;
+  int ok = memcmp(h->magic, CSR_BIN_MAGIC, sizeof(h->magic)) == 0 &&
+           h->version == CSR_BIN_VERSION &&
+           h->n >= 0 && h->n <= INT32_MAX && h->m >= 0 &&
+           h->row_ptr_offset % CSR_BIN_ALIGN == 0 &&
+           h->col_idx_offset % CSR_BIN_ALIGN == 0 &&
+           h->row_ptr_offset >= sizeof(CSRBinHeader) &&
+           h->row_ptr_offset + (uint64_t)(h->n + 1) * sizeof(int64_t) <= h->col_idx_offset &&
+           h->col_idx_offset + (uint64_t)h->m * sizeof(int32_t) <= file_size;
+  if (!ok)
+  {
+    fprintf(stderr, "%s is not a valid version %d CSR file.\n", path, CSR_BIN_VERSION);
+    munmap(map, (size_t)st.st_size);
+    return 4;
+  }
+
+  *base = map;
+  *size = (size_t)st.st_size;
+  *header = h;
+  return 0;
+}
+
+// Shared state of the structural check of a mapped graph
+typedef struct
+{
+  const int64_t *row_ptr;
+  const int32_t *col_idx;
+  int64_t n;
+  int64_t m;
+  atomic_int invalid;
+} CSRCheckCtx;
+
+// Every thread checks an equal share of the offsets and of the columns; the split cannot
+// follow row_ptr, which is what is being checked
+static void csr_check_structure(int thread_id, int num_threads, void *arg)
+{
+  CSRCheckCtx *ctx = (CSRCheckCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->n, num_threads, thread_id, &start, &end);
+  for (long long u = start; u < end; u++)
+  {
+    if (ctx->row_ptr[u] > ctx->row_ptr[u + 1])
+    {
+      atomic_store_explicit(&ctx->invalid, 1, memory_order_relaxed);
+      return;
+    }
+  }
+
+  thread_util_split_range(ctx->m, num_threads, thread_id, &start, &end);
+  for (long long j = start; j < end; j++)
+  {
+    int32_t v = ctx->col_idx[j];
+    if (v < 0 || v >= ctx->n)
+    {
+      atomic_store_explicit(&ctx->invalid, 1, memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+// Map path into out; the checksum pass over both sections runs only when verify is set
+static int map_csr_graph(const char *path, int verify, CSRGraph *out)
+{
+  memset(out, 0, sizeof(*out));
+
+  void *map;
+  size_t map_size;
+  const CSRBinHeader *header;
+  int rc = map_csr_file(path, &map, &map_size, &header);
+  if (rc != 0)
+    return rc;
+
+  int64_t *row_ptr = (int64_t *)((char *)map + header->row_ptr_offset);
+  int32_t *col_idx = (int32_t *)((char *)map + header->col_idx_offset);
+
+  if ((verify && csr_checksum(row_ptr, header->n, col_idx, header->m) != header->checksum) ||
+      row_ptr[0] != 0 || row_ptr[header->n] != header->m)
+  {
+    fprintf(stderr, "Checksum mismatch in %s; the file is corrupt or truncated.\n", path);
+    munmap(map, map_size);
+    return 5;
+  }
+
+  // A matching checksum does not make the arrays usable: the kernels index with them unchecked.
+  // Unverified maps leave this to their reader, which never looks at the sections up front
+  if (verify)
+  {
+    CSRCheckCtx check = {.row_ptr = row_ptr, .col_idx = col_idx, .n = header->n, .m = header->m};
+    atomic_init(&check.invalid, 0);
+    thread_util_parallel_run(0, csr_check_structure, &check);
+    if (atomic_load(&check.invalid))
+    {
+      fprintf(stderr, "%s holds decreasing row offsets or out-of-range columns.\n", path);
+      munmap(map, map_size);
+      return 6;
+    }
+  }
+
+  out->n = (int32_t)header->n;
+  out->m = header->m;
+  out->row_ptr = row_ptr;
+  out->col_idx = col_idx;
+  out->storage = CSR_STORAGE_MMAP;
+  out->mapping = map;
+  out->mapping_size = map_size;
+  return 0;
+}
+
+int load_csr_from_bin(const char *path, CSRGraph *out)
+{
+  return map_csr_graph(path, 1, out);
+}
+
+int map_csr_from_bin(const char *path, CSRGraph *out)
+{
+  return map_csr_graph(path, 0, out);
+}
+
+// Replace the extension of path (if any) with .csr
+static int cache_path_for(const char *path, char *dest, size_t dest_size)
+{
+  const char *slash = strrchr(path, '/');
+  const char *dot = strrchr(path, '.');
+  size_t stem_len = (dot && (!slash || dot > slash + 1)) ? (size_t)(dot - path) : strlen(path);
+  int written = snprintf(dest, dest_size, "%.*s.csr", (int)stem_len, path);
+  return (written < 0 || (size_t)written >= dest_size) ? -1 : 0;
+}
+
+// Read the header of a .csr file without mapping it. Returns 0 for a current-version header
+static int read_header(const char *path, CSRBinHeader *header)
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return -1;
+  size_t got = fread(header, sizeof(*header), 1, f);
+  fclose(f);
+  return (got == 1 && memcmp(header->magic, CSR_BIN_MAGIC, sizeof(header->magic)) == 0 &&
+          header->version == CSR_BIN_VERSION)
+             ? 0
+             : -1;
+}
+
+int csr_bin_is_symmetric(const char *path)
+{
+  CSRBinHeader header;
+  if (read_header(path, &header) != 0)
+    return -1;
+  return (header.flags & CSR_BIN_FLAG_SYMMETRIZE) ? 1 : 0;
+}
+
+// Returns 1 when cache_path exists, is newer than path and was built with matching flags
+static int cache_is_fresh(const char *path, const char *cache_path, uint32_t flags)
+{
+  struct stat src_st, cache_st;
+  if (stat(path, &src_st) != 0 || stat(cache_path, &cache_st) != 0)
+    return 0;
+  if (cache_st.st_mtime < src_st.st_mtime)
+    return 0;
+
+  CSRBinHeader header;
+  return read_header(cache_path, &header) == 0 && header.flags == flags;
+}
+
+int load_csr_from_file_cached(const char *path, int symmetrize, int drop_self_loops, CSRGraph *out)
+{
+  // Generated graphs are rebuilt in memory, never cached
+  if (graph_gen_is_spec(path))
+    return load_csr_from_file(path, symmetrize, drop_self_loops, out);
+
+  const char *ext = strrchr(path, '.');
+  if (ext && strcasecmp(ext, ".csr") == 0)
+    return load_csr_from_bin(path, out);
+
+  char cache_path[PATH_MAX];
+  if (cache_path_for(path, cache_path, sizeof(cache_path)) != 0)
+    return load_csr_from_file(path, symmetrize, drop_self_loops, out);
+
+  if (cache_is_fresh(path, cache_path, build_flags(symmetrize, drop_self_loops)))
+  {
+    if (load_csr_from_bin(cache_path, out) == 0)
+    {
+      printf("Using cached graph: %s\n", cache_path);
+      return 0;
+    }
+    fprintf(stderr, "Warning: ignoring unusable cache %s\n", cache_path);
+  }
+
+  int rc = load_csr_from_file(path, symmetrize, drop_self_loops, out);
+  if (rc != 0)
+    return rc;
+
+  if (save_csr_to_bin(out, cache_path, symmetrize, drop_self_loops) == 0)
+    printf("Cached graph written to %s\n", cache_path);
+  else
+    fprintf(stderr, "Warning: failed to write graph cache %s\n", cache_path);
+  return 0;
+}
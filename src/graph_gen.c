@@ -0,0 +1,440 @@
+#define _POSIX_C_SOURCE 200112L
+#include "graph_gen.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPEC_TEXT_MAX 512
+#define MAX_EDGE_SLOTS ((int64_t)1 << 40)
+
+static const char *const kind_names[] = {"rmat", "er", "grid2d", "grid3d", "components"};
+
+// Keys accepted by each kind, in kind order
+static const char *const kind_keys[] = {
+    "scale ef a b c seed permute",
+    "n scale ef seed permute",
+    "w h seed permute",
+    "x y z seed permute",
+    "count size ef seed permute"};
+
+// splitmix64 step
+static inline uint64_t next_random(uint64_t *state)
+{
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Random stream of edge slot k: the splitmix64 finalizer spreads neighbouring slots apart
+static inline uint64_t slot_state(const GraphGenSpec *spec, int64_t k)
+{
+  uint64_t state = spec->seed * 0xD1B54A32D192ED03ULL + (uint64_t)k;
+  return next_random(&state);
+}
+
+// Uniform in [0, bound) for bound < 2^32
+static inline int64_t random_below(uint64_t *state, int64_t bound)
+{
+  return (int64_t)(((next_random(state) >> 32) * (uint64_t)bound) >> 32);
+}
+
+static inline double random_unit(uint64_t *state)
+{
+  return (double)(next_random(state) >> 11) * 0x1.0p-53;
+}
+
+static inline int32_t relabel(const GraphGenSpec *spec, int64_t v)
+{
+  if (!spec->permute)
+    return (int32_t)v;
+  return (int32_t)((spec->perm_mul * (uint64_t)v + spec->perm_add) % (uint64_t)spec->n);
+}
+
+// One R-MAT descent per edge: each of the scale levels picks a quadrant of the adjacency matrix
+static int rmat_edge(const void *params, int64_t k, int32_t *u, int32_t *v)
+{
+  const GraphGenSpec *spec = (const GraphGenSpec *)params;
+  uint64_t state = slot_state(spec, k);
+  const double ab = spec->a + spec->b;
+  const double abc = ab + spec->c;
+  int64_t row = 0, col = 0;
+  for (int level = 0; level < spec->scale; level++)
+  {
+    double r = random_unit(&state);
+    row = (row << 1) | (r >= ab);
+    col = (col << 1) | ((r >= spec->a && r < ab) || r >= abc);
+  }
+  *u = relabel(spec, row);
+  *v = relabel(spec, col);
+  return 1;
+}
+
+static int er_edge(const void *params, int64_t k, int32_t *u, int32_t *v)
+{
+  const GraphGenSpec *spec = (const GraphGenSpec *)params;
+  uint64_t state = slot_state(spec, k);
+  *u = relabel(spec, random_below(&state, spec->n));
+  *v = relabel(spec, random_below(&state, spec->n));
+  return 1;
+}
+
+// Slot 2p links vertex p to its right neighbor, slot 2p + 1 to the one below
+static int grid2d_edge(const void *params, int64_t k, int32_t *u, int32_t *v)
+{
+  const GraphGenSpec *spec = (const GraphGenSpec *)params;
+  const int64_t w = spec->dims[0];
+  const int64_t p = k / 2;
+  const int64_t x = p % w, y = p / w;
+  int64_t q;
+  if (k % 2 == 0)
+  {
+    if (x + 1 >= w)
+      return 0;
+    q = p + 1;
+  }
+  else
+  {
+    if (y + 1 >= spec->dims[1])
+      return 0;
+    q = p + w;
+  }
+  *u = relabel(spec, p);
+  *v = relabel(spec, q);
+  return 1;
+}
+
+// Slots 3p, 3p + 1 and 3p + 2 link vertex p along x, y and z
+static int grid3d_edge(const void *params, int64_t k, int32_t *u, int32_t *v)
+{
+  const GraphGenSpec *spec = (const GraphGenSpec *)params;
+  const int64_t nx = spec->dims[0], ny = spec->dims[1], nz = spec->dims[2];
+  const int64_t p = k / 3;
+  const int64_t x = p % nx, y = (p / nx) % ny, z = p / (nx * ny);
+  int64_t q;
+  switch (k % 3)
+  {
+  case 0:
+    if (x + 1 >= nx)
+      return 0;
+    q = p + 1;
+    break;
+  case 1:
+    if (y + 1 >= ny)
+      return 0;
+    q = p + nx;
+    break;
+  default:
+    if (z + 1 >= nz)
+      return 0;
+    q = p + nx * ny;
+    break;
+  }
+  *u = relabel(spec, p);
+  *v = relabel(spec, q);
+  return 1;
+}
+
+// The first size - 1 slots of a piece attach vertex i + 1 to one of 0..i, which spans the
+// piece; the remaining slots are random pairs inside it (self loops are dropped by the build)
+static int components_edge(const void *params, int64_t k, int32_t *u, int32_t *v)
+{
+  const GraphGenSpec *spec = (const GraphGenSpec *)params;
+  uint64_t state = slot_state(spec, k);
+  const int64_t size = spec->piece_size;
+  const int64_t base = (k / spec->piece_slots) * size;
+  const int64_t i = k % spec->piece_slots;
+  int64_t a, b;
+  if (i < size - 1)
+  {
+    a = i + 1;
+    b = random_below(&state, i + 1);
+  }
+  else
+  {
+    a = random_below(&state, size);
+    b = random_below(&state, size);
+  }
+  *u = relabel(spec, base + a);
+  *v = relabel(spec, base + b);
+  return 1;
+}
+
+static int64_t gcd64(int64_t a, int64_t b)
+{
+  while (b != 0)
+  {
+    int64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// 1 when key appears in the space-separated list
+static int key_allowed(const char *list, const char *key)
+{
+  size_t len = strlen(key);
+  for (const char *p = list; (p = strstr(p, key)) != NULL; p += len)
+  {
+    if ((p == list || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0'))
+      return 1;
+  }
+  return 0;
+}
+
+// Whole number value of key in [min, max]
+static int integer_value(const char *key, double value, double min, double max, int64_t *out)
+{
+  if (!(value >= min && value <= max) || value != (double)(int64_t)value)
+  {
+    fprintf(stderr, "Generator key '%s' needs a whole number in [%.0f, %.0f]\n", key, min, max);
+    return 1;
+  }
+  *out = (int64_t)value;
+  return 0;
+}
+
+// Round ef * vertices to an edge slot count, rejecting absurd sizes before the conversion
+static int scaled_slots(double edge_factor, int64_t vertices, int64_t *out)
+{
+  double slots = edge_factor * (double)vertices;
+  if (!(slots <= (double)MAX_EDGE_SLOTS))
+  {
+    fprintf(stderr, "Generated graph would have more than %" PRId64 " edges\n", MAX_EDGE_SLOTS);
+    return 1;
+  }
+  *out = (int64_t)(slots + 0.5);
+  return 0;
+}
+
+int graph_gen_is_spec(const char *path)
+{
+  return path && strncmp(path, GRAPH_GEN_PREFIX, strlen(GRAPH_GEN_PREFIX)) == 0;
+}
+
+int graph_gen_parse(const char *text, GraphGenSpec *spec)
+{
+  if (graph_gen_is_spec(text))
+    text += strlen(GRAPH_GEN_PREFIX);
+
+  char buffer[SPEC_TEXT_MAX];
+  if (strlen(text) >= sizeof(buffer))
+  {
+    fprintf(stderr, "Generator specification too long\n");
+    return 1;
+  }
+  strcpy(buffer, text);
+
+  char *save = NULL;
+  char *token = strtok_r(buffer, ":", &save);
+  int kind = -1;
+  for (int i = 0; token && i < (int)(sizeof(kind_names) / sizeof(kind_names[0])); i++)
+  {
+    if (strcmp(token, kind_names[i]) == 0)
+      kind = i;
+  }
+  if (kind < 0)
+  {
+    fprintf(stderr, "Unknown generator '%s'. Choose rmat, er, grid2d, grid3d or components.\n",
+            token ? token : "");
+    return 1;
+  }
+
+  memset(spec, 0, sizeof(*spec));
+  spec->kind = (GraphGenKind)kind;
+  spec->seed = 1;
+  spec->permute = (spec->kind == GRAPH_GEN_RMAT);
+  spec->a = 0.57;
+  spec->b = 0.19;
+  spec->c = 0.19;
+  int64_t scale = -1, n = -1, dims[3] = {-1, -1, -1}, pieces = 1024, piece_size = 32;
+  double edge_factor = -1.0;
+
+  while ((token = strtok_r(NULL, ":", &save)) != NULL)
+  {
+    char *eq = strchr(token, '=');
+    char *end = NULL;
+    double value = eq ? strtod(eq + 1, &end) : 0.0;
+    if (!eq || eq == token || end == eq + 1 || *end != '\0')
+    {
+      fprintf(stderr, "Malformed generator option '%s', expected key=value\n", token);
+      return 1;
+    }
+    *eq = '\0';
+    const char *key = token;
+    if (!key_allowed(kind_keys[kind], key))
+    {
+      fprintf(stderr, "Generator %s does not take '%s' (keys: %s)\n", kind_names[kind], key, kind_keys[kind]);
+      return 1;
+    }
+
+    int64_t whole = 0;
+    int rc = 0;
+    if (strcmp(key, "scale") == 0)
+      rc = integer_value(key, value, 1, 30, &scale);
+    else if (strcmp(key, "n") == 0)
+      rc = integer_value(key, value, 1, INT32_MAX, &n);
+    else if (strcmp(key, "w") == 0 || strcmp(key, "x") == 0)
+      rc = integer_value(key, value, 1, INT32_MAX, &dims[0]);
+    else if (strcmp(key, "h") == 0 || strcmp(key, "y") == 0)
+      rc = integer_value(key, value, 1, INT32_MAX, &dims[1]);
+    else if (strcmp(key, "z") == 0)
+      rc = integer_value(key, value, 1, INT32_MAX, &dims[2]);
+    else if (strcmp(key, "count") == 0)
+      rc = integer_value(key, value, 1, INT32_MAX, &pieces);
+    else if (strcmp(key, "size") == 0)
+      rc = integer_value(key, value, 1, INT32_MAX, &piece_size);
+    else if (strcmp(key, "seed") == 0)
+    {
+      rc = integer_value(key, value, 0, 9007199254740992.0, &whole);
+      spec->seed = (uint64_t)whole;
+    }
+    else if (strcmp(key, "permute") == 0)
+    {
+      rc = integer_value(key, value, 0, 1, &whole);
+      spec->permute = (int)whole;
+    }
+    else if (strcmp(key, "ef") == 0)
+    {
+      if (!(value > 0.0))
+      {
+        fprintf(stderr, "Generator key 'ef' must be positive\n");
+        return 1;
+      }
+      edge_factor = value;
+    }
+    else if (!(value >= 0.0 && value <= 1.0))
+    {
+      fprintf(stderr, "Generator key '%s' must be a probability\n", key);
+      return 1;
+    }
+    else if (strcmp(key, "a") == 0)
+      spec->a = value;
+    else if (strcmp(key, "b") == 0)
+      spec->b = value;
+    else
+      spec->c = value;
+    if (rc != 0)
+      return 1;
+  }
+
+  int64_t vertices = 0;
+  switch (spec->kind)
+  {
+  case GRAPH_GEN_RMAT:
+    if (spec->a + spec->b + spec->c > 1.0)
+    {
+      fprintf(stderr, "Generator rmat needs a + b + c <= 1\n");
+      return 1;
+    }
+    spec->scale = (int)(scale > 0 ? scale : 16);
+    spec->edge_factor = edge_factor > 0.0 ? edge_factor : 16.0;
+    vertices = (int64_t)1 << spec->scale;
+    if (scaled_slots(spec->edge_factor, vertices, &spec->edge_slots) != 0)
+      return 1;
+    break;
+  case GRAPH_GEN_ER:
+    if (n > 0 && scale > 0)
+    {
+      fprintf(stderr, "Generator er takes n or scale, not both\n");
+      return 1;
+    }
+    spec->scale = (int)(scale > 0 ? scale : 0);
+    spec->edge_factor = edge_factor > 0.0 ? edge_factor : 8.0;
+    vertices = n > 0 ? n : ((int64_t)1 << (scale > 0 ? scale : 16));
+    if (scaled_slots(spec->edge_factor, vertices, &spec->edge_slots) != 0)
+      return 1;
+    break;
+  case GRAPH_GEN_GRID2D:
+    spec->dims[0] = dims[0] > 0 ? dims[0] : 1024;
+    spec->dims[1] = dims[1] > 0 ? dims[1] : spec->dims[0];
+    spec->dims[2] = 1;
+    if (spec->dims[0] * spec->dims[1] > INT32_MAX)
+      break;
+    vertices = spec->dims[0] * spec->dims[1];
+    spec->edge_slots = 2 * vertices;
+    break;
+  case GRAPH_GEN_GRID3D:
+    spec->dims[0] = dims[0] > 0 ? dims[0] : 128;
+    spec->dims[1] = dims[1] > 0 ? dims[1] : spec->dims[0];
+    spec->dims[2] = dims[2] > 0 ? dims[2] : spec->dims[1];
+    if (spec->dims[0] * spec->dims[1] > INT32_MAX || spec->dims[0] * spec->dims[1] * spec->dims[2] > INT32_MAX)
+      break;
+    vertices = spec->dims[0] * spec->dims[1] * spec->dims[2];
+    spec->edge_slots = 3 * vertices;
+    break;
+  case GRAPH_GEN_COMPONENTS:
+    spec->pieces = pieces;
+    spec->piece_size = piece_size;
+    spec->edge_factor = edge_factor > 0.0 ? edge_factor : 2.0;
+    if (pieces * piece_size > INT32_MAX)
+      break;
+    vertices = pieces * piece_size;
+    if (scaled_slots(spec->edge_factor, piece_size, &spec->piece_slots) != 0)
+      return 1;
+    if (spec->piece_slots < piece_size - 1)
+      spec->piece_slots = piece_size - 1;
+    if (spec->piece_slots < 1)
+      spec->piece_slots = 1;
+    if (scaled_slots((double)spec->piece_slots, pieces, &spec->edge_slots) != 0)
+      return 1;
+    break;
+  }
+  if (vertices <= 0 || vertices > INT32_MAX)
+  {
+    fprintf(stderr, "Generated graph must have between 1 and %d vertices\n", INT32_MAX);
+    return 1;
+  }
+  spec->n = (int32_t)vertices;
+
+  // Affine bijection of [0, n): any multiplier coprime to n
+  spec->perm_mul = 1;
+  spec->perm_add = 0;
+  if (spec->permute && vertices > 1)
+  {
+    uint64_t state = spec->seed ^ 0x5851F42D4C957F2DULL;
+    int64_t mul = (int64_t)(next_random(&state) % (uint64_t)vertices);
+    if (mul < 2)
+      mul = 2;
+    while (gcd64(mul, vertices) != 1)
+      mul = (mul + 1 < vertices) ? mul + 1 : 1;
+    spec->perm_mul = (uint64_t)mul;
+    spec->perm_add = next_random(&state) % (uint64_t)vertices;
+  }
+  return 0;
+}
+
+int graph_gen_build(const GraphGenSpec *spec, int num_threads, CSRGraph *out)
+{
+  CSREdgeGenerator generator = NULL;
+  switch (spec->kind)
+  {
+  case GRAPH_GEN_RMAT:
+    generator = rmat_edge;
+    break;
+  case GRAPH_GEN_ER:
+    generator = er_edge;
+    break;
+  case GRAPH_GEN_GRID2D:
+    generator = grid2d_edge;
+    break;
+  case GRAPH_GEN_GRID3D:
+    generator = grid3d_edge;
+    break;
+  case GRAPH_GEN_COMPONENTS:
+    generator = components_edge;
+    break;
+  }
+  return build_csr_from_generator(spec->n, spec->edge_slots, generator, spec, num_threads, out);
+}
+
+int load_csr_from_generator(const char *path, int num_threads, CSRGraph *out)
+{
+  GraphGenSpec spec;
+  if (graph_gen_parse(path, &spec) != 0)
+    return 1;
+  return graph_gen_build(&spec, num_threads, out);
+}
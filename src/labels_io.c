@@ -0,0 +1,654 @@
+#define _GNU_SOURCE
+#include "labels_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "thread_util.h"
+
+#define LABELS_BIN_MAGIC "CCLABELS"
+#define LABELS_BIN_ALIGN 64
+
+// Vertices per thread below which extra threads cost more than they save
+#define LABELS_MIN_VERTICES_PER_THREAD 65536
+
+// Formatting buffer of every writer thread
+#define LABELS_TEXT_BUFFER (1 << 20)
+
+// Longest formatted label: "-2147483648\n"
+#define LABELS_TEXT_MAX_LINE 12
+
+// Labels sampled to find the most frequent component
+#define COMPONENT_STATS_SAMPLES 1024
+
+// On-disk header, padded to one cache line
+typedef struct
+{
+  char magic[8];        // LABELS_BIN_MAGIC without terminator
+  uint32_t version;     // LABELS_BIN_VERSION
+  uint32_t reserved;
+  int64_t n;            // number of labels
+  uint64_t data_offset; // byte offset of the labels
+  uint8_t padding[32];
+} LabelsBinHeader;
+
+_Static_assert(sizeof(LabelsBinHeader) == LABELS_BIN_ALIGN, "Labels header must fill one cache line");
+
+static int resolve_threads(int num_threads, int64_t work)
+{
+  if (num_threads <= 0)
+    num_threads = thread_util_default_threads();
+  int64_t useful = work / LABELS_MIN_VERTICES_PER_THREAD;
+  if (useful < 1)
+    useful = 1;
+  return (int64_t)num_threads > useful ? (int)useful : num_threads;
+}
+
+static void split_vertices(int32_t n, int num_threads, int tid, int32_t *begin, int32_t *end)
+{
+  long long start, stop;
+  thread_util_split_range(n, num_threads, tid, &start, &stop);
+  *begin = (int32_t)start;
+  *end = (int32_t)stop;
+}
+
+int labels_parse_format(const char *name, LabelsFormat *out)
+{
+  if (strcmp(name, "text") == 0)
+    *out = LABELS_FORMAT_TEXT;
+  else if (strcmp(name, "binary") == 0)
+    *out = LABELS_FORMAT_BINARY;
+  else
+    return -1;
+  return 0;
+}
+
+const char *labels_format_extension(LabelsFormat format)
+{
+  return format == LABELS_FORMAT_BINARY ? "bin" : "txt";
+}
+
+// ---------------------------------------------------------------------------
+// Text writer
+// ---------------------------------------------------------------------------
+
+static inline int decimal_length(int32_t value)
+{
+  uint32_t v = value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+  int digits = 1;
+  while (v >= 10)
+  {
+    v /= 10;
+    digits++;
+  }
+  return digits + (value < 0);
+}
+
+// Format value followed by a newline at dst; returns the number of bytes written
+static inline int format_label(char *dst, int32_t value)
+{
+  char tmp[LABELS_TEXT_MAX_LINE];
+  uint32_t v = value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+  int len = 0;
+  do
+  {
+    tmp[len++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+
+  int pos = 0;
+  if (value < 0)
+    dst[pos++] = '-';
+  while (len)
+    dst[pos++] = tmp[--len];
+  dst[pos++] = '\n';
+  return pos;
+}
+
+typedef struct
+{
+  const int32_t *labels;
+  int32_t n;
+  int fd;
+  int64_t *offsets; // bytes per thread after the sizing pass, start offsets after the scan
+  int *failed;
+} TextWriteCtx;
+
+static void text_size_worker(int tid, int num_threads, void *arg)
+{
+  TextWriteCtx *ctx = (TextWriteCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->n, num_threads, tid, &begin, &end);
+
+  int64_t bytes = 0;
+  for (int32_t v = begin; v < end; v++)
+    bytes += decimal_length(ctx->labels[v]) + 1;
+  ctx->offsets[tid] = bytes;
+}
+
+static int pwrite_fully(int fd, const char *data, size_t bytes, off_t offset)
+{
+  while (bytes > 0)
+  {
+    ssize_t written = pwrite(fd, data, bytes, offset);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    data += written;
+    bytes -= (size_t)written;
+    offset += written;
+  }
+  return 0;
+}
+
+static void text_write_worker(int tid, int num_threads, void *arg)
+{
+  TextWriteCtx *ctx = (TextWriteCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->n, num_threads, tid, &begin, &end);
+  if (begin == end)
+    return;
+
+  char *buffer = (char *)malloc(LABELS_TEXT_BUFFER);
+  if (!buffer)
+  {
+    ctx->failed[tid] = 1;
+    return;
+  }
+
+  off_t offset = (off_t)ctx->offsets[tid];
+  size_t used = 0;
+  for (int32_t v = begin; v < end; v++)
+  {
+    if (used + LABELS_TEXT_MAX_LINE > LABELS_TEXT_BUFFER)
+    {
+      if (pwrite_fully(ctx->fd, buffer, used, offset) != 0)
+      {
+        ctx->failed[tid] = 1;
+        free(buffer);
+        return;
+      }
+      offset += (off_t)used;
+      used = 0;
+    }
+    used += (size_t)format_label(buffer + used, ctx->labels[v]);
+  }
+  if (used > 0 && pwrite_fully(ctx->fd, buffer, used, offset) != 0)
+    ctx->failed[tid] = 1;
+  free(buffer);
+}
+
+int labels_write_text(const char *path, const int32_t *labels, int32_t n, int num_threads)
+{
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    fprintf(stderr, "Failed to open %s for writing: %s\n", path, strerror(errno));
+    return 1;
+  }
+
+  num_threads = resolve_threads(num_threads, n);
+  int64_t *offsets = (int64_t *)malloc((size_t)num_threads * sizeof(int64_t));
+  int *failed = (int *)calloc((size_t)num_threads, sizeof(int));
+  if (!offsets || !failed)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    free(offsets);
+    free(failed);
+    close(fd);
+    return 2;
+  }
+
+  TextWriteCtx ctx = {labels, n, fd, offsets, failed};
+  int status = 0;
+  if (thread_util_parallel_run(num_threads, text_size_worker, &ctx) != 0)
+    status = 3;
+
+  int64_t total = 0;
+  for (int t = 0; t < num_threads && status == 0; t++)
+  {
+    int64_t bytes = offsets[t];
+    offsets[t] = total;
+    total += bytes;
+  }
+
+  // Sizing the file first keeps the writers from extending it concurrently
+  if (status == 0 && ftruncate(fd, (off_t)total) != 0)
+    status = 4;
+  if (status == 0 && thread_util_parallel_run(num_threads, text_write_worker, &ctx) != 0)
+    status = 3;
+  for (int t = 0; t < num_threads && status == 0; t++)
+  {
+    if (failed[t])
+      status = 4;
+  }
+  if (close(fd) != 0 && status == 0)
+    status = 4;
+  if (status != 0)
+    fprintf(stderr, "Failed to write labels to %s: %s\n", path, strerror(errno));
+
+  free(offsets);
+  free(failed);
+  return status;
+}
+
+// ---------------------------------------------------------------------------
+// Binary writer and reader
+// ---------------------------------------------------------------------------
+
+typedef struct
+{
+  const int32_t *labels;
+  int32_t n;
+  int32_t *dst;
+} BinaryWriteCtx;
+
+static void binary_write_worker(int tid, int num_threads, void *arg)
+{
+  BinaryWriteCtx *ctx = (BinaryWriteCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->n, num_threads, tid, &begin, &end);
+  if (end > begin)
+    memcpy(ctx->dst + begin, ctx->labels + begin, (size_t)(end - begin) * sizeof(int32_t));
+}
+
+int labels_write_binary(const char *path, const int32_t *labels, int32_t n, int num_threads)
+{
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    fprintf(stderr, "Failed to open %s for writing: %s\n", path, strerror(errno));
+    return 1;
+  }
+
+  size_t size = LABELS_BIN_ALIGN + (size_t)n * sizeof(int32_t);
+  if (ftruncate(fd, (off_t)size) != 0)
+  {
+    fprintf(stderr, "Failed to size %s: %s\n", path, strerror(errno));
+    close(fd);
+    return 4;
+  }
+  void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED)
+  {
+    fprintf(stderr, "Failed to map %s: %s\n", path, strerror(errno));
+    close(fd);
+    return 4;
+  }
+
+  LabelsBinHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, LABELS_BIN_MAGIC, sizeof(header.magic));
+  header.version = LABELS_BIN_VERSION;
+  header.n = n;
+  header.data_offset = LABELS_BIN_ALIGN;
+  memcpy(mapping, &header, sizeof(header));
+
+  BinaryWriteCtx ctx = {labels, n, (int32_t *)((char *)mapping + LABELS_BIN_ALIGN)};
+  int status = thread_util_parallel_run(resolve_threads(num_threads, n), binary_write_worker, &ctx) != 0 ? 3 : 0;
+
+  if (munmap(mapping, size) != 0 && status == 0)
+    status = 4;
+  if (close(fd) != 0 && status == 0)
+    status = 4;
+  if (status != 0)
+    fprintf(stderr, "Failed to write labels to %s: %s\n", path, strerror(errno));
+  return status;
+}
+
+int labels_write(const char *path, LabelsFormat format, const int32_t *labels, int32_t n, int num_threads)
+{
+  if (format == LABELS_FORMAT_BINARY)
+    return labels_write_binary(path, labels, n, num_threads);
+  return labels_write_text(path, labels, n, num_threads);
+}
+
+int labels_map_binary(const char *path, LabelsFile *out)
+{
+  memset(out, 0, sizeof(*out));
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+    return 1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(LabelsBinHeader))
+  {
+    fprintf(stderr, "%s is not a binary label file\n", path);
+    close(fd);
+    return 2;
+  }
+  size_t size = (size_t)st.st_size;
+  void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    fprintf(stderr, "Failed to map %s: %s\n", path, strerror(errno));
+    return 3;
+  }
+
+  LabelsBinHeader header;
+  memcpy(&header, mapping, sizeof(header));
+  if (memcmp(header.magic, LABELS_BIN_MAGIC, sizeof(header.magic)) != 0 || header.version != LABELS_BIN_VERSION ||
+      header.n < 0 || header.n > INT32_MAX || header.data_offset % sizeof(int32_t) != 0 ||
+      header.data_offset > size || (size - header.data_offset) / sizeof(int32_t) < (uint64_t)header.n)
+  {
+    fprintf(stderr, "%s is not a valid binary label file\n", path);
+    munmap(mapping, size);
+    return 2;
+  }
+
+  out->labels = (const int32_t *)((const char *)mapping + header.data_offset);
+  out->n = (int32_t)header.n;
+  out->mapping = mapping;
+  out->mapping_size = size;
+  return 0;
+}
+
+void labels_unmap(LabelsFile *file)
+{
+  if (file->mapping)
+    munmap(file->mapping, file->mapping_size);
+  memset(file, 0, sizeof(*file));
+}
+
+// ---------------------------------------------------------------------------
+// Component statistics
+// ---------------------------------------------------------------------------
+
+typedef struct
+{
+  const int32_t *labels;
+  int32_t n;
+  int32_t *dense_labels;
+  int32_t *id_of;   // per label: 1 when used after marking, dense ID (or -1) after numbering
+  int32_t *sizes;   // per dense ID
+  int64_t *counts;  // per thread: used labels in its range, then the first dense ID of the range
+  int32_t hot_id;   // dense ID counted in thread-local counters
+  int *failed;
+  int64_t (*histograms)[COMPONENT_STATS_BUCKETS];
+  int32_t *largest; // per thread: dense ID of the largest component in its range
+  int32_t num_components;
+} StatsCtx;
+
+static void stats_clear_worker(int tid, int num_threads, void *arg)
+{
+  StatsCtx *ctx = (StatsCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->n, num_threads, tid, &begin, &end);
+  if (end > begin)
+    memset(ctx->id_of + begin, 0, (size_t)(end - begin) * sizeof(int32_t));
+}
+
+// Flag every label in use; concurrent stores all write the same value
+static void stats_mark_worker(int tid, int num_threads, void *arg)
+{
+  StatsCtx *ctx = (StatsCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->n, num_threads, tid, &begin, &end);
+
+  for (int32_t v = begin; v < end; v++)
+  {
+    int32_t label = ctx->labels[v];
+    if (label < 0 || label >= ctx->n)
+    {
+      ctx->failed[tid] = 1;
+      return;
+    }
+    if (!__atomic_load_n(&ctx->id_of[label], __ATOMIC_RELAXED))
+      __atomic_store_n(&ctx->id_of[label], 1, __ATOMIC_RELAXED);
+  }
+}
+
+static void stats_count_worker(int tid, int num_threads, void *arg)
+{
+  StatsCtx *ctx = (StatsCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->n, num_threads, tid, &begin, &end);
+
+  int64_t used = 0;
+  for (int32_t label = begin; label < end; label++)
+    used += ctx->id_of[label];
+  ctx->counts[tid] = used;
+}
+
+// Number the used labels of this range from its prefix-sum offset and clear their sizes
+static void stats_number_worker(int tid, int num_threads, void *arg)
+{
+  StatsCtx *ctx = (StatsCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->n, num_threads, tid, &begin, &end);
+
+  int32_t next = (int32_t)ctx->counts[tid];
+  for (int32_t label = begin; label < end; label++)
+    ctx->id_of[label] = ctx->id_of[label] ? next++ : -1;
+  if (next > ctx->counts[tid])
+    memset(ctx->sizes + ctx->counts[tid], 0, (size_t)(next - ctx->counts[tid]) * sizeof(int32_t));
+}
+
+// Count component sizes. Runs of equal IDs are added at once, and the most frequent
+// component is counted per thread so the giant component does not serialize on one counter.
+static void stats_size_worker(int tid, int num_threads, void *arg)
+{
+  StatsCtx *ctx = (StatsCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->n, num_threads, tid, &begin, &end);
+
+  int32_t hot_count = 0;
+  int32_t run_id = -1;
+  int32_t run_length = 0;
+  for (int32_t v = begin; v < end; v++)
+  {
+    int32_t id = ctx->id_of[ctx->labels[v]];
+    if (ctx->dense_labels)
+      ctx->dense_labels[v] = id;
+    if (id == ctx->hot_id)
+    {
+      hot_count++;
+      continue;
+    }
+    if (id != run_id)
+    {
+      if (run_length)
+        __atomic_fetch_add(&ctx->sizes[run_id], run_length, __ATOMIC_RELAXED);
+      run_id = id;
+      run_length = 0;
+    }
+    run_length++;
+  }
+  if (run_length)
+    __atomic_fetch_add(&ctx->sizes[run_id], run_length, __ATOMIC_RELAXED);
+  if (hot_count)
+    __atomic_fetch_add(&ctx->sizes[ctx->hot_id], hot_count, __ATOMIC_RELAXED);
+}
+
+static inline int size_bucket(int32_t size)
+{
+  return 31 - __builtin_clz((uint32_t)size);
+}
+
+static void stats_histogram_worker(int tid, int num_threads, void *arg)
+{
+  StatsCtx *ctx = (StatsCtx *)arg;
+  int32_t begin, end;
+  split_vertices(ctx->num_components, num_threads, tid, &begin, &end);
+
+  int64_t *histogram = ctx->histograms[tid];
+  memset(histogram, 0, sizeof(ctx->histograms[tid]));
+  int32_t largest = -1;
+  for (int32_t id = begin; id < end; id++)
+  {
+    int32_t size = ctx->sizes[id];
+    histogram[size_bucket(size)]++;
+    if (largest < 0 || size > ctx->sizes[largest])
+      largest = id;
+  }
+  ctx->largest[tid] = largest;
+}
+
+static int cmp_int32(const void *a, const void *b)
+{
+  int32_t lhs = *(const int32_t *)a;
+  int32_t rhs = *(const int32_t *)b;
+  return (lhs > rhs) - (lhs < rhs);
+}
+
+// Most frequent label among evenly spaced samples, as in the Afforest kernels
+static int32_t sample_frequent_label(const int32_t *labels, int32_t n)
+{
+  int32_t samples[COMPONENT_STATS_SAMPLES];
+  int count = n < COMPONENT_STATS_SAMPLES ? (int)n : COMPONENT_STATS_SAMPLES;
+  for (int i = 0; i < count; i++)
+    samples[i] = labels[(int64_t)i * n / count];
+  qsort(samples, (size_t)count, sizeof(int32_t), cmp_int32);
+
+  int32_t best = samples[0];
+  int best_run = 0;
+  for (int i = 0; i < count;)
+  {
+    int j = i;
+    while (j < count && samples[j] == samples[i])
+      j++;
+    if (j - i > best_run)
+    {
+      best_run = j - i;
+      best = samples[i];
+    }
+    i = j;
+  }
+  return best;
+}
+
+int component_stats_compute(const int32_t *labels, int32_t n, int num_threads, int32_t *dense_labels,
+                            ComponentStats *out)
+{
+  memset(out, 0, sizeof(*out));
+  out->largest_component = -1;
+  out->largest_label = -1;
+  if (n <= 0)
+    return 0;
+
+  num_threads = resolve_threads(num_threads, n);
+  StatsCtx ctx;
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.labels = labels;
+  ctx.n = n;
+  ctx.dense_labels = dense_labels;
+  ctx.id_of = (int32_t *)malloc((size_t)n * sizeof(int32_t));
+  ctx.counts = (int64_t *)malloc((size_t)num_threads * sizeof(int64_t));
+  ctx.failed = (int *)calloc((size_t)num_threads, sizeof(int));
+  ctx.histograms = malloc((size_t)num_threads * sizeof(*ctx.histograms));
+  ctx.largest = (int32_t *)malloc((size_t)num_threads * sizeof(int32_t));
+
+  int status = (!ctx.id_of || !ctx.counts || !ctx.failed || !ctx.histograms || !ctx.largest) ? -1 : 0;
+  if (status == 0 && (thread_util_parallel_run(num_threads, stats_clear_worker, &ctx) != 0 ||
+                      thread_util_parallel_run(num_threads, stats_mark_worker, &ctx) != 0))
+    status = -1;
+  for (int t = 0; t < num_threads && status == 0; t++)
+  {
+    if (ctx.failed[t])
+    {
+      fprintf(stderr, "Labels outside [0, %d) cannot be summarized\n", n);
+      status = -1;
+    }
+  }
+  // The hot label is read before numbering turns id_of into dense IDs
+  int32_t hot_label = status == 0 ? sample_frequent_label(labels, n) : 0;
+  if (status == 0 && thread_util_parallel_run(num_threads, stats_count_worker, &ctx) != 0)
+    status = -1;
+
+  int64_t total = 0;
+  for (int t = 0; t < num_threads && status == 0; t++)
+  {
+    int64_t used = ctx.counts[t];
+    ctx.counts[t] = total;
+    total += used;
+  }
+  ctx.num_components = (int32_t)total;
+  if (status == 0)
+  {
+    ctx.sizes = (int32_t *)malloc((size_t)(total > 0 ? total : 1) * sizeof(int32_t));
+    if (!ctx.sizes || thread_util_parallel_run(num_threads, stats_number_worker, &ctx) != 0)
+      status = -1;
+  }
+  if (status == 0)
+  {
+    ctx.hot_id = ctx.id_of[hot_label];
+    if (thread_util_parallel_run(num_threads, stats_size_worker, &ctx) != 0 ||
+        thread_util_parallel_run(resolve_threads(num_threads, total), stats_histogram_worker, &ctx) != 0)
+      status = -1;
+  }
+
+  if (status == 0)
+  {
+    int histogram_threads = resolve_threads(num_threads, total);
+    out->num_components = ctx.num_components;
+    for (int t = 0; t < histogram_threads; t++)
+    {
+      for (int b = 0; b < COMPONENT_STATS_BUCKETS; b++)
+        out->histogram[b] += ctx.histograms[t][b];
+      int32_t id = ctx.largest[t];
+      if (id >= 0 && (out->largest_component < 0 || ctx.sizes[id] > out->largest_size))
+      {
+        out->largest_component = id;
+        out->largest_size = ctx.sizes[id];
+      }
+    }
+
+    // Only the range whose dense IDs cover the largest component has to be searched
+    int owner = 0;
+    while (owner + 1 < num_threads && ctx.counts[owner + 1] <= out->largest_component)
+      owner++;
+    int32_t begin, end;
+    split_vertices(n, num_threads, owner, &begin, &end);
+    for (int32_t label = begin; label < end; label++)
+    {
+      if (ctx.id_of[label] == out->largest_component)
+      {
+        out->largest_label = label;
+        break;
+      }
+    }
+  }
+  else
+  {
+    fprintf(stderr, "Failed to compute component statistics\n");
+  }
+
+  free(ctx.id_of);
+  free(ctx.sizes);
+  free(ctx.counts);
+  free(ctx.failed);
+  free(ctx.histograms);
+  free(ctx.largest);
+  return status;
+}
+
+int component_stats_write_csv(const ComponentStats *stats, const char *path)
+{
+  FILE *f = fopen(path, "w");
+  if (!f)
+    return -1;
+
+  fprintf(f, "Min Size,Max Size,Components\n");
+  for (int b = 0; b < COMPONENT_STATS_BUCKETS; b++)
+  {
+    if (stats->histogram[b] == 0)
+      continue;
+    long long lo = 1LL << b;
+    long long hi = (1LL << (b + 1)) - 1;
+    fprintf(f, "%lld,%lld,%lld\n", lo, hi, (long long)stats->histogram[b]);
+  }
+  return fclose(f) == 0 ? 0 : -1;
+}
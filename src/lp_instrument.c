@@ -0,0 +1,104 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lp_instrument.h"
+
+// Log of the last instrumented run
+static LPInstrumentSlot *current = NULL; // num_threads slots of the open round
+static LPInstrumentSlot *log_rows = NULL; // rounds * num_threads recorded slots
+static int log_threads = 0;
+static int log_rounds = 0;
+static int log_capacity = 0; // rounds that fit in log_rows
+
+void lp_instrument_begin(int num_threads)
+{
+  if (num_threads < 1)
+    num_threads = 1;
+  if (num_threads != log_threads)
+  {
+    free(current);
+    free(log_rows);
+    current = NULL;
+    log_rows = NULL;
+    log_capacity = 0;
+    if (posix_memalign((void **)&current, 64, (size_t)num_threads * sizeof(LPInstrumentSlot)) != 0)
+    {
+      fprintf(stderr, "Memory allocation failed (instrumentation)\n");
+      exit(EXIT_FAILURE);
+    }
+    log_threads = num_threads;
+  }
+  memset(current, 0, (size_t)num_threads * sizeof(LPInstrumentSlot));
+  log_rounds = 0;
+}
+
+LPInstrumentSlot *lp_instrument_slot(int thread_id)
+{
+  return &current[thread_id];
+}
+
+void lp_instrument_end_round(double wall_seconds)
+{
+  if (log_rounds == log_capacity)
+  {
+    int new_capacity = log_capacity ? log_capacity * 2 : 64;
+    LPInstrumentSlot *tmp;
+    if (posix_memalign((void **)&tmp, 64, (size_t)new_capacity * log_threads * sizeof(LPInstrumentSlot)) != 0)
+    {
+      fprintf(stderr, "Memory allocation failed (instrumentation)\n");
+      exit(EXIT_FAILURE);
+    }
+    if (log_rows)
+      memcpy(tmp, log_rows, (size_t)log_rounds * log_threads * sizeof(LPInstrumentSlot));
+    free(log_rows);
+    log_rows = tmp;
+    log_capacity = new_capacity;
+  }
+
+  LPInstrumentSlot *row = &log_rows[(size_t)log_rounds * log_threads];
+  for (int t = 0; t < log_threads; t++)
+  {
+    row[t] = current[t];
+    if (wall_seconds > 0.0)
+      row[t].idle_seconds = (wall_seconds > row[t].busy_seconds) ? wall_seconds - row[t].busy_seconds : 0.0;
+  }
+  memset(current, 0, (size_t)log_threads * sizeof(LPInstrumentSlot));
+  log_rounds++;
+}
+
+double lp_instrument_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int lp_instrument_rounds(void)
+{
+  return log_rounds;
+}
+
+int lp_instrument_write_csv(const char *path)
+{
+  FILE *f = fopen(path, "w");
+  if (!f)
+    return -1;
+
+  fprintf(f, "Round,Thread,Changed Vertices,Edges Scanned,CAS Failures,Busy Seconds,Idle Seconds\n");
+  for (int r = 0; r < log_rounds; r++)
+  {
+    for (int t = 0; t < log_threads; t++)
+    {
+      const LPInstrumentSlot *s = &log_rows[(size_t)r * log_threads + t];
+      fprintf(f, "%d,%d,%" PRId64 ",%" PRId64 ",%" PRId64 ",%.9f,%.9f\n", r + 1, t, s->changed_vertices,
+              s->edges_scanned, s->cas_failures, s->busy_seconds, s->idle_seconds);
+    }
+  }
+
+  return fclose(f) == 0 ? 0 : -1;
+}
@@ -1,7 +1,7 @@
 /* CC Test (sequential LP + BFS)
  *
- * Loads a graph, runs either sequential label propagation or BFS connected
- * components, emits label files, and appends runtimes to the CSV summaries.
+ * Loads a graph, runs sequential label propagation, BFS, or Afforest union-find
+ * connected components, emits label files, and appends runtimes to the CSV summaries.
  * Algorithm selection and run counts are exposed via --algorithm/--runs flags.
  */
 
@@ -14,33 +14,116 @@
 #include <string.h>
 
 #include "cc.h"
+#include "cc_alloc.h"
 #include "graph.h"
+#include "labels_io.h"
+#include "perf_counters.h"
+#include "reorder.h"
+#include "trim.h"
 #include "opt_parser.h"
 #include "results_writer.h"
 
+// Long-only option identifiers
+enum
+{
+    OPT_CACHE = 256,
+    OPT_REORDER,
+    OPT_TRIM,
+    OPT_PERF_COUNTERS,
+    OPT_LABELS_FORMAT,
+    OPT_COMPONENT_STATS,
+    OPT_LOW_MEMORY,
+    OPT_HUGEPAGES,
+    OPT_RESULTS_FORMAT,
+};
+
 static void print_usage(const char *prog)
 {
     fprintf(stderr,
             "Usage: %s [OPTIONS] <matrix-file-path>\n\n"
             "Options:\n"
-            "  -a, --algorithm lp|bfs   Algorithm to execute (default lp)\n"
+            "  -a, --algorithm NAME     lp, bfs or afforest (default lp)\n"
             "  -r, --runs N             Number of runs to average (default 1)\n"
             "  -o, --output DIR         Output directory (default 'results')\n"
+            "      --cache              Reuse/write a binary .csr cache next to the input\n"
+            "      --reorder KIND       Vertex order: none, degree, bfs or rcm (default none)\n"
+            "      --trim               Peel degree-0/1 vertices and run on the remaining core\n"
+            "      --perf-counters      Read hardware counters around the kernel (perf_event_open)\n"
+            "      --labels-format FMT  Label file format: text or binary (default text)\n"
+            "      --component-stats    Write the component-size histogram and report the largest component\n"
+            "      --low-memory         Load .mtx inputs in two passes without an edge list\n"
+            "      --hugepages MODE     Back large arrays with huge pages: off, thp, 2m, 1g (default off)\n"
+            "      --results-format FMT Results layout: wide or long (appended rows, default wide)\n"
             "  -h, --help               Show this message\n",
             prog);
 }
 
+// Print the counter averages and append one column per counter to perf_<tag>_<matrix>.csv
+static void write_perf_counters(const PerfReading *readings, int runs, const char *output_dir, const char *tag,
+                                const char *column_name, const char *matrix_path)
+{
+    printf("Performance counters (average over %d run%s):\n", runs, runs == 1 ? "" : "s");
+    perf_counters_print_summary(readings, runs);
+
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "perf_%s", tag);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        perf_counters_write_columns(path, column_name, readings, runs) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write performance counters: %s\n", strerror(errno));
+        return;
+    }
+    printf("Performance counters written to %s\n", path);
+}
+
+// Print the largest component and write the component-size histogram
+static void write_component_stats(const ComponentStats *stats, const char *output_dir, const char *results_tag,
+                                  const char *matrix_path)
+{
+    printf("Largest component: %d vertices (label %d, dense ID %d of %d)\n", stats->largest_size,
+           stats->largest_label, stats->largest_component, stats->num_components);
+
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "components_%s", results_tag);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        component_stats_write_csv(stats, path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write component statistics: %s\n", strerror(errno));
+        return;
+    }
+    printf("Component size histogram written to %s\n", path);
+}
+
 int main(int argc, char **argv)
 {
     const char *algorithm = "lp";
     int runs = 1;
     const char *path = NULL;
     const char *output_dir = "results";
+    int use_component_stats = 0;
+    LabelsFormat labels_format = LABELS_FORMAT_TEXT;
+    int use_perf = 0;
+    ReorderKind reorder = REORDER_NONE;
+    int use_cache = 0;
+    int use_trim = 0;
 
     const struct option long_opts[] = {
         {"algorithm", required_argument, NULL, 'a'},
         {"runs", required_argument, NULL, 'r'},
         {"output", required_argument, NULL, 'o'},
+        {"cache", no_argument, NULL, OPT_CACHE},
+        {"reorder", required_argument, NULL, OPT_REORDER},
+        {"trim", no_argument, NULL, OPT_TRIM},
+        {"perf-counters", no_argument, NULL, OPT_PERF_COUNTERS},
+        {"labels-format", required_argument, NULL, OPT_LABELS_FORMAT},
+        {"component-stats", no_argument, NULL, OPT_COMPONENT_STATS},
+        {"low-memory", no_argument, NULL, OPT_LOW_MEMORY},
+        {"hugepages", required_argument, NULL, OPT_HUGEPAGES},
+        {"results-format", required_argument, NULL, OPT_RESULTS_FORMAT},
         {"help", no_argument, NULL, 'h'},
         {NULL, 0, NULL, 0}};
 
@@ -72,6 +155,57 @@ int main(int argc, char **argv)
             }
             output_dir = optarg;
             break;
+        case OPT_CACHE:
+            use_cache = 1;
+            break;
+        case OPT_REORDER:
+            if (reorder_parse_kind(optarg, &reorder) != 0)
+            {
+                fprintf(stderr, "Unknown vertex order '%s'. Choose none, degree, bfs or rcm.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_TRIM:
+            use_trim = 1;
+            break;
+        case OPT_PERF_COUNTERS:
+            use_perf = 1;
+            break;
+        case OPT_LABELS_FORMAT:
+            if (labels_parse_format(optarg, &labels_format) != 0)
+            {
+                fprintf(stderr, "Unsupported labels format '%s'. Choose 'text' or 'binary'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_COMPONENT_STATS:
+            use_component_stats = 1;
+            break;
+        case OPT_LOW_MEMORY:
+            graph_set_low_memory_loading(1);
+            break;
+        case OPT_HUGEPAGES:
+        {
+            CCHugePages hugepages;
+            if (cc_hugepages_parse(optarg, &hugepages) != 0)
+            {
+                fprintf(stderr, "Unknown huge page mode '%s'. Choose off, thp, 2m or 1g.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            cc_alloc_set_hugepages(hugepages);
+            break;
+        }
+        case OPT_RESULTS_FORMAT:
+        {
+            results_format results_format_choice;
+            if (results_writer_parse_format(optarg, &results_format_choice) != 0)
+            {
+                fprintf(stderr, "Unknown results format '%s'. Choose 'wide' or 'long'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            results_writer_set_format(results_format_choice);
+            break;
+        }
         case 'h':
             print_usage(argv[0]);
             return EXIT_SUCCESS;
@@ -89,9 +223,9 @@ int main(int argc, char **argv)
     }
     path = argv[optind];
 
-    if (strcmp(algorithm, "lp") != 0 && strcmp(algorithm, "bfs") != 0)
+    if (strcmp(algorithm, "lp") != 0 && strcmp(algorithm, "bfs") != 0 && strcmp(algorithm, "afforest") != 0)
     {
-        fprintf(stderr, "Unsupported algorithm '%s'. Choose 'lp' or 'bfs'.\n", algorithm);
+        fprintf(stderr, "Unsupported algorithm '%s'. Choose 'lp', 'bfs' or 'afforest'.\n", algorithm);
         return EXIT_FAILURE;
     }
 
@@ -101,9 +235,10 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
-    const char *method_base = (strcmp(algorithm, "bfs") == 0) ? "bfs" : "c";
+    const char *method_base = (strcmp(algorithm, "lp") == 0) ? "c" : algorithm;
     char labels_filename[64];
-    snprintf(labels_filename, sizeof(labels_filename), "%s_labels.txt", method_base);
+    snprintf(labels_filename, sizeof(labels_filename), "%s_labels.%s", method_base,
+             labels_format_extension(labels_format));
 
     char labels_path[PATH_MAX];
     if (results_writer_join_path(labels_path, sizeof(labels_path), output_dir, labels_filename) != 0)
@@ -115,12 +250,51 @@ int main(int argc, char **argv)
     printf("Loading graph: %s\n", path);
 
     CSRGraph G;
-    if (load_csr_from_file(path, 1, 1, &G) != 0)
+    int load_status = use_cache ? load_csr_from_file_cached(path, 1, 1, &G)
+                                : load_csr_from_file(path, 1, 1, &G);
+    if (load_status != 0)
     {
         fprintf(stderr, "Failed to load graph from %s\n", path);
         return EXIT_FAILURE;
     }
 
+    // Optional degree-0/1 trimming: the kernels (and the reordering) only see the core
+    TrimResult trim = {0};
+    int trimmed = 0;
+    if (use_trim)
+    {
+        double trim_start = omp_get_wtime();
+        CSRGraph core;
+        if (trim_graph(&G, 0, &core, &trim) != 0)
+        {
+            fprintf(stderr, "Failed to trim graph\n");
+            free_csr(&G);
+            return EXIT_FAILURE;
+        }
+        free_csr(&G);
+        G = core;
+        trimmed = 1;
+        printf("Trim time: %.6f seconds\n", omp_get_wtime() - trim_start);
+        printf("Trimmed core: %d of %d vertices (%.1f%%), %lld of %lld edges (%.1f%%); %d isolated, %d peeled\n",
+               trim.core_n, trim.n, trim.n > 0 ? 100.0 * trim.core_n / trim.n : 0.0, (long long)trim.core_m,
+               (long long)trim.m, trim.m > 0 ? 100.0 * (double)trim.core_m / (double)trim.m : 0.0, trim.isolated,
+               trim.peeled);
+    }
+
+    // Optional locality reordering, timed separately from the kernels
+    int32_t *new_id = NULL;
+    if (reorder != REORDER_NONE)
+    {
+        double reorder_start = omp_get_wtime();
+        if (reorder_graph(&G, reorder, &new_id) != 0)
+        {
+            fprintf(stderr, "Failed to reorder graph (%s)\n", reorder_kind_name(reorder));
+            free_csr(&G);
+            return EXIT_FAILURE;
+        }
+        printf("Reorder (%s) time: %.6f seconds\n", reorder_kind_name(reorder), omp_get_wtime() - reorder_start);
+    }
+
     int32_t *labels = (int32_t *)malloc(G.n * sizeof(int32_t));
     if (!labels)
     {
@@ -138,17 +312,41 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    // Hardware counters cover the kernel call only, not loading or preprocessing
+    PerfCounters *perf = NULL;
+    PerfReading *perf_readings = NULL;
+    if (use_perf)
+    {
+        perf = perf_counters_create();
+        perf_readings = (PerfReading *)malloc((size_t)runs * sizeof(PerfReading));
+        if (!perf || !perf_readings)
+        {
+            fprintf(stderr, "Warning: Running without performance counters\n");
+            perf_counters_destroy(perf);
+            perf = NULL;
+        }
+    }
+
     printf("Computing connected components (%d run%s)...\n", runs, runs == 1 ? "" : "s");
 
     double total_time = 0.0;
     for (int run = 0; run < runs; run++)
     {
+        if (perf && perf_counters_start(perf) != 0)
+        {
+            perf_counters_destroy(perf);
+            perf = NULL;
+        }
         double start = omp_get_wtime();
         if (strcmp(algorithm, "lp") == 0)
             compute_connected_components(&G, labels);
+        else if (strcmp(algorithm, "afforest") == 0)
+            compute_connected_components_afforest(&G, labels);
         else
             compute_connected_components_bfs(&G, labels);
         double elapsed = omp_get_wtime() - start;
+        if (perf)
+            perf_counters_stop(perf, &perf_readings[run]);
         total_time += elapsed;
         printf("Run %d time: %.6f seconds\n", run + 1, elapsed);
         run_times[run] = elapsed;
@@ -164,15 +362,30 @@ int main(int argc, char **argv)
         snprintf(column_name, sizeof(column_name), "1 Thread");
         results_prefix = "results_omp";
     }
+    else if (strcmp(algorithm, "afforest") == 0)
+    {
+        snprintf(column_name, sizeof(column_name), "1 Thread");
+        results_prefix = "results_afforest";
+    }
     else
     {
         snprintf(column_name, sizeof(column_name), "BFS");
         results_prefix = "results_bfs";
     }
 
+    // Reordered and trimmed runs get their own results files; label files keep the original name
+    char reordered_prefix[64];
+    if (reorder != REORDER_NONE || trimmed)
+    {
+        snprintf(reordered_prefix, sizeof(reordered_prefix), "%s%s%s%s", results_prefix,
+                 reorder != REORDER_NONE ? "_" : "", reorder != REORDER_NONE ? reorder_kind_name(reorder) : "",
+                 trimmed ? "_trim" : "");
+        results_prefix = reordered_prefix;
+    }
+
     char results_path[PATH_MAX] = "";
     int results_path_ready = 0;
-    if (results_writer_build_results_path(results_path, sizeof(results_path), output_dir, results_prefix, path) != 0)
+    if (results_writer_build_times_path(results_path, sizeof(results_path), output_dir, results_prefix, path) != 0)
     {
         fprintf(stderr, "Warning: Failed to build results path: %s\n", strerror(errno));
     }
@@ -184,26 +397,58 @@ int main(int argc, char **argv)
             fprintf(stderr, "Warning: Failed to update %s (error %d)\n", results_path, (int)status);
     }
 
-    int32_t num_components = count_unique_labels(labels, G.n);
-    printf("Number of connected components: %d\n", num_components);
+    if (perf)
+        write_perf_counters(perf_readings, runs, output_dir, results_prefix + strlen("results_"), column_name, path);
+    perf_counters_destroy(perf);
+    free(perf_readings);
+
+    if (new_id && reorder_restore_labels(labels, new_id, G.n, strcmp(algorithm, "bfs") == 0) != 0)
+        fprintf(stderr, "Warning: Failed to map labels back to the original vertex order\n");
+
+    // Map the core labels back onto every input vertex
+    int32_t num_labels = G.n;
+    if (trimmed)
+    {
+        int32_t *full_labels = trim_expand_labels(&trim, labels, strcmp(algorithm, "bfs") == 0);
+        if (!full_labels)
+        {
+            fprintf(stderr, "Failed to expand trimmed labels\n");
+            free(run_times);
+            free(labels);
+            free_csr(&G);
+            return EXIT_FAILURE;
+        }
+        free(labels);
+        labels = full_labels;
+        num_labels = trim.n;
+    }
+
+    // Counted on the expanded labels, so trimmed trees are included
+    ComponentStats component_stats;
+    if (component_stats_compute(labels, num_labels, 0, NULL, &component_stats) == 0)
+    {
+        printf("Number of connected components: %d\n", component_stats.num_components);
+        if (use_component_stats)
+            write_component_stats(&component_stats, output_dir, results_prefix + strlen("results_"), path);
+    }
 
-    FILE *fout = fopen(labels_path, "w");
-    if (!fout)
+    if (labels_write(labels_path, labels_format, labels, num_labels, 0) != 0)
     {
-        fprintf(stderr, "Failed to open output file %s\n", labels_path);
         free(run_times);
         free(labels);
         free_csr(&G);
         return EXIT_FAILURE;
     }
-    for (int32_t i = 0; i < G.n; i++)
-        fprintf(fout, "%d\n", labels[i]);
-    fclose(fout);
 
+    char pages[32];
+    printf("Huge pages: %s (pages used: %s)\n", cc_hugepages_name(cc_alloc_hugepages()),
+           cc_alloc_pages_used(pages, sizeof(pages)));
     printf("Labels written to %s\n", labels_path);
     if (results_path_ready)
         printf("Time results written to %s\n", results_path);
 
+    trim_free(&trim);
+    free(new_id);
     free(run_times);
     free(labels);
     free_csr(&G);
@@ -0,0 +1,647 @@
+/* CC Benchmark harness
+ *
+ * Loads a graph once and runs any subset of the registered kernels (include/cc_bench.h)
+ * over lists of thread counts and chunk sizes, with warmup runs and optional cache
+ * flushing between runs. Every measured run becomes one CSV or JSON row and every
+ * configuration gets min/median/p95 statistics.
+ *
+ * Example:
+ *   bin/cc_bench -k omp,pthread_steal,afforest_omp -t 1,2,4,8 -w 2 -r 10 data/graph.mtx
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <math.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cc.h"
+#include "cc_alloc.h"
+#include "cc_bench.h"
+#include "cc_pthread_pool.h"
+#include "graph.h"
+#include "reorder.h"
+#include "opt_parser.h"
+#include "results_writer.h"
+#include "thread_util.h"
+
+// Long-only option identifiers
+enum
+{
+    OPT_CACHE = 256,
+    OPT_REORDER,
+    OPT_FLUSH_CACHE,
+    OPT_FORMAT,
+    OPT_LIST,
+    OPT_LOW_MEMORY,
+    OPT_HUGEPAGES,
+};
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTIONS] <matrix-file-path>\n\n"
+            "Options:\n"
+            "  -k, --kernels LIST       Comma-separated kernel names or 'all' (default all)\n"
+            "  -t, --threads SPEC       Thread counts (comma list or start:end[:step], default: all CPUs)\n"
+            "  -c, --chunk-size SPEC    Chunk sizes (comma list or start:end[:step], default 4096)\n"
+            "  -w, --warmup N           Untimed runs before every configuration (default 1)\n"
+            "  -r, --runs N             Measured runs per configuration (default 5)\n"
+            "  -o, --output DIR         Output directory (default 'results')\n"
+            "      --flush-cache MB     Stream an MB-sized buffer before every run (default off)\n"
+            "      --format FMT         Row format: csv or json (default csv)\n"
+            "      --cache              Reuse/write a binary .csr cache next to the input\n"
+            "      --reorder KIND       Vertex order: none, degree, bfs or rcm (default none)\n"
+            "      --list               List the available kernels and exit\n"
+            "      --low-memory         Load .mtx inputs in two passes without an edge list\n"
+            "      --hugepages MODE     Back large arrays with huge pages: off, thp, 2m, 1g (default off)\n"
+            "  -h, --help               Show this message\n",
+            prog);
+}
+
+static void list_kernels(void)
+{
+    size_t count;
+    const BenchKernel *kernels = cc_bench_kernels(&count);
+    for (size_t i = 0; i < count; i++)
+        printf("  %-18s %-10s %s\n", kernels[i].name, cc_bench_runtime_name(kernels[i].runtime),
+               kernels[i].description);
+}
+
+// Parse a comma-separated kernel list into selected (registry pointers). Returns the count or -1
+static int parse_kernel_list(const char *spec, const BenchKernel **selected, size_t capacity)
+{
+    size_t count;
+    const BenchKernel *kernels = cc_bench_kernels(&count);
+    if (strcmp(spec, "all") == 0)
+    {
+        for (size_t i = 0; i < count && i < capacity; i++)
+            selected[i] = &kernels[i];
+        return (int)(count < capacity ? count : capacity);
+    }
+
+    char *copy = strdup(spec);
+    if (!copy)
+        return -1;
+    int selected_count = 0;
+    char *save = NULL;
+    for (char *name = strtok_r(copy, ",", &save); name; name = strtok_r(NULL, ",", &save))
+    {
+        const BenchKernel *kernel = cc_bench_find_kernel(name);
+        if (!kernel)
+        {
+            fprintf(stderr, "Unknown kernel '%s' (see --list)\n", name);
+            free(copy);
+            return -1;
+        }
+        if ((size_t)selected_count < capacity)
+            selected[selected_count++] = kernel;
+    }
+    free(copy);
+    return selected_count;
+}
+
+// Evict the graph and labels from the caches by streaming through an unrelated buffer
+static void flush_caches(unsigned char *buffer, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i += 64)
+        buffer[i]++;
+    __asm__ __volatile__("" : : "r"(buffer) : "memory");
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Summary of the measured runs of one configuration (sorts times in place)
+typedef struct
+{
+    double min;
+    double median;
+    double p95;
+    double mean;
+} BenchStats;
+
+static BenchStats compute_stats(double *times, int count)
+{
+    qsort(times, (size_t)count, sizeof(double), cmp_double);
+    BenchStats stats;
+    double sum = 0.0;
+    for (int i = 0; i < count; i++)
+        sum += times[i];
+    stats.min = times[0];
+    stats.median = (count % 2) ? times[count / 2] : 0.5 * (times[count / 2 - 1] + times[count / 2]);
+    // Nearest-rank percentile
+    int rank = (int)((95 * (long long)count + 99) / 100);
+    stats.p95 = times[rank > 0 ? rank - 1 : 0];
+    stats.mean = sum / count;
+    return stats;
+}
+
+// Median speedup of every compact-layout kernel over its csr64 counterpart ("omp_varint" over "omp")
+// for the configurations both of them ran
+static void print_layout_speedups(const BenchKernel **selected, int num_selected, const double *medians,
+                                  const OptIntList *thread_counts, const OptIntList *chunk_sizes)
+{
+    const size_t num_configs = thread_counts->size * chunk_sizes->size;
+    int printed_header = 0;
+    for (int k = 0; k < num_selected; k++)
+    {
+        if (selected[k]->layout == CSR_LAYOUT_CSR64)
+            continue;
+        const char *suffix = strrchr(selected[k]->name, '_');
+        size_t base_len = suffix ? (size_t)(suffix - selected[k]->name) : 0;
+        for (int b = 0; b < num_selected && base_len > 0; b++)
+        {
+            if (selected[b]->layout != CSR_LAYOUT_CSR64 || strlen(selected[b]->name) != base_len ||
+                strncmp(selected[b]->name, selected[k]->name, base_len) != 0)
+                continue;
+            for (size_t c = 0; c < num_configs; c++)
+            {
+                double base = medians[(size_t)b * num_configs + c];
+                double compact = medians[(size_t)k * num_configs + c];
+                if (isnan(base) || isnan(compact) || compact <= 0.0)
+                    continue;
+                if (!printed_header)
+                {
+                    printf("Layout speedup over csr64 (median):\n");
+                    printed_header = 1;
+                }
+                printf("  %-18s %7d threads %10d chunk  %.3fx\n", selected[k]->name,
+                       thread_counts->values[c / chunk_sizes->size], chunk_sizes->values[c % chunk_sizes->size],
+                       base / compact);
+            }
+        }
+    }
+}
+
+// Open dir/<prefix>_<matrix>.<ext> for appending; header is written when the file is new
+static FILE *open_rows_file(const char *output_dir, const char *prefix, const char *matrix_path, int json,
+                            const char *header, char *path, size_t path_size)
+{
+    if (results_writer_build_results_path(path, path_size, output_dir, prefix, matrix_path) != 0)
+    {
+        fprintf(stderr, "Failed to build output path: %s\n", strerror(errno));
+        return NULL;
+    }
+    // The results path always ends in .csv; JSON rows go to a .jsonl file next to it
+    if (json)
+    {
+        size_t len = strlen(path);
+        if (len + 2 > path_size)
+            return NULL;
+        strcpy(path + len - 4, ".jsonl");
+    }
+
+    FILE *f = fopen(path, "a");
+    if (!f)
+    {
+        fprintf(stderr, "Failed to open %s for writing: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    if (!json && ftell(f) == 0)
+        fprintf(f, "%s\n", header);
+    return f;
+}
+
+int main(int argc, char **argv)
+{
+    const char *kernel_spec = "all";
+    const char *thread_spec = NULL;
+    const char *chunk_spec = "4096";
+    const char *output_dir = "results";
+    int warmup = 1;
+    int runs = 5;
+    int flush_mb = 0;
+    int json = 0;
+    ReorderKind reorder = REORDER_NONE;
+    int use_cache = 0;
+
+    const struct option long_opts[] = {
+        {"kernels", required_argument, NULL, 'k'},
+        {"threads", required_argument, NULL, 't'},
+        {"chunk-size", required_argument, NULL, 'c'},
+        {"warmup", required_argument, NULL, 'w'},
+        {"runs", required_argument, NULL, 'r'},
+        {"output", required_argument, NULL, 'o'},
+        {"flush-cache", required_argument, NULL, OPT_FLUSH_CACHE},
+        {"format", required_argument, NULL, OPT_FORMAT},
+        {"cache", no_argument, NULL, OPT_CACHE},
+        {"reorder", required_argument, NULL, OPT_REORDER},
+        {"list", no_argument, NULL, OPT_LIST},
+        {"low-memory", no_argument, NULL, OPT_LOW_MEMORY},
+        {"hugepages", required_argument, NULL, OPT_HUGEPAGES},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}};
+
+    int opt;
+    int opt_index = 0;
+    while ((opt = getopt_long(argc, argv, "k:t:c:w:r:o:h", long_opts, &opt_index)) != -1)
+    {
+        switch (opt)
+        {
+        case 'k':
+            kernel_spec = optarg;
+            break;
+        case 't':
+            thread_spec = optarg;
+            break;
+        case 'c':
+            chunk_spec = optarg;
+            break;
+        case 'w':
+            // Zero warmups is allowed
+            if (strcmp(optarg, "0") == 0)
+                warmup = 0;
+            else if (opt_parse_positive_int(optarg, &warmup) != 0)
+            {
+                fprintf(stderr, "Invalid warmup count: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'r':
+            if (opt_parse_positive_int(optarg, &runs) != 0)
+            {
+                fprintf(stderr, "Invalid run count: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'o':
+            if (!optarg || *optarg == '\0')
+            {
+                fprintf(stderr, "Output directory must not be empty.\n");
+                return EXIT_FAILURE;
+            }
+            output_dir = optarg;
+            break;
+        case OPT_FLUSH_CACHE:
+            if (opt_parse_positive_int(optarg, &flush_mb) != 0)
+            {
+                fprintf(stderr, "Invalid flush size: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_FORMAT:
+            if (strcmp(optarg, "json") == 0)
+                json = 1;
+            else if (strcmp(optarg, "csv") != 0)
+            {
+                fprintf(stderr, "Unsupported format '%s'. Choose 'csv' or 'json'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_CACHE:
+            use_cache = 1;
+            break;
+        case OPT_REORDER:
+            if (reorder_parse_kind(optarg, &reorder) != 0)
+            {
+                fprintf(stderr, "Unsupported reorder kind '%s'. Choose 'none', 'degree', 'bfs' or 'rcm'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_LIST:
+            list_kernels();
+            return EXIT_SUCCESS;
+        case OPT_LOW_MEMORY:
+            graph_set_low_memory_loading(1);
+            break;
+        case OPT_HUGEPAGES:
+        {
+            CCHugePages hugepages;
+            if (cc_hugepages_parse(optarg, &hugepages) != 0)
+            {
+                fprintf(stderr, "Unknown huge page mode '%s'. Choose off, thp, 2m or 1g.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            cc_alloc_set_hugepages(hugepages);
+            break;
+        }
+        case 'h':
+            print_usage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc)
+    {
+        fprintf(stderr, "Missing matrix file path.\n");
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *matrix_path = argv[optind];
+
+    size_t registry_size;
+    cc_bench_kernels(&registry_size);
+    const BenchKernel **selected = malloc(registry_size * sizeof(*selected));
+    if (!selected)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        return EXIT_FAILURE;
+    }
+    int num_selected = parse_kernel_list(kernel_spec, selected, registry_size);
+    if (num_selected <= 0)
+    {
+        free(selected);
+        return EXIT_FAILURE;
+    }
+
+    OptIntList thread_counts;
+    OptIntList chunk_sizes;
+    opt_int_list_init(&thread_counts);
+    opt_int_list_init(&chunk_sizes);
+    char default_threads[16];
+    if (!thread_spec)
+    {
+        snprintf(default_threads, sizeof(default_threads), "%d", thread_util_default_threads());
+        thread_spec = default_threads;
+    }
+    if (opt_parse_range_list(thread_spec, &thread_counts, "thread counts") != 0 ||
+        opt_parse_range_list(chunk_spec, &chunk_sizes, "chunk sizes") != 0)
+    {
+        opt_int_list_free(&thread_counts);
+        opt_int_list_free(&chunk_sizes);
+        free(selected);
+        return EXIT_FAILURE;
+    }
+
+    if (results_writer_ensure_directory(output_dir) != 0)
+    {
+        fprintf(stderr, "Failed to create output directory '%s': %s\n", output_dir, strerror(errno));
+        opt_int_list_free(&thread_counts);
+        opt_int_list_free(&chunk_sizes);
+        free(selected);
+        return EXIT_FAILURE;
+    }
+
+    char graph_name[256];
+    if (results_writer_matrix_stem(matrix_path, graph_name, sizeof(graph_name)) != 0)
+        snprintf(graph_name, sizeof(graph_name), "graph");
+
+    printf("Loading graph: %s\n", matrix_path);
+    double load_start = omp_get_wtime();
+    CSRGraph G;
+    int load_status = use_cache ? load_csr_from_file_cached(matrix_path, 1, 1, &G)
+                                : load_csr_from_file(matrix_path, 1, 1, &G);
+    if (load_status != 0)
+    {
+        fprintf(stderr, "Failed to load graph from %s\n", matrix_path);
+        opt_int_list_free(&thread_counts);
+        opt_int_list_free(&chunk_sizes);
+        free(selected);
+        return EXIT_FAILURE;
+    }
+    printf("Load time: %.6f seconds (n=%d, m=%lld)\n", omp_get_wtime() - load_start, G.n, (long long)G.m);
+
+    if (reorder != REORDER_NONE)
+    {
+        double reorder_start = omp_get_wtime();
+        int32_t *new_id = NULL;
+        if (reorder_graph(&G, reorder, &new_id) != 0)
+        {
+            fprintf(stderr, "Failed to reorder graph (%s)\n", reorder_kind_name(reorder));
+            free_csr(&G);
+            opt_int_list_free(&thread_counts);
+            opt_int_list_free(&chunk_sizes);
+            free(selected);
+            return EXIT_FAILURE;
+        }
+        free(new_id); // labels are not written, so the permutation is not needed
+        printf("Reorder (%s) time: %.6f seconds\n", reorder_kind_name(reorder), omp_get_wtime() - reorder_start);
+    }
+    const char *order_name = reorder_kind_name(reorder);
+
+    int max_threads = 1;
+    for (size_t ti = 0; ti < thread_counts.size; ti++)
+    {
+        if (thread_counts.values[ti] > max_threads)
+            max_threads = thread_counts.values[ti];
+    }
+
+    // Compact layouts are built once, outside the timed runs, and only when a selected kernel reads them
+    int need_csr32 = 0;
+    int need_varint = 0;
+    for (int k = 0; k < num_selected; k++)
+    {
+        need_csr32 |= (selected[k]->layout == CSR_LAYOUT_CSR32);
+        need_varint |= (selected[k]->layout == CSR_LAYOUT_VARINT);
+    }
+    CSRGraph32 G32 = {0};
+    CSRGraphVarint Gv = {0};
+    int have_csr32 = 0;
+    int have_varint = 0;
+    if (need_csr32 || need_varint)
+        printf("Adjacency csr64: %.2f bytes/edge\n", csr64_bytes_per_edge(&G));
+    if (need_csr32)
+    {
+        have_csr32 = (csr32_from_csr(&G, &G32) == 0);
+        if (have_csr32)
+            printf("Adjacency csr32: %.2f bytes/edge\n", csr32_bytes_per_edge(&G32));
+        else
+            fprintf(stderr, "Warning: csr32 layout unavailable (m=%lld), skipping its kernels\n", (long long)G.m);
+    }
+    if (need_varint)
+    {
+        double build_start = omp_get_wtime();
+        have_varint = (csr_varint_from_csr(&G, max_threads, &Gv) == 0);
+        if (have_varint)
+            printf("Adjacency varint: %.2f bytes/edge (encoded in %.6f seconds)\n", csr_varint_bytes_per_edge(&Gv),
+                   omp_get_wtime() - build_start);
+        else
+            fprintf(stderr, "Warning: varint layout unavailable, skipping its kernels\n");
+    }
+
+    size_t flush_bytes = (size_t)flush_mb << 20;
+    int32_t *labels = (int32_t *)malloc((size_t)(G.n > 0 ? G.n : 1) * sizeof(int32_t));
+    double *times = (double *)malloc((size_t)runs * sizeof(double));
+    unsigned char *flush_buffer = flush_bytes ? (unsigned char *)calloc(flush_bytes, 1) : NULL;
+    CCPthreadPool *pool = cc_pthread_pool_create(max_threads);
+    // Median of every (kernel, threads, chunk) configuration, for the layout speedups; NaN when not run
+    const size_t num_configs = thread_counts.size * chunk_sizes.size;
+    double *medians = (double *)malloc((size_t)num_selected * num_configs * sizeof(double));
+    if (!labels || !times || (flush_bytes && !flush_buffer) || !pool || !medians)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(medians);
+        csr32_free(&G32);
+        csr_varint_free(&Gv);
+        cc_pthread_pool_destroy(pool);
+        free(flush_buffer);
+        free(times);
+        free(labels);
+        free_csr(&G);
+        opt_int_list_free(&thread_counts);
+        opt_int_list_free(&chunk_sizes);
+        free(selected);
+        return EXIT_FAILURE;
+    }
+
+    char rows_path[PATH_MAX];
+    char summary_path[PATH_MAX];
+    FILE *rows = open_rows_file(output_dir, "bench", matrix_path, json,
+                                "graph,order,pages,kernel,threads,chunk_size,run,seconds", rows_path,
+                                sizeof(rows_path));
+    FILE *summary = rows ? open_rows_file(output_dir, "bench_summary", matrix_path, json,
+                                          "graph,order,pages,kernel,threads,chunk_size,warmup,runs,min_seconds,"
+                                          "median_seconds,p95_seconds,mean_seconds,components",
+                                          summary_path, sizeof(summary_path))
+                         : NULL;
+    if (!rows || !summary)
+    {
+        if (rows)
+            fclose(rows);
+        free(medians);
+        csr32_free(&G32);
+        csr_varint_free(&Gv);
+        cc_pthread_pool_destroy(pool);
+        free(flush_buffer);
+        free(times);
+        free(labels);
+        free_csr(&G);
+        opt_int_list_free(&thread_counts);
+        opt_int_list_free(&chunk_sizes);
+        free(selected);
+        return EXIT_FAILURE;
+    }
+
+    printf("Benchmarking %d kernel%s: %d warmup + %d measured run%s per configuration%s\n", num_selected,
+           num_selected == 1 ? "" : "s", warmup, runs, runs == 1 ? "" : "s",
+           flush_bytes ? ", caches flushed between runs" : "");
+    printf("%-18s %7s %10s %12s %12s %12s %10s\n", "Kernel", "Threads", "Chunk", "Min (s)", "Median (s)", "P95 (s)",
+           "Components");
+
+    for (size_t i = 0; i < (size_t)num_selected * num_configs; i++)
+        medians[i] = NAN;
+
+    int32_t reference_components = -1;
+    int mismatches = 0;
+    char pages[32];
+    cc_alloc_pages_used(pages, sizeof(pages));
+    for (int k = 0; k < num_selected; k++)
+    {
+        const BenchKernel *kernel = selected[k];
+        if ((kernel->layout == CSR_LAYOUT_CSR32 && !have_csr32) ||
+            (kernel->layout == CSR_LAYOUT_VARINT && !have_varint))
+            continue;
+        // Sequential and Cilk kernels have one thread setting, chunk-less kernels one chunk setting
+        const int cilk_workers = cc_bench_cilk_workers();
+        size_t num_thread_configs = (kernel->runtime == CC_BENCH_SEQUENTIAL || kernel->runtime == CC_BENCH_CILK)
+                                        ? 1
+                                        : thread_counts.size;
+        size_t num_chunk_configs = kernel->uses_chunk ? chunk_sizes.size : 1;
+
+        for (size_t ti = 0; ti < num_thread_configs; ti++)
+        {
+            int threads = kernel->runtime == CC_BENCH_SEQUENTIAL ? 1
+                          : kernel->runtime == CC_BENCH_CILK     ? cilk_workers
+                                                                 : thread_counts.values[ti];
+            if (kernel->runtime == CC_BENCH_OPENMP)
+                omp_set_num_threads(threads);
+
+            for (size_t ci = 0; ci < num_chunk_configs; ci++)
+            {
+                int chunk = kernel->uses_chunk ? chunk_sizes.values[ci] : 0;
+                BenchContext ctx = {&G, &G32, &Gv, threads, chunk, pool};
+
+                for (int run = 0; run < warmup + runs; run++)
+                {
+                    if (flush_buffer)
+                        flush_caches(flush_buffer, flush_bytes);
+                    double start = omp_get_wtime();
+                    kernel->run(&ctx, labels);
+                    double elapsed = omp_get_wtime() - start;
+                    if (run < warmup)
+                        continue;
+
+                    int index = run - warmup;
+                    times[index] = elapsed;
+                    // Page sizes of everything allocated so far, the kernel's own arrays included
+                    cc_alloc_pages_used(pages, sizeof(pages));
+                    if (json)
+                        fprintf(rows,
+                                "{\"graph\": \"%s\", \"order\": \"%s\", \"pages\": \"%s\", \"kernel\": \"%s\", "
+                                "\"threads\": %d, \"chunk_size\": %d, \"run\": %d, \"seconds\": %.9f}\n",
+                                graph_name, order_name, pages, kernel->name, threads, chunk, index, elapsed);
+                    else
+                        fprintf(rows, "%s,%s,%s,%s,%d,%d,%d,%.9f\n", graph_name, order_name, pages, kernel->name,
+                                threads, chunk, index, elapsed);
+                }
+
+                // Compact and minimum-ID labels both count components the same way
+                int32_t components = count_unique_labels(labels, G.n);
+                if (reference_components < 0)
+                    reference_components = components;
+                else if (components != reference_components)
+                {
+                    fprintf(stderr, "Warning: %s found %d components, expected %d\n", kernel->name, components,
+                            reference_components);
+                    mismatches++;
+                }
+
+                BenchStats stats = compute_stats(times, runs);
+                medians[(size_t)k * num_configs + ti * chunk_sizes.size + ci] = stats.median;
+                printf("%-18s %7d %10d %12.6f %12.6f %12.6f %10d\n", kernel->name, threads, chunk, stats.min,
+                       stats.median, stats.p95, components);
+                if (json)
+                    fprintf(summary,
+                            "{\"graph\": \"%s\", \"order\": \"%s\", \"pages\": \"%s\", \"kernel\": \"%s\", "
+                            "\"threads\": %d, \"chunk_size\": %d, \"warmup\": %d, \"runs\": %d, \"min_seconds\": %.9f, "
+                            "\"median_seconds\": %.9f, \"p95_seconds\": %.9f, \"mean_seconds\": %.9f, "
+                            "\"components\": %d}\n",
+                            graph_name, order_name, pages, kernel->name, threads, chunk, warmup, runs, stats.min,
+                            stats.median, stats.p95, stats.mean, components);
+                else
+                    fprintf(summary, "%s,%s,%s,%s,%d,%d,%d,%d,%.9f,%.9f,%.9f,%.9f,%d\n", graph_name, order_name,
+                            pages, kernel->name, threads, chunk, warmup, runs, stats.min, stats.median, stats.p95,
+                            stats.mean, components);
+                fflush(rows);
+                fflush(summary);
+            }
+        }
+    }
+
+    print_layout_speedups(selected, num_selected, medians, &thread_counts, &chunk_sizes);
+    printf("Huge pages: %s (pages used: %s)\n", cc_hugepages_name(cc_alloc_hugepages()),
+           cc_alloc_pages_used(pages, sizeof(pages)));
+
+    int status = EXIT_SUCCESS;
+    if (fclose(rows) != 0 || fclose(summary) != 0)
+    {
+        fprintf(stderr, "Failed to write results: %s\n", strerror(errno));
+        status = EXIT_FAILURE;
+    }
+    else
+    {
+        printf("Run rows written to %s\n", rows_path);
+        printf("Summary written to %s\n", summary_path);
+    }
+    if (mismatches > 0)
+    {
+        fprintf(stderr, "%d configuration%s disagreed on the component count\n", mismatches,
+                mismatches == 1 ? "" : "s");
+        status = EXIT_FAILURE;
+    }
+
+    free(medians);
+    csr32_free(&G32);
+    csr_varint_free(&Gv);
+    cc_pthread_pool_destroy(pool);
+    free(flush_buffer);
+    free(times);
+    free(labels);
+    free_csr(&G);
+    opt_int_list_free(&thread_counts);
+    opt_int_list_free(&chunk_sizes);
+    free(selected);
+    return status;
+}
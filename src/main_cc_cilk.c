@@ -1,8 +1,8 @@
 /* CC Test (OpenCilk)
  *
  * Loads a Matrix Market or MATLAB graph, runs the OpenCilk label propagation
- * implementation for the configured worker count, and records timings plus
- * labels. Use --runs/--chunk-size/--output to control benchmarking parameters.
+ * (recursive edge-balanced label propagation, or Afforest union-find) implementation for the configured worker count, and records timings plus
+ * labels. Use --algorithm/--runs/--chunk-size/--output to control benchmarking parameters.
  *
  * Example:
  *   CILK_NWORKERS=8 ./cc_cilk [OPTIONS] <matrix-file-path>
@@ -17,27 +17,83 @@
 #include <limits.h>
 #include <time.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <cilk/cilk.h>
 #include <cilk/cilk_api.h>
 #include <getopt.h>
 #include "cc.h"
+#include "cc_alloc.h"
 #include "graph.h"
+#include "labels_io.h"
+#include "lp_instrument.h"
+#include "perf_counters.h"
+#include "reorder.h"
+#include "trim.h"
+#include "tuned_profile.h"
 #include "opt_parser.h"
 #include "results_writer.h"
 
+// Long-only option identifiers
+enum
+{
+    OPT_CACHE = 256,
+    OPT_REORDER,
+    OPT_TRIM,
+    OPT_PERF_COUNTERS,
+    OPT_LABELS_FORMAT,
+    OPT_COMPONENT_STATS,
+    OPT_LOW_MEMORY,
+    OPT_HUGEPAGES,
+    OPT_TUNED,
+    OPT_RESULTS_FORMAT,
+};
+
 static void print_usage(const char *prog)
 {
     fprintf(stderr,
             "Usage: %s [OPTIONS] <matrix-file>\n\n"
             "Options:\n"
+            "  -a, --algorithm NAME  lp, recursive or afforest (default lp)\n"
             "  -r, --runs N          Number of runs to average (default 1)\n"
             "  -o, --output DIR      Output directory (default 'results')\n"
             "  -c, --chunk-size N    Chunk size for label propagation (default 2048)\n"
+            "      --cache           Reuse/write a binary .csr cache next to the input\n"
+            "      --reorder KIND    Vertex order: none, degree, bfs or rcm (default none)\n"
+            "      --trim            Peel degree-0/1 vertices and run on the remaining core\n"
+            "      --perf-counters   Read hardware counters around the kernel (perf_event_open)\n"
+            "      --labels-format FMT Label file format: text or binary (default text)\n"
+            "      --component-stats Write the component-size histogram and report the largest component\n"
+            "      --low-memory      Load .mtx inputs in two passes without an edge list\n"
+            "      --hugepages MODE  Back large arrays with huge pages: off, thp, 2m, 1g (default off)\n"
+            "      --tuned           Use the chunk size saved by cc_pthreads_sweep --autotune\n"
+            "      --results-format FMT Results layout: wide or long (appended rows, default wide)\n"
             "  -h, --help            Show this message\n"
             "Example: CILK_NWORKERS=8 %s data/graph.mtx\n",
             prog, prog);
 }
 
+// Write the per-round log of the recursive kernel next to the timing results
+static void write_round_stats(const LPRoundStats *stats, const char *output_dir, const char *method_base,
+                              const char *matrix_path, int64_t m)
+{
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "rounds_%s", method_base);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        lp_round_stats_write_csv(stats, path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write round statistics: %s\n", strerror(errno));
+        return;
+    }
+
+    int64_t scanned = lp_round_stats_total_edges(stats);
+    double full = (double)m * stats->count;
+    printf("Edges scanned (last run): %" PRId64 " of %.0f for full-scan rounds (%.1f%%)\n",
+           scanned, full, full > 0.0 ? 100.0 * (double)scanned / full : 0.0);
+    printf("Round statistics written to %s\n", path);
+}
+
 // Wall-clock time in seconds
 static inline double wall_time(void)
 {
@@ -46,27 +102,109 @@ static inline double wall_time(void)
     return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
 
+// Write the per-round, per-thread counters of the last LP run (builds with CC_INSTRUMENT only)
+static void write_instrument_log(const char *output_dir, const char *method_base, const char *matrix_path)
+{
+    if (lp_instrument_rounds() == 0)
+        return;
+
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "instrument_%s", method_base);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        lp_instrument_write_csv(path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write instrumentation log: %s\n", strerror(errno));
+        return;
+    }
+    printf("Instrumentation (last run, %d round%s) written to %s\n", lp_instrument_rounds(),
+           lp_instrument_rounds() == 1 ? "" : "s", path);
+}
+
+// Print the counter averages and append one column per counter to perf_<tag>_<matrix>.csv
+static void write_perf_counters(const PerfReading *readings, int runs, const char *output_dir, const char *tag,
+                                const char *column_name, const char *matrix_path)
+{
+    printf("Performance counters (average over %d run%s):\n", runs, runs == 1 ? "" : "s");
+    perf_counters_print_summary(readings, runs);
+
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "perf_%s", tag);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        perf_counters_write_columns(path, column_name, readings, runs) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write performance counters: %s\n", strerror(errno));
+        return;
+    }
+    printf("Performance counters written to %s\n", path);
+}
+
+// Print the largest component and write the component-size histogram
+static void write_component_stats(const ComponentStats *stats, const char *output_dir, const char *results_tag,
+                                  const char *matrix_path)
+{
+    printf("Largest component: %d vertices (label %d, dense ID %d of %d)\n", stats->largest_size,
+           stats->largest_label, stats->largest_component, stats->num_components);
+
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "components_%s", results_tag);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        component_stats_write_csv(stats, path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write component statistics: %s\n", strerror(errno));
+        return;
+    }
+    printf("Component size histogram written to %s\n", path);
+}
+
 int main(int argc, char **argv)
 {
+    const char *algorithm = "lp";
     int runs = 1;
     int chunk_size = 2048;
     const char *path = NULL;
     const char *output_dir = "results";
+    int use_tuned = 0;
+    int use_component_stats = 0;
+    LabelsFormat labels_format = LABELS_FORMAT_TEXT;
+    int use_perf = 0;
+    ReorderKind reorder = REORDER_NONE;
+    int use_cache = 0;
+    int use_trim = 0;
 
     const struct option long_opts[] = {
+        {"algorithm", required_argument, NULL, 'a'},
         {"runs", required_argument, NULL, 'r'},
         {"output", required_argument, NULL, 'o'},
         {"chunk-size", required_argument, NULL, 'c'},
+        {"cache", no_argument, NULL, OPT_CACHE},
+        {"reorder", required_argument, NULL, OPT_REORDER},
+        {"trim", no_argument, NULL, OPT_TRIM},
+        {"perf-counters", no_argument, NULL, OPT_PERF_COUNTERS},
+        {"labels-format", required_argument, NULL, OPT_LABELS_FORMAT},
+        {"component-stats", no_argument, NULL, OPT_COMPONENT_STATS},
+        {"low-memory", no_argument, NULL, OPT_LOW_MEMORY},
+        {"hugepages", required_argument, NULL, OPT_HUGEPAGES},
+        {"tuned", no_argument, NULL, OPT_TUNED},
+        {"results-format", required_argument, NULL, OPT_RESULTS_FORMAT},
         {"help", no_argument, NULL, 'h'},
         {NULL, 0, NULL, 0}
     };
 
     int opt;
     int opt_index = 0;
-    while ((opt = getopt_long(argc, argv, "r:o:c:h", long_opts, &opt_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "a:r:o:c:h", long_opts, &opt_index)) != -1)
     {
         switch (opt)
         {
+        case 'a':
+            algorithm = optarg;
+            break;
         case 'r':
             if (opt_parse_positive_int(optarg, &runs) != 0)
             {
@@ -89,6 +227,60 @@ int main(int argc, char **argv)
                 return EXIT_FAILURE;
             }
             break;
+        case OPT_CACHE:
+            use_cache = 1;
+            break;
+        case OPT_REORDER:
+            if (reorder_parse_kind(optarg, &reorder) != 0)
+            {
+                fprintf(stderr, "Unknown vertex order '%s'. Choose none, degree, bfs or rcm.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_TRIM:
+            use_trim = 1;
+            break;
+        case OPT_PERF_COUNTERS:
+            use_perf = 1;
+            break;
+        case OPT_LABELS_FORMAT:
+            if (labels_parse_format(optarg, &labels_format) != 0)
+            {
+                fprintf(stderr, "Unsupported labels format '%s'. Choose 'text' or 'binary'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_COMPONENT_STATS:
+            use_component_stats = 1;
+            break;
+        case OPT_LOW_MEMORY:
+            graph_set_low_memory_loading(1);
+            break;
+        case OPT_HUGEPAGES:
+        {
+            CCHugePages hugepages;
+            if (cc_hugepages_parse(optarg, &hugepages) != 0)
+            {
+                fprintf(stderr, "Unknown huge page mode '%s'. Choose off, thp, 2m or 1g.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            cc_alloc_set_hugepages(hugepages);
+            break;
+        }
+        case OPT_TUNED:
+            use_tuned = 1;
+            break;
+        case OPT_RESULTS_FORMAT:
+        {
+            results_format results_format_choice;
+            if (results_writer_parse_format(optarg, &results_format_choice) != 0)
+            {
+                fprintf(stderr, "Unknown results format '%s'. Choose 'wide' or 'long'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            results_writer_set_format(results_format_choice);
+            break;
+        }
         case 'h':
             print_usage(argv[0]);
             return EXIT_SUCCESS;
@@ -106,18 +298,27 @@ int main(int argc, char **argv)
 
     path = argv[optind];
 
+    const int use_afforest = (strcmp(algorithm, "afforest") == 0);
+    const int use_recursive = (strcmp(algorithm, "recursive") == 0);
+    if (!use_afforest && !use_recursive && strcmp(algorithm, "lp") != 0)
+    {
+        fprintf(stderr, "Unsupported algorithm '%s'. Choose 'lp', 'recursive' or 'afforest'.\n", algorithm);
+        return EXIT_FAILURE;
+    }
+
     if (results_writer_ensure_directory(output_dir) != 0)
     {
         fprintf(stderr, "Failed to create output directory '%s': %s\n", output_dir, strerror(errno));
         return EXIT_FAILURE;
     }
 
-    const char *method_base = "cilk";
+    const char *method_base = use_afforest ? "afforest_cilk" : use_recursive ? "recursive_cilk" : "cilk";
     char method_name[32];
     snprintf(method_name, sizeof(method_name), "%s", method_base);
 
     char labels_filename[64];
-    snprintf(labels_filename, sizeof(labels_filename), "%s_labels.txt", method_name);
+    snprintf(labels_filename, sizeof(labels_filename), "%s_labels.%s", method_name,
+             labels_format_extension(labels_format));
 
     char labels_path[PATH_MAX];
     if (results_writer_join_path(labels_path, sizeof(labels_path), output_dir, labels_filename) != 0)
@@ -130,14 +331,67 @@ int main(int argc, char **argv)
     int workers = __cilkrts_get_nworkers();
     printf("OpenCilk workers: %d\n", workers);
 
+    // --tuned replaces -c with the autotuned entry of this kernel variant. The worker count is
+    // fixed by CILK_NWORKERS when the runtime starts, so a different tuned thread count is reported
+    if (use_tuned)
+    {
+        TunedConfig tuned;
+        if (tuned_profile_lookup(output_dir, path, algorithm, reorder, use_trim, &tuned) != 0)
+            return EXIT_FAILURE;
+        chunk_size = tuned.chunk_size;
+        printf("Tuned configuration: chunk_size=%d\n", tuned.chunk_size);
+        if (tuned.threads != workers)
+            printf("Note: tuned for %d threads; run with CILK_NWORKERS=%d to match\n", tuned.threads,
+                   tuned.threads);
+    }
+
     printf("Loading graph: %s\n", path);
     CSRGraph G;
-    if (load_csr_from_file(path, 1, 1, &G) != 0)
+    int load_status = use_cache ? load_csr_from_file_cached(path, 1, 1, &G)
+                                : load_csr_from_file(path, 1, 1, &G);
+    if (load_status != 0)
     {
         fprintf(stderr, "Failed to load graph from %s\n", path);
         return EXIT_FAILURE;
     }
 
+    // Optional degree-0/1 trimming: the kernels (and the reordering) only see the core
+    TrimResult trim = {0};
+    int trimmed = 0;
+    if (use_trim)
+    {
+        double trim_start = wall_time();
+        CSRGraph core;
+        if (trim_graph(&G, 0, &core, &trim) != 0)
+        {
+            fprintf(stderr, "Failed to trim graph\n");
+            free_csr(&G);
+            return EXIT_FAILURE;
+        }
+        free_csr(&G);
+        G = core;
+        trimmed = 1;
+        printf("Trim time: %.6f seconds\n", wall_time() - trim_start);
+        printf("Trimmed core: %d of %d vertices (%.1f%%), %lld of %lld edges (%.1f%%); %d isolated, %d peeled\n",
+               trim.core_n, trim.n, trim.n > 0 ? 100.0 * trim.core_n / trim.n : 0.0, (long long)trim.core_m,
+               (long long)trim.m, trim.m > 0 ? 100.0 * (double)trim.core_m / (double)trim.m : 0.0, trim.isolated,
+               trim.peeled);
+    }
+
+    // Optional locality reordering, timed separately from the kernels
+    int32_t *new_id = NULL;
+    if (reorder != REORDER_NONE)
+    {
+        double reorder_start = wall_time();
+        if (reorder_graph(&G, reorder, &new_id) != 0)
+        {
+            fprintf(stderr, "Failed to reorder graph (%s)\n", reorder_kind_name(reorder));
+            free_csr(&G);
+            return EXIT_FAILURE;
+        }
+        printf("Reorder (%s) time: %.6f seconds\n", reorder_kind_name(reorder), wall_time() - reorder_start);
+    }
+
     int32_t *labels = malloc(G.n * sizeof(int32_t));
     if (!labels)
     {
@@ -155,17 +409,53 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    // Hardware counters cover the kernel call only, not loading or preprocessing
+    PerfCounters *perf = NULL;
+    PerfReading *perf_readings = NULL;
+    if (use_perf)
+    {
+        perf = perf_counters_create();
+        perf_readings = (PerfReading *)malloc((size_t)runs * sizeof(PerfReading));
+        if (!perf || !perf_readings)
+        {
+            fprintf(stderr, "Warning: Running without performance counters\n");
+            perf_counters_destroy(perf);
+            perf = NULL;
+        }
+    }
+
     printf("Computing connected components (%d run%s)...\n", runs, runs == 1 ? "" : "s");
 
+    LPRoundStats round_stats;
+    lp_round_stats_init(&round_stats);
     double total_time = 0.0;
     for (int run = 0; run < runs; run++)
     {
+        int rounds = 0;
+        if (use_recursive)
+            lp_round_stats_free(&round_stats); // keep only the last run
+        if (perf && perf_counters_start(perf) != 0)
+        {
+            perf_counters_destroy(perf);
+            perf = NULL;
+        }
         double start = wall_time();
-    compute_connected_components_cilk(&G, labels, chunk_size);
+        if (use_afforest)
+            compute_connected_components_afforest_cilk(&G, labels, chunk_size);
+        else if (use_recursive)
+            rounds = compute_connected_components_recursive_cilk(&G, labels, chunk_size, &round_stats);
+        else
+            compute_connected_components_cilk(&G, labels, chunk_size);
         double end = wall_time();
+        if (perf)
+            perf_counters_stop(perf, &perf_readings[run]);
         double elapsed = end - start;
         total_time += elapsed;
-        printf("Run %d time: %.6f seconds\n", run + 1, elapsed);
+        if (use_recursive)
+            printf("Run %d time: %.6f seconds (%d round%s, %" PRId64 " edges scanned)\n", run + 1, elapsed, rounds,
+                   rounds == 1 ? "" : "s", lp_round_stats_total_edges(&round_stats));
+        else
+            printf("Run %d time: %.6f seconds\n", run + 1, elapsed);
         run_times[run] = elapsed;
     }
 
@@ -179,10 +469,18 @@ int main(int argc, char **argv)
     char results_path[PATH_MAX];
     results_path[0] = '\0';
 
-    char results_prefix[32];
-    snprintf(results_prefix, sizeof(results_prefix), "results_%s", method_base);
+    // Reordered and trimmed runs get their own results files; label files keep the original name
+    char results_tag[64];
+    if (reorder == REORDER_NONE)
+        snprintf(results_tag, sizeof(results_tag), "%s%s", method_base, trimmed ? "_trim" : "");
+    else
+        snprintf(results_tag, sizeof(results_tag), "%s_%s%s", method_base, reorder_kind_name(reorder),
+                 trimmed ? "_trim" : "");
+
+    char results_prefix[96];
+    snprintf(results_prefix, sizeof(results_prefix), "results_%s", results_tag);
 
-    if (results_writer_build_results_path(results_path, sizeof(results_path), output_dir, results_prefix, path) != 0)
+    if (results_writer_build_times_path(results_path, sizeof(results_path), output_dir, results_prefix, path) != 0)
     {
         fprintf(stderr, "Warning: Failed to build results path: %s\n", strerror(errno));
     }
@@ -196,26 +494,63 @@ int main(int argc, char **argv)
         }
     }
 
-    int32_t num_components = count_unique_labels(labels, G.n);
-    printf("Number of connected components: %d\n", num_components);
+    if (perf)
+        write_perf_counters(perf_readings, runs, output_dir, results_tag, column_name, path);
+    perf_counters_destroy(perf);
+    free(perf_readings);
+
+    if (use_recursive)
+        write_round_stats(&round_stats, output_dir, results_tag, path, G.m);
+    lp_round_stats_free(&round_stats);
 
-    FILE *fout = fopen(labels_path, "w");
-    if (!fout)
+    if (new_id && reorder_restore_labels(labels, new_id, G.n, 0) != 0)
+        fprintf(stderr, "Warning: Failed to map labels back to the original vertex order\n");
+
+    // Map the core labels back onto every input vertex
+    int32_t num_labels = G.n;
+    if (trimmed)
+    {
+        int32_t *full_labels = trim_expand_labels(&trim, labels, 0);
+        if (!full_labels)
+        {
+            fprintf(stderr, "Failed to expand trimmed labels\n");
+            free(labels);
+            free_csr(&G);
+            return EXIT_FAILURE;
+        }
+        free(labels);
+        labels = full_labels;
+        num_labels = trim.n;
+    }
+
+    // Counted on the expanded labels, so trimmed trees are included
+    ComponentStats component_stats;
+    if (component_stats_compute(labels, num_labels, 0, NULL, &component_stats) == 0)
+    {
+        printf("Number of connected components: %d\n", component_stats.num_components);
+        if (use_component_stats)
+            write_component_stats(&component_stats, output_dir, results_tag, path);
+    }
+
+    if (labels_write(labels_path, labels_format, labels, num_labels, 0) != 0)
     {
-        fprintf(stderr, "Failed to open output file %s\n", labels_path);
         free(run_times);
         free(labels);
         free_csr(&G);
         return EXIT_FAILURE;
     }
-    for (int32_t i = 0; i < G.n; i++)
-        fprintf(fout, "%d\n", labels[i]);
-    fclose(fout);
 
+    char pages[32];
+    printf("Huge pages: %s (pages used: %s)\n", cc_hugepages_name(cc_alloc_hugepages()),
+           cc_alloc_pages_used(pages, sizeof(pages)));
     printf("Labels written to %s\n", labels_path);
     if (results_path_ready)
         printf("Time results written to %s\n", results_path);
 
+    write_instrument_log(output_dir, results_tag, path);
+
+    trim_free(&trim);
+    free(new_id);
     free(run_times);
     free(labels);
     free_csr(&G);
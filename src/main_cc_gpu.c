@@ -0,0 +1,289 @@
+/* CC Test (CUDA)
+ *
+ * Loads a graph on the host, streams it to the GPU through pinned staging buffers, runs
+ * ECL-CC on the device, copies the labels back and appends the kernel times to the same
+ * results_<algorithm>_<matrix>.csv family as the CPU backends. Upload and download times
+ * are reported separately and written to transfer_gpu_<matrix>.csv.
+ *
+ * Example:
+ *   bin/cc_gpu --runs 5 --device 0 data/graph.csr
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cc.h"
+#include "cc_gpu.h"
+#include "graph.h"
+#include "labels_io.h"
+#include "opt_parser.h"
+#include "results_writer.h"
+
+// Long-only option identifiers
+enum
+{
+    OPT_CACHE = 256,
+    OPT_LABELS_FORMAT,
+    OPT_LOW_MEMORY,
+    OPT_DEVICE,
+    OPT_CHUNK_MB,
+    OPT_RESULTS_FORMAT,
+};
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTIONS] <matrix-file-path>\n\n"
+            "Options:\n"
+            "  -r, --runs N             Number of runs to average (default 1)\n"
+            "  -o, --output DIR         Output directory (default 'results')\n"
+            "      --cache              Reuse/write a binary .csr cache next to the input\n"
+            "      --labels-format FMT  Label file format: text or binary (default text)\n"
+            "      --low-memory         Load .mtx inputs in two passes without an edge list\n"
+            "      --device N           CUDA device index (default 0)\n"
+            "      --chunk-mb N         Pinned staging chunk for the upload in MiB (default %zu)\n"
+            "      --results-format FMT Results layout: wide or long (appended rows, default wide)\n"
+            "  -h, --help               Show this message\n"
+            "Every run uploads the graph, runs the kernels and downloads the labels; only the\n"
+            "kernel time goes to the results file.\n",
+            prog, CC_GPU_DEFAULT_CHUNK_BYTES >> 20);
+}
+
+// Append the per-run upload and download times to transfer_gpu_<matrix>.csv
+static void write_transfer_times(const double *upload, const double *download, int runs, const char *output_dir,
+                                 const char *matrix_path)
+{
+    char path[PATH_MAX];
+    if (results_writer_build_times_path(path, sizeof(path), output_dir, "transfer_gpu", matrix_path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to build transfer results path: %s\n", strerror(errno));
+        return;
+    }
+    results_writer_status status = append_times_column(path, "H2D", upload, (size_t)runs);
+    if (status == RESULTS_WRITER_OK)
+        status = append_times_column(path, "D2H", download, (size_t)runs);
+    if (status != RESULTS_WRITER_OK)
+    {
+        fprintf(stderr, "Warning: Failed to update %s (error %d)\n", path, (int)status);
+        return;
+    }
+    printf("Transfer times written to %s\n", path);
+}
+
+int main(int argc, char **argv)
+{
+    int runs = 1;
+    const char *path = NULL;
+    const char *output_dir = "results";
+    LabelsFormat labels_format = LABELS_FORMAT_TEXT;
+    int use_cache = 0;
+    int device = 0;
+    size_t chunk_bytes = CC_GPU_DEFAULT_CHUNK_BYTES;
+
+    const struct option long_opts[] = {
+        {"runs", required_argument, NULL, 'r'},
+        {"output", required_argument, NULL, 'o'},
+        {"cache", no_argument, NULL, OPT_CACHE},
+        {"labels-format", required_argument, NULL, OPT_LABELS_FORMAT},
+        {"low-memory", no_argument, NULL, OPT_LOW_MEMORY},
+        {"device", required_argument, NULL, OPT_DEVICE},
+        {"chunk-mb", required_argument, NULL, OPT_CHUNK_MB},
+        {"results-format", required_argument, NULL, OPT_RESULTS_FORMAT},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}};
+
+    int opt;
+    int opt_index = 0;
+    while ((opt = getopt_long(argc, argv, "r:o:h", long_opts, &opt_index)) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            if (opt_parse_positive_int(optarg, &runs) != 0)
+            {
+                fprintf(stderr, "Invalid run count: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'o':
+            if (!optarg || *optarg == '\0')
+            {
+                fprintf(stderr, "Output directory must not be empty.\n");
+                return EXIT_FAILURE;
+            }
+            output_dir = optarg;
+            break;
+        case OPT_CACHE:
+            use_cache = 1;
+            break;
+        case OPT_LABELS_FORMAT:
+            if (labels_parse_format(optarg, &labels_format) != 0)
+            {
+                fprintf(stderr, "Unsupported labels format '%s'. Choose 'text' or 'binary'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_LOW_MEMORY:
+            graph_set_low_memory_loading(1);
+            break;
+        case OPT_DEVICE:
+        {
+            int parsed = 0;
+            if (strcmp(optarg, "0") != 0 && opt_parse_positive_int(optarg, &parsed) != 0)
+            {
+                fprintf(stderr, "Invalid device index: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            device = parsed;
+            break;
+        }
+        case OPT_CHUNK_MB:
+        {
+            int parsed = 0;
+            if (opt_parse_positive_int(optarg, &parsed) != 0)
+            {
+                fprintf(stderr, "Invalid staging chunk size: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            chunk_bytes = (size_t)parsed << 20;
+            break;
+        }
+        case OPT_RESULTS_FORMAT:
+        {
+            results_format results_format_choice;
+            if (results_writer_parse_format(optarg, &results_format_choice) != 0)
+            {
+                fprintf(stderr, "Unknown results format '%s'. Choose 'wide' or 'long'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            results_writer_set_format(results_format_choice);
+            break;
+        }
+        case 'h':
+            print_usage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc)
+    {
+        fprintf(stderr, "Missing matrix file path.\n");
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    path = argv[optind];
+
+    if (results_writer_ensure_directory(output_dir) != 0)
+    {
+        fprintf(stderr, "Failed to create output directory '%s': %s\n", output_dir, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    char labels_filename[64];
+    snprintf(labels_filename, sizeof(labels_filename), "gpu_labels.%s", labels_format_extension(labels_format));
+    char labels_path[PATH_MAX];
+    if (results_writer_join_path(labels_path, sizeof(labels_path), output_dir, labels_filename) != 0)
+    {
+        fprintf(stderr, "Output path too long for labels file: %s\n", strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    char device_name[256];
+    if (cc_gpu_init(device, device_name, sizeof(device_name)) != 0)
+        return EXIT_FAILURE;
+    printf("CUDA device %d: %s\n", device, device_name);
+
+    printf("Loading graph: %s\n", path);
+    CSRGraph G;
+    int load_status = use_cache ? load_csr_from_file_cached(path, 1, 1, &G) : load_csr_from_file(path, 1, 1, &G);
+    if (load_status != 0)
+    {
+        fprintf(stderr, "Failed to load graph from %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    CCGpuGraph *device_graph = cc_gpu_graph_create(G.n, G.m);
+    int32_t *labels = (int32_t *)malloc((size_t)(G.n > 0 ? G.n : 1) * sizeof(int32_t));
+    double *run_times = (double *)malloc((size_t)runs * 3 * sizeof(double));
+    if (!device_graph || !labels || !run_times)
+    {
+        if (device_graph)
+            fprintf(stderr, "Memory allocation failed\n");
+        cc_gpu_graph_destroy(device_graph);
+        free(labels);
+        free(run_times);
+        free_csr(&G);
+        return EXIT_FAILURE;
+    }
+    double *upload_times = run_times + runs;
+    double *download_times = run_times + 2 * (size_t)runs;
+
+    printf("Computing connected components (%d run%s)...\n", runs, runs == 1 ? "" : "s");
+
+    double total_time = 0.0;
+    for (int run = 0; run < runs; run++)
+    {
+        GPURunStats stats = {0};
+        if (cc_gpu_upload(device_graph, &G, chunk_bytes, &stats) != 0 ||
+            cc_gpu_components(device_graph, labels, &stats) != 0)
+        {
+            cc_gpu_graph_destroy(device_graph);
+            free(labels);
+            free(run_times);
+            free_csr(&G);
+            return EXIT_FAILURE;
+        }
+        run_times[run] = stats.kernel_seconds;
+        upload_times[run] = stats.upload_seconds;
+        download_times[run] = stats.download_seconds;
+        total_time += stats.kernel_seconds;
+        printf("Run %d time: %.6f seconds (upload %.6f s in %d chunk%s, download %.6f s)\n", run + 1,
+               stats.kernel_seconds, stats.upload_seconds, stats.chunks, stats.chunks == 1 ? "" : "s",
+               stats.download_seconds);
+    }
+    cc_gpu_graph_destroy(device_graph);
+
+    double average_time = total_time / runs;
+    printf("Average time over %d run%s: %.6f seconds\n", runs, runs == 1 ? "" : "s", average_time);
+
+    // A column without a thread count: plot_results.py draws it like the sequential baselines
+    char results_path[PATH_MAX] = "";
+    int results_path_ready = 0;
+    if (results_writer_build_times_path(results_path, sizeof(results_path), output_dir, "results_gpu", path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to build results path: %s\n", strerror(errno));
+    }
+    else
+    {
+        results_path_ready = 1;
+        results_writer_status status = append_times_column(results_path, "GPU", run_times, (size_t)runs);
+        if (status != RESULTS_WRITER_OK)
+            fprintf(stderr, "Warning: Failed to update %s (error %d)\n", results_path, (int)status);
+    }
+    write_transfer_times(upload_times, download_times, runs, output_dir, path);
+
+    printf("Number of connected components: %d\n", count_unique_labels(labels, G.n));
+
+    if (labels_write(labels_path, labels_format, labels, G.n, 0) != 0)
+    {
+        free(labels);
+        free(run_times);
+        free_csr(&G);
+        return EXIT_FAILURE;
+    }
+    printf("Labels written to %s\n", labels_path);
+    if (results_path_ready)
+        printf("Time results written to %s\n", results_path);
+
+    free(labels);
+    free(run_times);
+    free_csr(&G);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,271 @@
+/* CC Test (MPI)
+ *
+ * Splits the graph into edge-balanced vertex ranges over the MPI ranks, runs the
+ * distributed union-find + boundary label exchange, gathers the labels on rank 0, and
+ * appends the runtimes to the CSV summaries (one column per rank count).
+ *
+ * Example:
+ *   mpirun -np 8 bin/cc_mpi --runs 5 data/graph.csr
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "cc.h"
+#include "cc_mpi.h"
+#include "labels_io.h"
+#include "opt_parser.h"
+#include "results_writer.h"
+
+// Long-only option identifiers
+enum
+{
+    OPT_RESULTS_FORMAT = 256,
+    OPT_LABELS_FORMAT,
+};
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: mpirun -np R %s [OPTIONS] <matrix-file-path>\n\n"
+            "Options:\n"
+            "  -r, --runs N             Number of runs to average (default 1)\n"
+            "  -o, --output DIR         Output directory (default 'results')\n"
+            "      --labels-format FMT  Label file format: text or binary (default text)\n"
+            "      --results-format FMT Results layout: wide or long (appended rows, default wide)\n"
+            "  -h, --help               Show this message\n"
+            "Binary .csr inputs are mapped by every rank; other formats are loaded on rank 0.\n",
+            prog);
+}
+
+// Finalize MPI and return status from main
+static int finish(int status)
+{
+    MPI_Finalize();
+    return status;
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int runs = 1;
+    const char *path = NULL;
+    const char *output_dir = "results";
+    LabelsFormat labels_format = LABELS_FORMAT_TEXT;
+
+    const struct option long_opts[] = {
+        {"runs", required_argument, NULL, 'r'},
+        {"output", required_argument, NULL, 'o'},
+        {"results-format", required_argument, NULL, OPT_RESULTS_FORMAT},
+        {"labels-format", required_argument, NULL, OPT_LABELS_FORMAT},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}};
+
+    // Every rank parses the same arguments, rank 0 does the talking
+    int opt;
+    int opt_index = 0;
+    while ((opt = getopt_long(argc, argv, "r:o:h", long_opts, &opt_index)) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            if (opt_parse_positive_int(optarg, &runs) != 0)
+            {
+                if (rank == 0)
+                    fprintf(stderr, "Invalid run count: %s\n", optarg);
+                return finish(EXIT_FAILURE);
+            }
+            break;
+        case 'o':
+            if (!optarg || *optarg == '\0')
+            {
+                if (rank == 0)
+                    fprintf(stderr, "Output directory must not be empty.\n");
+                return finish(EXIT_FAILURE);
+            }
+            output_dir = optarg;
+            break;
+        case OPT_RESULTS_FORMAT:
+        {
+            results_format results_format_choice;
+            if (results_writer_parse_format(optarg, &results_format_choice) != 0)
+            {
+                if (rank == 0)
+                    fprintf(stderr, "Unknown results format '%s'. Choose 'wide' or 'long'.\n", optarg);
+                return finish(EXIT_FAILURE);
+            }
+            results_writer_set_format(results_format_choice);
+            break;
+        }
+        case OPT_LABELS_FORMAT:
+            if (labels_parse_format(optarg, &labels_format) != 0)
+            {
+                if (rank == 0)
+                    fprintf(stderr, "Unsupported labels format '%s'. Choose 'text' or 'binary'.\n", optarg);
+                return finish(EXIT_FAILURE);
+            }
+            break;
+        case 'h':
+            if (rank == 0)
+                print_usage(argv[0]);
+            return finish(EXIT_SUCCESS);
+        default:
+            if (rank == 0)
+                print_usage(argv[0]);
+            return finish(EXIT_FAILURE);
+        }
+    }
+
+    if (optind >= argc)
+    {
+        if (rank == 0)
+        {
+            fprintf(stderr, "Missing matrix file path.\n");
+            print_usage(argv[0]);
+        }
+        return finish(EXIT_FAILURE);
+    }
+    path = argv[optind];
+
+    char labels_filename[64];
+    snprintf(labels_filename, sizeof(labels_filename), "mpi_labels.%s", labels_format_extension(labels_format));
+    char labels_path[PATH_MAX];
+    int status = 0;
+    if (rank == 0)
+    {
+        if (results_writer_ensure_directory(output_dir) != 0)
+        {
+            fprintf(stderr, "Failed to create output directory '%s': %s\n", output_dir, strerror(errno));
+            status = 1;
+        }
+        else if (results_writer_join_path(labels_path, sizeof(labels_path), output_dir, labels_filename) != 0)
+        {
+            fprintf(stderr, "Output path too long for labels file: %s\n", strerror(errno));
+            status = 1;
+        }
+        else
+        {
+            printf("Loading graph: %s (%d rank%s)\n", path, size, size == 1 ? "" : "s");
+        }
+    }
+    MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (status != 0)
+        return finish(EXIT_FAILURE);
+
+    double load_start = MPI_Wtime();
+    MPIGraphPart part;
+    if (cc_mpi_distribute_graph(path, &part, MPI_COMM_WORLD) != 0)
+        return finish(EXIT_FAILURE);
+    const int32_t rows = part.last - part.first;
+    if (rank == 0)
+        printf("Distribution time: %.6f seconds (n=%d, m=%lld)\n", MPI_Wtime() - load_start, part.n,
+               (long long)part.m);
+
+    int32_t *local_labels = (int32_t *)malloc((size_t)(rows > 0 ? rows : 1) * sizeof(int32_t));
+    double *run_times = (double *)malloc((size_t)runs * sizeof(double));
+    status = (local_labels && run_times) ? 0 : 1;
+    MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (status != 0)
+    {
+        if (rank == 0)
+            fprintf(stderr, "Memory allocation failed\n");
+        free(local_labels);
+        free(run_times);
+        cc_mpi_free_graph(&part);
+        return finish(EXIT_FAILURE);
+    }
+
+    if (rank == 0)
+        printf("Computing connected components (%d run%s)...\n", runs, runs == 1 ? "" : "s");
+
+    double total_time = 0.0;
+    MPIRunStats stats = {0};
+    for (int run = 0; run < runs; run++)
+    {
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        status = cc_mpi_components(&part, local_labels, &stats, MPI_COMM_WORLD);
+        double elapsed = MPI_Wtime() - start;
+        // A run lasts as long as its slowest rank
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        if (status != 0)
+        {
+            free(local_labels);
+            free(run_times);
+            cc_mpi_free_graph(&part);
+            return finish(EXIT_FAILURE);
+        }
+
+        int64_t traffic[3] = {stats.updates, stats.bytes_sent, stats.raw_bytes};
+        MPI_Allreduce(MPI_IN_PLACE, traffic, 3, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
+        total_time += elapsed;
+        run_times[run] = elapsed;
+        if (rank == 0)
+            printf("Run %d time: %.6f seconds (%d exchange round%s, %lld updates, %.1f KiB sent, %.2fx compression)\n",
+                   run + 1, elapsed, stats.rounds, stats.rounds == 1 ? "" : "s", (long long)traffic[0],
+                   (double)traffic[1] / 1024.0, traffic[1] > 0 ? (double)traffic[2] / (double)traffic[1] : 1.0);
+    }
+
+    int32_t *labels = NULL;
+    if (rank == 0)
+    {
+        labels = (int32_t *)malloc((size_t)(part.n > 0 ? part.n : 1) * sizeof(int32_t));
+        if (!labels)
+        {
+            fprintf(stderr, "Memory allocation failed\n");
+            MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+        }
+    }
+    cc_mpi_gather_labels(&part, local_labels, labels, 0, MPI_COMM_WORLD);
+    free(local_labels);
+
+    if (rank == 0)
+    {
+        double average_time = total_time / runs;
+        printf("Average time over %d run%s: %.6f seconds\n", runs, runs == 1 ? "" : "s", average_time);
+
+        // Columns follow the "N Threads" naming of the shared-memory results, counting ranks
+        char results_path[PATH_MAX] = "";
+        int results_path_ready = 0;
+        if (results_writer_build_times_path(results_path, sizeof(results_path), output_dir, "results_mpi", path) != 0)
+        {
+            fprintf(stderr, "Warning: Failed to build results path: %s\n", strerror(errno));
+        }
+        else
+        {
+            results_path_ready = 1;
+            char column_name[64];
+            snprintf(column_name, sizeof(column_name), size == 1 ? "1 Thread" : "%d Threads", size);
+            results_writer_status csv_status = append_times_column(results_path, column_name, run_times, (size_t)runs);
+            if (csv_status != RESULTS_WRITER_OK)
+                fprintf(stderr, "Warning: Failed to update %s (error %d)\n", results_path, (int)csv_status);
+        }
+
+        printf("Number of connected components: %d\n", count_unique_labels(labels, part.n));
+
+        if (labels_write(labels_path, labels_format, labels, part.n, 0) != 0)
+        {
+            status = 1;
+        }
+        else
+        {
+            printf("Labels written to %s\n", labels_path);
+            if (results_path_ready)
+                printf("Time results written to %s\n", results_path);
+        }
+        free(labels);
+    }
+
+    free(run_times);
+    cc_mpi_free_graph(&part);
+    return finish(status == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -1,8 +1,8 @@
 /* CC Test (Pthreads)
  *
  * Loads a Matrix Market (.mtx/.txt) or MATLAB (.mat) graph, sweeps the pthread-based
- * label propagation implementation across one or more thread counts, and writes both the
- * component labels and timing results. Thread counts accept either a single value
+ * label propagation (or frontier LP / parallel BFS / Afforest union-find / Shiloach-Vishkin) implementation across one
+ * or more thread counts, and writes both the component labels and timing results. Thread counts accept either a single value
  * (default 1) or the range/list syntax shared with the sweep tool.
  *
  * Usage:
@@ -17,47 +17,231 @@
 #include <string.h>
 #include <limits.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <omp.h>  // only for timing
 #include "cc.h"
+#include "cc_alloc.h"
+#include "cc_pthread_pool.h"
 #include "graph.h"
+#include "labels_io.h"
+#include "lp_instrument.h"
+#include "numa_util.h"
+#include "perf_counters.h"
+#include "reorder.h"
+#include "trim.h"
+#include "tuned_profile.h"
 #include "opt_parser.h"
 #include "results_writer.h"
 
+// Long-only option identifiers
+enum
+{
+    OPT_CACHE = 256,
+    OPT_REORDER,
+    OPT_SCHEDULE,
+    OPT_NUMA,
+    OPT_TRIM,
+    OPT_PERF_COUNTERS,
+    OPT_LABELS_FORMAT,
+    OPT_COMPONENT_STATS,
+    OPT_LOW_MEMORY,
+    OPT_HUGEPAGES,
+    OPT_TUNED,
+    OPT_RESULTS_FORMAT,
+};
+
 static void print_usage(const char *prog)
 {
     fprintf(stderr,
             "Usage: %s [OPTIONS] <matrix-file-path>\n\n"
             "Options:\n"
+            "  -a, --algorithm NAME   lp, frontier, bfs-par, afforest or sv (default lp)\n"
             "  -t, --threads SPEC     Thread counts (default 1; comma/range syntax supported)\n"
             "  -r, --runs N           Number of runs to average (default 1)\n"
             "  -o, --output DIR       Output directory (default 'results')\n"
             "  -c, --chunk-size N     Chunk size for dynamic scheduling (default 4096)\n"
+            "      --cache            Reuse/write a binary .csr cache next to the input\n"
+            "      --reorder KIND     Vertex order: none, degree, bfs or rcm (default none)\n"
+            "      --schedule MODE    LP scheduler: chunk, steal or async (default chunk)\n"
+            "      --numa             Pin threads and place graph/label arrays per NUMA node\n"
+            "      --trim             Peel degree-0/1 vertices and run on the remaining core\n"
+            "      --perf-counters    Read hardware counters around the kernel (perf_event_open)\n"
+            "      --labels-format FMT Label file format: text or binary (default text)\n"
+            "      --component-stats  Write the component-size histogram and report the largest component\n"
+            "      --low-memory       Load .mtx inputs in two passes without an edge list\n"
+            "      --hugepages MODE   Back large arrays with huge pages: off, thp, 2m, 1g (default off)\n"
+            "      --tuned            Use the threads, chunk size and schedule from cc_pthreads_sweep --autotune\n"
+            "      --results-format FMT Results layout: wide or long (appended rows, default wide)\n"
             "  -h, --help             Show this message\n",
             prog);
 }
 
+// Write the per-round frontier log next to the timing results
+static void write_round_stats(const LPRoundStats *stats, const char *output_dir, const char *method_base,
+                              const char *matrix_path, int64_t m)
+{
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "rounds_%s", method_base);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        lp_round_stats_write_csv(stats, path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write round statistics: %s\n", strerror(errno));
+        return;
+    }
+
+    int64_t scanned = lp_round_stats_total_edges(stats);
+    double full = (double)m * stats->count;
+    printf("Edges scanned (last run): %" PRId64 " of %.0f for full-scan rounds (%.1f%%)\n",
+           scanned, full, full > 0.0 ? 100.0 * (double)scanned / full : 0.0);
+    printf("Round statistics written to %s\n", path);
+}
+
+// Write the per-round, per-thread counters of the last LP run (builds with CC_INSTRUMENT only)
+static void write_instrument_log(const char *output_dir, const char *method_base, const char *matrix_path)
+{
+    if (lp_instrument_rounds() == 0)
+        return;
+
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "instrument_%s", method_base);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        lp_instrument_write_csv(path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write instrumentation log: %s\n", strerror(errno));
+        return;
+    }
+    printf("Instrumentation (last run, %d round%s) written to %s\n", lp_instrument_rounds(),
+           lp_instrument_rounds() == 1 ? "" : "s", path);
+}
+
+// Print the per-node read bandwidth over the NUMA-placed graph arrays
+static void report_numa_bandwidth(const CSRGraph *G, const NumaTopology *topo, int num_threads)
+{
+    double *gbps = malloc((size_t)topo->num_nodes * sizeof(double));
+    if (!gbps || numa_measure_bandwidth(G, topo, num_threads, gbps) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to measure per-socket bandwidth\n");
+        free(gbps);
+        return;
+    }
+    for (int node = 0; node < topo->num_nodes; node++)
+        printf("Socket %d read bandwidth (%d thread%s total): %.2f GB/s\n", node, num_threads,
+               num_threads == 1 ? "" : "s", gbps[node]);
+    free(gbps);
+}
+
+// Pin threads and place the graph arrays per node. Returns 1 when NUMA mode is active
+static int setup_numa(CSRGraph *G, NumaTopology *topo, int num_threads)
+{
+    if (numa_topology_load(topo) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to read the CPU topology; --numa ignored\n");
+        return 0;
+    }
+
+    double start = omp_get_wtime();
+    if (numa_localize_csr(G, topo, num_threads) != 0)
+        fprintf(stderr, "Warning: Failed to place the graph arrays per node\n");
+    printf("NUMA placement (%d node%s, %d CPU%s) time: %.6f seconds\n", topo->num_nodes,
+           topo->num_nodes == 1 ? "" : "s", topo->num_cpus, topo->num_cpus == 1 ? "" : "s",
+           omp_get_wtime() - start);
+    report_numa_bandwidth(G, topo, num_threads);
+    return 1;
+}
+
+// Print the counter averages and append one column per counter to perf_<tag>_<matrix>.csv
+static void write_perf_counters(const PerfReading *readings, int runs, const char *output_dir, const char *tag,
+                                const char *column_name, const char *matrix_path)
+{
+    printf("Performance counters (average over %d run%s):\n", runs, runs == 1 ? "" : "s");
+    perf_counters_print_summary(readings, runs);
+
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "perf_%s", tag);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        perf_counters_write_columns(path, column_name, readings, runs) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write performance counters: %s\n", strerror(errno));
+        return;
+    }
+    printf("Performance counters written to %s\n", path);
+}
+
+// Print the largest component and write the component-size histogram
+static void write_component_stats(const ComponentStats *stats, const char *output_dir, const char *results_tag,
+                                  const char *matrix_path)
+{
+    printf("Largest component: %d vertices (label %d, dense ID %d of %d)\n", stats->largest_size,
+           stats->largest_label, stats->largest_component, stats->num_components);
+
+    char prefix[96];
+    snprintf(prefix, sizeof(prefix), "components_%s", results_tag);
+
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0 ||
+        component_stats_write_csv(stats, path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to write component statistics: %s\n", strerror(errno));
+        return;
+    }
+    printf("Component size histogram written to %s\n", path);
+}
+
 int main(int argc, char **argv)
 {
+    const char *algorithm = "lp";
     int runs = 1;
     int chunk_size = 4096;
     const char *path = NULL;
     const char *output_dir = "results";
+    int use_tuned = 0;
+    int use_component_stats = 0;
+    LabelsFormat labels_format = LABELS_FORMAT_TEXT;
+    int use_perf = 0;
+    int use_steal = 0;
+    int use_async = 0;
+    ReorderKind reorder = REORDER_NONE;
+    int use_cache = 0;
+    int use_trim = 0;
+    int use_numa = 0;
     const char *thread_spec = "1";
 
     const struct option long_opts[] = {
+        {"algorithm", required_argument, NULL, 'a'},
         {"threads", required_argument, NULL, 't'},
         {"runs", required_argument, NULL, 'r'},
         {"output", required_argument, NULL, 'o'},
         {"chunk-size", required_argument, NULL, 'c'},
+        {"cache", no_argument, NULL, OPT_CACHE},
+        {"reorder", required_argument, NULL, OPT_REORDER},
+        {"schedule", required_argument, NULL, OPT_SCHEDULE},
+        {"numa", no_argument, NULL, OPT_NUMA},
+        {"trim", no_argument, NULL, OPT_TRIM},
+        {"perf-counters", no_argument, NULL, OPT_PERF_COUNTERS},
+        {"labels-format", required_argument, NULL, OPT_LABELS_FORMAT},
+        {"component-stats", no_argument, NULL, OPT_COMPONENT_STATS},
+        {"low-memory", no_argument, NULL, OPT_LOW_MEMORY},
+        {"hugepages", required_argument, NULL, OPT_HUGEPAGES},
+        {"tuned", no_argument, NULL, OPT_TUNED},
+        {"results-format", required_argument, NULL, OPT_RESULTS_FORMAT},
         {"help", no_argument, NULL, 'h'},
         {NULL, 0, NULL, 0}
     };
 
     int opt, opt_index = 0;
-    while ((opt = getopt_long(argc, argv, "t:r:o:c:h", long_opts, &opt_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "a:t:r:o:c:h", long_opts, &opt_index)) != -1)
     {
         switch (opt)
         {
+        case 'a':
+            algorithm = optarg;
+            break;
         case 't':
             if (!optarg || *optarg == '\0')
             {
@@ -94,6 +278,70 @@ int main(int argc, char **argv)
             }
             break;
         }
+        case OPT_CACHE:
+            use_cache = 1;
+            break;
+        case OPT_REORDER:
+            if (reorder_parse_kind(optarg, &reorder) != 0)
+            {
+                fprintf(stderr, "Unknown vertex order '%s'. Choose none, degree, bfs or rcm.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_SCHEDULE:
+            use_steal = (strcmp(optarg, "steal") == 0);
+            use_async = (strcmp(optarg, "async") == 0);
+            if (use_steal || use_async || strcmp(optarg, "chunk") == 0)
+                break;
+            fprintf(stderr, "Unknown schedule '%s'. Choose chunk, steal or async.\n", optarg);
+            return EXIT_FAILURE;
+        case OPT_NUMA:
+            use_numa = 1;
+            break;
+        case OPT_TRIM:
+            use_trim = 1;
+            break;
+        case OPT_PERF_COUNTERS:
+            use_perf = 1;
+            break;
+        case OPT_LABELS_FORMAT:
+            if (labels_parse_format(optarg, &labels_format) != 0)
+            {
+                fprintf(stderr, "Unsupported labels format '%s'. Choose 'text' or 'binary'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_COMPONENT_STATS:
+            use_component_stats = 1;
+            break;
+        case OPT_LOW_MEMORY:
+            graph_set_low_memory_loading(1);
+            break;
+        case OPT_HUGEPAGES:
+        {
+            CCHugePages hugepages;
+            if (cc_hugepages_parse(optarg, &hugepages) != 0)
+            {
+                fprintf(stderr, "Unknown huge page mode '%s'. Choose off, thp, 2m or 1g.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            cc_alloc_set_hugepages(hugepages);
+            break;
+        }
+        case OPT_TUNED:
+            use_tuned = 1;
+            break;
+        case OPT_RESULTS_FORMAT:
+        {
+            results_format results_format_choice;
+            if (results_writer_parse_format(optarg, &results_format_choice) != 0)
+            {
+                fprintf(stderr, "Unknown results format '%s'. Choose 'wide' or 'long'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            results_writer_set_format(results_format_choice);
+            break;
+        }
         case 'h':
             print_usage(argv[0]);
             return EXIT_SUCCESS;
@@ -111,6 +359,52 @@ int main(int argc, char **argv)
     }
     path = argv[optind];
 
+    // --tuned replaces -t, -c and --schedule with the autotuned entry of this kernel variant
+    char tuned_threads[16];
+    if (use_tuned)
+    {
+        TunedConfig tuned;
+        if (tuned_profile_lookup(output_dir, path, algorithm, reorder, use_trim, &tuned) != 0)
+            return EXIT_FAILURE;
+        snprintf(tuned_threads, sizeof(tuned_threads), "%d", tuned.threads);
+        thread_spec = tuned_threads;
+        chunk_size = tuned.chunk_size;
+        use_steal = (strcmp(tuned.schedule, "steal") == 0);
+        use_async = (strcmp(tuned.schedule, "async") == 0);
+        printf("Tuned configuration: threads=%d chunk_size=%d schedule=%s\n", tuned.threads, tuned.chunk_size,
+               tuned.schedule);
+    }
+
+    const int use_afforest = (strcmp(algorithm, "afforest") == 0);
+    const int use_sv = (strcmp(algorithm, "sv") == 0);
+    const int use_frontier = (strcmp(algorithm, "frontier") == 0);
+    const int use_bfs = (strcmp(algorithm, "bfs-par") == 0);
+    if (!use_afforest && !use_sv && !use_frontier && !use_bfs && strcmp(algorithm, "lp") != 0)
+    {
+        fprintf(stderr, "Unsupported algorithm '%s'. Choose 'lp', 'frontier', 'bfs-par', 'afforest' or 'sv'.\n",
+                algorithm);
+        return EXIT_FAILURE;
+    }
+    if ((use_steal || use_async) && (use_afforest || use_sv || use_frontier || use_bfs))
+    {
+        fprintf(stderr, "--schedule steal/async only applies to the lp algorithm.\n");
+        return EXIT_FAILURE;
+    }
+    const CCPoolKernel kernel = use_afforest   ? CC_POOL_AFFOREST
+                                : use_sv       ? CC_POOL_SV
+                                : use_frontier ? CC_POOL_FRONTIER
+                                : use_bfs      ? CC_POOL_BFS
+                                : use_steal    ? CC_POOL_LP_STEAL
+                                : use_async    ? CC_POOL_LP_ASYNC
+                                               : CC_POOL_LP;
+    const char *method_base = use_afforest   ? "afforest_pthread"
+                              : use_sv       ? "sv_pthread"
+                              : use_frontier ? "frontier_pthread"
+                              : use_bfs      ? "bfs_pthread"
+                              : use_steal    ? "pthread_steal"
+                              : use_async    ? "pthread_async"
+                                             : "pthread";
+
     OptIntList thread_counts;
     opt_int_list_init(&thread_counts);
     if (opt_parse_range_list(thread_spec, &thread_counts, "thread counts") != 0)
@@ -132,8 +426,12 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    char labels_filename[64];
+    snprintf(labels_filename, sizeof(labels_filename), "%s_labels.%s", method_base,
+             labels_format_extension(labels_format));
+
     char labels_path[PATH_MAX];
-    if (results_writer_join_path(labels_path, sizeof(labels_path), output_dir, "pthread_labels.txt") != 0)
+    if (results_writer_join_path(labels_path, sizeof(labels_path), output_dir, labels_filename) != 0)
     {
         fprintf(stderr, "Output path too long for labels file: %s\n", strerror(errno));
         opt_int_list_free(&thread_counts);
@@ -143,13 +441,54 @@ int main(int argc, char **argv)
     printf("Loading graph: %s\n", path);
 
     CSRGraph G;
-    if (load_csr_from_file(path, 1, 1, &G) != 0)
+    int load_status = use_cache ? load_csr_from_file_cached(path, 1, 1, &G)
+                                : load_csr_from_file(path, 1, 1, &G);
+    if (load_status != 0)
     {
         fprintf(stderr, "Failed to load graph from %s\n", path);
         opt_int_list_free(&thread_counts);
         return EXIT_FAILURE;
     }
 
+    // Optional degree-0/1 trimming: the kernels (and the reordering) only see the core
+    TrimResult trim = {0};
+    int trimmed = 0;
+    if (use_trim)
+    {
+        double trim_start = omp_get_wtime();
+        CSRGraph core;
+        if (trim_graph(&G, 0, &core, &trim) != 0)
+        {
+            fprintf(stderr, "Failed to trim graph\n");
+            free_csr(&G);
+            opt_int_list_free(&thread_counts);
+            return EXIT_FAILURE;
+        }
+        free_csr(&G);
+        G = core;
+        trimmed = 1;
+        printf("Trim time: %.6f seconds\n", omp_get_wtime() - trim_start);
+        printf("Trimmed core: %d of %d vertices (%.1f%%), %lld of %lld edges (%.1f%%); %d isolated, %d peeled\n",
+               trim.core_n, trim.n, trim.n > 0 ? 100.0 * trim.core_n / trim.n : 0.0, (long long)trim.core_m,
+               (long long)trim.m, trim.m > 0 ? 100.0 * (double)trim.core_m / (double)trim.m : 0.0, trim.isolated,
+               trim.peeled);
+    }
+
+    // Optional locality reordering, timed separately from the kernels
+    int32_t *new_id = NULL;
+    if (reorder != REORDER_NONE)
+    {
+        double reorder_start = omp_get_wtime();
+        if (reorder_graph(&G, reorder, &new_id) != 0)
+        {
+            fprintf(stderr, "Failed to reorder graph (%s)\n", reorder_kind_name(reorder));
+            free_csr(&G);
+            opt_int_list_free(&thread_counts);
+            return EXIT_FAILURE;
+        }
+        printf("Reorder (%s) time: %.6f seconds\n", reorder_kind_name(reorder), omp_get_wtime() - reorder_start);
+    }
+
     int32_t *labels = malloc(G.n * sizeof(int32_t));
     if (!labels)
     {
@@ -169,6 +508,9 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    LPRoundStats round_stats;
+    lp_round_stats_init(&round_stats);
+
     printf("Sweeping %zu thread option%s (%d run%s each).\n",
            thread_counts.size,
            thread_counts.size == 1 ? "" : "s",
@@ -178,7 +520,19 @@ int main(int argc, char **argv)
     int results_path_ready = 0;
     char results_path[PATH_MAX];
     results_path[0] = '\0';
-    if (results_writer_build_results_path(results_path, sizeof(results_path), output_dir, "results_pthread", path) != 0)
+
+    // Reordered and trimmed runs get their own results files; label files keep the original name
+    char results_tag[64];
+    if (reorder == REORDER_NONE)
+        snprintf(results_tag, sizeof(results_tag), "%s%s", method_base, trimmed ? "_trim" : "");
+    else
+        snprintf(results_tag, sizeof(results_tag), "%s_%s%s", method_base, reorder_kind_name(reorder),
+                 trimmed ? "_trim" : "");
+
+    char results_prefix[96];
+    snprintf(results_prefix, sizeof(results_prefix), "results_%s", results_tag);
+
+    if (results_writer_build_times_path(results_path, sizeof(results_path), output_dir, results_prefix, path) != 0)
     {
         fprintf(stderr, "Warning: Failed to build results path: %s\n", strerror(errno));
     }
@@ -187,6 +541,46 @@ int main(int argc, char **argv)
         results_path_ready = 1;
     }
 
+    // Workers are started once for every thread count, so the runs time the kernel only
+    int max_threads = 1;
+    for (size_t idx = 0; idx < thread_counts.size; idx++)
+    {
+        if (thread_counts.values[idx] > max_threads)
+            max_threads = thread_counts.values[idx];
+    }
+    CCPthreadPool *pool = cc_pthread_pool_create(max_threads);
+    if (!pool)
+    {
+        lp_round_stats_free(&round_stats);
+        free(run_times);
+        free(labels);
+        trim_free(&trim);
+        free(new_id);
+        free_csr(&G);
+        opt_int_list_free(&thread_counts);
+        return EXIT_FAILURE;
+    }
+
+    // Placement follows the largest thread count; smaller runs reuse the same pinning order
+    NumaTopology topo = {0};
+    if (use_numa && setup_numa(&G, &topo, max_threads))
+        cc_pthread_pool_set_affinity(pool, &topo);
+
+    // Hardware counters cover the kernel call only, not loading or preprocessing
+    PerfCounters *perf = NULL;
+    PerfReading *perf_readings = NULL;
+    if (use_perf)
+    {
+        perf = perf_counters_create();
+        perf_readings = (PerfReading *)malloc((size_t)runs * sizeof(PerfReading));
+        if (!perf || !perf_readings)
+        {
+            fprintf(stderr, "Warning: Running without performance counters\n");
+            perf_counters_destroy(perf);
+            perf = NULL;
+        }
+    }
+
     for (size_t idx = 0; idx < thread_counts.size; idx++)
     {
         int num_threads = thread_counts.values[idx];
@@ -200,11 +594,34 @@ int main(int argc, char **argv)
         double total_time = 0.0;
         for (int run = 0; run < runs; run++)
         {
+            int rounds = 0;
+            if (use_frontier)
+                lp_round_stats_free(&round_stats); // keep only the last run
+            if (perf && perf_counters_start(perf) != 0)
+            {
+                perf_counters_destroy(perf);
+                perf = NULL;
+            }
             double start = omp_get_wtime();
-            compute_connected_components_pthreads(&G, labels, num_threads, chunk_size);
+            rounds = cc_pthread_pool_run_cc(pool, kernel, &G, labels, num_threads, chunk_size, &round_stats);
             double elapsed = omp_get_wtime() - start;
+            if (perf)
+                perf_counters_stop(perf, &perf_readings[run]);
             total_time += elapsed;
-            printf("  Run %d: %.6f seconds\n", run + 1, elapsed);
+            if (use_sv)
+                printf("  Run %d: %.6f seconds (%d round%s)\n", run + 1, elapsed, rounds, rounds == 1 ? "" : "s");
+            else if (use_frontier)
+                printf("  Run %d: %.6f seconds (%d round%s, %" PRId64 " edges scanned)\n", run + 1, elapsed,
+                       rounds, rounds == 1 ? "" : "s", lp_round_stats_total_edges(&round_stats));
+            else if (use_bfs)
+                printf("  Run %d: %.6f seconds (%d BFS level%s)\n", run + 1, elapsed, rounds, rounds == 1 ? "" : "s");
+            else if (use_steal)
+                printf("  Run %d: %.6f seconds (%d task%s stolen)\n", run + 1, elapsed, rounds, rounds == 1 ? "" : "s");
+            else if (use_async)
+                printf("  Run %d: %.6f seconds (at most %d sweep%s per thread)\n", run + 1, elapsed, rounds,
+                       rounds == 1 ? "" : "s");
+            else
+                printf("  Run %d: %.6f seconds\n", run + 1, elapsed);
             run_times[run] = elapsed;
         }
 
@@ -214,38 +631,80 @@ int main(int argc, char **argv)
                num_threads == 1 ? "" : "s",
                average);
 
+        char column_name[64];
+        snprintf(column_name, sizeof(column_name), num_threads == 1 ? "1 Thread" : "%d Threads", num_threads);
         if (results_path_ready)
         {
-            char column_name[64];
-            snprintf(column_name, sizeof(column_name), num_threads == 1 ? "1 Thread" : "%d Threads", num_threads);
             results_writer_status csv_status = append_times_column(results_path, column_name, run_times, (size_t)runs);
             if (csv_status != RESULTS_WRITER_OK)
                 fprintf(stderr, "Warning: Failed to update %s (error %d)\n", results_path, (int)csv_status);
         }
+        if (perf)
+            write_perf_counters(perf_readings, runs, output_dir, results_tag, column_name, path);
+    }
+    perf_counters_destroy(perf);
+    free(perf_readings);
+
+    cc_pthread_pool_destroy(pool);
+
+    if (new_id && reorder_restore_labels(labels, new_id, G.n, 0) != 0)
+        fprintf(stderr, "Warning: Failed to map labels back to the original vertex order\n");
+
+    // Map the core labels back onto every input vertex
+    int32_t num_labels = G.n;
+    if (trimmed)
+    {
+        int32_t *full_labels = trim_expand_labels(&trim, labels, 0);
+        if (!full_labels)
+        {
+            fprintf(stderr, "Failed to expand trimmed labels\n");
+            lp_round_stats_free(&round_stats);
+            numa_topology_free(&topo);
+            free(labels);
+            free_csr(&G);
+            free(run_times);
+            opt_int_list_free(&thread_counts);
+            return EXIT_FAILURE;
+        }
+        free(labels);
+        labels = full_labels;
+        num_labels = trim.n;
     }
 
-    int32_t num_components = count_unique_labels(labels, G.n);
-    printf("Number of connected components (last run): %d\n", num_components);
+    // Counted on the expanded labels, so trimmed trees are included
+    ComponentStats component_stats;
+    if (component_stats_compute(labels, num_labels, 0, NULL, &component_stats) == 0)
+    {
+        printf("Number of connected components (last run): %d\n", component_stats.num_components);
+        if (use_component_stats)
+            write_component_stats(&component_stats, output_dir, results_tag, path);
+    }
 
-    FILE *fout = fopen(labels_path, "w");
-    if (!fout)
+    if (labels_write(labels_path, labels_format, labels, num_labels, 0) != 0)
     {
-        fprintf(stderr, "Failed to open output file %s.\n", labels_path);
+        lp_round_stats_free(&round_stats);
+        numa_topology_free(&topo);
         free(labels);
         free_csr(&G);
         free(run_times);
         opt_int_list_free(&thread_counts);
         return EXIT_FAILURE;
     }
-
-    for (int32_t i = 0; i < G.n; i++)
-        fprintf(fout, "%d\n", labels[i]);
-
-    fclose(fout);
+    char pages[32];
+    printf("Huge pages: %s (pages used: %s)\n", cc_hugepages_name(cc_alloc_hugepages()),
+           cc_alloc_pages_used(pages, sizeof(pages)));
     printf("Labels written to %s\n", labels_path);
     if (results_path_ready)
         printf("Timing results written to %s\n", results_path);
 
+    if (use_frontier)
+        write_round_stats(&round_stats, output_dir, results_tag, path, G.m);
+    lp_round_stats_free(&round_stats);
+    write_instrument_log(output_dir, results_tag, path);
+
+    numa_topology_free(&topo);
+    trim_free(&trim);
+    free(new_id);
     free(run_times);
     free(labels);
     free_csr(&G);
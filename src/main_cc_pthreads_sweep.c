@@ -1,8 +1,9 @@
 /*
  * Connected Components using POSIX Threads - Parameter Sweep Tool
  *
- * Loads a graph, sweeps across lists/ranges of thread counts and chunk sizes,
- * executes multiple runs per configuration, and emits a compact CSV of
+ * Loads a graph, sweeps across lists/ranges of thread counts and chunk sizes for the
+ * LP, frontier LP, parallel BFS, Afforest union-find or Shiloach-Vishkin pthreads kernel,
+ * executes multiple runs per configuration on one persistent worker pool, and emits a compact CSV of
  * (threads, chunk_size, average_seconds) values suitable for 3D surface plots.
  *
  * Usage:
@@ -21,49 +22,346 @@
 #include <string.h>
 
 #include "cc.h"
+#include "cc_alloc.h"
+#include "cc_pthread_pool.h"
 #include "graph.h"
+#include "reorder.h"
+#include "trim.h"
 #include "results_writer.h"
 #include "opt_parser.h"
+#include "thread_util.h"
+#include "tuned_profile.h"
 
 #ifndef PATH_MAX
 #define PATH_MAX 4096
 #endif
 
+// Long-only option identifiers
+enum
+{
+    OPT_CACHE = 256,
+    OPT_REORDER,
+    OPT_SCHEDULE,
+    OPT_TRIM,
+    OPT_LOW_MEMORY,
+    OPT_HUGEPAGES,
+    OPT_AUTOTUNE,
+};
+
 static void print_usage(const char *prog)
 {
     fprintf(stderr,
             "Usage: %s [OPTIONS] <matrix-file-path>\n"
             "\n"
             "Options:\n"
+            "  -a, --algorithm NAME      lp, frontier, bfs-par, afforest or sv (default lp)\n"
             "  -t, --threads SPEC        Thread counts to sweep (comma list or start:end[:step])\n"
             "  -c, --chunk-size SPEC     Chunk sizes to sweep (comma list or start:end[:step])\n"
             "  -r, --runs N              Runs per configuration (default 100)\n"
             "  -o, --output DIR          Directory for result CSV (default 'results')\n"
+            "      --cache               Reuse/write a binary .csr cache next to the input\n"
+            "      --reorder KIND        Vertex order: none, degree, bfs or rcm (default none)\n"
+            "      --schedule MODE       LP scheduler: chunk, steal or async (default chunk)\n"
+            "      --trim                Peel degree-0/1 vertices and run on the remaining core\n"
+            "      --low-memory          Load .mtx inputs in two passes without an edge list\n"
+            "      --hugepages MODE      Back large arrays with huge pages: off, thp, 2m, 1g (default off)\n"
+            "      --autotune            Successive-halving search instead of the full sweep (see README)\n"
             "  -h, --help                Show this message\n",
             prog);
 }
 
+// Samples per configuration in the first autotune round; every later round doubles them
+#define AUTOTUNE_FIRST_SAMPLES 3
+
+// Chunk sizes tried by --autotune when -c is not given
+static const int autotune_default_chunks[] = {256, 1024, 4096, 16384, 65536};
+
+// One (threads, chunk size, scheduler) point of the autotune search
+typedef struct
+{
+    int threads;
+    int chunk;
+    CCPoolKernel kernel;
+    const char *schedule;
+    double *samples; // sorted after every round
+    int count;
+    double median;
+} TuneCandidate;
+
+// Search space and outputs of one --autotune session
+typedef struct
+{
+    const char *matrix_path;
+    const char *output_dir;
+    const char *results_tag;
+    const char *profile_key;
+    const OptIntList *thread_counts;
+    const OptIntList *chunk_sizes;
+    const CCPoolKernel *kernels;
+    const char *const *schedules;
+    size_t num_schedules;
+    int max_samples;
+    int32_t peeled_components; // trees removed by --trim, added to the reported count
+} AutotuneOptions;
+
+// Powers of two below the online CPU count, then the count itself. Returns 0 on success
+static int autotune_default_threads(OptIntList *list)
+{
+    int max_threads = thread_util_default_threads();
+    for (int threads = 1; threads < max_threads; threads *= 2)
+    {
+        if (opt_int_list_append(list, threads) != 0)
+            return -1;
+    }
+    return opt_int_list_append(list, max_threads);
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_candidate_median(const void *a, const void *b)
+{
+    const TuneCandidate *x = *(const TuneCandidate *const *)a;
+    const TuneCandidate *y = *(const TuneCandidate *const *)b;
+    return (x->median > y->median) - (x->median < y->median);
+}
+
+// Successive halving over every (threads, chunk, scheduler) candidate on the loaded graph. Each
+// round tops the surviving candidates up to the round's sample count, ranks them by median and
+// keeps the faster half. A candidate whose fastest run is slower than every run of the leader is
+// dominated and dropped at once. Stops with one survivor or after max_samples runs each.
+// The rounds are traced to results_<tag>_autotune_<matrix>.csv and the winner is stored in
+// the graph's tuned profile. Returns 0 on success
+static int run_autotune(const AutotuneOptions *opts, const CSRGraph *G, int32_t *labels)
+{
+    size_t num_candidates = 0;
+    for (size_t si = 0; si < opts->num_schedules; si++)
+        num_candidates += opts->thread_counts->size *
+                          (opts->kernels[si] == CC_POOL_LP_ASYNC ? 1 : opts->chunk_sizes->size);
+
+    TuneCandidate *candidates = (TuneCandidate *)calloc(num_candidates, sizeof(*candidates));
+    TuneCandidate **alive = (TuneCandidate **)malloc(num_candidates * sizeof(*alive));
+    double *samples = (double *)malloc(num_candidates * (size_t)opts->max_samples * sizeof(double));
+    if (!candidates || !alive || !samples)
+    {
+        fprintf(stderr, "Autotune allocation failed (%zu configurations).\n", num_candidates);
+        free(candidates);
+        free(alive);
+        free(samples);
+        return -1;
+    }
+
+    int max_threads = 1;
+    size_t c = 0;
+    for (size_t ti = 0; ti < opts->thread_counts->size; ti++)
+    {
+        int threads = opts->thread_counts->values[ti];
+        if (threads > max_threads)
+            max_threads = threads;
+        for (size_t si = 0; si < opts->num_schedules; si++)
+        {
+            // The async scheduler ignores the chunk size, so it is tried once per thread count
+            size_t num_chunks = opts->kernels[si] == CC_POOL_LP_ASYNC ? 1 : opts->chunk_sizes->size;
+            for (size_t ci = 0; ci < num_chunks; ci++, c++)
+            {
+                candidates[c].threads = threads;
+                candidates[c].chunk = opts->chunk_sizes->values[ci];
+                candidates[c].kernel = opts->kernels[si];
+                candidates[c].schedule = opts->schedules[si];
+                candidates[c].samples = samples + c * (size_t)opts->max_samples;
+                alive[c] = &candidates[c];
+            }
+        }
+    }
+
+    char trace_prefix[96];
+    char trace_path[PATH_MAX];
+    char profile_path[PATH_MAX];
+    snprintf(trace_prefix, sizeof(trace_prefix), "results_%s_autotune", opts->results_tag);
+    if (results_writer_build_results_path(trace_path, sizeof(trace_path), opts->output_dir, trace_prefix,
+                                          opts->matrix_path) != 0 ||
+        tuned_profile_path(profile_path, sizeof(profile_path), opts->output_dir, opts->matrix_path) != 0)
+    {
+        fprintf(stderr, "Failed to build output path: %s\n", strerror(errno));
+        free(candidates);
+        free(alive);
+        free(samples);
+        return -1;
+    }
+
+    FILE *trace = fopen(trace_path, "w");
+    if (!trace)
+    {
+        fprintf(stderr, "Failed to open %s for writing: %s\n", trace_path, strerror(errno));
+        free(candidates);
+        free(alive);
+        free(samples);
+        return -1;
+    }
+    fprintf(trace, "round,threads,chunk_size,schedule,runs,median_seconds,min_seconds,status\n");
+
+    CCPthreadPool *pool = cc_pthread_pool_create(max_threads);
+    if (!pool)
+    {
+        fclose(trace);
+        free(candidates);
+        free(alive);
+        free(samples);
+        return -1;
+    }
+
+    printf("Autotuning %zu configuration%s (up to %d run%s each).\n", num_candidates,
+           num_candidates == 1 ? "" : "s", opts->max_samples, opts->max_samples == 1 ? "" : "s");
+
+    // One untimed run faults in the labels and wakes the workers before anything is measured
+    cc_pthread_pool_run_cc(pool, candidates[0].kernel, G, labels, max_threads, candidates[0].chunk, NULL);
+
+    size_t total_runs = 0;
+    size_t num_alive = num_candidates;
+    int target = opts->max_samples < AUTOTUNE_FIRST_SAMPLES ? opts->max_samples : AUTOTUNE_FIRST_SAMPLES;
+    for (int round = 1;; round++)
+    {
+        for (size_t i = 0; i < num_alive; i++)
+        {
+            TuneCandidate *cand = alive[i];
+            while (cand->count < target)
+            {
+                double start = omp_get_wtime();
+                cc_pthread_pool_run_cc(pool, cand->kernel, G, labels, cand->threads, cand->chunk, NULL);
+                cand->samples[cand->count++] = omp_get_wtime() - start;
+                total_runs++;
+            }
+            qsort(cand->samples, (size_t)cand->count, sizeof(double), cmp_double);
+            int n = cand->count;
+            cand->median = (n % 2) ? cand->samples[n / 2] : 0.5 * (cand->samples[n / 2 - 1] + cand->samples[n / 2]);
+        }
+        qsort(alive, num_alive, sizeof(*alive), cmp_candidate_median);
+
+        const TuneCandidate *leader = alive[0];
+        const double leader_max = leader->samples[leader->count - 1];
+        const size_t keep = (num_alive + 1) / 2;
+        size_t survivors = 0;
+        for (size_t i = 0; i < num_alive; i++)
+        {
+            if (i < keep && (i == 0 || alive[i]->samples[0] <= leader_max))
+                survivors++;
+        }
+        const int last = target >= opts->max_samples || survivors == 1;
+
+        for (size_t i = 0; i < num_alive; i++)
+        {
+            const TuneCandidate *cand = alive[i];
+            const char *status = i == 0 && last                            ? "best"
+                                 : i > 0 && cand->samples[0] > leader_max ? "dominated"
+                                 : i >= keep                               ? "halved"
+                                 : last                                    ? "dropped"
+                                                                           : "kept";
+            fprintf(trace, "%d,%d,%d,%s,%d,%.9f,%.9f,%s\n", round, cand->threads, cand->chunk, cand->schedule,
+                    cand->count, cand->median, cand->samples[0], status);
+        }
+
+        printf("Round %d: %zu configuration%s at %d run%s, leader threads=%d chunk=%d schedule=%s "
+               "(median %.6f s)",
+               round, num_alive, num_alive == 1 ? "" : "s", target, target == 1 ? "" : "s", leader->threads,
+               leader->chunk, leader->schedule, leader->median);
+        if (last)
+            printf("\n");
+        else
+            printf(", %zu kept\n", survivors);
+        if (last)
+            break;
+
+        // The survivors are the leading entries that were not dominated
+        size_t next = 0;
+        for (size_t i = 0; i < keep; i++)
+        {
+            if (i == 0 || alive[i]->samples[0] <= leader_max)
+                alive[next++] = alive[i];
+        }
+        num_alive = next;
+        target = target > opts->max_samples / 2 ? opts->max_samples : target * 2;
+    }
+
+    const TuneCandidate *best = alive[0];
+    int32_t components = count_unique_labels(labels, G->n) + opts->peeled_components;
+    cc_pthread_pool_destroy(pool);
+
+    int status = 0;
+    if (fclose(trace) != 0)
+    {
+        fprintf(stderr, "Failed to write %s: %s\n", trace_path, strerror(errno));
+        status = -1;
+    }
+
+    printf("Best configuration: threads=%d chunk_size=%d schedule=%s (median %.6f s over %d run%s)\n",
+           best->threads, best->chunk, best->schedule, best->median, best->count, best->count == 1 ? "" : "s");
+    printf("Autotune used %zu kernel runs; the exhaustive sweep takes %zu.\n", total_runs,
+           num_candidates * (size_t)opts->max_samples);
+    printf("Detected %d connected components.\n", components);
+
+    TunedConfig tuned = {.threads = best->threads, .chunk_size = best->chunk, .median_seconds = best->median};
+    snprintf(tuned.schedule, sizeof(tuned.schedule), "%s", best->schedule);
+    if (tuned_profile_store(profile_path, opts->profile_key, &tuned) != 0)
+    {
+        fprintf(stderr, "Failed to write tuned profile %s: %s\n", profile_path, strerror(errno));
+        status = -1;
+    }
+    else
+    {
+        printf("Autotune trace saved to %s\n", trace_path);
+        printf("Tuned profile entry '%s' saved to %s\n", opts->profile_key, profile_path);
+    }
+
+    free(candidates);
+    free(alive);
+    free(samples);
+    return status;
+}
+
 int main(int argc, char **argv)
 {
-    const char *thread_spec = "1";
-    const char *chunk_spec = "4096";
+    const char *algorithm = "lp";
+    const char *thread_spec = NULL;
+    const char *chunk_spec = NULL;
+    int schedule_given = 0;
     const char *output_dir = "results";
+    int use_autotune = 0;
+    int use_steal = 0;
+    int use_async = 0;
+    ReorderKind reorder = REORDER_NONE;
+    int use_cache = 0;
+    int use_trim = 0;
     int runs = 100;
 
     const struct option long_opts[] = {
+        {"algorithm", required_argument, NULL, 'a'},
         {"threads", required_argument, NULL, 't'},
         {"chunk-size", required_argument, NULL, 'c'},
         {"runs", required_argument, NULL, 'r'},
         {"output", required_argument, NULL, 'o'},
+        {"cache", no_argument, NULL, OPT_CACHE},
+        {"reorder", required_argument, NULL, OPT_REORDER},
+        {"schedule", required_argument, NULL, OPT_SCHEDULE},
+        {"trim", no_argument, NULL, OPT_TRIM},
+        {"low-memory", no_argument, NULL, OPT_LOW_MEMORY},
+        {"hugepages", required_argument, NULL, OPT_HUGEPAGES},
+        {"autotune", no_argument, NULL, OPT_AUTOTUNE},
         {"help", no_argument, NULL, 'h'},
         {NULL, 0, NULL, 0}};
 
     int opt;
     int opt_index = 0;
-    while ((opt = getopt_long(argc, argv, "t:c:r:o:h", long_opts, &opt_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "a:t:c:r:o:h", long_opts, &opt_index)) != -1)
     {
         switch (opt)
         {
+        case 'a':
+            algorithm = optarg;
+            break;
         case 't':
             if (!optarg || *optarg == '\0')
             {
@@ -99,6 +397,44 @@ int main(int argc, char **argv)
             }
             output_dir = optarg;
             break;
+        case OPT_CACHE:
+            use_cache = 1;
+            break;
+        case OPT_REORDER:
+            if (reorder_parse_kind(optarg, &reorder) != 0)
+            {
+                fprintf(stderr, "Unknown vertex order '%s'. Choose none, degree, bfs or rcm.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case OPT_SCHEDULE:
+            schedule_given = 1;
+            use_steal = (strcmp(optarg, "steal") == 0);
+            use_async = (strcmp(optarg, "async") == 0);
+            if (use_steal || use_async || strcmp(optarg, "chunk") == 0)
+                break;
+            fprintf(stderr, "Unknown schedule '%s'. Choose chunk, steal or async.\n", optarg);
+            return EXIT_FAILURE;
+        case OPT_TRIM:
+            use_trim = 1;
+            break;
+        case OPT_LOW_MEMORY:
+            graph_set_low_memory_loading(1);
+            break;
+        case OPT_HUGEPAGES:
+        {
+            CCHugePages hugepages;
+            if (cc_hugepages_parse(optarg, &hugepages) != 0)
+            {
+                fprintf(stderr, "Unknown huge page mode '%s'. Choose off, thp, 2m or 1g.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            cc_alloc_set_hugepages(hugepages);
+            break;
+        }
+        case OPT_AUTOTUNE:
+            use_autotune = 1;
+            break;
         case 'h':
             print_usage(argv[0]);
             return EXIT_SUCCESS;
@@ -123,6 +459,36 @@ int main(int argc, char **argv)
 
     const char *matrix_path = argv[optind];
 
+    const int use_afforest = (strcmp(algorithm, "afforest") == 0);
+    const int use_sv = (strcmp(algorithm, "sv") == 0);
+    const int use_frontier = (strcmp(algorithm, "frontier") == 0);
+    const int use_bfs = (strcmp(algorithm, "bfs-par") == 0);
+    if (!use_afforest && !use_sv && !use_frontier && !use_bfs && strcmp(algorithm, "lp") != 0)
+    {
+        fprintf(stderr, "Unsupported algorithm '%s'. Choose 'lp', 'frontier', 'bfs-par', 'afforest' or 'sv'.\n",
+                algorithm);
+        return EXIT_FAILURE;
+    }
+    if ((use_steal || use_async) && (use_afforest || use_sv || use_frontier || use_bfs))
+    {
+        fprintf(stderr, "--schedule steal/async only applies to the lp algorithm.\n");
+        return EXIT_FAILURE;
+    }
+    const CCPoolKernel kernel = use_afforest   ? CC_POOL_AFFOREST
+                                : use_sv       ? CC_POOL_SV
+                                : use_frontier ? CC_POOL_FRONTIER
+                                : use_bfs      ? CC_POOL_BFS
+                                : use_steal    ? CC_POOL_LP_STEAL
+                                : use_async    ? CC_POOL_LP_ASYNC
+                                               : CC_POOL_LP;
+    const char *method_base = use_afforest   ? "afforest_pthread"
+                              : use_sv       ? "sv_pthread"
+                              : use_frontier ? "frontier_pthread"
+                              : use_bfs      ? "bfs_pthread"
+                              : use_steal    ? "pthread_steal"
+                              : use_async    ? "pthread_async"
+                                             : "pthread";
+
     if (results_writer_ensure_directory(output_dir) != 0)
     {
         fprintf(stderr, "Failed to prepare output directory '%s': %s\n", output_dir, strerror(errno));
@@ -134,19 +500,32 @@ int main(int argc, char **argv)
     opt_int_list_init(&thread_counts);
     opt_int_list_init(&chunk_sizes);
 
-    if (opt_parse_range_list(thread_spec, &thread_counts, "thread counts") != 0)
+    // Without -t/-c the sweep measures one point, while the autotuner gets a default search space
+    int spec_status = 0;
+    if (thread_spec)
+        spec_status = opt_parse_range_list(thread_spec, &thread_counts, "thread counts");
+    else if (use_autotune)
+        spec_status = autotune_default_threads(&thread_counts);
+    else
+        spec_status = opt_int_list_append(&thread_counts, 1);
+    if (spec_status == 0 && chunk_spec)
+        spec_status = opt_parse_range_list(chunk_spec, &chunk_sizes, "chunk sizes");
+    else if (spec_status == 0 && use_autotune)
     {
-        opt_int_list_free(&thread_counts);
-        return EXIT_FAILURE;
+        for (size_t i = 0; spec_status == 0 && i < sizeof(autotune_default_chunks) / sizeof(int); i++)
+            spec_status = opt_int_list_append(&chunk_sizes, autotune_default_chunks[i]);
     }
-    if (opt_parse_range_list(chunk_spec, &chunk_sizes, "chunk sizes") != 0)
+    else if (spec_status == 0)
+        spec_status = opt_int_list_append(&chunk_sizes, 4096);
+    if (spec_status != 0)
     {
         opt_int_list_free(&thread_counts);
         opt_int_list_free(&chunk_sizes);
         return EXIT_FAILURE;
     }
 
-    printf("Sweeping %zu thread option%s x %zu chunk-size option%s (%d run%s each).\n",
+    if (!use_autotune)
+        printf("Sweeping %zu thread option%s x %zu chunk-size option%s (%d run%s each).\n",
            thread_counts.size,
            thread_counts.size == 1 ? "" : "s",
            chunk_sizes.size,
@@ -155,7 +534,9 @@ int main(int argc, char **argv)
            runs == 1 ? "" : "s");
 
     CSRGraph G;
-    if (load_csr_from_file(matrix_path, 1, 1, &G) != 0)
+    int load_status = use_cache ? load_csr_from_file_cached(matrix_path, 1, 1, &G)
+                                : load_csr_from_file(matrix_path, 1, 1, &G);
+    if (load_status != 0)
     {
         fprintf(stderr, "Failed to load graph from %s\n", matrix_path);
         opt_int_list_free(&thread_counts);
@@ -163,6 +544,49 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    // Optional degree-0/1 trimming: the kernels (and the reordering) only see the core
+    TrimResult trim = {0};
+    int trimmed = 0;
+    if (use_trim)
+    {
+        double trim_start = omp_get_wtime();
+        CSRGraph core;
+        if (trim_graph(&G, 0, &core, &trim) != 0)
+        {
+            fprintf(stderr, "Failed to trim graph\n");
+            free_csr(&G);
+            opt_int_list_free(&thread_counts);
+            opt_int_list_free(&chunk_sizes);
+            return EXIT_FAILURE;
+        }
+        free_csr(&G);
+        G = core;
+        trimmed = 1;
+        printf("Trim time: %.6f seconds\n", omp_get_wtime() - trim_start);
+        printf("Trimmed core: %d of %d vertices (%.1f%%), %lld of %lld edges (%.1f%%); %d isolated, %d peeled\n",
+               trim.core_n, trim.n, trim.n > 0 ? 100.0 * trim.core_n / trim.n : 0.0, (long long)trim.core_m,
+               (long long)trim.m, trim.m > 0 ? 100.0 * (double)trim.core_m / (double)trim.m : 0.0, trim.isolated,
+               trim.peeled);
+    }
+
+    // Optional locality reordering, timed separately from the kernels
+    int32_t *new_id = NULL;
+    if (reorder != REORDER_NONE)
+    {
+        double reorder_start = omp_get_wtime();
+        if (reorder_graph(&G, reorder, &new_id) != 0)
+        {
+            fprintf(stderr, "Failed to reorder graph (%s)\n", reorder_kind_name(reorder));
+            free_csr(&G);
+            opt_int_list_free(&thread_counts);
+            opt_int_list_free(&chunk_sizes);
+            return EXIT_FAILURE;
+        }
+        free(new_id); // labels are not written, so the permutation is not needed
+        new_id = NULL;
+        printf("Reorder (%s) time: %.6f seconds\n", reorder_kind_name(reorder), omp_get_wtime() - reorder_start);
+    }
+
     int32_t *labels = (int32_t *)malloc((size_t)G.n * sizeof(int32_t));
     if (!labels)
     {
@@ -173,9 +597,56 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
+    // Reordered and trimmed runs get their own results files; label files keep the original name
+    char results_tag[64];
+    if (reorder == REORDER_NONE)
+        snprintf(results_tag, sizeof(results_tag), "%s%s", method_base, trimmed ? "_trim" : "");
+    else
+        snprintf(results_tag, sizeof(results_tag), "%s_%s%s", method_base, reorder_kind_name(reorder),
+                 trimmed ? "_trim" : "");
+
+    if (use_autotune)
+    {
+        // The LP kernel also searches over its schedulers unless --schedule fixes one
+        static const CCPoolKernel lp_kernels[] = {CC_POOL_LP, CC_POOL_LP_STEAL, CC_POOL_LP_ASYNC};
+        static const char *const lp_schedules[] = {"chunk", "steal", "async"};
+        const char *schedule = use_steal ? "steal" : use_async ? "async" : "chunk";
+        const int all_schedules = kernel == CC_POOL_LP && !schedule_given;
+
+        char profile_key[64];
+        tuned_profile_key(profile_key, sizeof(profile_key), algorithm, reorder, trimmed);
+        AutotuneOptions opts = {
+            .matrix_path = matrix_path,
+            .output_dir = output_dir,
+            .results_tag = results_tag,
+            .profile_key = profile_key,
+            .thread_counts = &thread_counts,
+            .chunk_sizes = &chunk_sizes,
+            .kernels = all_schedules ? lp_kernels : &kernel,
+            .schedules = all_schedules ? lp_schedules : &schedule,
+            .num_schedules = all_schedules ? 3 : 1,
+            .max_samples = runs,
+            .peeled_components = trimmed ? trim.trees : 0,
+        };
+        int status = run_autotune(&opts, &G, labels);
+
+        char pages[32];
+        printf("Huge pages: %s (pages used: %s)\n", cc_hugepages_name(cc_alloc_hugepages()),
+               cc_alloc_pages_used(pages, sizeof(pages)));
+        trim_free(&trim);
+        free(labels);
+        free_csr(&G);
+        opt_int_list_free(&thread_counts);
+        opt_int_list_free(&chunk_sizes);
+        return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    char results_prefix[96];
+    snprintf(results_prefix, sizeof(results_prefix), "results_%s_surface", results_tag);
+
     char results_path[PATH_MAX];
     if (results_writer_build_results_path(results_path, sizeof(results_path), output_dir,
-                                          "results_pthread_surface", matrix_path) != 0)
+                                          results_prefix, matrix_path) != 0)
     {
         fprintf(stderr, "Failed to build output path: %s\n", strerror(errno));
         free(labels);
@@ -227,6 +698,24 @@ int main(int argc, char **argv)
         }
     }
 
+    // One pool serves every configuration; only the barrier is rebuilt when the thread count changes
+    int max_threads = 1;
+    for (size_t ti = 0; ti < thread_counts.size; ti++)
+    {
+        if (thread_counts.values[ti] > max_threads)
+            max_threads = thread_counts.values[ti];
+    }
+    CCPthreadPool *pool = cc_pthread_pool_create(max_threads);
+    if (!pool)
+    {
+        fclose(csv);
+        free(labels);
+        free_csr(&G);
+        opt_int_list_free(&thread_counts);
+        opt_int_list_free(&chunk_sizes);
+        return EXIT_FAILURE;
+    }
+
     int32_t reference_components = -1;
     size_t total_configs = thread_counts.size * chunk_sizes.size;
     size_t completed = 0;
@@ -241,7 +730,7 @@ int main(int argc, char **argv)
             for (int run = 0; run < runs; run++)
             {
                 double start = omp_get_wtime();
-                compute_connected_components_pthreads(&G, labels, threads, chunk);
+                cc_pthread_pool_run_cc(pool, kernel, &G, labels, threads, chunk, NULL);
                 double elapsed = omp_get_wtime() - start;
                 total_time += elapsed;
             }
@@ -250,6 +739,7 @@ int main(int argc, char **argv)
             if (fprintf(csv, "%d,%d,%.6f\n", threads, chunk, average) < 0)
             {
                 fprintf(stderr, "Failed to append row to %s.\n", results_path);
+                cc_pthread_pool_destroy(pool);
                 fclose(csv);
                 free(labels);
                 free_csr(&G);
@@ -259,7 +749,7 @@ int main(int argc, char **argv)
             }
 
             if (reference_components < 0)
-                reference_components = count_unique_labels(labels, G.n);
+                reference_components = count_unique_labels(labels, G.n) + (trimmed ? trim.trees : 0);
 
             completed++;
             printf("[%zu/%zu] Threads=%d, Chunk=%d => average %.6f seconds over %d run%s.\n",
@@ -273,13 +763,18 @@ int main(int argc, char **argv)
         }
     }
 
+    cc_pthread_pool_destroy(pool);
     fclose(csv);
 
     if (reference_components >= 0)
         printf("Detected %d connected components.\n", reference_components);
 
+    char pages[32];
+    printf("Huge pages: %s (pages used: %s)\n", cc_hugepages_name(cc_alloc_hugepages()),
+           cc_alloc_pages_used(pages, sizeof(pages)));
     printf("3D sweep results saved to %s\n", results_path);
 
+    trim_free(&trim);
     free(labels);
     free_csr(&G);
     opt_int_list_free(&thread_counts);
@@ -0,0 +1,276 @@
+/* CC Test (semi-streaming union-find)
+ *
+ * Streams the edges of a Matrix Market or binary .csr file in fixed-size blocks into a
+ * union-find over the vertices, without building a CSR graph, so memory stays O(n) plus
+ * one block. Emits labels in the LP format and appends runtimes to the CSV summaries.
+ * Use --threads/--block-size/--runs/--output to control the run.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cc_incremental.h"
+#include "edge_stream.h"
+#include "labels_io.h"
+#include "opt_parser.h"
+#include "results_writer.h"
+
+// Default number of edges per streamed block
+#define DEFAULT_BLOCK_EDGES (1 << 20)
+
+// Long-only option identifiers
+enum
+{
+    OPT_RESULTS_FORMAT = 256,
+    OPT_LABELS_FORMAT,
+};
+
+static void print_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTIONS] <matrix-file-path>\n\n"
+            "Options:\n"
+            "  -t, --threads N          Threads applying each block (default: all CPUs)\n"
+            "  -b, --block-size N       Edges per streamed block (default %d)\n"
+            "  -r, --runs N             Number of runs to average (default 1)\n"
+            "  -o, --output DIR         Output directory (default 'results')\n"
+            "      --labels-format FMT  Label file format: text or binary (default text)\n"
+            "      --results-format FMT Results layout: wide or long (appended rows, default wide)\n"
+            "  -h, --help               Show this message\n"
+            "Input must be .mtx/.txt or a binary .csr file.\n",
+            prog, DEFAULT_BLOCK_EDGES);
+}
+
+// Stream path once into a fresh union-find. Returns the engine, or NULL on failure
+static CCIncremental *stream_components(const char *path, CCEdge *block, int64_t block_edges,
+                                        int num_threads, int64_t *edges_read)
+{
+    EdgeStream *stream = edge_stream_open(path);
+    if (!stream)
+        return NULL;
+
+    CCIncremental *cc = cc_incremental_create(edge_stream_num_vertices(stream), NULL, num_threads);
+    if (!cc)
+    {
+        edge_stream_close(stream);
+        return NULL;
+    }
+
+    *edges_read = 0;
+    int64_t count;
+    while ((count = edge_stream_next_block(stream, block, block_edges)) > 0)
+    {
+        if (cc_incremental_add_edges(cc, block, count) < 0)
+        {
+            count = -1;
+            break;
+        }
+        *edges_read += count;
+    }
+    edge_stream_close(stream);
+
+    if (count < 0)
+    {
+        fprintf(stderr, "Failed while streaming edges from %s\n", path);
+        cc_incremental_destroy(cc);
+        return NULL;
+    }
+    return cc;
+}
+
+int main(int argc, char **argv)
+{
+    int num_threads = 0;
+    int block_edges = DEFAULT_BLOCK_EDGES;
+    int runs = 1;
+    const char *path = NULL;
+    const char *output_dir = "results";
+    LabelsFormat labels_format = LABELS_FORMAT_TEXT;
+
+    const struct option long_opts[] = {
+        {"threads", required_argument, NULL, 't'},
+        {"block-size", required_argument, NULL, 'b'},
+        {"runs", required_argument, NULL, 'r'},
+        {"output", required_argument, NULL, 'o'},
+        {"results-format", required_argument, NULL, OPT_RESULTS_FORMAT},
+        {"labels-format", required_argument, NULL, OPT_LABELS_FORMAT},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}};
+
+    int opt;
+    int opt_index = 0;
+    while ((opt = getopt_long(argc, argv, "t:b:r:o:h", long_opts, &opt_index)) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            if (opt_parse_positive_int(optarg, &num_threads) != 0)
+            {
+                fprintf(stderr, "Invalid thread count: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'b':
+            if (opt_parse_positive_int(optarg, &block_edges) != 0)
+            {
+                fprintf(stderr, "Invalid block size: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'r':
+            if (opt_parse_positive_int(optarg, &runs) != 0)
+            {
+                fprintf(stderr, "Invalid run count: %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'o':
+            if (!optarg || *optarg == '\0')
+            {
+                fprintf(stderr, "Output directory must not be empty.\n");
+                return EXIT_FAILURE;
+            }
+            output_dir = optarg;
+            break;
+        case OPT_RESULTS_FORMAT:
+        {
+            results_format results_format_choice;
+            if (results_writer_parse_format(optarg, &results_format_choice) != 0)
+            {
+                fprintf(stderr, "Unknown results format '%s'. Choose 'wide' or 'long'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            results_writer_set_format(results_format_choice);
+            break;
+        }
+        case OPT_LABELS_FORMAT:
+            if (labels_parse_format(optarg, &labels_format) != 0)
+            {
+                fprintf(stderr, "Unsupported labels format '%s'. Choose 'text' or 'binary'.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'h':
+            print_usage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc)
+    {
+        fprintf(stderr, "Missing matrix file path.\n");
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    path = argv[optind];
+    if (num_threads == 0)
+        num_threads = omp_get_num_procs();
+
+    if (results_writer_ensure_directory(output_dir) != 0)
+    {
+        fprintf(stderr, "Failed to create output directory '%s': %s\n", output_dir, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    char labels_filename[64];
+    snprintf(labels_filename, sizeof(labels_filename), "stream_labels.%s", labels_format_extension(labels_format));
+    char labels_path[PATH_MAX];
+    if (results_writer_join_path(labels_path, sizeof(labels_path), output_dir, labels_filename) != 0)
+    {
+        fprintf(stderr, "Output path too long for labels file: %s\n", strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    CCEdge *block = (CCEdge *)malloc((size_t)block_edges * sizeof(CCEdge));
+    double *run_times = (double *)malloc((size_t)runs * sizeof(double));
+    if (!block || !run_times)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(block);
+        free(run_times);
+        return EXIT_FAILURE;
+    }
+
+    printf("Streaming graph: %s (%d edges per block, %d thread%s, %d run%s)\n", path, block_edges,
+           num_threads, num_threads == 1 ? "" : "s", runs, runs == 1 ? "" : "s");
+
+    // Every run re-reads the file, so the timings include the parsing
+    CCIncremental *cc = NULL;
+    int64_t edges_read = 0;
+    double total_time = 0.0;
+    for (int run = 0; run < runs; run++)
+    {
+        cc_incremental_destroy(cc);
+        double start = omp_get_wtime();
+        cc = stream_components(path, block, block_edges, num_threads, &edges_read);
+        double elapsed = omp_get_wtime() - start;
+        if (!cc)
+        {
+            free(block);
+            free(run_times);
+            return EXIT_FAILURE;
+        }
+        total_time += elapsed;
+        printf("Run %d time: %.6f seconds (%lld edges)\n", run + 1, elapsed, (long long)edges_read);
+        run_times[run] = elapsed;
+    }
+    free(block);
+
+    int32_t n = cc_incremental_num_vertices(cc);
+    printf("Average time over %d run%s: %.6f seconds\n", runs, runs == 1 ? "" : "s", total_time / runs);
+    printf("Working set: %.1f MiB union-find + %.1f MiB edge block\n",
+           (double)n * sizeof(int32_t) / (1024.0 * 1024.0),
+           (double)block_edges * sizeof(CCEdge) / (1024.0 * 1024.0));
+
+    char results_path[PATH_MAX] = "";
+    int results_path_ready = 0;
+    if (results_writer_build_times_path(results_path, sizeof(results_path), output_dir, "results_stream", path) != 0)
+    {
+        fprintf(stderr, "Warning: Failed to build results path: %s\n", strerror(errno));
+    }
+    else
+    {
+        results_path_ready = 1;
+        char column_name[64];
+        snprintf(column_name, sizeof(column_name), num_threads == 1 ? "1 Thread" : "%d Threads", num_threads);
+        results_writer_status status = append_times_column(results_path, column_name, run_times, (size_t)runs);
+        if (status != RESULTS_WRITER_OK)
+            fprintf(stderr, "Warning: Failed to update %s (error %d)\n", results_path, (int)status);
+    }
+
+    printf("Number of connected components: %d\n", cc_incremental_num_components(cc));
+
+    int32_t *labels = (int32_t *)malloc((size_t)(n > 0 ? n : 1) * sizeof(int32_t));
+    if (!labels)
+    {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(run_times);
+        cc_incremental_destroy(cc);
+        return EXIT_FAILURE;
+    }
+    cc_incremental_labels(cc, labels);
+    cc_incremental_destroy(cc);
+
+    if (labels_write(labels_path, labels_format, labels, n, 0) != 0)
+    {
+        free(run_times);
+        free(labels);
+        return EXIT_FAILURE;
+    }
+
+    printf("Labels written to %s\n", labels_path);
+    if (results_path_ready)
+        printf("Time results written to %s\n", results_path);
+
+    free(run_times);
+    free(labels);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "neighbor_min.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NEIGHBOR_MIN_X86 1
+#include <immintrin.h>
+#endif
+
+typedef int32_t (*neighbor_min_fn)(const int32_t *labels, const int32_t *col_idx,
+                                   int64_t begin, int64_t end, int32_t init);
+
+static int32_t neighbor_min_scalar(const int32_t *labels, const int32_t *col_idx,
+                                   int64_t begin, int64_t end, int32_t init)
+{
+  const _Atomic int32_t *atomic_labels = (const _Atomic int32_t *)labels;
+  int32_t result = init;
+  for (int64_t j = begin; j < end; j++)
+  {
+    int32_t label = atomic_load_explicit(&atomic_labels[col_idx[j]], memory_order_relaxed);
+    if (label < result)
+      result = label;
+  }
+  return result;
+}
+
+#ifdef NEIGHBOR_MIN_X86
+__attribute__((target("avx2"))) static int32_t neighbor_min_avx2(const int32_t *labels, const int32_t *col_idx,
+                                                                 int64_t begin, int64_t end, int32_t init)
+{
+  __m256i vmin = _mm256_set1_epi32(init);
+  int64_t j = begin;
+  for (; j + 8 <= end; j += 8)
+  {
+    __m256i idx = _mm256_loadu_si256((const __m256i *)(col_idx + j));
+    vmin = _mm256_min_epi32(vmin, _mm256_i32gather_epi32((const int *)labels, idx, 4));
+  }
+
+  // Horizontal min of the 8 lanes
+  __m128i m = _mm_min_epi32(_mm256_castsi256_si128(vmin), _mm256_extracti128_si256(vmin, 1));
+  m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  int32_t result = _mm_cvtsi128_si32(m);
+
+  return neighbor_min_scalar(labels, col_idx, j, end, result);
+}
+
+__attribute__((target("avx512f"))) static int32_t neighbor_min_avx512(const int32_t *labels, const int32_t *col_idx,
+                                                                      int64_t begin, int64_t end, int32_t init)
+{
+  __m512i vmin = _mm512_set1_epi32(init);
+  int64_t j = begin;
+  for (; j + 16 <= end; j += 16)
+  {
+    __m512i idx = _mm512_loadu_si512((const void *)(col_idx + j));
+    vmin = _mm512_min_epi32(vmin, _mm512_i32gather_epi32(idx, (const void *)labels, 4));
+  }
+
+  // Masked tail: inactive lanes keep the running minimum
+  if (j < end)
+  {
+    __mmask16 mask = (__mmask16)((1u << (end - j)) - 1u);
+    __m512i idx = _mm512_maskz_loadu_epi32(mask, (const void *)(col_idx + j));
+    __m512i vals = _mm512_mask_i32gather_epi32(vmin, mask, idx, (const void *)labels, 4);
+    vmin = _mm512_min_epi32(vmin, vals);
+  }
+
+  return _mm512_reduce_min_epi32(vmin);
+}
+#endif
+
+// Highest level allowed by CC_SIMD (2 = avx512, 1 = avx2, 0 = scalar)
+static int simd_level_cap(void)
+{
+  const char *env = getenv("CC_SIMD");
+  if (!env || *env == '\0')
+    return 2;
+  if (strcasecmp(env, "scalar") == 0 || strcasecmp(env, "off") == 0)
+    return 0;
+  if (strcasecmp(env, "avx2") == 0)
+    return 1;
+  return 2;
+}
+
+static neighbor_min_fn resolve(const char **name)
+{
+#ifdef NEIGHBOR_MIN_X86
+  const int cap = simd_level_cap();
+  __builtin_cpu_init();
+  if (cap >= 2 && __builtin_cpu_supports("avx512f"))
+  {
+    *name = "avx512";
+    return neighbor_min_avx512;
+  }
+  if (cap >= 1 && __builtin_cpu_supports("avx2"))
+  {
+    *name = "avx2";
+    return neighbor_min_avx2;
+  }
+#endif
+  *name = "scalar";
+  return neighbor_min_scalar;
+}
+
+static _Atomic(neighbor_min_fn) selected_impl = NULL;
+static const char *_Atomic selected_name = NULL;
+
+static neighbor_min_fn current_impl(void)
+{
+  neighbor_min_fn fn = atomic_load_explicit(&selected_impl, memory_order_acquire);
+  if (!fn)
+  {
+    // Concurrent first calls resolve to the same answer, so the race is harmless
+    const char *name;
+    fn = resolve(&name);
+    atomic_store_explicit(&selected_name, name, memory_order_relaxed);
+    atomic_store_explicit(&selected_impl, fn, memory_order_release);
+  }
+  return fn;
+}
+
+int32_t neighbor_min_simd(_Atomic int32_t *labels, const int32_t *col_idx,
+                          int64_t begin, int64_t end, int32_t init)
+{
+  return current_impl()((const int32_t *)labels, col_idx, begin, end, init);
+}
+
+const char *neighbor_min_isa(void)
+{
+  current_impl();
+  return atomic_load_explicit(&selected_name, memory_order_relaxed);
+}
@@ -0,0 +1,334 @@
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "numa_util.h"
+#include "cc_alloc.h"
+#include "thread_util.h"
+
+// Passes over the row ranges per bandwidth measurement
+#define NUMA_BANDWIDTH_PASSES 3
+
+// Parse a sysfs CPU list ("0-3,8,10-11") and mark its CPUs in set
+static void parse_cpu_list(const char *list, cpu_set_t *set)
+{
+  CPU_ZERO(set);
+  const char *p = list;
+  while (*p)
+  {
+    char *next;
+    long first = strtol(p, &next, 10);
+    if (next == p)
+      break;
+    long last = first;
+    p = next;
+    if (*p == '-')
+    {
+      last = strtol(p + 1, &next, 10);
+      p = next;
+    }
+    for (long c = first; c <= last && c < CPU_SETSIZE; c++)
+    {
+      if (c >= 0)
+        CPU_SET((int)c, set);
+    }
+    if (*p == ',')
+      p++;
+    else
+      break;
+  }
+}
+
+static int read_node_cpus(int node, cpu_set_t *set)
+{
+  char path[128];
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+  FILE *f = fopen(path, "r");
+  if (!f)
+    return 1;
+  char line[4096];
+  int ok = (fgets(line, sizeof(line), f) != NULL);
+  fclose(f);
+  if (!ok)
+    return 1;
+  parse_cpu_list(line, set);
+  return 0;
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+  int x = *(const int *)a;
+  int y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+int numa_topology_load(NumaTopology *topo)
+{
+  memset(topo, 0, sizeof(*topo));
+
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0)
+    return 1;
+
+  const int total = CPU_COUNT(&allowed);
+  topo->cpus = malloc((size_t)total * sizeof(int));
+  topo->cpu_node = malloc((size_t)total * sizeof(int));
+  if (!topo->cpus || !topo->cpu_node)
+  {
+    numa_topology_free(topo);
+    return 1;
+  }
+
+  // Node IDs in increasing order (they may be sparse)
+  int node_ids[CPU_SETSIZE];
+  int num_ids = 0;
+  DIR *dir = opendir("/sys/devices/system/node");
+  if (dir)
+  {
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && num_ids < CPU_SETSIZE)
+    {
+      int id;
+      char tail;
+      if (sscanf(entry->d_name, "node%d%c", &id, &tail) == 1)
+        node_ids[num_ids++] = id;
+    }
+    closedir(dir);
+  }
+  qsort(node_ids, (size_t)num_ids, sizeof(int), cmp_int);
+
+  cpu_set_t seen;
+  CPU_ZERO(&seen);
+  for (int i = 0; i < num_ids; i++)
+  {
+    cpu_set_t node_cpus;
+    if (read_node_cpus(node_ids[i], &node_cpus) != 0)
+      continue;
+    int added = 0;
+    for (int c = 0; c < CPU_SETSIZE; c++)
+    {
+      if (CPU_ISSET(c, &node_cpus) && CPU_ISSET(c, &allowed) && !CPU_ISSET(c, &seen))
+      {
+        CPU_SET(c, &seen);
+        topo->cpus[topo->num_cpus] = c;
+        topo->cpu_node[topo->num_cpus] = topo->num_nodes;
+        topo->num_cpus++;
+        added = 1;
+      }
+    }
+    topo->num_nodes += added;
+  }
+
+  // CPUs the node lists did not cover (or no sysfs at all) form one extra node
+  int leftover = 0;
+  for (int c = 0; c < CPU_SETSIZE; c++)
+  {
+    if (CPU_ISSET(c, &allowed) && !CPU_ISSET(c, &seen))
+    {
+      topo->cpus[topo->num_cpus] = c;
+      topo->cpu_node[topo->num_cpus] = topo->num_nodes;
+      topo->num_cpus++;
+      leftover = 1;
+    }
+  }
+  topo->num_nodes += leftover;
+  return 0;
+}
+
+void numa_topology_free(NumaTopology *topo)
+{
+  free(topo->cpus);
+  free(topo->cpu_node);
+  memset(topo, 0, sizeof(*topo));
+}
+
+static int cpu_index_for_thread(const NumaTopology *topo, int thread_id, int num_threads)
+{
+  if (num_threads <= topo->num_cpus)
+    return (int)((long long)thread_id * topo->num_cpus / num_threads);
+  return thread_id % topo->num_cpus;
+}
+
+int numa_cpu_for_thread(const NumaTopology *topo, int thread_id, int num_threads)
+{
+  return topo->cpus[cpu_index_for_thread(topo, thread_id, num_threads)];
+}
+
+int numa_node_for_thread(const NumaTopology *topo, int thread_id, int num_threads)
+{
+  return topo->cpu_node[cpu_index_for_thread(topo, thread_id, num_threads)];
+}
+
+int numa_pin_self(int cpu)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+int numa_pin_thread(const NumaTopology *topo, int thread_id, int num_threads)
+{
+  return numa_pin_self(numa_cpu_for_thread(topo, thread_id, num_threads));
+}
+
+// Restore the calling thread's CPU set after a pinned helper ran on it
+static void restore_affinity(const cpu_set_t *saved)
+{
+  pthread_setaffinity_np(pthread_self(), sizeof(*saved), saved);
+}
+
+typedef struct
+{
+  const CSRGraph *G;
+  const NumaTopology *topo;
+  int64_t *row_ptr; // new arrays, untouched until the copy
+  int32_t *col_idx;
+} LocalizeCtx;
+
+static void localize_rows(int thread_id, int num_threads, void *arg)
+{
+  LocalizeCtx *ctx = (LocalizeCtx *)arg;
+  const CSRGraph *G = ctx->G;
+  numa_pin_thread(ctx->topo, thread_id, num_threads);
+
+  int32_t start, end;
+  csr_edge_balanced_rows(G->row_ptr, G->n, num_threads, thread_id, &start, &end);
+  // The last part also owns the closing row_ptr entry
+  int32_t ptr_end = (thread_id == num_threads - 1) ? G->n + 1 : end;
+  memcpy(ctx->row_ptr + start, G->row_ptr + start, sizeof(int64_t) * (size_t)(ptr_end - start));
+  memcpy(ctx->col_idx + G->row_ptr[start], G->col_idx + G->row_ptr[start],
+         sizeof(int32_t) * (size_t)(G->row_ptr[end] - G->row_ptr[start]));
+}
+
+int numa_localize_csr(CSRGraph *G, const NumaTopology *topo, int num_threads)
+{
+  if (num_threads <= 0)
+    num_threads = topo->num_cpus;
+
+  int64_t *row_ptr = NULL;
+  int32_t *col_idx = NULL;
+  if (!(row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)G->n + 1))) ||
+      !(col_idx = cc_alloc(sizeof(int32_t) * (size_t)(G->m > 0 ? G->m : 1))))
+  {
+    fprintf(stderr, "Memory allocation failed (NUMA copy)\n");
+    cc_free(row_ptr);
+    return 1;
+  }
+
+  cpu_set_t saved;
+  pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved);
+
+  LocalizeCtx ctx = {.G = G, .topo = topo, .row_ptr = row_ptr, .col_idx = col_idx};
+  int rc = thread_util_parallel_run(num_threads, localize_rows, &ctx);
+  restore_affinity(&saved);
+  if (rc != 0)
+  {
+    cc_free(row_ptr);
+    cc_free(col_idx);
+    return 2;
+  }
+
+  CSRGraph local = *G;
+  local.row_ptr = row_ptr;
+  local.col_idx = col_idx;
+  local.storage = CSR_STORAGE_HEAP;
+  local.mapping = NULL;
+  local.mapping_size = 0;
+  free_csr(G);
+  *G = local;
+  return 0;
+}
+
+typedef struct
+{
+  const CSRGraph *G;
+  const NumaTopology *topo;
+  double *seconds;  // per thread
+  int64_t *bytes;   // per thread
+  int64_t *sinks;   // per thread, keeps the reads alive
+} BandwidthCtx;
+
+static double now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static void bandwidth_worker(int thread_id, int num_threads, void *arg)
+{
+  BandwidthCtx *ctx = (BandwidthCtx *)arg;
+  const CSRGraph *G = ctx->G;
+  numa_pin_thread(ctx->topo, thread_id, num_threads);
+
+  int32_t start, end;
+  csr_edge_balanced_rows(G->row_ptr, G->n, num_threads, thread_id, &start, &end);
+  const int64_t *restrict row_ptr = G->row_ptr;
+  const int32_t *restrict col_idx = G->col_idx;
+
+  int64_t sink = 0;
+  double begin = now_seconds();
+  for (int pass = 0; pass < NUMA_BANDWIDTH_PASSES; pass++)
+  {
+    for (int32_t u = start; u < end; u++)
+      sink += row_ptr[u];
+    for (int64_t j = row_ptr[start]; j < row_ptr[end]; j++)
+      sink += col_idx[j];
+  }
+  ctx->seconds[thread_id] = now_seconds() - begin;
+  ctx->bytes[thread_id] = NUMA_BANDWIDTH_PASSES * ((int64_t)(end - start) * (int64_t)sizeof(int64_t) +
+                                                   (row_ptr[end] - row_ptr[start]) * (int64_t)sizeof(int32_t));
+  ctx->sinks[thread_id] = sink;
+}
+
+int numa_measure_bandwidth(const CSRGraph *G, const NumaTopology *topo, int num_threads, double *gbps)
+{
+  if (num_threads <= 0)
+    num_threads = topo->num_cpus;
+
+  BandwidthCtx ctx = {.G = G, .topo = topo};
+  ctx.seconds = calloc((size_t)num_threads, sizeof(double));
+  ctx.bytes = calloc((size_t)num_threads, sizeof(int64_t));
+  ctx.sinks = calloc((size_t)num_threads, sizeof(int64_t));
+  double *node_seconds = calloc((size_t)topo->num_nodes, sizeof(double));
+  int64_t *node_bytes = calloc((size_t)topo->num_nodes, sizeof(int64_t));
+  if (!ctx.seconds || !ctx.bytes || !ctx.sinks || !node_seconds || !node_bytes)
+  {
+    free(ctx.seconds);
+    free(ctx.bytes);
+    free(ctx.sinks);
+    free(node_seconds);
+    free(node_bytes);
+    return 1;
+  }
+
+  cpu_set_t saved;
+  pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved);
+  int rc = thread_util_parallel_run(num_threads, bandwidth_worker, &ctx);
+  restore_affinity(&saved);
+
+  for (int t = 0; rc == 0 && t < num_threads; t++)
+  {
+    int node = numa_node_for_thread(topo, t, num_threads);
+    node_bytes[node] += ctx.bytes[t];
+    if (ctx.seconds[t] > node_seconds[node])
+      node_seconds[node] = ctx.seconds[t];
+  }
+  for (int node = 0; node < topo->num_nodes; node++)
+    gbps[node] = (node_seconds[node] > 0.0) ? (double)node_bytes[node] / node_seconds[node] * 1e-9 : 0.0;
+
+  free(ctx.seconds);
+  free(ctx.bytes);
+  free(ctx.sinks);
+  free(node_seconds);
+  free(node_bytes);
+  return rc;
+}
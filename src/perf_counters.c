@@ -0,0 +1,372 @@
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "perf_counters.h"
+#include "results_writer.h"
+
+// Bytes moved per LLC miss in the bandwidth estimate
+#define PERF_CACHE_LINE_BYTES 64
+
+// Counters that share a group are scheduled on the PMU together. The second group keeps
+// the cache-event counters apart so that every group fits next to the fixed counters.
+#define PERF_NUM_GROUPS 2
+
+typedef struct
+{
+  const char *name;
+  uint32_t type;
+  uint64_t config;
+  int group;
+} PerfEventSpec;
+
+#define PERF_CACHE_CONFIG(cache, op, result) \
+  ((uint64_t)(cache) | ((uint64_t)(op) << 8) | ((uint64_t)(result) << 16))
+
+static const PerfEventSpec perf_events[PERF_COUNTER_COUNT] = {
+    [PERF_COUNTER_CYCLES] = {"Cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 0},
+    [PERF_COUNTER_INSTRUCTIONS] = {"Instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 0},
+    [PERF_COUNTER_CACHE_REFERENCES] = {"Cache References", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, 0},
+    [PERF_COUNTER_CACHE_MISSES] = {"Cache Misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 0},
+    [PERF_COUNTER_LLC_LOAD_MISSES] = {"LLC Misses", PERF_TYPE_HW_CACHE,
+                                      PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                                                        PERF_COUNT_HW_CACHE_RESULT_MISS),
+                                      1},
+    [PERF_COUNTER_DTLB_LOAD_MISSES] = {"dTLB Misses", PERF_TYPE_HW_CACHE,
+                                       PERF_CACHE_CONFIG(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                                         PERF_COUNT_HW_CACHE_RESULT_MISS),
+                                       1},
+};
+
+struct PerfCounters
+{
+  int available[PERF_COUNTER_COUNT]; // 1 when the event opened during the probe
+  int *fds;                          // PERF_COUNTER_COUNT descriptors per measured thread, -1 if unused
+  int threads;                       // threads with open groups
+  int capacity;                      // threads that fit in fds
+  double start_time;
+};
+
+static double perf_now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int perf_event_open(const PerfEventSpec *spec, pid_t tid, int group_fd)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = spec->type;
+  attr.config = spec->config;
+  attr.disabled = (group_fd == -1);
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return (int)syscall(SYS_perf_event_open, &attr, tid, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+PerfCounters *perf_counters_create(void)
+{
+  PerfCounters *pc = calloc(1, sizeof(PerfCounters));
+  if (!pc)
+  {
+    fprintf(stderr, "Memory allocation failed\n");
+    return NULL;
+  }
+
+  int any = 0;
+  int first_error = 0;
+  for (int id = 0; id < PERF_COUNTER_COUNT; id++)
+  {
+    int fd = perf_event_open(&perf_events[id], 0, -1);
+    if (fd < 0)
+    {
+      if (!first_error)
+        first_error = errno;
+      continue;
+    }
+    close(fd);
+    pc->available[id] = 1;
+    any = 1;
+  }
+
+  if (!any)
+  {
+    fprintf(stderr, "perf_event_open: %s (check /proc/sys/kernel/perf_event_paranoid)\n",
+            strerror(first_error));
+    free(pc);
+    return NULL;
+  }
+  for (int id = 0; id < PERF_COUNTER_COUNT; id++)
+    if (!pc->available[id])
+      fprintf(stderr, "Warning: %s counter not available\n", perf_events[id].name);
+  return pc;
+}
+
+static void close_groups(PerfCounters *pc)
+{
+  for (int i = 0; i < pc->threads * PERF_COUNTER_COUNT; i++)
+    if (pc->fds[i] >= 0)
+      close(pc->fds[i]);
+  pc->threads = 0;
+}
+
+void perf_counters_destroy(PerfCounters *pc)
+{
+  if (!pc)
+    return;
+  close_groups(pc);
+  free(pc->fds);
+  free(pc);
+}
+
+// Open both groups on thread tid into fds; the first event of a group is its leader
+static int open_thread_groups(const PerfCounters *pc, pid_t tid, int *fds)
+{
+  int leaders[PERF_NUM_GROUPS] = {-1, -1};
+  for (int id = 0; id < PERF_COUNTER_COUNT; id++)
+    fds[id] = -1;
+  for (int id = 0; id < PERF_COUNTER_COUNT; id++)
+  {
+    if (!pc->available[id])
+      continue;
+    int group = perf_events[id].group;
+    fds[id] = perf_event_open(&perf_events[id], tid, leaders[group]);
+    if (fds[id] < 0)
+      return -1;
+    if (leaders[group] < 0)
+      leaders[group] = fds[id];
+  }
+  return 0;
+}
+
+// Leader descriptor of group in one thread's fds, -1 when the group is empty
+static int group_leader(const PerfCounters *pc, const int *fds, int group)
+{
+  for (int id = 0; id < PERF_COUNTER_COUNT; id++)
+    if (pc->available[id] && perf_events[id].group == group)
+      return fds[id];
+  return -1;
+}
+
+int perf_counters_start(PerfCounters *pc)
+{
+  close_groups(pc);
+
+  DIR *dir = opendir("/proc/self/task");
+  if (!dir)
+  {
+    perror("opendir /proc/self/task");
+    return -1;
+  }
+
+  int status = 0;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (entry->d_name[0] == '.')
+      continue;
+    if (pc->threads == pc->capacity)
+    {
+      int new_capacity = pc->capacity ? pc->capacity * 2 : 64;
+      int *tmp = realloc(pc->fds, (size_t)new_capacity * PERF_COUNTER_COUNT * sizeof(int));
+      if (!tmp)
+      {
+        fprintf(stderr, "Memory allocation failed\n");
+        status = -1;
+        break;
+      }
+      pc->fds = tmp;
+      pc->capacity = new_capacity;
+    }
+
+    int *fds = &pc->fds[pc->threads * PERF_COUNTER_COUNT];
+    pid_t tid = (pid_t)strtol(entry->d_name, NULL, 10);
+    int opened = open_thread_groups(pc, tid, fds);
+    pc->threads++;
+    // A thread that exited since the directory was read has nothing to count
+    if (opened != 0 && errno != ESRCH)
+    {
+      perror("perf_event_open");
+      status = -1;
+      break;
+    }
+  }
+  closedir(dir);
+
+  if (status != 0)
+  {
+    close_groups(pc);
+    return -1;
+  }
+
+  for (int t = 0; t < pc->threads; t++)
+  {
+    for (int group = 0; group < PERF_NUM_GROUPS; group++)
+    {
+      int leader = group_leader(pc, &pc->fds[t * PERF_COUNTER_COUNT], group);
+      if (leader < 0)
+        continue;
+      ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+  pc->start_time = perf_now();
+  return 0;
+}
+
+int perf_counters_stop(PerfCounters *pc, PerfReading *out)
+{
+  const double stop_time = perf_now();
+  for (int t = 0; t < pc->threads; t++)
+  {
+    for (int group = 0; group < PERF_NUM_GROUPS; group++)
+    {
+      int leader = group_leader(pc, &pc->fds[t * PERF_COUNTER_COUNT], group);
+      if (leader >= 0)
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  out->seconds = stop_time - pc->start_time;
+  for (int id = 0; id < PERF_COUNTER_COUNT; id++)
+    out->values[id] = pc->available[id] ? 0.0 : -1.0;
+
+  // Group read layout: nr, time_enabled, time_running, then nr values in open order
+  uint64_t buffer[3 + PERF_COUNTER_COUNT];
+  int status = 0;
+  for (int t = 0; t < pc->threads; t++)
+  {
+    const int *fds = &pc->fds[t * PERF_COUNTER_COUNT];
+    for (int group = 0; group < PERF_NUM_GROUPS; group++)
+    {
+      int leader = group_leader(pc, fds, group);
+      if (leader < 0)
+        continue;
+      if (read(leader, buffer, sizeof(buffer)) < (ssize_t)(3 * sizeof(uint64_t)))
+      {
+        status = -1;
+        continue;
+      }
+      // Extrapolate multiplexed groups to the whole section
+      double scale = buffer[2] > 0 ? (double)buffer[1] / (double)buffer[2] : 0.0;
+      uint64_t slot = 0;
+      for (int id = 0; id < PERF_COUNTER_COUNT && slot < buffer[0]; id++)
+      {
+        if (!pc->available[id] || perf_events[id].group != group)
+          continue;
+        out->values[id] += (double)buffer[3 + slot] * scale;
+        slot++;
+      }
+    }
+  }
+
+  close_groups(pc);
+  if (status != 0)
+    fprintf(stderr, "Warning: Failed to read some perf counters\n");
+  return status;
+}
+
+const char *perf_counter_name(PerfCounterId id)
+{
+  return (id >= 0 && id < PERF_COUNTER_COUNT) ? perf_events[id].name : "Unknown";
+}
+
+// Instructions per cycle, negative when either counter is missing
+static double reading_ipc(const PerfReading *r)
+{
+  double cycles = r->values[PERF_COUNTER_CYCLES];
+  double instructions = r->values[PERF_COUNTER_INSTRUCTIONS];
+  return (cycles > 0.0 && instructions >= 0.0) ? instructions / cycles : -1.0;
+}
+
+// Memory read bandwidth estimated from the LLC misses, negative when they are missing
+static double reading_gbps(const PerfReading *r)
+{
+  double misses = r->values[PERF_COUNTER_LLC_LOAD_MISSES];
+  return (misses >= 0.0 && r->seconds > 0.0) ? misses * PERF_CACHE_LINE_BYTES / r->seconds / 1e9 : -1.0;
+}
+
+int perf_counters_write_columns(const char *path, const char *column_prefix, const PerfReading *runs, int count)
+{
+  if (count <= 0)
+    return 0;
+  double *values = malloc((size_t)count * sizeof(double));
+  if (!values)
+    return -1;
+
+  char column[128];
+  int status = 0;
+  for (int id = 0; id < PERF_COUNTER_COUNT && status == 0; id++)
+  {
+    if (runs[0].values[id] < 0.0)
+      continue;
+    for (int r = 0; r < count; r++)
+      values[r] = runs[r].values[id];
+    snprintf(column, sizeof(column), "%s %s", column_prefix, perf_events[id].name);
+    if (append_values_column(path, column, values, (size_t)count, 0) != RESULTS_WRITER_OK)
+      status = -1;
+  }
+
+  if (status == 0 && reading_ipc(&runs[0]) >= 0.0)
+  {
+    for (int r = 0; r < count; r++)
+      values[r] = reading_ipc(&runs[r]);
+    snprintf(column, sizeof(column), "%s IPC", column_prefix);
+    if (append_values_column(path, column, values, (size_t)count, 3) != RESULTS_WRITER_OK)
+      status = -1;
+  }
+
+  if (status == 0 && reading_gbps(&runs[0]) >= 0.0)
+  {
+    for (int r = 0; r < count; r++)
+      values[r] = reading_gbps(&runs[r]);
+    snprintf(column, sizeof(column), "%s LLC GB/s", column_prefix);
+    if (append_values_column(path, column, values, (size_t)count, 3) != RESULTS_WRITER_OK)
+      status = -1;
+  }
+
+  free(values);
+  return status;
+}
+
+void perf_counters_print_summary(const PerfReading *runs, int count)
+{
+  if (count <= 0)
+    return;
+
+  for (int id = 0; id < PERF_COUNTER_COUNT; id++)
+  {
+    if (runs[0].values[id] < 0.0)
+      continue;
+    double sum = 0.0;
+    for (int r = 0; r < count; r++)
+      sum += runs[r].values[id];
+    printf("  %-18s %.0f\n", perf_events[id].name, sum / count);
+  }
+
+  double ipc = 0.0, gbps = 0.0;
+  for (int r = 0; r < count; r++)
+  {
+    ipc += reading_ipc(&runs[r]);
+    gbps += reading_gbps(&runs[r]);
+  }
+  if (reading_ipc(&runs[0]) >= 0.0)
+    printf("  %-18s %.3f\n", "IPC", ipc / count);
+  if (reading_gbps(&runs[0]) >= 0.0)
+    printf("  %-18s %.3f GB/s (LLC misses x %d B)\n", "Memory bandwidth", gbps / count, PERF_CACHE_LINE_BYTES);
+}
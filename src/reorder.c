@@ -0,0 +1,349 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#include "reorder.h"
+#include "cc_alloc.h"
+#include "thread_util.h"
+
+int reorder_parse_kind(const char *name, ReorderKind *out)
+{
+  static const struct
+  {
+    const char *name;
+    ReorderKind kind;
+  } kinds[] = {
+      {"none", REORDER_NONE},
+      {"degree", REORDER_DEGREE},
+      {"bfs", REORDER_BFS},
+      {"rcm", REORDER_RCM}};
+
+  for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++)
+  {
+    if (strcasecmp(name, kinds[i].name) == 0)
+    {
+      *out = kinds[i].kind;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+const char *reorder_kind_name(ReorderKind kind)
+{
+  switch (kind)
+  {
+  case REORDER_DEGREE:
+    return "degree";
+  case REORDER_BFS:
+    return "bfs";
+  case REORDER_RCM:
+    return "rcm";
+  default:
+    return "none";
+  }
+}
+
+static inline int64_t degree_of(const CSRGraph *G, int32_t u)
+{
+  return G->row_ptr[u + 1] - G->row_ptr[u];
+}
+
+// Vertex IDs sorted by degree (ascending or descending), ties by ID: counting sort on degree
+static int32_t *vertices_by_degree(const CSRGraph *G, int descending)
+{
+  const int32_t n = G->n;
+  int64_t max_degree = 0;
+  for (int32_t u = 0; u < n; u++)
+  {
+    if (degree_of(G, u) > max_degree)
+      max_degree = degree_of(G, u);
+  }
+
+  int64_t *bucket = (int64_t *)calloc((size_t)max_degree + 2, sizeof(int64_t));
+  int32_t *order = (int32_t *)malloc(sizeof(int32_t) * (size_t)(n > 0 ? n : 1));
+  if (!bucket || !order)
+  {
+    free(bucket);
+    free(order);
+    return NULL;
+  }
+
+  for (int32_t u = 0; u < n; u++)
+  {
+    int64_t key = descending ? max_degree - degree_of(G, u) : degree_of(G, u);
+    bucket[key + 1]++;
+  }
+  for (int64_t d = 0; d <= max_degree; d++)
+    bucket[d + 1] += bucket[d];
+  for (int32_t u = 0; u < n; u++)
+  {
+    int64_t key = descending ? max_degree - degree_of(G, u) : degree_of(G, u);
+    order[bucket[key]++] = u;
+  }
+
+  free(bucket);
+  return order;
+}
+
+// (degree, vertex) pair used to visit Cuthill-McKee neighbors by increasing degree
+typedef struct
+{
+  int64_t degree;
+  int32_t v;
+} DegreeVertex;
+
+static int cmp_degree_vertex(const void *a, const void *b)
+{
+  const DegreeVertex *x = (const DegreeVertex *)a;
+  const DegreeVertex *y = (const DegreeVertex *)b;
+  if (x->degree != y->degree)
+    return (x->degree < y->degree) ? -1 : 1;
+  return (x->v > y->v) - (x->v < y->v);
+}
+
+// BFS numbering over all components. Components are started in the order of seeds;
+// with by_degree the neighbors of each vertex are visited by increasing degree (Cuthill-McKee).
+static int bfs_numbering(const CSRGraph *G, const int32_t *seeds, int by_degree, int32_t *new_id)
+{
+  const int32_t n = G->n;
+  int32_t *queue = (int32_t *)malloc(sizeof(int32_t) * (size_t)(n > 0 ? n : 1));
+  DegreeVertex *scratch = NULL;
+  if (by_degree)
+  {
+    int64_t max_degree = 0;
+    for (int32_t u = 0; u < n; u++)
+    {
+      if (degree_of(G, u) > max_degree)
+        max_degree = degree_of(G, u);
+    }
+    scratch = (DegreeVertex *)malloc(sizeof(DegreeVertex) * (size_t)(max_degree > 0 ? max_degree : 1));
+  }
+  if (!queue || (by_degree && !scratch))
+  {
+    free(queue);
+    free(scratch);
+    return 1;
+  }
+
+  for (int32_t u = 0; u < n; u++)
+    new_id[u] = -1;
+
+  int32_t next = 0;
+  for (int32_t s = 0; s < n; s++)
+  {
+    int32_t seed = seeds[s];
+    if (new_id[seed] != -1)
+      continue;
+
+    int32_t front = next, back = next;
+    new_id[seed] = next;
+    queue[back++] = seed;
+    while (front < back)
+    {
+      int32_t u = queue[front++];
+      if (by_degree)
+      {
+        int64_t count = 0;
+        for (int64_t j = G->row_ptr[u]; j < G->row_ptr[u + 1]; j++)
+        {
+          int32_t v = G->col_idx[j];
+          if (new_id[v] == -1)
+          {
+            new_id[v] = -2; // queued
+            scratch[count++] = (DegreeVertex){degree_of(G, v), v};
+          }
+        }
+        qsort(scratch, (size_t)count, sizeof(DegreeVertex), cmp_degree_vertex);
+        for (int64_t k = 0; k < count; k++)
+        {
+          new_id[scratch[k].v] = back;
+          queue[back++] = scratch[k].v;
+        }
+      }
+      else
+      {
+        for (int64_t j = G->row_ptr[u]; j < G->row_ptr[u + 1]; j++)
+        {
+          int32_t v = G->col_idx[j];
+          if (new_id[v] == -1)
+          {
+            new_id[v] = back;
+            queue[back++] = v;
+          }
+        }
+      }
+    }
+    next = back;
+  }
+
+  free(queue);
+  free(scratch);
+  return 0;
+}
+
+int reorder_compute_permutation(const CSRGraph *G, ReorderKind kind, int32_t *new_id)
+{
+  const int32_t n = G->n;
+  if (kind == REORDER_NONE)
+  {
+    for (int32_t u = 0; u < n; u++)
+      new_id[u] = u;
+    return 0;
+  }
+
+  // Degree order doubles as the seed order of the BFS-based numberings:
+  // BFS starts each component at its hub, Cuthill-McKee at a low-degree (peripheral) vertex
+  int32_t *order = vertices_by_degree(G, kind != REORDER_RCM);
+  if (!order)
+    return 1;
+
+  int rc = 0;
+  if (kind == REORDER_DEGREE)
+  {
+    for (int32_t i = 0; i < n; i++)
+      new_id[order[i]] = i;
+  }
+  else
+  {
+    rc = bfs_numbering(G, order, kind == REORDER_RCM, new_id);
+    if (rc == 0 && kind == REORDER_RCM)
+    {
+      for (int32_t u = 0; u < n; u++)
+        new_id[u] = n - 1 - new_id[u];
+    }
+  }
+
+  free(order);
+  return rc;
+}
+
+// Shared state of the parallel relabelling
+typedef struct
+{
+  const CSRGraph *G;
+  const int32_t *new_id;
+  const int32_t *old_id; // inverse of new_id
+  CSRGraph *out;
+} ReorderCtx;
+
+static int cmp_int32(const void *a, const void *b)
+{
+  int32_t x = *(const int32_t *)a;
+  int32_t y = *(const int32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void reorder_fill_rows(int thread_id, int num_threads, void *arg)
+{
+  ReorderCtx *ctx = (ReorderCtx *)arg;
+  const CSRGraph *G = ctx->G;
+  CSRGraph *out = ctx->out;
+  int32_t start, end;
+  csr_edge_balanced_rows(out->row_ptr, out->n, num_threads, thread_id, &start, &end);
+  for (int32_t r = start; r < end; r++)
+  {
+    int32_t u = ctx->old_id[r];
+    int32_t *row = out->col_idx + out->row_ptr[r];
+    int64_t len = G->row_ptr[u + 1] - G->row_ptr[u];
+    for (int64_t j = 0; j < len; j++)
+      row[j] = ctx->new_id[G->col_idx[G->row_ptr[u] + j]];
+    qsort(row, (size_t)len, sizeof(int32_t), cmp_int32);
+  }
+}
+
+int reorder_apply(const CSRGraph *G, const int32_t *new_id, CSRGraph *out)
+{
+  const int32_t n = G->n;
+  memset(out, 0, sizeof(*out));
+
+  int32_t *old_id = (int32_t *)malloc(sizeof(int32_t) * (size_t)(n > 0 ? n : 1));
+  int64_t *row_ptr = NULL;
+  int32_t *col_idx = NULL;
+  if (!old_id ||
+      !(row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)n + 1))) ||
+      !(col_idx = cc_alloc(sizeof(int32_t) * (size_t)(G->m > 0 ? G->m : 1))))
+  {
+    fprintf(stderr, "Memory allocation failed (reorder)\n");
+    free(old_id);
+    cc_free(row_ptr);
+    return 1;
+  }
+
+  for (int32_t u = 0; u < n; u++)
+    old_id[new_id[u]] = u;
+
+  row_ptr[0] = 0;
+  for (int32_t r = 0; r < n; r++)
+    row_ptr[r + 1] = row_ptr[r] + degree_of(G, old_id[r]);
+
+  out->n = n;
+  out->m = G->m;
+  out->row_ptr = row_ptr;
+  out->col_idx = col_idx;
+
+  ReorderCtx ctx = {.G = G, .new_id = new_id, .old_id = old_id, .out = out};
+  thread_util_parallel_run(0, reorder_fill_rows, &ctx);
+
+  free(old_id);
+  return 0;
+}
+
+int reorder_graph(CSRGraph *G, ReorderKind kind, int32_t **new_id_out)
+{
+  *new_id_out = NULL;
+  if (kind == REORDER_NONE)
+    return 0;
+
+  int32_t *new_id = (int32_t *)malloc(sizeof(int32_t) * (size_t)(G->n > 0 ? G->n : 1));
+  if (!new_id)
+    return 1;
+
+  CSRGraph reordered;
+  if (reorder_compute_permutation(G, kind, new_id) != 0 || reorder_apply(G, new_id, &reordered) != 0)
+  {
+    free(new_id);
+    return 2;
+  }
+
+  free_csr(G);
+  *G = reordered;
+  *new_id_out = new_id;
+  return 0;
+}
+
+int reorder_restore_labels(int32_t *labels, const int32_t *new_id, int32_t n, int compact)
+{
+  // component_min[l]: smallest original vertex whose reordered label is l
+  int32_t *component_min = (int32_t *)malloc(sizeof(int32_t) * (size_t)(n > 0 ? n : 1));
+  int32_t *restored = (int32_t *)malloc(sizeof(int32_t) * (size_t)(n > 0 ? n : 1));
+  if (!component_min || !restored)
+  {
+    free(component_min);
+    free(restored);
+    return 1;
+  }
+
+  for (int32_t i = 0; i < n; i++)
+    component_min[i] = -1;
+
+  // Visiting original IDs in increasing order finds every minimum first; the compact
+  // form numbers components in that same order, like the sequential BFS kernel
+  int32_t next_label = 0;
+  for (int32_t v = 0; v < n; v++)
+  {
+    int32_t l = labels[new_id[v]];
+    if (component_min[l] == -1)
+      component_min[l] = compact ? next_label++ : v;
+    restored[v] = component_min[l];
+  }
+
+  memcpy(labels, restored, sizeof(int32_t) * (size_t)n);
+  free(component_min);
+  free(restored);
+  return 0;
+}
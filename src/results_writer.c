@@ -2,12 +2,20 @@
 #include "results_writer.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
+
+#define LONG_HEADER "column,run,value\n"
+#define LONG_SUFFIX ".long.csv"
+
+// Set by results_writer_set_format
+static results_format output_format = RESULTS_FORMAT_WIDE;
 
 typedef struct
 {
@@ -101,6 +109,26 @@ int results_writer_matrix_stem(const char *matrix_path,
     dest[0] = '\0';
 
     const char *path = matrix_path ? matrix_path : "";
+
+    // Generated graphs (gen:rmat:scale=20:ef=16) become gen_rmat_scale20_ef16
+    if (strncmp(path, "gen:", 4) == 0)
+    {
+        size_t len = 0;
+        for (const char *p = path; *p; p++)
+        {
+            if (*p == '=')
+                continue;
+            if (len + 1 >= dest_size)
+            {
+                dest[0] = '\0';
+                errno = ENAMETOOLONG;
+                return -1;
+            }
+            dest[len++] = (*p == ':' || *p == '/') ? '_' : (*p == '.' ? 'p' : *p);
+        }
+        dest[len] = '\0';
+        return 0;
+    }
     const char *base = strrchr(path, '/');
     base = base ? base + 1 : path;
 
@@ -162,6 +190,28 @@ int results_writer_build_results_path(char *dest,
     return results_writer_join_path(dest, dest_size, output_dir, filename);
 }
 
+int results_writer_build_times_path(char *dest,
+                                    size_t dest_size,
+                                    const char *output_dir,
+                                    const char *prefix,
+                                    const char *matrix_path)
+{
+    char path[PATH_MAX];
+    if (results_writer_build_results_path(path, sizeof(path), output_dir, prefix, matrix_path) != 0)
+        return -1;
+    if (output_format == RESULTS_FORMAT_LONG)
+        return results_writer_long_path(dest, dest_size, path);
+
+    size_t len = strlen(path);
+    if (len >= dest_size)
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memcpy(dest, path, len + 1);
+    return 0;
+}
+
 static void free_column(CsvColumn *col)
 {
     if (!col)
@@ -298,7 +348,8 @@ static void free_fields(char **fields, size_t count)
     free(fields);
 }
 
-static results_writer_status write_new_file(const char *filename, const char *column_name, const double *values, size_t count)
+static results_writer_status write_new_file(const char *filename, const char *column_name, const double *values, size_t count,
+                                            int precision)
 {
     FILE *out = fopen(filename, "w");
     if (!out)
@@ -312,7 +363,7 @@ static results_writer_status write_new_file(const char *filename, const char *co
 
     for (size_t i = 0; i < count; i++)
     {
-        if (fprintf(out, "%.6f\n", values[i]) < 0)
+        if (fprintf(out, "%.*f\n", precision, values[i]) < 0)
         {
             fclose(out);
             return RESULTS_WRITER_IO_ERROR;
@@ -323,6 +374,145 @@ static results_writer_status write_new_file(const char *filename, const char *co
     return RESULTS_WRITER_OK;
 }
 
+void results_writer_set_format(results_format format)
+{
+    output_format = format;
+}
+
+results_format results_writer_get_format(void)
+{
+    return output_format;
+}
+
+int results_writer_parse_format(const char *name, results_format *out)
+{
+    if (strcmp(name, "wide") == 0)
+        *out = RESULTS_FORMAT_WIDE;
+    else if (strcmp(name, "long") == 0)
+        *out = RESULTS_FORMAT_LONG;
+    else
+        return -1;
+    return 0;
+}
+
+int results_writer_long_path(char *dest, size_t dest_size, const char *filename)
+{
+    size_t len = strlen(filename);
+    const size_t suffix_len = strlen(LONG_SUFFIX);
+    if (len >= suffix_len && strcmp(filename + len - suffix_len, LONG_SUFFIX) == 0)
+        len -= suffix_len;
+    else if (len >= 4 && strcmp(filename + len - 4, ".csv") == 0)
+        len -= 4;
+    int written = snprintf(dest, dest_size, "%.*s%s", (int)len, filename, LONG_SUFFIX);
+    if (written < 0 || (size_t)written >= dest_size)
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    return 0;
+}
+
+// write() until every byte is out; one call for a normal file, which O_APPEND keeps in one piece
+static int write_all(int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return 0;
+}
+
+// Create path holding just the header if it does not exist yet. The header goes into a
+// private temporary file that is then linked into place, so the file never appears without
+// it and rows appended by other runs always follow it. Returns 0 on success
+static int create_long_file(const char *path)
+{
+    char tmp_path[PATH_MAX];
+    int written = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%ld", path, (long)getpid());
+    if (written < 0 || (size_t)written >= sizeof(tmp_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return -1;
+    int rc = write_all(fd, LONG_HEADER, sizeof(LONG_HEADER) - 1);
+    if (close(fd) != 0)
+        rc = -1;
+    // link() never replaces an existing file; losing the race to another run is fine
+    if (rc == 0 && link(tmp_path, path) != 0 && errno != EEXIST)
+        rc = -1;
+    unlink(tmp_path);
+    return rc;
+}
+
+// Long mode: one "column,run,value" row per value, appended to <base>.long.csv with a single
+// O_APPEND write so concurrent runs never interleave or lose rows. The header is in place
+// before any run can open the file for appending (see create_long_file).
+static results_writer_status append_values_long(const char *filename,
+                                                const char *column_name,
+                                                const double *values,
+                                                size_t count,
+                                                int precision)
+{
+    if (strchr(column_name, ',') || strchr(column_name, '\n'))
+        return RESULTS_WRITER_INVALID_ARGS;
+
+    char path[PATH_MAX];
+    if (results_writer_long_path(path, sizeof(path), filename) != 0)
+        return RESULTS_WRITER_IO_ERROR;
+
+    int fd = open(path, O_WRONLY | O_APPEND);
+    if (fd < 0 && errno == ENOENT)
+    {
+        if (create_long_file(path) != 0)
+            return RESULTS_WRITER_IO_ERROR;
+        fd = open(path, O_WRONLY | O_APPEND);
+    }
+    if (fd < 0)
+        return RESULTS_WRITER_IO_ERROR;
+
+    // Size the rows first: a %f of a large value has no useful upper bound on its length
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        int row = snprintf(NULL, 0, "%s,%zu,%.*f\n", column_name, i + 1, precision, values[i]);
+        if (row < 0)
+        {
+            close(fd);
+            return RESULTS_WRITER_INVALID_ARGS;
+        }
+        total += (size_t)row;
+    }
+
+    char *buffer = (char *)malloc(total + 1);
+    if (!buffer)
+    {
+        close(fd);
+        return RESULTS_WRITER_MEMORY_ERROR;
+    }
+    size_t used = 0;
+    for (size_t i = 0; i < count; i++)
+        used += (size_t)snprintf(buffer + used, total + 1 - used, "%s,%zu,%.*f\n", column_name, i + 1, precision,
+                                 values[i]);
+
+    results_writer_status status = (write_all(fd, buffer, used) == 0) ? RESULTS_WRITER_OK : RESULTS_WRITER_IO_ERROR;
+    free(buffer);
+    if (close(fd) != 0)
+        status = RESULTS_WRITER_IO_ERROR;
+    return status;
+}
+
 results_writer_status append_times_column(const char *filename,
                                           const char *column_name,
                                           const double *values,
@@ -330,12 +520,25 @@ results_writer_status append_times_column(const char *filename,
 {
     if (!filename || !column_name || (!values && count > 0))
         return RESULTS_WRITER_INVALID_ARGS;
+    if (output_format == RESULTS_FORMAT_LONG)
+        return append_values_long(filename, column_name, values, count, 6);
+    return append_values_column(filename, column_name, values, count, 6);
+}
+
+results_writer_status append_values_column(const char *filename,
+                                           const char *column_name,
+                                           const double *values,
+                                           size_t count,
+                                           int precision)
+{
+    if (!filename || !column_name || (!values && count > 0) || precision < 0)
+        return RESULTS_WRITER_INVALID_ARGS;
 
     FILE *fp = fopen(filename, "r");
     if (!fp)
     {
         if (errno == ENOENT)
-            return write_new_file(filename, column_name, values, count);
+            return write_new_file(filename, column_name, values, count, precision);
         return RESULTS_WRITER_IO_ERROR;
     }
 
@@ -352,7 +555,7 @@ results_writer_status append_times_column(const char *filename,
     {
         free(line);
         fclose(fp);
-        return write_new_file(filename, column_name, values, count);
+        return write_new_file(filename, column_name, values, count, precision);
     }
 
     trim_trailing_newline(line);
@@ -361,7 +564,7 @@ results_writer_status append_times_column(const char *filename,
     {
         free(line);
         fclose(fp);
-        return write_new_file(filename, column_name, values, count);
+        return write_new_file(filename, column_name, values, count, precision);
     }
 
     columns = (CsvColumn *)calloc(header_count, sizeof(CsvColumn));
@@ -467,7 +670,7 @@ results_writer_status append_times_column(const char *filename,
         for (size_t i = 0; i < count; i++)
         {
             char buffer[64];
-            snprintf(buffer, sizeof(buffer), "%.6f", values[i]);
+            snprintf(buffer, sizeof(buffer), "%.*f", precision, values[i]);
             char *formatted = clone_string(buffer);
             if (!formatted)
             {
@@ -511,7 +714,7 @@ results_writer_status append_times_column(const char *filename,
             if (i < count)
             {
                 char buffer[64];
-                snprintf(buffer, sizeof(buffer), "%.6f", values[i]);
+                snprintf(buffer, sizeof(buffer), "%.*f", precision, values[i]);
                 if (append_cell(new_col, buffer) != 0)
                 {
                     status = RESULTS_WRITER_MEMORY_ERROR;
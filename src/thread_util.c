@@ -0,0 +1,87 @@
+#define _GNU_SOURCE
+#include "thread_util.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct
+{
+  thread_util_fn fn;
+  void *ctx;
+  int thread_id;
+  int num_threads;
+} ThreadUtilArgs;
+
+static void *thread_util_trampoline(void *arg)
+{
+  ThreadUtilArgs *args = (ThreadUtilArgs *)arg;
+  args->fn(args->thread_id, args->num_threads, args->ctx);
+  return NULL;
+}
+
+int thread_util_default_threads(void)
+{
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return (cpus > 0) ? (int)cpus : 1;
+}
+
+int thread_util_parallel_run(int num_threads, thread_util_fn fn, void *ctx)
+{
+  if (!fn)
+    return -1;
+  if (num_threads <= 0)
+    num_threads = thread_util_default_threads();
+  if (num_threads == 1)
+  {
+    fn(0, 1, ctx);
+    return 0;
+  }
+
+  pthread_t *threads = malloc((size_t)num_threads * sizeof(pthread_t));
+  ThreadUtilArgs *args = malloc((size_t)num_threads * sizeof(ThreadUtilArgs));
+  if (!threads || !args)
+  {
+    free(threads);
+    free(args);
+    return -1;
+  }
+
+  int launched = 1;
+  for (int t = 0; t < num_threads; t++)
+  {
+    args[t].fn = fn;
+    args[t].ctx = ctx;
+    args[t].thread_id = t;
+    args[t].num_threads = num_threads;
+  }
+  for (int t = 1; t < num_threads; t++)
+  {
+    if (pthread_create(&threads[t], NULL, thread_util_trampoline, &args[t]) != 0)
+    {
+      // Run whatever could not be started on the calling thread
+      for (int r = t; r < num_threads; r++)
+        fn(r, num_threads, ctx);
+      break;
+    }
+    launched++;
+  }
+
+  fn(0, num_threads, ctx);
+
+  for (int t = 1; t < launched; t++)
+    pthread_join(threads[t], NULL);
+
+  free(threads);
+  free(args);
+  return 0;
+}
+
+void thread_util_split_range(long long total, int num_parts, int part, long long *start, long long *end)
+{
+  long long base = total / num_parts;
+  long long extra = total % num_parts;
+  *start = part * base + (part < extra ? part : extra);
+  *end = *start + base + (part < extra ? 1 : 0);
+}
@@ -0,0 +1,483 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "trim.h"
+#include "cc_alloc.h"
+#include "thread_util.h"
+
+// Peeling rounds run in parallel while the frontier holds at least this many vertices;
+// the tail of long chains is finished by a sequential queue
+#define TRIM_PARALLEL_MIN_FRONTIER 4096
+
+// Shared state of the trimming stages
+typedef struct
+{
+  const CSRGraph *G;
+  _Atomic int64_t *degree;    // remaining (unpeeled) neighbors
+  unsigned char *removed;     // 1 once peeled, updated between parallel stages only
+  unsigned char *in_frontier; // 1 for the vertices of the current round
+  int32_t *attach;            // vertex a peeled vertex hangs off (itself for roots)
+  int32_t *decrement;         // per frontier slot: neighbor to decrement, -1 for none
+  int32_t *frontier;
+  int64_t frontier_size;
+  int32_t *next;
+  _Atomic int64_t next_tail;
+  _Atomic int32_t *root;      // pointer-jumping target
+  atomic_int changed;
+  int64_t *counts;            // per-thread counts for the core numbering
+  int64_t *tree_counts;       // per-thread roots of peeled trees
+  CSRGraph *core;
+  TrimResult *out;
+} TrimCtx;
+
+static void trim_init_degrees(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  const int64_t *row_ptr = ctx->G->row_ptr;
+  const int32_t *col_idx = ctx->G->col_idx;
+  long long start, end;
+  thread_util_split_range(ctx->G->n, num_threads, thread_id, &start, &end);
+
+  int64_t local = 0;
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+  {
+    // Self-loops do not keep a vertex out of the peeling
+    int64_t degree = 0;
+    for (int64_t j = row_ptr[v]; j < row_ptr[v + 1]; j++)
+      degree += (col_idx[j] != v);
+    atomic_init(&ctx->degree[v], degree);
+    ctx->removed[v] = 0;
+    ctx->in_frontier[v] = 0;
+    ctx->attach[v] = v;
+    if (degree == 0)
+    {
+      ctx->removed[v] = 1;
+      local++;
+    }
+    else if (degree == 1)
+    {
+      int64_t pos = atomic_fetch_add_explicit(&ctx->next_tail, 1, memory_order_relaxed);
+      ctx->next[pos] = v;
+    }
+  }
+  ctx->counts[thread_id] = local;
+}
+
+// Unique unpeeled neighbor of a vertex whose remaining degree is 1
+static inline int32_t remaining_neighbor(const TrimCtx *ctx, int32_t v)
+{
+  const int64_t *row_ptr = ctx->G->row_ptr;
+  const int32_t *col_idx = ctx->G->col_idx;
+  for (int64_t j = row_ptr[v]; j < row_ptr[v + 1]; j++)
+  {
+    if (col_idx[j] != v && !ctx->removed[col_idx[j]])
+      return col_idx[j];
+  }
+  return v;
+}
+
+// Round phase 1: pick the attachment of every frontier vertex (removed/degree are stable)
+static void trim_round_attach(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->frontier_size, num_threads, thread_id, &start, &end);
+  for (long long i = start; i < end; i++)
+  {
+    int32_t v = ctx->frontier[i];
+    ctx->decrement[i] = -1;
+    if (atomic_load_explicit(&ctx->degree[v], memory_order_relaxed) == 0)
+    {
+      ctx->attach[v] = v; // the last vertex of a fully peeled tree
+      continue;
+    }
+
+    int32_t u = remaining_neighbor(ctx, v);
+    if (ctx->in_frontier[u] && atomic_load_explicit(&ctx->degree[u], memory_order_relaxed) == 1)
+    {
+      // Two leaves holding on to each other: the smaller one becomes the tree root
+      ctx->attach[v] = (v < u) ? v : u;
+      continue;
+    }
+    ctx->attach[v] = u;
+    ctx->decrement[i] = u;
+  }
+}
+
+// Round phase 2: peel the frontier and collect the vertices that dropped to degree 1
+static void trim_round_peel(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->frontier_size, num_threads, thread_id, &start, &end);
+  for (long long i = start; i < end; i++)
+  {
+    int32_t u = ctx->decrement[i];
+    if (u < 0)
+      continue;
+    // Only the step from 2 to 1 queues u; if it drops to 0 in the same round it becomes a root
+    if (atomic_fetch_sub_explicit(&ctx->degree[u], 1, memory_order_relaxed) == 2)
+    {
+      int64_t pos = atomic_fetch_add_explicit(&ctx->next_tail, 1, memory_order_relaxed);
+      ctx->next[pos] = u;
+    }
+  }
+}
+
+static void trim_round_mark(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->frontier_size, num_threads, thread_id, &start, &end);
+  for (long long i = start; i < end; i++)
+  {
+    ctx->removed[ctx->frontier[i]] = 1;
+    ctx->in_frontier[ctx->frontier[i]] = 0;
+  }
+}
+
+// Finish the remaining chains one vertex at a time; stack holds the frontier on entry
+static void trim_peel_sequential(TrimCtx *ctx, int32_t *stack, int64_t count)
+{
+  while (count > 0)
+  {
+    int32_t v = stack[--count];
+    if (ctx->removed[v])
+      continue;
+    ctx->removed[v] = 1;
+    if (atomic_load_explicit(&ctx->degree[v], memory_order_relaxed) == 0)
+    {
+      ctx->attach[v] = v;
+      continue;
+    }
+
+    int32_t u = remaining_neighbor(ctx, v);
+    ctx->attach[v] = u;
+    if (atomic_fetch_sub_explicit(&ctx->degree[u], 1, memory_order_relaxed) == 2)
+      stack[count++] = u;
+    // u reaching 0 was already queued when it reached 1
+  }
+}
+
+// Pointer jumping over attach until every vertex reaches its core vertex or tree root
+static void trim_jump_roots(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->G->n, num_threads, thread_id, &start, &end);
+  int changed = 0;
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+  {
+    int32_t r = atomic_load_explicit(&ctx->root[v], memory_order_relaxed);
+    int32_t rr = atomic_load_explicit(&ctx->root[r], memory_order_relaxed);
+    if (rr != r)
+    {
+      atomic_store_explicit(&ctx->root[v], rr, memory_order_relaxed);
+      changed = 1;
+    }
+  }
+  if (changed)
+    atomic_store_explicit(&ctx->changed, 1, memory_order_relaxed);
+}
+
+static void trim_init_roots(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->G->n, num_threads, thread_id, &start, &end);
+  int64_t core = 0, trees = 0;
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+  {
+    atomic_init(&ctx->root[v], ctx->attach[v]);
+    core += !ctx->removed[v];
+    trees += ctx->removed[v] && ctx->attach[v] == v;
+  }
+  ctx->counts[thread_id] = core;
+  ctx->tree_counts[thread_id] = trees;
+}
+
+// Number the core vertices of this thread's range (counts holds the exclusive offsets)
+// and count their core neighbors
+static void trim_number_core(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  TrimResult *out = ctx->out;
+  long long start, end;
+  thread_util_split_range(ctx->G->n, num_threads, thread_id, &start, &end);
+  int32_t next = (int32_t)ctx->counts[thread_id];
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+  {
+    out->root[v] = atomic_load_explicit(&ctx->root[v], memory_order_relaxed);
+    out->core_id[v] = ctx->removed[v] ? -1 : next++;
+  }
+}
+
+static void trim_count_core_edges(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  const CSRGraph *G = ctx->G;
+  const int32_t *core_id = ctx->out->core_id;
+  int32_t start, end;
+  csr_edge_balanced_rows(G->row_ptr, G->n, num_threads, thread_id, &start, &end);
+  for (int32_t v = start; v < end; v++)
+  {
+    if (ctx->removed[v])
+      continue;
+    int64_t count = 0;
+    for (int64_t j = G->row_ptr[v]; j < G->row_ptr[v + 1]; j++)
+      count += !ctx->removed[G->col_idx[j]];
+    ctx->core->row_ptr[core_id[v] + 1] = count;
+  }
+}
+
+static void trim_fill_core(int thread_id, int num_threads, void *arg)
+{
+  TrimCtx *ctx = (TrimCtx *)arg;
+  const CSRGraph *G = ctx->G;
+  const int32_t *core_id = ctx->out->core_id;
+  int32_t start, end;
+  csr_edge_balanced_rows(G->row_ptr, G->n, num_threads, thread_id, &start, &end);
+  for (int32_t v = start; v < end; v++)
+  {
+    if (ctx->removed[v])
+      continue;
+    // core_id is increasing in the original ID, so the rows stay sorted
+    int32_t *row = ctx->core->col_idx + ctx->core->row_ptr[core_id[v]];
+    for (int64_t j = G->row_ptr[v]; j < G->row_ptr[v + 1]; j++)
+    {
+      int32_t w = G->col_idx[j];
+      if (!ctx->removed[w])
+        *row++ = core_id[w];
+    }
+  }
+}
+
+int trim_graph(const CSRGraph *G, int num_threads, CSRGraph *core, TrimResult *out)
+{
+  const int32_t n = G->n;
+  const size_t slots = (size_t)(n > 0 ? n : 1);
+  if (num_threads <= 0)
+    num_threads = thread_util_default_threads();
+  memset(out, 0, sizeof(*out));
+  memset(core, 0, sizeof(*core));
+  out->n = n;
+  out->m = G->m;
+
+  TrimCtx ctx;
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.G = G;
+  ctx.core = core;
+  ctx.out = out;
+  ctx.degree = cc_alloc(slots * sizeof(*ctx.degree));
+  ctx.removed = cc_alloc(slots);
+  ctx.in_frontier = cc_alloc(slots);
+  ctx.attach = cc_alloc(slots * sizeof(int32_t));
+  ctx.decrement = cc_alloc(slots * sizeof(int32_t));
+  ctx.frontier = cc_alloc(slots * sizeof(int32_t)); // doubles as the sequential stack
+  ctx.next = cc_alloc(slots * sizeof(int32_t));
+  ctx.root = cc_alloc(slots * sizeof(*ctx.root));
+  ctx.counts = malloc((size_t)num_threads * sizeof(int64_t));
+  ctx.tree_counts = malloc((size_t)num_threads * sizeof(int64_t));
+  out->core_id = cc_alloc(slots * sizeof(int32_t));
+  out->root = cc_alloc(slots * sizeof(int32_t));
+
+  int rc = 0;
+  if (!ctx.degree || !ctx.removed || !ctx.in_frontier || !ctx.attach || !ctx.decrement ||
+      !ctx.frontier || !ctx.next || !ctx.root || !ctx.counts || !ctx.tree_counts || !out->core_id ||
+      !out->root)
+  {
+    fprintf(stderr, "Memory allocation failed (trim)\n");
+    rc = 1;
+    goto cleanup;
+  }
+
+  atomic_init(&ctx.next_tail, 0);
+  thread_util_parallel_run(num_threads, trim_init_degrees, &ctx);
+  for (int t = 0; t < num_threads; t++)
+    out->isolated += (int32_t)ctx.counts[t];
+
+  // Parallel rounds while the frontier is large, then a sequential queue for the chains
+  for (;;)
+  {
+    ctx.frontier_size = atomic_load_explicit(&ctx.next_tail, memory_order_relaxed);
+    memcpy(ctx.frontier, ctx.next, sizeof(int32_t) * (size_t)ctx.frontier_size);
+    atomic_store_explicit(&ctx.next_tail, 0, memory_order_relaxed);
+    if (ctx.frontier_size < TRIM_PARALLEL_MIN_FRONTIER)
+      break;
+
+    for (int64_t i = 0; i < ctx.frontier_size; i++)
+      ctx.in_frontier[ctx.frontier[i]] = 1;
+    thread_util_parallel_run(num_threads, trim_round_attach, &ctx);
+    thread_util_parallel_run(num_threads, trim_round_peel, &ctx);
+    thread_util_parallel_run(num_threads, trim_round_mark, &ctx);
+  }
+  trim_peel_sequential(&ctx, ctx.frontier, ctx.frontier_size);
+
+  thread_util_parallel_run(num_threads, trim_init_roots, &ctx);
+  int64_t core_n = 0;
+  for (int t = 0; t < num_threads; t++)
+  {
+    int64_t count = ctx.counts[t];
+    ctx.counts[t] = core_n;
+    core_n += count;
+    out->trees += (int32_t)ctx.tree_counts[t];
+  }
+  out->peeled = (int32_t)(n - out->isolated - core_n);
+
+  do
+  {
+    atomic_store_explicit(&ctx.changed, 0, memory_order_relaxed);
+    thread_util_parallel_run(num_threads, trim_jump_roots, &ctx);
+  } while (atomic_load_explicit(&ctx.changed, memory_order_relaxed));
+
+  thread_util_parallel_run(num_threads, trim_number_core, &ctx);
+
+  // Core CSR: count the core neighbors, scan, then copy the renumbered rows
+  core->n = (int32_t)core_n;
+  core->storage = CSR_STORAGE_HEAP;
+  if (!(core->row_ptr = cc_alloc(sizeof(int64_t) * ((size_t)core_n + 1))))
+  {
+    fprintf(stderr, "Memory allocation failed (trim core)\n");
+    rc = 2;
+    goto cleanup;
+  }
+  core->row_ptr[0] = 0;
+  thread_util_parallel_run(num_threads, trim_count_core_edges, &ctx);
+  for (int64_t c = 0; c < core_n; c++)
+    core->row_ptr[c + 1] += core->row_ptr[c];
+  core->m = core->row_ptr[core_n];
+
+  if (!(core->col_idx = cc_alloc(sizeof(int32_t) * (size_t)(core->m > 0 ? core->m : 1))))
+  {
+    fprintf(stderr, "Memory allocation failed (trim core)\n");
+    rc = 2;
+    goto cleanup;
+  }
+  thread_util_parallel_run(num_threads, trim_fill_core, &ctx);
+  out->core_n = core->n;
+  out->core_m = core->m;
+
+cleanup:
+  cc_free(ctx.degree);
+  cc_free(ctx.removed);
+  cc_free(ctx.in_frontier);
+  cc_free(ctx.attach);
+  cc_free(ctx.decrement);
+  cc_free(ctx.frontier);
+  cc_free(ctx.next);
+  cc_free(ctx.root);
+  free(ctx.counts);
+  free(ctx.tree_counts);
+  if (rc != 0)
+  {
+    free_csr(core);
+    trim_free(out);
+  }
+  return rc;
+}
+
+// Shared state of the label expansion
+typedef struct
+{
+  const TrimResult *trim;
+  const int32_t *core_labels;
+  _Atomic int32_t *component_min; // indexed by component key
+  int32_t *labels;
+} ExpandCtx;
+
+// Core components are keyed by their core label, peeled trees by core_n + root
+static inline int64_t component_key(const ExpandCtx *ctx, int32_t v)
+{
+  const TrimResult *trim = ctx->trim;
+  int32_t r = trim->root[v];
+  int32_t c = trim->core_id[r];
+  return (c >= 0) ? ctx->core_labels[c] : (int64_t)trim->core_n + r;
+}
+
+static void expand_init(int thread_id, int num_threads, void *arg)
+{
+  ExpandCtx *ctx = (ExpandCtx *)arg;
+  long long keys = (long long)ctx->trim->core_n + ctx->trim->n;
+  long long start, end;
+  thread_util_split_range(keys, num_threads, thread_id, &start, &end);
+  for (long long k = start; k < end; k++)
+    atomic_init(&ctx->component_min[k], INT32_MAX);
+}
+
+static void expand_min(int thread_id, int num_threads, void *arg)
+{
+  ExpandCtx *ctx = (ExpandCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->trim->n, num_threads, thread_id, &start, &end);
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+  {
+    _Atomic int32_t *slot = &ctx->component_min[component_key(ctx, v)];
+    int32_t current = atomic_load_explicit(slot, memory_order_relaxed);
+    while (v < current &&
+           !atomic_compare_exchange_weak_explicit(slot, &current, v, memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+  }
+}
+
+static void expand_write(int thread_id, int num_threads, void *arg)
+{
+  ExpandCtx *ctx = (ExpandCtx *)arg;
+  long long start, end;
+  thread_util_split_range(ctx->trim->n, num_threads, thread_id, &start, &end);
+  for (int32_t v = (int32_t)start; v < (int32_t)end; v++)
+    ctx->labels[v] = atomic_load_explicit(&ctx->component_min[component_key(ctx, v)], memory_order_relaxed);
+}
+
+int32_t *trim_expand_labels(const TrimResult *trim, const int32_t *core_labels, int compact)
+{
+  const int32_t n = trim->n;
+  int32_t *labels = malloc(sizeof(int32_t) * (size_t)(n > 0 ? n : 1));
+  _Atomic int32_t *component_min =
+      cc_alloc(sizeof(*component_min) * ((size_t)trim->core_n + (size_t)n + 1));
+  if (!labels || !component_min)
+  {
+    free(labels);
+    cc_free(component_min);
+    return NULL;
+  }
+
+  ExpandCtx ctx = {.trim = trim, .core_labels = core_labels, .component_min = component_min, .labels = labels};
+  thread_util_parallel_run(0, expand_init, &ctx);
+  thread_util_parallel_run(0, expand_min, &ctx);
+  thread_util_parallel_run(0, expand_write, &ctx);
+  cc_free(component_min);
+
+  if (compact)
+  {
+    // Component minima appear in increasing order, so renumber them as they are found
+    int32_t *number = cc_alloc(sizeof(int32_t) * (size_t)(n > 0 ? n : 1));
+    if (!number)
+    {
+      free(labels);
+      return NULL;
+    }
+    int32_t next_label = 0;
+    for (int32_t v = 0; v < n; v++)
+    {
+      if (labels[v] == v)
+        number[v] = next_label++;
+      labels[v] = number[labels[v]];
+    }
+    cc_free(number);
+  }
+  return labels;
+}
+
+void trim_free(TrimResult *trim)
+{
+  cc_free(trim->core_id);
+  cc_free(trim->root);
+  trim->core_id = NULL;
+  trim->root = NULL;
+}
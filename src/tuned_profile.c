@@ -0,0 +1,170 @@
+#define _GNU_SOURCE
+#include "tuned_profile.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "results_writer.h"
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+#define PROFILE_LINE_MAX 256
+
+// Parse one entry line. Returns 1 for an entry, 0 for blank and comment lines, -1 when malformed
+static int parse_entry(const char *line, char *key, size_t key_size, TunedConfig *config)
+{
+    const char *p = line;
+    while (*p == ' ' || *p == '\t')
+        p++;
+    if (*p == '#' || *p == '\n' || *p == '\0')
+        return 0;
+
+    char key_buf[PROFILE_LINE_MAX];
+    TunedConfig parsed = {0};
+    if (sscanf(p, "%255s %d %d %7s %lf", key_buf, &parsed.threads, &parsed.chunk_size, parsed.schedule,
+               &parsed.median_seconds) != 5 ||
+        parsed.threads <= 0 || parsed.chunk_size <= 0)
+        return -1;
+    if (strcmp(parsed.schedule, "chunk") != 0 && strcmp(parsed.schedule, "steal") != 0 &&
+        strcmp(parsed.schedule, "async") != 0)
+        return -1;
+    if (strlen(key_buf) >= key_size)
+        return -1;
+    strcpy(key, key_buf);
+    *config = parsed;
+    return 1;
+}
+
+int tuned_profile_key(char *dest, size_t dest_size, const char *algorithm, ReorderKind reorder, int trimmed)
+{
+    int written = snprintf(dest, dest_size, "%s%s%s%s", algorithm, reorder == REORDER_NONE ? "" : "_",
+                           reorder == REORDER_NONE ? "" : reorder_kind_name(reorder), trimmed ? "_trim" : "");
+    if (written < 0 || (size_t)written >= dest_size)
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    return 0;
+}
+
+int tuned_profile_path(char *dest, size_t dest_size, const char *output_dir, const char *matrix_path)
+{
+    char stem[PATH_MAX];
+    if (results_writer_matrix_stem(matrix_path, stem, sizeof(stem)) != 0)
+        return -1;
+
+    char filename[PATH_MAX];
+    int written = snprintf(filename, sizeof(filename), "tuned_%s.txt", stem);
+    if (written < 0 || (size_t)written >= sizeof(filename))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    return results_writer_join_path(dest, dest_size, output_dir, filename);
+}
+
+int tuned_profile_load(const char *path, const char *key, TunedConfig *config)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+        return errno == ENOENT ? 1 : -1;
+
+    char line[PROFILE_LINE_MAX];
+    char entry_key[PROFILE_LINE_MAX];
+    TunedConfig entry;
+    int status = 1;
+    while (fgets(line, sizeof(line), file))
+    {
+        int parsed = parse_entry(line, entry_key, sizeof(entry_key), &entry);
+        if (parsed < 0)
+        {
+            fprintf(stderr, "Malformed tuned profile line in %s: %s", path, line);
+            status = -1;
+            break;
+        }
+        // Later entries win, matching what tuned_profile_store would keep
+        if (parsed == 1 && strcmp(entry_key, key) == 0)
+        {
+            *config = entry;
+            status = 0;
+        }
+    }
+    if (ferror(file))
+        status = -1;
+    fclose(file);
+    return status;
+}
+
+int tuned_profile_store(const char *path, const char *key, const TunedConfig *config)
+{
+    char tmp_path[PATH_MAX];
+    int written = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    if (written < 0 || (size_t)written >= sizeof(tmp_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    FILE *out = fopen(tmp_path, "w");
+    if (!out)
+        return -1;
+
+    int failed = fprintf(out, "# key threads chunk_size schedule median_seconds (cc_pthreads_sweep --autotune)\n") < 0;
+
+    // Keep every other entry of an existing profile, in its original order
+    FILE *in = fopen(path, "r");
+    if (in)
+    {
+        char line[PROFILE_LINE_MAX];
+        char entry_key[PROFILE_LINE_MAX];
+        TunedConfig entry;
+        while (!failed && fgets(line, sizeof(line), in))
+        {
+            if (parse_entry(line, entry_key, sizeof(entry_key), &entry) != 1 || strcmp(entry_key, key) == 0)
+                continue;
+            failed = fprintf(out, "%s %d %d %s %.9f\n", entry_key, entry.threads, entry.chunk_size, entry.schedule,
+                             entry.median_seconds) < 0;
+        }
+        fclose(in);
+    }
+
+    if (!failed)
+        failed = fprintf(out, "%s %d %d %s %.9f\n", key, config->threads, config->chunk_size, config->schedule,
+                         config->median_seconds) < 0;
+    if (fclose(out) != 0)
+        failed = 1;
+    if (failed || rename(tmp_path, path) != 0)
+    {
+        int saved = errno;
+        remove(tmp_path);
+        errno = saved;
+        return -1;
+    }
+    return 0;
+}
+
+int tuned_profile_lookup(const char *output_dir, const char *matrix_path, const char *algorithm,
+                         ReorderKind reorder, int trimmed, TunedConfig *config)
+{
+    char key[64];
+    char path[PATH_MAX];
+    if (tuned_profile_key(key, sizeof(key), algorithm, reorder, trimmed) != 0 ||
+        tuned_profile_path(path, sizeof(path), output_dir, matrix_path) != 0)
+    {
+        fprintf(stderr, "Failed to build the tuned profile path: %s\n", strerror(errno));
+        return -1;
+    }
+
+    int status = tuned_profile_load(path, key, config);
+    if (status == 1)
+        fprintf(stderr, "No tuned configuration for '%s' in %s. Run cc_pthreads_sweep --autotune first.\n", key,
+                path);
+    else if (status < 0)
+        fprintf(stderr, "Failed to read tuned profile %s\n", path);
+    return status == 0 ? 0 : -1;
+}
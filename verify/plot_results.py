@@ -70,7 +70,8 @@ def _gather_results(folder: Path) -> Tuple[str, Dict[str, Dict[int, float]], Dic
     thread_data: Dict[str, Dict[int, float]] = {}
     sequential_data: Dict[str, float] = {}
 
-    csv_paths = sorted(folder.glob("results_*_*.csv"))
+    # Long-format files (--results-format long) go through results_to_wide.py first
+    csv_paths = sorted(p for p in folder.glob("results_*_*.csv") if not p.name.endswith(".long.csv"))
     if not csv_paths:
         raise FileNotFoundError(f"No results_<_>_<_>.csv files found in {folder}")
 
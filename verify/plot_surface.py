@@ -21,10 +21,11 @@ _REQUIRED_COLUMNS = {"threads", "chunk_size", "average_seconds"}
 
 
 def _infer_matrix_name(path: Path) -> str:
+    # results_<method>_surface_<matrix>, where <method> may itself contain underscores
     stem = path.stem
     parts = stem.split("_")
-    if len(parts) >= 4 and parts[0] == "results" and parts[1] == "pthread" and parts[2] == "surface":
-        return "_".join(parts[3:])
+    if len(parts) >= 4 and parts[0] == "results" and "surface" in parts[2:-1]:
+        return "_".join(parts[parts.index("surface", 2) + 1:])
     return stem
 
 
@@ -169,6 +170,52 @@ def plot_surface_and_projection(csv_path: Path, output: Path | None, elev: float
     return output_surface, output_projection
 
 
+def plot_speedup(csv_path: Path, baseline_path: Path) -> Path:
+    """Plot baseline / csv runtime over the (threads, chunk size) grid both sweeps share."""
+    threads, chunks, surface = _load_surface_data(csv_path)
+    base_threads, base_chunks, base_surface = _load_surface_data(baseline_path)
+    matrix_name = _infer_matrix_name(csv_path)
+
+    common_threads = [t for t in threads if t in base_threads]
+    common_chunks = [c for c in chunks if c in base_chunks]
+    if not common_threads or not common_chunks:
+        raise ValueError(f"{csv_path} and {baseline_path} share no (threads, chunk size) configurations")
+
+    speedup = np.empty((len(common_threads), len(common_chunks)), dtype=float)
+    for ti, thread in enumerate(common_threads):
+        for ci, chunk in enumerate(common_chunks):
+            new = surface[threads.index(thread), chunks.index(chunk)]
+            old = base_surface[base_threads.index(thread), base_chunks.index(chunk)]
+            speedup[ti, ci] = old / new if new > 0 else np.nan
+
+    chunks_arr = np.array(common_chunks, dtype=float)
+    fig, ax = plt.subplots(figsize=(9, 6), dpi=150)
+    image = ax.imshow(speedup, origin="lower", aspect="auto", cmap="RdYlGn")
+    fig.colorbar(image, ax=ax, label=f"Speedup over {baseline_path.name}")
+    for ti in range(len(common_threads)):
+        for ci in range(len(common_chunks)):
+            ax.text(ci, ti, f"{speedup[ti, ci]:.2f}", ha="center", va="center", fontsize=7)
+
+    ax.set_xticks(range(len(common_chunks)))
+    ax.set_xticklabels([f"2^{int(np.log2(c))}" if np.log2(c).is_integer() else str(int(c)) for c in chunks_arr])
+    ax.set_yticks(range(len(common_threads)))
+    ax.set_yticklabels([str(t) for t in common_threads])
+    ax.set_xlabel("Chunk size")
+    ax.set_ylabel("Threads")
+    ax.set_title(f"Speedup {csv_path.stem} vs {baseline_path.stem}")
+
+    output = csv_path.with_name(f"speedup_plot_{matrix_name}.png")
+    fig.tight_layout()
+    fig.savefig(output, dpi=300, bbox_inches="tight", facecolor="white")
+    plt.close(fig)
+
+    best_old = float(np.min(base_surface))
+    best_new = float(np.min(surface))
+    print(f"Best baseline configuration: {best_old:.6f} s, best new configuration: {best_new:.6f} s "
+          f"({best_old / best_new:.2f}x)")
+    return output
+
+
 def main() -> None:
     parser = argparse.ArgumentParser(description="Plot a 3D surface and a 2D projection from pthread sweep CSV data")
     parser.add_argument("csv", type=Path, help="Path to results_pthread_surface_<matrix>.csv")
@@ -176,6 +223,8 @@ def main() -> None:
     parser.add_argument("--elev", type=float, default=30.0)
     parser.add_argument("--azim", type=float, default=-60.0)
     parser.add_argument("--cmap", type=str, default="viridis")
+    parser.add_argument("--baseline", type=Path,
+                        help="Second sweep CSV (e.g. results_pthread_surface_<matrix>.csv) to plot the speedup against")
 
     args = parser.parse_args()
 
@@ -186,6 +235,10 @@ def main() -> None:
     print(f"Surface plot saved to: {surface_png}")
     print(f"Projection plot saved to: {proj_png}")
 
+    if args.baseline is not None:
+        speedup_png = plot_speedup(args.csv, args.baseline)
+        print(f"Speedup plot saved to: {speedup_png}")
+
 
 if __name__ == "__main__":
     main()
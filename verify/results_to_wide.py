@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Convert long-format results (<base>.long.csv) into the wide <base>.csv layout."""
+
+from __future__ import annotations
+
+import argparse
+import csv
+from pathlib import Path
+from typing import Dict, Iterator, List, Tuple
+
+LONG_SUFFIX = ".long.csv"
+LONG_HEADER = ["column", "run", "value"]
+
+
+def _read_batches(path: Path) -> Iterator[Tuple[str, List[str]]]:
+    """Yield (column, values) for every append call recorded in a long file.
+
+    Each call is written with one O_APPEND write, so its rows are contiguous and numbered
+    from 1. A header line may show up in the middle when two runs created the file at once.
+    """
+    column: str | None = None
+    values: List[str] = []
+    with path.open(newline="") as fh:
+        for lineno, row in enumerate(csv.reader(fh), start=1):
+            if not row or row == LONG_HEADER:
+                continue
+            if len(row) != 3:
+                raise ValueError(f"{path.name}:{lineno}: expected column,run,value, got {row}")
+            name, run, value = row
+            if int(run) == 1 or name != column:
+                if column is not None:
+                    yield column, values
+                column, values = name, []
+            values.append(value)
+    if column is not None:
+        yield column, values
+
+
+def _pad(columns: Dict[str, List[str]], rows: int) -> None:
+    for cells in columns.values():
+        cells.extend([""] * (rows - len(cells)))
+
+
+def to_wide(path: Path) -> Tuple[List[str], List[List[str]]]:
+    """Replay the append calls the way append_times_column lays them out: a new column starts
+    at the top, values for an existing column go below the longest column."""
+    columns: Dict[str, List[str]] = {}
+    for name, values in _read_batches(path):
+        baseline = max((len(cells) for cells in columns.values()), default=0)
+        if name in columns:
+            _pad(columns, baseline)
+            columns[name].extend(values)
+            _pad(columns, baseline + len(values))
+        else:
+            _pad(columns, max(baseline, len(values)))
+            columns[name] = values + [""] * (max(baseline, len(values)) - len(values))
+    header = list(columns)
+    rows = max((len(cells) for cells in columns.values()), default=0)
+    return header, [[columns[name][i] for name in header] for i in range(rows)]
+
+
+def convert(path: Path, output: Path | None = None) -> Path:
+    if output is None:
+        output = path.with_name(path.name[: -len(LONG_SUFFIX)] + ".csv")
+    header, rows = to_wide(path)
+    with output.open("w", newline="") as fh:
+        writer = csv.writer(fh, lineterminator="\n")
+        writer.writerow(header)
+        writer.writerows(rows)
+    return output
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Rebuild wide results CSVs from --results-format long output")
+    parser.add_argument("inputs", type=Path, nargs="+", help="*.long.csv files or directories containing them")
+    parser.add_argument("--output", type=Path, help="Output CSV path (single input file only)")
+    args = parser.parse_args()
+
+    paths: List[Path] = []
+    for item in args.inputs:
+        if item.is_dir():
+            paths.extend(sorted(item.glob(f"*{LONG_SUFFIX}")))
+        elif item.name.endswith(LONG_SUFFIX):
+            paths.append(item)
+        else:
+            parser.error(f"Not a long-format results file: {item}")
+    if not paths:
+        parser.error("No *.long.csv files found")
+    if args.output and len(paths) != 1:
+        parser.error("--output needs exactly one input file")
+
+    for path in paths:
+        print(f"{path} -> {convert(path, args.output)}")
+
+
+if __name__ == "__main__":
+    main()